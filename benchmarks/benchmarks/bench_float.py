@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Script for testing the performance of converting floats to and from strs.
+The values have all 53 significand bits set, so that their repr() needs many
+digits.
+"""
+
+import argparse
+import random
+
+
+DEFAULT_LOOPS = 20
+random_source = random.Random(42)  # Fixed seed.
+VALUES = [random_source.getrandbits(53) / 2 ** 60 for _ in range(4096)]
+STRS = [repr(value) for value in VALUES]
+
+
+def bench_repr(loops):
+    for _ in range(loops):
+        for value in VALUES:
+            repr(value)
+
+
+def bench_parse(loops):
+    for _ in range(loops):
+        for s in STRS:
+            float(s)
+
+
+BENCHMARKS = {
+    "repr": (bench_repr, len(VALUES)),
+    "parse": (bench_parse, len(STRS)),
+}
+
+
+def run():
+    bench_repr(DEFAULT_LOOPS)
+    bench_parse(DEFAULT_LOOPS)
+
+
+def warmup():
+    bench_repr(1)
+    bench_parse(1)
+
+
+def jit():
+    try:
+        from _builtins import _jit_fromlist
+
+        _jit_fromlist(
+            [
+                bench_repr,
+                bench_parse,
+            ]
+        )
+    except ImportError:
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument("--jit", action="store_true", help="Run in JIT mode")
+    args = parser.parse_args()
+    warmup()
+    if args.jit:
+        jit()
+
+    for _ in range(args.num_iterations):
+        run()
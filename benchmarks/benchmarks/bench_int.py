@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Script for testing the performance of arithmetic on huge ints and of
+converting them to and from decimal strs.
+The operands have about 300, 3k, 10k and 100k decimal digits.
+"""
+
+import argparse
+import random
+import sys
+
+
+# Lift the decimal conversion limit of newer CPython versions.
+if hasattr(sys, "set_int_max_str_digits"):
+    sys.set_int_max_str_digits(0)
+
+DEFAULT_LOOPS = 4
+random_source = random.Random(5)  # Fixed seed.
+OPERANDS = [
+    random_source.getrandbits(bits) | (1 << (bits - 1))
+    for bits in (1000, 10000, 33000, 330000)
+]
+DECIMALS = [str(num) for num in OPERANDS]
+
+
+def bench_multiply(loops):
+    for _ in range(loops):
+        for num in OPERANDS:
+            num * num
+            num * (num >> 7)
+
+
+def bench_str(loops):
+    for _ in range(loops):
+        for num in OPERANDS:
+            str(num)
+
+
+def bench_parse(loops):
+    for _ in range(loops):
+        for s in DECIMALS:
+            int(s)
+
+
+BENCHMARKS = {
+    "multiply": (bench_multiply, 2 * len(OPERANDS)),
+    "str": (bench_str, len(OPERANDS)),
+    "parse": (bench_parse, len(DECIMALS)),
+}
+
+
+def run():
+    bench_multiply(DEFAULT_LOOPS)
+    bench_str(DEFAULT_LOOPS)
+    bench_parse(DEFAULT_LOOPS)
+
+
+def warmup():
+    bench_multiply(1)
+    bench_str(1)
+    bench_parse(1)
+
+
+def jit():
+    try:
+        from _builtins import _jit_fromlist
+
+        _jit_fromlist(
+            [
+                bench_multiply,
+                bench_str,
+                bench_parse,
+            ]
+        )
+    except ImportError:
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument("--jit", action="store_true", help="Run in JIT mode")
+    args = parser.parse_args()
+    warmup()
+    if args.jit:
+        jit()
+
+    for _ in range(args.num_iterations):
+        run()
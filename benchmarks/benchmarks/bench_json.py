@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Script for testing the performance of JSON encoding and decoding.
+The payloads are arrays of same-shaped records, the typical shape of API
+responses and newline delimited JSON logs.
+"""
+
+import argparse
+import io
+import json
+import random
+
+
+try:
+    from _json import iterload
+except ImportError:
+
+    def iterload(fp, chunk_size):
+        return (json.loads(line) for line in fp)
+
+
+DEFAULT_LOOPS = 8
+NUM_RECORDS = 2000
+
+
+def make_record(random_source, i):
+    return {
+        "id": i,
+        "uuid": "%032x" % random_source.getrandbits(128),
+        "name": "user%d" % random_source.randrange(100000),
+        "email": "user%d@example.com" % i,
+        "active": random_source.random() < 0.5,
+        "score": random_source.random() * 100,
+        "balance": random_source.randrange(-(10 ** 6), 10 ** 6),
+        "tags": random_source.sample(["red", "green", "blue", "admin", "beta"], 2),
+        "address": {
+            "street": "%d Main Street" % random_source.randrange(1000),
+            "city": random_source.choice(["Springfield", "Shelbyville"]),
+            "zip": "%05d" % random_source.randrange(100000),
+        },
+        "parent": None,
+    }
+
+
+random_source = random.Random(5)  # Fixed seed.
+RECORDS = [make_record(random_source, i) for i in range(NUM_RECORDS)]
+DOCUMENT = json.dumps(RECORDS)
+DOCUMENT_BYTES = DOCUMENT.encode()
+LINES = "\n".join(json.dumps(record) for record in RECORDS).encode()
+
+
+def bench_loads(loops):
+    loads = json.loads
+    for _ in range(loops):
+        loads(DOCUMENT)
+        loads(DOCUMENT_BYTES)
+
+
+def bench_dumps(loops):
+    dumps = json.dumps
+    for _ in range(loops):
+        dumps(RECORDS)
+        dumps(RECORDS, indent=2, sort_keys=True)
+
+
+def bench_iterload(loops):
+    for _ in range(loops):
+        for _record in iterload(io.BytesIO(LINES), chunk_size=16384):
+            pass
+
+
+BENCHMARKS = {
+    "loads": (bench_loads, 2),
+    "dumps": (bench_dumps, 2),
+    "iterload": (bench_iterload, 1),
+}
+
+
+def run():
+    bench_loads(DEFAULT_LOOPS)
+    bench_dumps(DEFAULT_LOOPS)
+    bench_iterload(DEFAULT_LOOPS)
+
+
+def warmup():
+    bench_loads(1)
+    bench_dumps(1)
+    bench_iterload(1)
+
+
+def jit():
+    try:
+        from _builtins import _jit_fromlist
+
+        _jit_fromlist(
+            [
+                bench_loads,
+                bench_dumps,
+                bench_iterload,
+            ]
+        )
+    except ImportError:
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument("--jit", action="store_true", help="Run in JIT mode")
+    args = parser.parse_args()
+    warmup()
+    if args.jit:
+        jit()
+
+    for _ in range(args.num_iterations):
+        run()
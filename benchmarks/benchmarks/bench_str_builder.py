@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""Script for testing the performance of building strs with `+=` on a local.
+One loop only appends to the local; the other reads it between appends, the
+way a line splitter checks its buffer after every chunk.
+"""
+
+import argparse
+
+
+DEFAULT_LOOPS = 20
+NUM_CHUNKS = 5000
+CHUNKS = [f"chunk {i:05d};" for i in range(NUM_CHUNKS)]
+LINE_CHUNKS = [chunk + ("\n" if i % 40 == 39 else "") for i, chunk in enumerate(CHUNKS)]
+
+
+def append_only(chunks):
+    buf = ""
+    for chunk in chunks:
+        buf += chunk
+    return buf
+
+
+def read_between_appends(chunks):
+    lines = 0
+    buf = ""
+    for chunk in chunks:
+        buf += chunk
+        if "\n" in buf:
+            lines += 1
+            buf = ""
+    return lines
+
+
+def bench_append_only(loops):
+    for _ in range(loops):
+        append_only(CHUNKS)
+
+
+def bench_read_between_appends(loops):
+    for _ in range(loops):
+        read_between_appends(LINE_CHUNKS)
+
+
+BENCHMARKS = {
+    "append_only": (bench_append_only, NUM_CHUNKS),
+    "read_between_appends": (bench_read_between_appends, NUM_CHUNKS),
+}
+
+
+def run():
+    bench_append_only(DEFAULT_LOOPS)
+    bench_read_between_appends(DEFAULT_LOOPS)
+
+
+def warmup():
+    bench_append_only(1)
+    bench_read_between_appends(1)
+
+
+def jit():
+    try:
+        from _builtins import _jit_fromlist
+
+        _jit_fromlist(
+            [
+                bench_append_only,
+                bench_read_between_appends,
+            ]
+        )
+    except ImportError:
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument("--jit", action="store_true", help="Run in JIT mode")
+    args = parser.parse_args()
+    warmup()
+    if args.jit:
+        jit()
+
+    for _ in range(args.num_iterations):
+        run()
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Script for testing the performance of str and bytes hashing.
+Every hash is taken of a freshly copied object so that no cached hash is
+reused. Run once as is and once with PYRO_STR_HASH=wyhash to compare the two
+hash algorithms.
+"""
+
+import argparse
+
+
+DEFAULT_LOOPS = 20
+NUM_KEYS = 2000
+# bytearrays, so that bytes() and decode() always create a new object.
+IDENTIFIERS = [bytearray(b"k%06d" % i) for i in range(NUM_KEYS // 2)] + [
+    bytearray(b"attribute_name_%09d" % i) for i in range(NUM_KEYS // 2)
+]
+PAYLOADS = [bytearray(97 + (i + j) % 26 for j in range(4096)) for i in range(26)]
+
+
+def bench_hash_identifiers(loops):
+    for _ in range(loops):
+        for key in IDENTIFIERS:
+            hash(bytes(key))
+            hash(key.decode())
+
+
+def bench_hash_payloads(loops):
+    for _ in range(loops):
+        for payload in PAYLOADS:
+            hash(bytes(payload))
+
+
+BENCHMARKS = {
+    "hash_identifiers": (bench_hash_identifiers, 2 * NUM_KEYS),
+    "hash_payloads": (bench_hash_payloads, len(PAYLOADS)),
+}
+
+
+def run():
+    bench_hash_identifiers(DEFAULT_LOOPS)
+    bench_hash_payloads(DEFAULT_LOOPS)
+
+
+def warmup():
+    bench_hash_identifiers(1)
+    bench_hash_payloads(1)
+
+
+def jit():
+    try:
+        from _builtins import _jit_fromlist
+
+        _jit_fromlist(
+            [
+                bench_hash_identifiers,
+                bench_hash_payloads,
+            ]
+        )
+    except ImportError:
+        pass
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+    parser.add_argument(
+        "num_iterations",
+        type=int,
+        default=1,
+        nargs="?",
+        help="Number of iterations to run the benchmark",
+    )
+    parser.add_argument("--jit", action="store_true", help="Run in JIT mode")
+    args = parser.parse_args()
+    warmup()
+    if args.jit:
+        jit()
+
+    for _ in range(args.num_iterations):
+        run()
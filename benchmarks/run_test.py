@@ -195,6 +195,91 @@ class TestBenchmark(unittest.TestCase):
         single_result = json_output[0]
         self.assertEqual(single_result["benchmark"], "bench_pickle")
 
+    def test_choose_bench_json_benchmark(self):
+        arguments = [
+            "-i",
+            "fbcode-python",
+            "-p",
+            BENCHMARKS_PATH,
+            "-b",
+            "bench_json",
+            "-t",
+            "time",
+            "--json",
+        ]
+        json_output = json.loads(run.main(arguments))
+        self.assertEqual(len(json_output), 1)
+        single_result = json_output[0]
+        self.assertEqual(single_result["benchmark"], "bench_json")
+
+    def test_choose_bench_str_builder_benchmark(self):
+        arguments = [
+            "-i",
+            "fbcode-python",
+            "-p",
+            BENCHMARKS_PATH,
+            "-b",
+            "bench_str_builder",
+            "-t",
+            "time",
+            "--json",
+        ]
+        json_output = json.loads(run.main(arguments))
+        self.assertEqual(len(json_output), 1)
+        single_result = json_output[0]
+        self.assertEqual(single_result["benchmark"], "bench_str_builder")
+
+    def test_choose_bench_str_hash_benchmark(self):
+        arguments = [
+            "-i",
+            "fbcode-python",
+            "-p",
+            BENCHMARKS_PATH,
+            "-b",
+            "bench_str_hash",
+            "-t",
+            "time",
+            "--json",
+        ]
+        json_output = json.loads(run.main(arguments))
+        self.assertEqual(len(json_output), 1)
+        single_result = json_output[0]
+        self.assertEqual(single_result["benchmark"], "bench_str_hash")
+
+    def test_choose_bench_int_benchmark(self):
+        arguments = [
+            "-i",
+            "fbcode-python",
+            "-p",
+            BENCHMARKS_PATH,
+            "-b",
+            "bench_int",
+            "-t",
+            "time",
+            "--json",
+        ]
+        json_output = json.loads(run.main(arguments))
+        self.assertEqual(len(json_output), 1)
+        single_result = json_output[0]
+        self.assertEqual(single_result["benchmark"], "bench_int")
+
+    def test_choose_bench_float_benchmark(self):
+        arguments = [
+            "-i",
+            "fbcode-python",
+            "-p",
+            BENCHMARKS_PATH,
+            "-b",
+            "bench_float",
+            "-t",
+            "time",
+            "--json",
+        ]
+        json_output = json.loads(run.main(arguments))
+        self.assertEqual(len(json_output), 1)
+        single_result = json_output[0]
+        self.assertEqual(single_result["benchmark"], "bench_float")
+
     def test_choose_loadproperty_benchmark(self):
         arguments = [
             "-i",
@@ -403,13 +403,23 @@ PY_EXPORT void Py_InitializeEx(int initsigs) {
     random_seed = randomState();
     Py_HashRandomizationFlag = 1;
   }
+  StrHashAlgorithm str_hash_algorithm = StrHashAlgorithm::kSiphash24;
+  const char* str_hash =
+      Py_IgnoreEnvironmentFlag ? nullptr : std::getenv("PYRO_STR_HASH");
+  if (str_hash != nullptr && str_hash[0] != '\0') {
+    if (std::strcmp(str_hash, "wyhash") == 0) {
+      str_hash_algorithm = StrHashAlgorithm::kWyhash;
+    } else if (std::strcmp(str_hash, "siphash24") != 0) {
+      Py_FatalError("PYRO_STR_HASH must be \"siphash24\" or \"wyhash\"");
+    }
+  }
   StdioState stdio_state =
       Py_UnbufferedStdioFlag ? StdioState::kUnbuffered : StdioState::kBuffered;
   Interpreter* interpreter = boolFromEnv("PYRO_CPP_INTERPRETER", false)
                                  ? createCppInterpreter()
                                  : createAsmInterpreter();
-  Runtime* runtime =
-      new Runtime(heap_size, interpreter, random_seed, stdio_state);
+  Runtime* runtime = new Runtime(heap_size, interpreter, random_seed,
+                                 stdio_state, str_hash_algorithm);
   Thread* thread = Thread::current();
   initializeSysFromGlobals(thread);
   CHECK(runtime->initialize(thread).isNoneType(),
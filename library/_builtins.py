@@ -655,6 +655,12 @@ def _jit(func):
     _builtin()
 
 
+def _jit_deopt_stats(func):
+    """Return a list of (pc, opname, count) tuples recording where the
+    compiled code of the given function fell back to the interpreter."""
+    _builtin()
+
+
 def _jit_fromlist(funcs):
     """Compile a list of function objects to native code."""
     for func in funcs:
@@ -717,6 +723,10 @@ def _list_guard(obj):
     _builtin()
 
 
+def _list_index(self, value, start, stop):
+    _builtin()
+
+
 def _list_len(self):
     "$intrinsic$"
     _builtin()
@@ -1235,6 +1245,10 @@ def _tuple_guard(obj):
     _builtin()
 
 
+def _tuple_index(self, value, start, stop):
+    _builtin()
+
+
 def _tuple_len(self):
     "$intrinsic$"
     _builtin()
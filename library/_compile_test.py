@@ -1570,5 +1570,192 @@ RETURN_VALUE
         self.assertEqual(func(), 123)
 
 
+@pyro_only
+class StrBuilderTests(unittest.TestCase):
+    def test_str_local_extended_with_aug_add_uses_str_builder(self):
+        source = """
+def foo(n):
+    s = ""
+    for i in n:
+        s += i
+    return s
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(
+            dis(func.__code__),
+            """\
+LOAD_CONST ''
+STORE_FAST_REVERSE s
+LOAD_FAST_REVERSE_UNCHECKED n
+GET_ITER
+FOR_ITER 12
+STORE_FAST_REVERSE i
+LOAD_FAST_STR_BUILDER s
+LOAD_FAST_REVERSE_UNCHECKED i
+INPLACE_ADD_STR_BUILDER
+STORE_FAST_REVERSE s
+JUMP_ABSOLUTE 8
+LOAD_FAST_STR s
+RETURN_VALUE
+""",
+        )
+        self.assertEqual(func(("a", "b", "c")), "abc")
+
+    def test_local_with_non_str_store_does_not_use_str_builder(self):
+        source = """
+def foo(n):
+    s = 0
+    s += n
+    return s
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(
+            dis(func.__code__),
+            """\
+LOAD_CONST 0
+STORE_FAST_REVERSE s
+LOAD_FAST_REVERSE_UNCHECKED s
+LOAD_FAST_REVERSE_UNCHECKED n
+INPLACE_ADD
+STORE_FAST_REVERSE s
+LOAD_FAST_REVERSE_UNCHECKED s
+RETURN_VALUE
+""",
+        )
+        self.assertEqual(func(5), 5)
+
+    def test_argument_does_not_use_str_builder(self):
+        source = """
+def foo(s):
+    s += "x"
+    return s
+"""
+        func = compile_function(source, "foo")
+        self.assertNotIn("STR_BUILDER", dis(func.__code__))
+        self.assertEqual(func("a"), "ax")
+
+    def test_str_builder_produces_long_str(self):
+        source = """
+def foo(n):
+    s = ""
+    for i in range(n):
+        s += str(i)
+        s += ","
+    return s
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(func(1000), "".join(f"{i}," for i in range(1000)))
+
+    def test_str_builder_read_inside_loop_sees_current_value(self):
+        source = """
+def foo(n):
+    s = ""
+    lengths = []
+    for i in range(n):
+        s += "abcdefghij"
+        lengths.append(len(s))
+        s += s[:3]
+    return s, lengths
+"""
+        func = compile_function(source, "foo")
+        s = ""
+        lengths = []
+        for i in range(20):
+            s += "abcdefghij"
+            lengths.append(len(s))
+            s += s[:3]
+        self.assertEqual(func(20), (s, lengths))
+
+    def test_str_builder_appended_to_itself(self):
+        source = """
+def foo(n):
+    s = "ab"
+    for i in range(n):
+        s += s
+    return s
+"""
+        func = compile_function(source, "foo")
+        code = dis(func.__code__)
+        self.assertIn("INPLACE_ADD_STR_BUILDER", code)
+        self.assertNotIn("LOAD_FAST_STR_BUILDER", code)
+        self.assertEqual(func(8), "ab" * 256)
+
+    def test_str_builder_is_finished_in_locals(self):
+        source = """
+def foo():
+    s = ""
+    for i in range(100):
+        s += "abc"
+    return locals()["s"]
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(func(), "abc" * 100)
+
+    def test_str_builder_with_non_str_raises_type_error(self):
+        source = """
+def foo(n):
+    s = ""
+    for i in range(100):
+        s += "abc"
+    s += n
+    return s
+"""
+        func = compile_function(source, "foo")
+        with self.assertRaises(TypeError):
+            func(1)
+
+    def test_str_builder_with_str_subclass_calls_radd(self):
+        source = """
+def foo(n):
+    s = ""
+    for i in range(100):
+        s += "abc"
+    s += n
+    return s
+"""
+
+        class C(str):
+            def __radd__(self, other):
+                return len(other)
+
+        func = compile_function(source, "foo")
+        self.assertEqual(func(C("x")), 300)
+
+    def test_unbound_str_builder_raises_unbound_local_error(self):
+        source = """
+def foo(cond):
+    if cond:
+        s = ""
+    s += "abc"
+    return s
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(func(True), "abc")
+        with self.assertRaises(UnboundLocalError):
+            func(False)
+
+    def test_str_builder_only_extended_keeps_its_stores(self):
+        source = """
+def foo():
+    s = ""
+    for i in range(3):
+        s += "ab"
+    return 1
+"""
+        func = compile_function(source, "foo")
+        self.assertEqual(func(), 1)
+
+    def test_str_builder_only_read_through_eval_keeps_its_stores(self):
+        source = """
+def foo():
+    s = ""
+    s += "ab"
+    return eval("s")
+"""
+        func = compile_function(source, "foo")
+        self.assertNotIn("POP_TOP", dis(func.__code__))
+        self.assertEqual(func(), "ab")
+
+
 if __name__ == "__main__":
     unittest.main()
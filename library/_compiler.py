@@ -2,7 +2,7 @@
 import ast
 from ast import AST
 from compiler import compile as compiler_compile
-from compiler.consts import CO_VARARGS, CO_VARKEYWORDS
+from compiler.consts import CO_VARARGS, CO_VARKEYWORDS, SC_LOCAL
 from compiler.optimizer import BIN_OPS, is_const, get_const_value
 from compiler.py38.optimizer import AstOptimizer38
 from compiler.pyassem import PyFlowGraph38, Instruction
@@ -211,6 +211,12 @@ class AstOptimizerPyro(AstOptimizer38):
 class PyroFlowGraph(PyFlowGraph38):
     opcode = opcodepyro.opcode
 
+    _converters = {
+        **PyFlowGraph38._converters,
+        "LOAD_FAST_STR": PyFlowGraph38._convert_LOAD_FAST,
+        "LOAD_FAST_STR_BUILDER": PyFlowGraph38._convert_LOAD_FAST,
+    }
+
     def optimizeStoreFast(self):
         if "locals" in self.varnames or "locals" in self.names:
             # A bit of a hack: if someone is using locals(), we shouldn't mess
@@ -219,7 +225,12 @@ class PyroFlowGraph(PyFlowGraph38):
         used = set()
         for block in self.getBlocksInOrder():
             for instr in block.getInstructions():
-                if instr.opname == "LOAD_FAST" or instr.opname == "DELETE_FAST":
+                if instr.opname in (
+                    "LOAD_FAST",
+                    "LOAD_FAST_STR",
+                    "LOAD_FAST_STR_BUILDER",
+                    "DELETE_FAST",
+                ):
                     used.add(instr.oparg)
         # We never read from or delete the local, so we can replace all stores
         # to it with POP_TOP.
@@ -283,6 +294,14 @@ class PyroFlowGraph(PyFlowGraph38):
                         # body assigned. The only thing that can undefine them
                         # is DELETE_FAST.
                         conditionally_assigned.add(instr.oparg)
+                elif modify and instr.opname in (
+                    "LOAD_FAST_STR",
+                    "LOAD_FAST_STR_BUILDER",
+                ):
+                    # These stay checked loads, but rely on unassigned locals
+                    # holding the unbound marker just like LOAD_FAST does.
+                    if not assigned & (1 << instr.ioparg):
+                        conditionally_assigned.add(instr.oparg)
                 elif instr.opname == "STORE_FAST":
                     assigned |= 1 << instr.ioparg
                     if modify:
@@ -372,6 +391,69 @@ def _can_inline_comprehension(node):
     return can_inline
 
 
+def _is_str_literal(node):
+    return isinstance(node, ast.JoinedStr) or (
+        isinstance(node, ast.Constant) and isinstance(node.value, str)
+    )
+
+
+def _reads_name(node, name):
+    return any(
+        isinstance(child, ast.Name) and child.id == name for child in ast.walk(node)
+    )
+
+
+class StrBuilderCandidates(ASTVisitor):
+    """Finds the locals of a function that are only ever assigned str literals
+    and extended with `+=`. Such locals can accumulate their appends in a
+    StrArray that is turned back into a str whenever the local is read."""
+
+    def __init__(self):
+        super().__init__()
+        self.appended = set()
+        self.excluded = set()
+
+    def visitAssign(self, node):
+        if _is_str_literal(node.value) and all(
+            isinstance(target, ast.Name) for target in node.targets
+        ):
+            self.visit(node.value)
+        else:
+            self.generic_visit(node)
+
+    def visitAugAssign(self, node):
+        if isinstance(node.target, ast.Name) and isinstance(node.op, ast.Add):
+            self.appended.add(node.target.id)
+            self.visit(node.value)
+        else:
+            self.generic_visit(node)
+
+    def visitName(self, node):
+        if not isinstance(node.ctx, ast.Load):
+            self.excluded.add(node.id)
+
+    def visitarg(self, node):
+        self.excluded.add(node.arg)
+
+    def visitalias(self, node):
+        self.excluded.add((node.asname or node.name).partition(".")[0])
+
+    def visitExceptHandler(self, node):
+        if node.name:
+            self.excluded.add(node.name)
+        self.generic_visit(node)
+
+    def visitFunctionDef(self, node):
+        # Nested scopes only bind their own name here.
+        self.excluded.add(node.name)
+
+    visitAsyncFunctionDef = visitFunctionDef
+    visitClassDef = visitFunctionDef
+
+    def visitLambda(self, node):
+        pass
+
+
 class PyroSymbolVisitor(SymbolVisitor):
     def visitDictCompListCompSetComp(self, node, scope):
         if not _can_inline_comprehension(node):
@@ -411,6 +493,7 @@ class PyroSymbolVisitor(SymbolVisitor):
 
 class PyroCodeGenerator(Python38CodeGenerator):
     flow_graph = PyroFlowGraph
+    _str_builders = None
 
     @classmethod
     def make_code_gen(
@@ -447,6 +530,51 @@ class PyroCodeGenerator(Python38CodeGenerator):
         else:
             self.emit("COMPARE_OP", self._cmp_opcode[type(op)])
 
+    def _is_str_builder(self, name):
+        str_builders = self._str_builders
+        if str_builders is None:
+            str_builders = self._str_builders = self._find_str_builders()
+        return name in str_builders
+
+    def _find_str_builders(self):
+        tree = self.tree
+        if not isinstance(tree, (ast.FunctionDef, ast.AsyncFunctionDef)):
+            return frozenset()
+        visitor = StrBuilderCandidates()
+        visitor.visit(tree.args)
+        for stmt in tree.body:
+            visitor.visit(stmt)
+        names = (self.mangle(name) for name in visitor.appended - visitor.excluded)
+        return frozenset(
+            name for name in names if self.scope.check_name(name) == SC_LOCAL
+        )
+
+    def _nameOp(self, prefix, name):
+        if prefix == "LOAD" and self._is_str_builder(self.mangle(name)):
+            self.emit("LOAD_FAST_STR", self.mangle(name))
+            return
+        super()._nameOp(prefix, name)
+
+    def visitAugAssign(self, node):
+        target = node.target
+        if not (
+            isinstance(target, ast.Name)
+            and isinstance(node.op, ast.Add)
+            and self._is_str_builder(self.mangle(target.id))
+        ):
+            return super().visitAugAssign(node)
+        name = self.mangle(target.id)
+        self.set_lineno(node)
+        if _reads_name(node.value, target.id):
+            # A read of the local may turn the builder into a str in place, so
+            # start from that str rather than keeping the builder on the stack.
+            self.emit("LOAD_FAST_STR", name)
+        else:
+            self.emit("LOAD_FAST_STR_BUILDER", name)
+        self.visit(node.value)
+        self.emit("INPLACE_ADD_STR_BUILDER")
+        self.emit("STORE_FAST", name)
+
     def visitListComp(self, node):
         if not _can_inline_comprehension(node):
             return super().visitListComp(node)
@@ -77,9 +77,12 @@ def_op("NOP", 9)
 def_op("UNARY_POSITIVE", 10)
 def_op("UNARY_NEGATIVE", 11)
 def_op("UNARY_NOT", 12)
+local_op("LOAD_FAST_STR", 13)
+local_op("LOAD_FAST_STR_BUILDER", 14)
 def_op("UNARY_INVERT", 15)
 def_op("BINARY_MATRIX_MULTIPLY", 16)
 def_op("INPLACE_MATRIX_MULTIPLY", 17)
+def_op("INPLACE_ADD_STR_BUILDER", 18)
 def_op("BINARY_POWER", 19)
 def_op("BINARY_MULTIPLY", 20)
 def_op("BINARY_MODULO", 22)
@@ -309,6 +312,7 @@ add_synonym("COMPARE_OP", "COMPARE_IS")
 add_synonym("COMPARE_OP", "COMPARE_IS_NOT")
 add_synonym("COMPARE_OP", "COMPARE_OP_ANAMORPHIC")
 add_synonym("FOR_ITER", "FOR_ITER_ANAMORPHIC")
+add_synonym("INPLACE_ADD", "INPLACE_ADD_STR_BUILDER")
 add_synonym("INPLACE_ADD", "INPLACE_OP_ANAMORPHIC")
 add_synonym("LOAD_ATTR", "LOAD_ATTR_ANAMORPHIC")
 add_synonym("LOAD_CONST", "LOAD_BOOL")
@@ -317,5 +321,7 @@ add_synonym("STORE_ATTR", "STORE_ATTR_ANAMORPHIC")
 add_synonym("STORE_SUBSCR", "STORE_SUBSCR_ANAMORPHIC")
 add_synonym("LOAD_FAST", "LOAD_FAST_REVERSE")
 add_synonym("LOAD_FAST", "LOAD_FAST_REVERSE_UNCHECKED")
+add_synonym("LOAD_FAST", "LOAD_FAST_STR")
+add_synonym("LOAD_FAST", "LOAD_FAST_STR_BUILDER")
 add_synonym("STORE_FAST", "STORE_FAST_REVERSE")
 add_synonym("DELETE_FAST", "DELETE_FAST_REVERSE_UNCHECKED")
@@ -113,6 +113,10 @@ def _TextIOWrapper_attached_closed_seekable_guard(obj):
     _builtin()
 
 
+def _TextIOWrapper_readline_UTF8(self):
+    _builtin()
+
+
 def _TextIOWrapper_write_UTF8(self, text):
     _builtin()
 
@@ -137,6 +141,18 @@ def _buffered_reader_readline(self, size=None):
     _builtin()
 
 
+def _buffered_writer_flush(self):
+    _builtin()
+
+
+def _buffered_writer_init(self, buffer_size):
+    _builtin()
+
+
+def _buffered_writer_write(self, b):
+    _builtin()
+
+
 def _detached_guard(self):
     if self.raw is None:
         raise ValueError("raw stream has been detached")
@@ -987,13 +1003,15 @@ class BufferedWriter(_BufferedIOMixin, bootstrap=True):
             raise UnsupportedOperation("File or stream is not writable.")
 
         _BufferedIOMixin.__init__(self, raw)
+        buffer_size = _index(buffer_size)
         if buffer_size <= 0:
             raise ValueError("buffer size must be strictly positive")
-        self.buffer_size = buffer_size
-        self._write_buf = bytearray()  # TODO(T47880928): use a memoryview
+        _buffered_writer_init(self, buffer_size)
         self._write_lock = _thread_Lock()
 
     def _flush_unlocked(self):
+        if _buffered_writer_flush(self) is not _Unbound:
+            return
         if self.closed:
             raise ValueError("flush of closed file")
         while self._write_buf:
@@ -1016,6 +1034,8 @@ class BufferedWriter(_BufferedIOMixin, bootstrap=True):
             del self._write_buf[:n]
 
     def flush(self):
+        if _buffered_writer_flush(self) is not _Unbound:
+            return
         with self._write_lock:
             self._flush_unlocked()
 
@@ -1039,6 +1059,9 @@ class BufferedWriter(_BufferedIOMixin, bootstrap=True):
         return self.raw.writable()
 
     def write(self, b):
+        result = _buffered_writer_write(self, b)
+        if result is not _Unbound:
+            return result
         if self.closed:
             raise ValueError("write to closed file")
         if _str_check(b):
@@ -1084,7 +1107,7 @@ class BytesIO(_BufferedIOBase, bootstrap=True):
     def getbuffer(self):
         """Return a readable and writable view of the buffer."""
         _BytesIO_closed_guard(self)
-        return memoryview(self._buffer)
+        return memoryview(self._buffer)[: self.__num_items]
 
     def close(self):
         _BytesIO_guard(self)
@@ -1451,12 +1474,14 @@ class TextIOWrapper(_TextIOBase, bootstrap=True):
     def __next__(self):
         _TextIOWrapper_attached_guard(self)
         self._telling = False
-        line = self.readline()
-        if not _str_check(line):
-            raise IOError(
-                "readline() should have returned a str object, not "
-                f"'{_type(line).__name__}'"
-            )
+        line = _TextIOWrapper_readline_UTF8(self)
+        if line is _Unbound:
+            line = self.readline()
+            if not _str_check(line):
+                raise IOError(
+                    "readline() should have returned a str object, not "
+                    f"'{_type(line).__name__}'"
+                )
         if not line:
             self._snapshot = None
             self._telling = self._seekable
@@ -1688,6 +1713,10 @@ class TextIOWrapper(_TextIOBase, bootstrap=True):
         return self._buffer.readable()
 
     def readline(self, size=None):  # noqa: C901
+        if size is None:
+            result = _TextIOWrapper_readline_UTF8(self)
+            if result is not _Unbound:
+                return result
         result = _TextIOWrapper_attached_closed_guard(self)
         if result is _Unbound:
             self._checkClosed()
@@ -717,6 +717,40 @@ class BufferedWriterTests(unittest.TestCase):
                 self.assertIs(writer.writable(), True)
                 self.assertEqual(bytes_io.writable.call_count, 2)
 
+    def test_write_to_file_io_keeps_small_writes_buffered(self):
+        r, w = os.pipe()
+        with _io.FileIO(r, mode="r") as reader:
+            with _io.BufferedWriter(_io.FileIO(w, mode="w"), 8) as writer:
+                self.assertEqual(writer.write(b"abc"), 3)
+                self.assertEqual(writer.write(bytearray(b"def")), 3)
+                os.set_blocking(r, False)
+                self.assertIsNone(reader.read(16))
+                writer.flush()
+                self.assertEqual(reader.read(16), b"abcdef")
+
+    def test_write_to_file_io_with_large_bytes_writes_buffer_and_bytes(self):
+        r, w = os.pipe()
+        with _io.FileIO(r, mode="r") as reader:
+            with _io.BufferedWriter(_io.FileIO(w, mode="w"), 4) as writer:
+                self.assertEqual(writer.write(b"ab"), 2)
+                self.assertEqual(writer.write(memoryview(b"23456789")), 8)
+                os.set_blocking(r, False)
+                self.assertEqual(reader.read(16), b"ab23456789")
+                self.assertEqual(writer.write(b"x"), 1)
+            self.assertEqual(reader.read(16), b"x")
+
+    def test_write_to_closed_file_io_raises_value_error(self):
+        r, w = os.pipe()
+        os.close(r)
+        writer = _io.BufferedWriter(_io.FileIO(w, mode="w"))
+        writer.close()
+        with self.assertRaises(ValueError) as context:
+            writer.write(b"hello")
+        self.assertEqual(str(context.exception), "write to closed file")
+        with self.assertRaises(ValueError) as context:
+            writer.flush()
+        self.assertEqual(str(context.exception), "flush of closed file")
+
     def test_write_with_closed_raises_value_error(self):
         writer = _io.BufferedWriter(_io.BytesIO(b"hello"))
         writer.close()
@@ -895,6 +929,11 @@ class BytesIOTests(unittest.TestCase):
         result = f.getbuffer()
         self.assertIsInstance(result, memoryview)
 
+    def test_getbuffer_after_write_returns_written_bytes_only(self):
+        f = _io.BytesIO()
+        f.write(b"abc")
+        self.assertEqual(bytes(f.getbuffer()), b"abc")
+
     def test_read_with_non_BytesIO_self_raises_type_error(self):
         with self.assertRaises(TypeError):
             _io.BytesIO.read(5)
@@ -2597,6 +2636,31 @@ class BufferedReaderTests(unittest.TestCase):
             result = buffered.read(3)
             self.assertEqual(result, b"hel")
 
+    def test_read_with_file_io_reads_large_counts_and_rest_of_file(self):
+        data = bytes(range(256)) * 400
+        with tempfile.TemporaryDirectory() as tempdir:
+            path = os.path.join(tempdir, "data")
+            with open(path, "wb") as f:
+                f.write(data)
+            with _io.FileIO(path, mode="r") as file_reader:
+                buffered = _io.BufferedReader(file_reader, buffer_size=16)
+                self.assertEqual(buffered.read(3), data[:3])
+                self.assertEqual(buffered.read(50000), data[3:50003])
+                self.assertEqual(buffered.read(), data[50003:])
+                self.assertEqual(buffered.read(), b"")
+                self.assertEqual(buffered.read(100), b"")
+                buffered.seek(1)
+                self.assertEqual(buffered.read(len(data)), data[1:])
+
+    def test_read_with_pipe_file_io_reads_until_end_of_file(self):
+        r, w = os.pipe()
+        with open(w, "wb") as f:
+            f.write(b"x" * 5000)
+        with _io.FileIO(r, mode="r") as file_reader:
+            buffered = _io.BufferedReader(file_reader, buffer_size=16)
+            self.assertEqual(buffered.read(2), b"xx")
+            self.assertEqual(buffered.read(), b"x" * 4998)
+
     def test_readinto_writes_to_buffer(self):
         with _io.BytesIO(b"hello") as bytes_io:
             with _io.BufferedReader(bytes_io, buffer_size=4) as buffered:
@@ -3068,6 +3132,71 @@ class TextIOWrapperTests(unittest.TestCase):
             self.assertEqual(text_io.readline(), "\n")
             self.assertEqual(text_io.readline(), "")
 
+    def test_readline_with_buffered_reader_reads_lines(self):
+        data = "foo\nb\u00e4r\r\n\u20ac\rlast".encode()
+        for newline, expected in (
+            (None, ["foo\n", "b\u00e4r\n", "\u20ac\n", "last"]),
+            ("", ["foo\n", "b\u00e4r\r\n", "\u20ac\r", "last"]),
+            ("\n", ["foo\n", "b\u00e4r\r\n", "\u20ac\rlast"]),
+            ("\r", ["foo\nb\u00e4r\r", "\n\u20ac\r", "last"]),
+        ):
+            for buffer_size in (4, 5, 8192):
+                buffer = _io.BufferedReader(_io.BytesIO(data), buffer_size)
+                with _io.TextIOWrapper(buffer, "utf-8", newline=newline) as text_io:
+                    self.assertEqual(list(text_io), expected)
+                    self.assertEqual(text_io.readline(), "")
+
+    def test_readline_with_buffered_reader_records_newlines(self):
+        buffer = _io.BufferedReader(_io.BytesIO(b"a\nb\r\nc\r"), 4)
+        with _io.TextIOWrapper(buffer, "ascii") as text_io:
+            self.assertIsNone(text_io.newlines)
+            self.assertEqual(text_io.readline(), "a\n")
+            self.assertEqual(text_io.readline(), "b\n")
+            self.assertEqual(text_io.readline(), "c\n")
+            self.assertEqual(text_io.newlines, ("\r", "\n", "\r\n"))
+
+    def test_readline_with_buffered_reader_and_long_line_reads_lines(self):
+        data = b"x" * 20 + b"\ny\nz"
+        buffer = _io.BufferedReader(_io.BytesIO(data), 8)
+        with _io.TextIOWrapper(buffer, "utf-8") as text_io:
+            self.assertEqual(text_io.readline(), "x" * 20 + "\n")
+            self.assertEqual(text_io.readline(), "y\n")
+            self.assertEqual(text_io.readline(), "z")
+
+    def test_readline_with_buffered_reader_after_read_reads_lines(self):
+        buffer = _io.BufferedReader(_io.BytesIO(b"abc\ndef\nghi\n"), 8)
+        with _io.TextIOWrapper(buffer, "utf-8") as text_io:
+            self.assertEqual(text_io.read(1), "a")
+            self.assertEqual(text_io.readline(), "bc\n")
+            self.assertEqual(text_io.readline(), "def\n")
+            self.assertEqual(text_io.read(), "ghi\n")
+
+    def test_readline_with_buffered_reader_and_invalid_bytes_raises_error(self):
+        buffer = _io.BufferedReader(_io.BytesIO(b"\xff\nok\n"))
+        with _io.TextIOWrapper(buffer, "utf-8") as text_io:
+            with self.assertRaises(UnicodeDecodeError):
+                text_io.readline()
+        buffer = _io.BufferedReader(_io.BytesIO(b"ok\n\xff\n"))
+        with _io.TextIOWrapper(buffer, "utf-8", errors="replace") as text_io:
+            self.assertEqual(text_io.readlines(), ["ok\n", "\ufffd\n"])
+        buffer = _io.BufferedReader(_io.BytesIO(b"\xc3\xa4\n"))
+        with _io.TextIOWrapper(buffer, "ascii", errors="replace") as text_io:
+            self.assertEqual(text_io.readline(), "\ufffd\ufffd\n")
+
+    def test_readline_with_file_io_returns_tell_after_line(self):
+        with tempfile.TemporaryDirectory() as tempdir:
+            path = os.path.join(tempdir, "lines.txt")
+            with open(path, "wb") as f:
+                f.write(b"one\r\ntwo\nthree\n")
+            with open(path, encoding="utf-8") as text_io:
+                self.assertEqual(text_io.readline(), "one\n")
+                self.assertEqual(text_io.tell(), 5)
+                self.assertEqual(text_io.readline(), "two\n")
+                position = text_io.tell()
+                self.assertEqual(text_io.readline(), "three\n")
+                text_io.seek(position)
+                self.assertEqual(text_io.readline(), "three\n")
+
     def test_tell_with_non_TextIOWrapper_raises_type_error(self):
         with self.assertRaises(TypeError):
             _io.TextIOWrapper.tell(5)
@@ -3155,6 +3284,15 @@ class TextIOWrapperTests(unittest.TestCase):
             text_io.seek(0)
             self.assertEqual(text_io.read(), "((llo++")
 
+    def test_write_with_more_than_buffer_size_writes_to_file(self):
+        r, w = os.pipe()
+        with _io.FileIO(r, mode="r") as reader:
+            buffer = _io.BufferedWriter(_io.FileIO(w, mode="w"), 16)
+            with _io.TextIOWrapper(buffer, encoding="utf-8") as text_io:
+                self.assertEqual(text_io.write("x" * 10000), 10000)
+                os.set_blocking(r, False)
+                self.assertEqual(reader.read(20000), b"x" * 10000)
+
     def test_write_with_utf8_encoding_and_strict_errors_and_surrogate_raises_unicodeencode_error(
         self,
     ):
@@ -2,6 +2,9 @@
 from _builtins import _builtin
 
 
+_UTF8_BOM = b"\xef\xbb\xbf"
+
+
 class JSONDecodeError(ValueError):
     """Subclass of ValueError with the following additional properties:
 
@@ -47,6 +50,100 @@ def _decode_with_cls(
     return cls(**kw).decode(s)
 
 
+def _encode_with_cls(
+    obj,
+    skipkeys,
+    ensure_ascii,
+    check_circular,
+    allow_nan,
+    cls,
+    indent,
+    separators,
+    default,
+    sort_keys,
+    **kw,
+):
+    if cls is None:
+        cls = _JSONEncoder
+    return cls(
+        skipkeys=skipkeys,
+        ensure_ascii=ensure_ascii,
+        check_circular=check_circular,
+        allow_nan=allow_nan,
+        indent=indent,
+        separators=separators,
+        default=default,
+        sort_keys=sort_keys,
+        **kw,
+    ).encode(obj)
+
+
+def _loads_values(
+    buffer,
+    end,
+    strict,
+    object_hook,
+    parse_float,
+    parse_int,
+    parse_constant,
+    object_pairs_hook,
+):
+    _builtin()
+
+
+def _scan_values(buffer, pos, state):
+    _builtin()
+
+
+def dumps(
+    obj,
+    *,
+    skipkeys=False,
+    ensure_ascii=True,
+    check_circular=True,
+    allow_nan=True,
+    cls=None,
+    indent=None,
+    separators=None,
+    default=None,
+    sort_keys=False,
+    **kw,
+):
+    _builtin()
+
+
+def encode_basestring(s):
+    _builtin()
+
+
+def encode_basestring_ascii(s):
+    _builtin()
+
+
+def iterload(fp, *, chunk_size=65536, **kwargs):
+    """Yield the documents of a stream of whitespace separated JSON documents,
+    such as newline delimited JSON, read from the file object `fp` in chunks.
+    Binary files are read with `readinto` into a reused buffer. The keyword
+    arguments are passed to `StreamDecoder`."""
+    decoder = StreamDecoder(**kwargs)
+    readinto = getattr(fp, "readinto", None)
+    if readinto is None:
+        while True:
+            chunk = fp.read(chunk_size)
+            if not chunk:
+                break
+            yield from decoder.feed(chunk)
+    else:
+        chunk = bytearray(chunk_size)
+        view = memoryview(chunk)
+        while True:
+            n = readinto(chunk)
+            if not n:
+                break
+            yield from decoder.feed(view[:n])
+    yield from decoder.close()
+
+
 def loads(
     s,
     *,
@@ -62,4 +159,71 @@ def loads(
     _builtin()
 
 
+class StreamDecoder:
+    """Incremental decoder for a stream of whitespace separated JSON documents
+    such as newline delimited JSON. Chunks of UTF-8 encoded data may split
+    documents anywhere; `feed` returns the documents completed so far and keeps
+    the rest buffered until more data arrives."""
+
+    def __init__(
+        self,
+        *,
+        object_hook=None,
+        parse_float=None,
+        parse_int=None,
+        parse_constant=None,
+        object_pairs_hook=None,
+        strict=True,
+    ):
+        self._buffer = bytearray()
+        self._scan_pos = 0
+        self._scan_state = 0
+        self._started = False
+        self._hooks = (
+            object_hook,
+            parse_float,
+            parse_int,
+            parse_constant,
+            object_pairs_hook,
+        )
+        self._strict = strict
+
+    def _decode(self, end):
+        buffer = self._buffer
+        values = _loads_values(buffer, end, self._strict, *self._hooks)
+        del buffer[:end]
+        self._scan_pos -= end
+        return values
+
+    def feed(self, data):
+        """Add `data` (bytes-like or str) to the stream and return a list of
+        the documents it completed."""
+        if isinstance(data, str):
+            data = data.encode("utf-8", "surrogatepass")
+        buffer = self._buffer
+        buffer += data
+        if not self._started:
+            if len(buffer) < 3 and _UTF8_BOM.startswith(buffer):
+                return []
+            if buffer.startswith(_UTF8_BOM):
+                del buffer[:3]
+            self._started = True
+        end, self._scan_pos, self._scan_state = _scan_values(
+            buffer, self._scan_pos, self._scan_state
+        )
+        if end == 0:
+            return []
+        return self._decode(end)
+
+    def close(self):
+        """Finish the stream and return a list of the remaining documents.
+        Raises `JSONDecodeError` if the stream ends inside a document."""
+        values = self._decode(len(self._buffer))
+        self._scan_pos = 0
+        self._scan_state = 0
+        self._started = False
+        return values
+
+
 from json.decoder import JSONDecoder as _JSONDecoder
+from json.encoder import JSONEncoder as _JSONEncoder
@@ -1,15 +1,33 @@
 #!/usr/bin/env python3
 # Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+import io
 import sys
 import unittest
 
-from test_support import cpython_only
+from test_support import cpython_only, pyro_only
+
+
+from json.encoder import JSONEncoder
 
 
 if sys.implementation.name == "skybison":
-    from _json import loads, JSONDecodeError
+    from _json import (
+        dumps,
+        encode_basestring,
+        encode_basestring_ascii,
+        iterload,
+        loads,
+        JSONDecodeError,
+        StreamDecoder,
+    )
 else:
-    from json import loads, JSONDecodeError
+    from json import dumps, loads, JSONDecodeError
+    from json.encoder import encode_basestring, encode_basestring_ascii
+
+
+def _py_dumps(obj, **kwargs):
+    # Not one-shot, so this always takes the pure-Python encoder.
+    return "".join(JSONEncoder(**kwargs).iterencode(obj))
 
 
 class LoadsTests(unittest.TestCase):
@@ -756,6 +774,51 @@ class LoadsTests(unittest.TestCase):
         self.assertIs(d0_keys[0], d1_keys[1])
         self.assertIs(d0_keys[2], d1_keys[0])
 
+    def test_dicts_with_same_first_key_keep_their_own_keys(self):
+        result = loads(
+            '[{"a": 1, "b": 2}, {"a": 3, "b": 4}, {"a": 5}, {"a": 6, "c": 7},'
+            ' {"a": 8, "b": 9, "c": 10}, {"a": 11, "a": 12, "b": 13}]'
+        )
+        self.assertEqual(
+            result,
+            [
+                {"a": 1, "b": 2},
+                {"a": 3, "b": 4},
+                {"a": 5},
+                {"a": 6, "c": 7},
+                {"a": 8, "b": 9, "c": 10},
+                {"a": 12, "b": 13},
+            ],
+        )
+        self.assertEqual([list(d) for d in result][3], ["a", "c"])
+        result[1]["z"] = 14
+        del result[0]["a"]
+        self.assertEqual(result[0], {"b": 2})
+        self.assertEqual(list(result[1].items()), [("a", 3), ("b", 4), ("z", 14)])
+        self.assertEqual(result[2], {"a": 5})
+
+    def test_dicts_with_predicted_keys_match_whole_keys(self):
+        result = loads(
+            '[{"abc": 1, "long key name": 2}, {"ab": 3}, {"abcd": 4},'
+            ' {"a\\u0062c": 5, "long key name": 6}, {"abc": 7, "long key": 8},'
+            ' {"abc": 9, "long key name": {"abc": 10}}, {"abc": 11, "\\"": 12}]'
+        )
+        self.assertEqual(
+            result,
+            [
+                {"abc": 1, "long key name": 2},
+                {"ab": 3},
+                {"abcd": 4},
+                {"abc": 5, "long key name": 6},
+                {"abc": 7, "long key": 8},
+                {"abc": 9, "long key name": {"abc": 10}},
+                {"abc": 11, '"': 12},
+            ],
+        )
+        keys = [list(d) for d in result]
+        self.assertIs(keys[0][1], keys[3][1])
+        self.assertIs(keys[0][1], keys[5][1])
+
     def test_with_cls_calls_cls_and_calls_decode(self):
         class C:
             def decode(self, s):
@@ -835,6 +898,13 @@ class LoadsTests(unittest.TestCase):
         ):
             loads("\ufeff0")
 
+    def test_with_invalid_bytes_raises_decode_error(self):
+        with self.assertRaisesRegex(
+            JSONDecodeError, r"Expecting value: line 2 column 1 \(char 4\)"
+        ) as context:
+            loads(b"[1,\n")
+        self.assertEqual(context.exception.doc, "[1,\n")
+
     def test_json_raises_type_error(self):
         with self.assertRaisesRegex(
             TypeError, "the JSON object must be str, bytes or bytearray, not float"
@@ -842,5 +912,241 @@ class LoadsTests(unittest.TestCase):
             loads(42.42)
 
 
+class DumpsTests(unittest.TestCase):
+    def test_with_simple_values_returns_str(self):
+        self.assertEqual(dumps(None), "null")
+        self.assertEqual(dumps(True), "true")
+        self.assertEqual(dumps(False), "false")
+        self.assertEqual(dumps(0), "0")
+        self.assertEqual(dumps(-42), "-42")
+        self.assertEqual(dumps(2 ** 100), "1267650600228229401496703205376")
+        self.assertEqual(dumps(-(2 ** 64)), "-18446744073709551616")
+        self.assertEqual(dumps(1.5), "1.5")
+        self.assertEqual(dumps(1e100), "1e+100")
+        self.assertEqual(dumps(3.0), "3.0")
+        self.assertEqual(dumps(float("nan")), "NaN")
+        self.assertEqual(dumps(float("inf")), "Infinity")
+        self.assertEqual(dumps(float("-inf")), "-Infinity")
+        self.assertEqual(dumps("hello"), '"hello"')
+
+    def test_with_containers_returns_str(self):
+        self.assertEqual(dumps([]), "[]")
+        self.assertEqual(dumps(()), "[]")
+        self.assertEqual(dumps({}), "{}")
+        self.assertEqual(
+            dumps([1, (2, 3), {"a": [None]}]), '[1, [2, 3], {"a": [null]}]'
+        )
+
+    def test_with_str_escapes_special_chars(self):
+        value = 'q"b\\s/\b\f\n\r\t\x00\x1f\x7f'
+        self.assertEqual(
+            dumps(value), '"q\\"b\\\\s/\\b\\f\\n\\r\\t\\u0000\\u001f\\u007f"'
+        )
+        self.assertEqual(
+            dumps(value, ensure_ascii=False),
+            '"q\\"b\\\\s/\\b\\f\\n\\r\\t\\u0000\\u001f\x7f"',
+        )
+
+    def test_with_non_ascii_str_escapes_unless_ensure_ascii_is_false(self):
+        value = "caf\xe9 € \U0001f40d \ud800"
+        self.assertEqual(dumps(value), '"caf\\u00e9 \\u20ac \\ud83d\\udc0d \\ud800"')
+        self.assertEqual(dumps(value, ensure_ascii=False), f'"{value}"')
+
+    def test_with_long_str_matches_python_encoder(self):
+        value = "abcdefghijklmnopqrstuvwxyzé\"0123456789\n" * 20
+        self.assertEqual(dumps(value), _py_dumps(value))
+        self.assertEqual(
+            dumps(value, ensure_ascii=False), _py_dumps(value, ensure_ascii=False)
+        )
+
+    def test_with_options_matches_python_encoder(self):
+        value = {
+            "b": [1, 2.5, {"x": None, "y": [], "z": {}}],
+            "a": (True, False, "s"),
+            "c": {"nested": [[1], [2, [3]]]},
+        }
+        for kwargs in (
+            {},
+            {"indent": 2},
+            {"indent": 0},
+            {"indent": "\t", "sort_keys": True},
+            {"separators": (",", ":")},
+            {"separators": [";", "="], "indent": 1},
+            {"sort_keys": True},
+        ):
+            with self.subTest(kwargs=kwargs):
+                self.assertEqual(dumps(value, **kwargs), _py_dumps(value, **kwargs))
+
+    def test_with_non_str_keys_converts_keys(self):
+        value = {7: "a", 2.5: "b", True: "c", None: "d", float("inf"): "e"}
+        self.assertEqual(
+            dumps(value),
+            '{"7": "a", "2.5": "b", "true": "c", "null": "d", "Infinity": "e"}',
+        )
+
+    def test_with_unsupported_key_raises_type_error(self):
+        with self.assertRaisesRegex(
+            TypeError, "keys must be str, int, float, bool or None, not tuple"
+        ):
+            dumps({(1,): 2})
+
+    def test_with_skipkeys_skips_unsupported_keys(self):
+        self.assertEqual(dumps({(1,): 2, "a": 3}, skipkeys=True), '{"a": 3}')
+        self.assertEqual(
+            dumps({(1,): 2}, skipkeys=True, indent=2),
+            _py_dumps({(1,): 2}, skipkeys=True, indent=2),
+        )
+
+    def test_with_sort_keys_and_unorderable_keys_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            dumps({1: 2, "a": 3}, sort_keys=True)
+
+    def test_with_unsupported_value_raises_type_error(self):
+        with self.assertRaisesRegex(
+            TypeError, "Object of type set is not JSON serializable"
+        ):
+            dumps([{1}])
+
+    def test_with_default_encodes_default_result(self):
+        self.assertEqual(dumps({"a": {3, 4}}, default=sorted), '{"a": [3, 4]}')
+
+    def test_with_circular_reference_raises_value_error(self):
+        value = []
+        value.append(value)
+        with self.assertRaisesRegex(ValueError, "Circular reference detected"):
+            dumps(value)
+        value = {}
+        value["a"] = [value]
+        with self.assertRaisesRegex(ValueError, "Circular reference detected"):
+            dumps(value)
+
+    def test_with_repeated_value_returns_str(self):
+        shared = [1]
+        self.assertEqual(dumps([shared, shared]), "[[1], [1]]")
+
+    def test_with_nan_and_allow_nan_false_raises_value_error(self):
+        with self.assertRaisesRegex(
+            ValueError, "Out of range float values are not JSON compliant"
+        ):
+            dumps([float("nan")], allow_nan=False)
+
+    def test_with_subclasses_encodes_underlying_values(self):
+        class I(int):
+            def __repr__(self):
+                return "bad"
+
+        class F(float):
+            def __repr__(self):
+                return "bad"
+
+        class S(str):
+            pass
+
+        class L(list):
+            pass
+
+        class D(dict):
+            pass
+
+        value = D(a=L([I(5), F(0.5), S("x")]))
+        self.assertEqual(dumps(value), '{"a": [5, 0.5, "x"]}')
+
+    def test_with_dict_subclass_overriding_items_uses_items(self):
+        class D(dict):
+            def items(self):
+                return [("x", 1), ("b", 2)]
+
+        self.assertEqual(dumps(D(a=1)), '{"x": 1, "b": 2}')
+        self.assertEqual(dumps(D(a=1), sort_keys=True), '{"b": 2, "x": 1}')
+
+    def test_with_dict_subclass_items_returning_non_pairs_raises_value_error(self):
+        class D(dict):
+            def items(self):
+                return [("x", 1, 2)]
+
+        with self.assertRaisesRegex(ValueError, "items must return 2-tuples"):
+            dumps(D(a=1))
+
+    def test_with_cls_uses_cls(self):
+        class E(JSONEncoder):
+            def default(self, o):
+                return "custom"
+
+        self.assertEqual(dumps([object()], cls=E), '["custom"]')
+
+    def test_encode_basestring_returns_quoted_str(self):
+        self.assertEqual(encode_basestring("a€\n"), '"a€\\n"')
+        self.assertEqual(encode_basestring_ascii("a€\n"), '"a\\u20ac\\n"')
+        with self.assertRaises(TypeError):
+            encode_basestring_ascii(b"a")
+
+
+@pyro_only
+class StreamDecoderTests(unittest.TestCase):
+    def test_feed_returns_completed_documents(self):
+        decoder = StreamDecoder()
+        self.assertEqual(
+            decoder.feed(b'{"a": 1}\n[2, 3]\n"x"\n'), [{"a": 1}, [2, 3], "x"]
+        )
+        self.assertEqual(decoder.close(), [])
+
+    def test_feed_resumes_documents_split_across_chunks(self):
+        data = b'{"a": [1, "b\\"]}", {"c": null}]}\n  \ttrue 12.5e3 "\xe2\x82\xac"\n[]'
+        expected = [{"a": [1, 'b"]}', {"c": None}]}, True, 12.5e3, "\u20ac", []]
+        for size in (1, 2, 3, 7):
+            decoder = StreamDecoder()
+            result = []
+            for i in range(0, len(data), size):
+                result += decoder.feed(data[i : i + size])
+            result += decoder.close()
+            self.assertEqual(result, expected)
+
+    def test_feed_keeps_trailing_scalar_until_delimited(self):
+        decoder = StreamDecoder()
+        self.assertEqual(decoder.feed(b"12"), [])
+        self.assertEqual(decoder.feed(b"34 5"), [1234])
+        self.assertEqual(decoder.close(), [5])
+
+    def test_feed_with_str_and_memoryview_chunks(self):
+        decoder = StreamDecoder()
+        self.assertEqual(decoder.feed('["\u20ac"'), [])
+        self.assertEqual(decoder.feed(memoryview(b"]")), [["\u20ac"]])
+
+    def test_feed_skips_utf8_bom(self):
+        decoder = StreamDecoder()
+        self.assertEqual(decoder.feed(b"\xef"), [])
+        self.assertEqual(decoder.feed(b"\xbb\xbf[1]"), [[1]])
+
+    def test_feed_passes_hooks(self):
+        decoder = StreamDecoder(object_hook=len, parse_int=float, strict=False)
+        self.assertEqual(
+            decoder.feed(b'{"a": 1, "b": 2} [3, "\t"]'), [2, [3.0, "\t"]]
+        )
+
+    def test_close_with_incomplete_document_raises_decode_error(self):
+        decoder = StreamDecoder()
+        self.assertEqual(decoder.feed(b'[1]\n{"a": [1,'), [[1]])
+        with self.assertRaisesRegex(
+            JSONDecodeError, r"Expecting value: line 2 column 10 \(char 10\)"
+        ):
+            decoder.close()
+
+    def test_feed_with_invalid_document_raises_decode_error(self):
+        decoder = StreamDecoder()
+        with self.assertRaisesRegex(
+            JSONDecodeError, r"Expecting ',' delimiter: line 2 column 4"
+        ):
+            decoder.feed(b"[1]\n[2 3]\n")
+
+    def test_iterload_reads_binary_file(self):
+        lines = [{"id": i, "name": "n%d" % i} for i in range(1000)]
+        data = "\n".join(dumps(line) for line in lines).encode()
+        self.assertEqual(list(iterload(io.BytesIO(data), chunk_size=100)), lines)
+
+    def test_iterload_reads_text_file(self):
+        fp = io.StringIO('1 [2]\n"3"')
+        self.assertEqual(list(iterload(fp, chunk_size=2)), [1, [2], "3"])
+
+
 if __name__ == "__main__":
     unittest.main()
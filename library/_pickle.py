@@ -0,0 +1,500 @@
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+"""Native accelerator for the `pickle` module.
+
+Protocols 2 and up are pickled and unpickled by the runtime; protocols 0 and 1
+are delegated to the pure Python implementation in `pickle`. The helpers at
+the bottom of this module implement the parts of the protocol that call back
+into arbitrary Python code and are used by the runtime."""
+
+import sys
+
+from _builtins import _builtin
+
+
+DEFAULT_PROTOCOL = 4
+HIGHEST_PROTOCOL = 5
+
+_PROTO = 0x80
+
+
+class PickleError(Exception):
+    pass
+
+
+class PicklingError(PickleError):
+    pass
+
+
+class UnpicklingError(PickleError):
+    pass
+
+
+class PickleBuffer:
+    """Wrapper for potentially out-of-band buffers"""
+
+    def __init__(self, buffer):
+        self._view = memoryview(buffer)
+
+    def raw(self):
+        view = self._view
+        if view is None:
+            raise ValueError("operation forbidden on released PickleBuffer object")
+        return view.cast("B")
+
+    def release(self):
+        view = self._view
+        if view is not None:
+            view.release()
+            self._view = None
+
+
+def _check_protocol(protocol, buffer_callback):
+    if protocol is None:
+        protocol = DEFAULT_PROTOCOL
+    protocol = int(protocol)
+    if protocol < 0:
+        protocol = HIGHEST_PROTOCOL
+    elif protocol > HIGHEST_PROTOCOL:
+        raise ValueError(f"pickle protocol must be <= {HIGHEST_PROTOCOL}")
+    if buffer_callback is not None and protocol < 5:
+        raise ValueError("buffer_callback needs protocol >= 5")
+    return protocol
+
+
+def _dumps(
+    obj,
+    protocol,
+    memo,
+    persistent_id,
+    reducer_override,
+    dispatch_table,
+    buffer_callback,
+    fix_imports,
+):
+    _builtin()
+
+
+def _load(unpickler, data, read, readline):
+    _builtin()
+
+
+class _FileWriter:
+    def __init__(self, write):
+        self.write = write
+
+
+class _PrefixedReader:
+    """File-like object that returns `prefix` before the rest of the file."""
+
+    def __init__(self, prefix, read, readline):
+        self._prefix = prefix
+        self._read = read
+        self._readline = readline
+
+    def read(self, n):
+        prefix = self._prefix
+        if not prefix or n <= 0:
+            return self._read(n)
+        self._prefix = b""
+        return prefix + self._read(n - 1)
+
+    def readline(self):
+        prefix = self._prefix
+        if not prefix:
+            return self._readline()
+        self._prefix = b""
+        if prefix == b"\n":
+            return prefix
+        return prefix + self._readline()
+
+
+class Pickler:
+    def __init__(self, file, protocol=None, *, fix_imports=True, buffer_callback=None):
+        self.proto = _check_protocol(protocol, buffer_callback)
+        try:
+            self._file_write = file.write
+        except AttributeError:
+            raise TypeError("file must have a 'write' attribute")
+        self._buffer_callback = buffer_callback
+        self._memo = {}
+        self._pure_pickler = None
+        self.bin = self.proto >= 1
+        self.fast = 0
+        self.fix_imports = fix_imports and self.proto < 3
+
+    def clear_memo(self):
+        self._memo.clear()
+        if self._pure_pickler is not None:
+            self._pure_pickler.clear_memo()
+
+    def dump(self, obj):
+        if not hasattr(self, "_file_write"):
+            raise PicklingError(
+                f"Pickler.__init__() was not called by "
+                f"{self.__class__.__name__}.__init__()"
+            )
+        if self.proto < 2:
+            self._dump_with_pure_pickle(obj)
+            return
+        dispatch_table = getattr(self, "dispatch_table", None)
+        if dispatch_table is None:
+            import copyreg
+
+            dispatch_table = copyreg.dispatch_table
+        self._file_write(
+            _dumps(
+                obj,
+                self.proto,
+                self._memo,
+                getattr(self, "persistent_id", None),
+                getattr(self, "reducer_override", None),
+                dispatch_table,
+                self._buffer_callback,
+                self.fix_imports,
+            )
+        )
+
+    def _dump_with_pure_pickle(self, obj):
+        pickler = self._pure_pickler
+        if pickler is None:
+            import pickle
+
+            pickler = pickle._Pickler(
+                _FileWriter(self._file_write), self.proto, fix_imports=self.fix_imports
+            )
+            self._pure_pickler = pickler
+        for name in ("persistent_id", "reducer_override", "dispatch_table"):
+            value = getattr(self, name, None)
+            if value is not None:
+                setattr(pickler, name, value)
+        pickler.dump(obj)
+
+
+class Unpickler:
+    def __init__(
+        self, file, *, fix_imports=True, encoding="ASCII", errors="strict", buffers=None
+    ):
+        self._file_read = file.read
+        self._file_readline = file.readline
+        self._init_state(fix_imports, encoding, errors, buffers)
+
+    def _init_state(self, fix_imports, encoding, errors, buffers):
+        self._buffers = iter(buffers) if buffers is not None else None
+        self.memo = {}
+        self.encoding = encoding
+        self.errors = errors
+        self.proto = 0
+        self.fix_imports = fix_imports
+
+    def load(self):
+        if not hasattr(self, "_file_read"):
+            raise UnpicklingError(
+                f"Unpickler.__init__() was not called by "
+                f"{self.__class__.__name__}.__init__()"
+            )
+        first = self._file_read(1)
+        if not first:
+            raise EOFError("Ran out of input")
+        if first[0] != _PROTO:
+            return self._load_with_pure_pickle(
+                _PrefixedReader(first, self._file_read, self._file_readline)
+            )
+        return _load(self, None, self._file_read, self._file_readline)
+
+    def _load_with_pure_pickle(self, file):
+        import pickle
+
+        unpickler = pickle._Unpickler(
+            file,
+            fix_imports=self.fix_imports,
+            encoding=self.encoding,
+            errors=self.errors,
+            buffers=self._buffers,
+        )
+        unpickler.memo = self.memo
+        unpickler.find_class = self.find_class
+        unpickler.persistent_load = self.persistent_load
+        self.proto = 0
+        return unpickler.load()
+
+    def find_class(self, module, name):
+        sys.audit("pickle.find_class", module, name)
+        if self.proto < 3 and self.fix_imports:
+            import _compat_pickle
+
+            if (module, name) in _compat_pickle.NAME_MAPPING:
+                module, name = _compat_pickle.NAME_MAPPING[(module, name)]
+            elif module in _compat_pickle.IMPORT_MAPPING:
+                module = _compat_pickle.IMPORT_MAPPING[module]
+        __import__(module, level=0)
+        if self.proto >= 4:
+            from pickle import _getattribute
+
+            return _getattribute(sys.modules[module], name)[0]
+        return getattr(sys.modules[module], name)
+
+    def persistent_load(self, pid):
+        raise UnpicklingError(
+            "A load persistent id instruction was encountered,\n"
+            "but no persistent_load function was specified."
+        )
+
+
+def dump(obj, file, protocol=None, *, fix_imports=True, buffer_callback=None):
+    Pickler(
+        file, protocol, fix_imports=fix_imports, buffer_callback=buffer_callback
+    ).dump(obj)
+
+
+def dumps(obj, protocol=None, *, fix_imports=True, buffer_callback=None):
+    protocol = _check_protocol(protocol, buffer_callback)
+    if protocol < 2:
+        import pickle
+
+        return pickle._dumps(
+            obj, protocol, fix_imports=fix_imports, buffer_callback=buffer_callback
+        )
+    import copyreg
+
+    return _dumps(
+        obj,
+        protocol,
+        {},
+        None,
+        None,
+        copyreg.dispatch_table,
+        buffer_callback,
+        fix_imports and protocol < 3,
+    )
+
+
+def load(file, *, fix_imports=True, encoding="ASCII", errors="strict", buffers=None):
+    return Unpickler(
+        file,
+        fix_imports=fix_imports,
+        encoding=encoding,
+        errors=errors,
+        buffers=buffers,
+    ).load()
+
+
+def loads(data, *, fix_imports=True, encoding="ASCII", errors="strict", buffers=None):
+    if isinstance(data, str):
+        raise TypeError("Can't load pickle from unicode string")
+    if not isinstance(data, bytes):
+        data = bytes(data)
+    if not data:
+        raise EOFError("Ran out of input")
+    if data[0] != _PROTO:
+        import pickle
+
+        return pickle._loads(
+            data,
+            fix_imports=fix_imports,
+            encoding=encoding,
+            errors=errors,
+            buffers=buffers,
+        )
+    unpickler = Unpickler.__new__(Unpickler)
+    unpickler._init_state(fix_imports, encoding, errors, buffers)
+    return _load(unpickler, data, None, None)
+
+
+# Helpers called by the runtime.
+
+# Kinds of results of `_global_info()`; keep in sync with `GlobalKind`.
+_GLOBAL_EXTENSION = 0
+_GLOBAL_NAME = 1
+_GLOBAL_GETATTR = 2
+_GLOBAL_REDUCE = 3
+
+
+def _global_info(obj, name, proto, fix_imports):
+    if name is None:
+        if obj is type(None):
+            return _GLOBAL_REDUCE, (type, (None,))
+        if obj is type(NotImplemented):
+            return _GLOBAL_REDUCE, (type, (NotImplemented,))
+        if obj is type(...):
+            return _GLOBAL_REDUCE, (type, (...,))
+        name = getattr(obj, "__qualname__", None)
+        if name is None:
+            name = obj.__name__
+
+    from copyreg import _extension_registry
+    from pickle import _getattribute, whichmodule
+
+    module_name = whichmodule(obj, name)
+    try:
+        __import__(module_name, level=0)
+        module = sys.modules[module_name]
+        obj2, parent = _getattribute(module, name)
+    except (ImportError, KeyError, AttributeError):
+        raise PicklingError(
+            f"Can't pickle {obj!r}: it's not found as {module_name}.{name}"
+        ) from None
+    if obj2 is not obj:
+        raise PicklingError(
+            f"Can't pickle {obj!r}: it's not the same object as {module_name}.{name}"
+        )
+
+    code = _extension_registry.get((module_name, name))
+    if code:
+        return _GLOBAL_EXTENSION, code
+    lastname = name.rpartition(".")[2]
+    if parent is module:
+        name = lastname
+    if proto >= 4:
+        return _GLOBAL_NAME, module_name, name
+    if parent is not module:
+        return _GLOBAL_GETATTR, (getattr, (parent, lastname))
+    if proto < 3:
+        if fix_imports:
+            import _compat_pickle
+
+            if (module_name, name) in _compat_pickle.REVERSE_NAME_MAPPING:
+                module_name, name = _compat_pickle.REVERSE_NAME_MAPPING[
+                    (module_name, name)
+                ]
+            elif module_name in _compat_pickle.REVERSE_IMPORT_MAPPING:
+                module_name = _compat_pickle.REVERSE_IMPORT_MAPPING[module_name]
+        if not module_name.isascii() or not name.isascii():
+            raise PicklingError(
+                f"can't pickle global identifier '{module_name}.{name}' using "
+                f"pickle protocol {proto}"
+            )
+    return _GLOBAL_NAME, module_name, name
+
+
+def _picklebuffer_info(buffer):
+    with buffer.raw() as view:
+        return view.tobytes(), view.readonly
+
+
+def _reduce_bytes(obj):
+    if type(obj) is bytearray:
+        return bytearray, ((bytes(obj),) if obj else ())
+    if not obj:
+        return bytes, ()
+    import codecs
+
+    return codecs.encode, (str(obj, "latin1"), "latin1")
+
+
+def _reduce_set(obj):
+    return type(obj), (list(obj),), getattr(obj, "__dict__", None)
+
+
+def _newobj_ex_partial(args):
+    from functools import partial
+
+    cls, cls_args, cls_kwargs = args
+    return partial(cls.__new__, cls, *cls_args, **cls_kwargs)
+
+
+def _dict_items_list(dictitems):
+    return [(key, value) for key, value in dictitems]
+
+
+def _newobj(cls, args):
+    return cls.__new__(cls, *args)
+
+
+def _newobj_ex(cls, args, kwargs):
+    return cls.__new__(cls, *args, **kwargs)
+
+
+def _build(inst, state):
+    setstate = getattr(inst, "__setstate__", None)
+    if setstate is not None:
+        setstate(state)
+        return
+    slotstate = None
+    if isinstance(state, tuple) and len(state) == 2:
+        state, slotstate = state
+    if state:
+        inst_dict = inst.__dict__
+        intern = sys.intern
+        for key, value in state.items():
+            if type(key) is str:
+                inst_dict[intern(key)] = value
+            else:
+                inst_dict[key] = value
+    if slotstate:
+        for key, value in slotstate.items():
+            setattr(inst, key, value)
+
+
+def _extend(obj, items):
+    try:
+        extend = obj.extend
+    except AttributeError:
+        pass
+    else:
+        extend(items)
+        return
+    append = obj.append
+    for item in items:
+        append(item)
+
+
+def _setitems(obj, items):
+    for i in range(0, len(items), 2):
+        obj[items[i]] = items[i + 1]
+
+
+def _additems(obj, items):
+    if isinstance(obj, set):
+        obj.update(items)
+        return
+    add = obj.add
+    for item in items:
+        add(item)
+
+
+_extension_cache = {}
+
+
+def _get_extension(unpickler, code):
+    nil = []
+    obj = _extension_cache.get(code, nil)
+    if obj is not nil:
+        return obj
+    from copyreg import _inverted_registry
+
+    key = _inverted_registry.get(code)
+    if not key:
+        if code <= 0:
+            raise UnpicklingError("EXT specifies code <= 0")
+        raise ValueError(f"unregistered extension code {code}")
+    obj = unpickler.find_class(*key)
+    _extension_cache[code] = obj
+    return obj
+
+
+def _next_buffer(unpickler):
+    buffers = unpickler._buffers
+    if buffers is None:
+        raise UnpicklingError(
+            "pickle stream refers to out-of-band data but no *buffers* "
+            "argument was given"
+        )
+    try:
+        return next(buffers)
+    except StopIteration:
+        raise UnpicklingError("not enough out-of-band buffers")
+
+
+def _readonly_buffer(buffer):
+    view = buffer.raw() if isinstance(buffer, PickleBuffer) else memoryview(buffer)
+    with view:
+        if view.readonly:
+            return buffer
+        # memoryview.toreadonly() is not available; fall back to a copy.
+        return view.tobytes()
+
+
+def _decode_string(unpickler, value):
+    if unpickler.encoding == "bytes":
+        return value
+    return value.decode(unpickler.encoding, unpickler.errors)
@@ -0,0 +1,421 @@
+#!/usr/bin/env python3
+# Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+import copyreg
+import io
+import pickle
+import unittest
+
+import _pickle
+
+
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+    def __eq__(self, other):
+        return type(other) is Point and (self.x, self.y) == (other.x, other.y)
+
+
+class Reduced:
+    def __init__(self, value):
+        self.value = value
+
+    def __reduce__(self):
+        return Reduced, (self.value,)
+
+
+class WithState:
+    def __init__(self):
+        self.items = []
+
+    def __getstate__(self):
+        return {"items": self.items, "extra": 42}
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self.restored = True
+
+
+class Outer:
+    class Inner:
+        pass
+
+
+def module_function():
+    pass
+
+
+class ZeroCopyBytearray(bytearray):
+    def __reduce_ex__(self, protocol):
+        if protocol >= 5:
+            return type(self)._reconstruct, (_pickle.PickleBuffer(self),), None
+        return type(self)._reconstruct, (bytearray(self),)
+
+    @classmethod
+    def _reconstruct(cls, obj):
+        if isinstance(obj, _pickle.PickleBuffer):
+            obj = obj.raw()
+        return cls(obj)
+
+
+SIMPLE_VALUES = [
+    None,
+    True,
+    False,
+    0,
+    1,
+    255,
+    256,
+    65535,
+    65536,
+    -1,
+    -129,
+    2 ** 31 - 1,
+    -(2 ** 31),
+    2 ** 31,
+    -(2 ** 31) - 1,
+    2 ** 64,
+    -(2 ** 64),
+    -(2 ** 63),
+    2 ** 2100,
+    -(2 ** 2100),
+    0.0,
+    -1.5,
+    1e300,
+    "",
+    "hello",
+    "h\xe9llo w€rld \U0001f40d",
+    "x" * 300,
+    b"",
+    b"bytes",
+    b"y" * 300,
+    (),
+    (1,),
+    (1, 2),
+    (1, 2, 3),
+    (1, 2, 3, 4),
+    [],
+    [1],
+    [1, "two", 3.0],
+    list(range(2500)),
+    {},
+    {"a": 1},
+    {i: str(i) for i in range(2500)},
+    {1, 2, 3},
+    frozenset({"a", "b"}),
+    set(range(1500)),
+]
+
+
+class DumpsTests(unittest.TestCase):
+    def test_dumps_matches_pure_python_pickler(self):
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            for value in SIMPLE_VALUES:
+                with self.subTest(protocol=protocol, value=value):
+                    self.assertEqual(
+                        _pickle.dumps(value, protocol),
+                        pickle._dumps(value, protocol),
+                    )
+
+    def test_dumps_with_shared_references_matches_pure_python_pickler(self):
+        shared = ["shared"]
+        value = [shared, (shared, shared), {"k": shared}]
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            self.assertEqual(
+                _pickle.dumps(value, protocol), pickle._dumps(value, protocol)
+            )
+
+    def test_dumps_globals_matches_pure_python_pickler(self):
+        values = [Point, Outer.Inner, module_function, len, type(None), Ellipsis]
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            for value in values:
+                with self.subTest(protocol=protocol, value=value):
+                    self.assertEqual(
+                        _pickle.dumps(value, protocol),
+                        pickle._dumps(value, protocol),
+                    )
+
+    def test_dumps_with_invalid_protocol_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _pickle.dumps(1, pickle.HIGHEST_PROTOCOL + 1)
+
+    def test_dumps_with_negative_protocol_uses_highest_protocol(self):
+        self.assertEqual(
+            _pickle.dumps(1, -1)[:2], bytes([0x80, pickle.HIGHEST_PROTOCOL])
+        )
+
+    def test_dumps_with_buffer_callback_and_protocol_4_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _pickle.dumps(1, 4, buffer_callback=list.append)
+
+    def test_dumps_local_class_raises_pickling_error(self):
+        class Local:
+            pass
+
+        with self.assertRaises((pickle.PicklingError, AttributeError)):
+            _pickle.dumps(Local, 4)
+
+    def test_dumps_non_tuple_reduce_raises_pickling_error(self):
+        class C:
+            def __reduce__(self):
+                return 42
+
+        with self.assertRaises(pickle.PicklingError):
+            _pickle.dumps(C(), 4)
+
+    def test_dumps_deeply_nested_list_raises_recursion_error(self):
+        value = []
+        for _ in range(100000):
+            value = [value]
+        with self.assertRaises(RecursionError):
+            _pickle.dumps(value, 4)
+
+    def test_dumps_large_value_is_split_into_frames(self):
+        value = [bytes([i % 256]) * 1000 for i in range(200)]
+        data = _pickle.dumps(value, 4)
+        self.assertGreater(data.count(b"\x95"), 1)
+        self.assertEqual(_pickle.loads(data), value)
+        self.assertEqual(pickle._loads(data), value)
+
+
+class RoundTripTests(unittest.TestCase):
+    def round_trip(self, value, protocol):
+        return _pickle.loads(_pickle.dumps(value, protocol))
+
+    def test_round_trip_simple_values(self):
+        for protocol in range(0, pickle.HIGHEST_PROTOCOL + 1):
+            for value in SIMPLE_VALUES + [bytearray(b"abc")]:
+                with self.subTest(protocol=protocol, value=value):
+                    result = self.round_trip(value, protocol)
+                    self.assertEqual(result, value)
+                    self.assertIs(type(result), type(value))
+
+    def test_round_trip_preserves_shared_references(self):
+        shared = [1, 2]
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip([shared, shared, (shared,)], protocol)
+            self.assertIs(result[0], result[1])
+            self.assertIs(result[0], result[2][0])
+
+    def test_round_trip_recursive_list(self):
+        value = [1]
+        value.append(value)
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip(value, protocol)
+            self.assertIs(result[1], result)
+
+    def test_round_trip_recursive_tuple(self):
+        inner = []
+        value = (inner,)
+        inner.append(value)
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip(value, protocol)
+            self.assertIs(result[0][0], result)
+
+    def test_round_trip_instances(self):
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip([Point(1, "a"), Reduced(3)], protocol)
+            self.assertEqual(result[0], Point(1, "a"))
+            self.assertIsInstance(result[1], Reduced)
+            self.assertEqual(result[1].value, 3)
+
+    def test_round_trip_calls_setstate(self):
+        value = WithState()
+        value.items.append(1)
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip(value, protocol)
+            self.assertEqual(result.items, [1])
+            self.assertEqual(result.extra, 42)
+            self.assertTrue(result.restored)
+
+    def test_round_trip_globals(self):
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            result = self.round_trip([Outer.Inner, module_function, len], protocol)
+            self.assertEqual(result, [Outer.Inner, module_function, len])
+
+    def test_round_trip_surrogates(self):
+        value = "a\udc80b"
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            self.assertEqual(self.round_trip(value, protocol), value)
+
+    def test_round_trip_extension_codes(self):
+        copyreg.add_extension(__name__, "Point", 0xABCD)
+        try:
+            for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+                data = _pickle.dumps(Point, protocol)
+                self.assertIn(b"\x83\xcd\xab", data)
+                self.assertIs(_pickle.loads(data), Point)
+        finally:
+            copyreg.remove_extension(__name__, "Point", 0xABCD)
+
+    def test_round_trip_with_out_of_band_buffers(self):
+        value = ZeroCopyBytearray(b"abc")
+        buffers = []
+        data = _pickle.dumps(value, 5, buffer_callback=buffers.append)
+        self.assertEqual(len(buffers), 1)
+        self.assertNotIn(b"abc", data)
+        result = _pickle.loads(data, buffers=buffers)
+        self.assertEqual(result, value)
+
+    def test_loads_out_of_band_buffer_without_buffers_raises_unpickling_error(self):
+        data = _pickle.dumps(
+            ZeroCopyBytearray(b"abc"), 5, buffer_callback=lambda buf: False
+        )
+        with self.assertRaises(pickle.UnpicklingError):
+            _pickle.loads(data)
+
+    def test_loads_pure_python_pickles(self):
+        value = {"a": [1, 2.5, (3, "x")], "b": {"c", 4}, "d": Point(1, 2)}
+        for protocol in range(0, pickle.HIGHEST_PROTOCOL + 1):
+            self.assertEqual(_pickle.loads(pickle._dumps(value, protocol)), value)
+
+
+class PicklerTests(unittest.TestCase):
+    def test_dump_writes_to_file(self):
+        f = io.BytesIO()
+        _pickle.Pickler(f, 4).dump([1, 2])
+        self.assertEqual(f.getvalue(), pickle._dumps([1, 2], 4))
+
+    def test_dump_without_write_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _pickle.Pickler(object())
+
+    def test_dump_reuses_memo_across_calls(self):
+        f = io.BytesIO()
+        pickler = _pickle.Pickler(f, 4)
+        value = ["shared"]
+        pickler.dump(value)
+        first_length = len(f.getvalue())
+        pickler.dump(value)
+        unpickler = _pickle.Unpickler(io.BytesIO(f.getvalue()))
+        first = unpickler.load()
+        self.assertIs(unpickler.load(), first)
+        self.assertLess(len(f.getvalue()) - first_length, first_length)
+
+    def test_clear_memo_forgets_previous_objects(self):
+        f = io.BytesIO()
+        pickler = _pickle.Pickler(f, 4)
+        value = ["shared"]
+        pickler.dump(value)
+        pickler.clear_memo()
+        pickler.dump(value)
+        unpickler = _pickle.Unpickler(io.BytesIO(f.getvalue()))
+        self.assertIsNot(unpickler.load(), unpickler.load())
+
+    def test_persistent_id_and_persistent_load(self):
+        class P(_pickle.Pickler):
+            def persistent_id(self, obj):
+                return f"id:{obj.value}" if isinstance(obj, Reduced) else None
+
+        class U(_pickle.Unpickler):
+            def persistent_load(self, pid):
+                return ("loaded", pid)
+
+        f = io.BytesIO()
+        P(f, 4).dump([1, Reduced(7)])
+        f.seek(0)
+        self.assertEqual(U(f).load(), [1, ("loaded", "id:7")])
+
+    def test_load_persistent_id_without_persistent_load_raises_unpickling_error(self):
+        class P(_pickle.Pickler):
+            def persistent_id(self, obj):
+                return "pid" if obj == 5 else None
+
+        f = io.BytesIO()
+        P(f, 4).dump([5])
+        with self.assertRaises(pickle.UnpicklingError):
+            _pickle.loads(f.getvalue())
+
+    def test_dispatch_table_overrides_reduce(self):
+        f = io.BytesIO()
+        pickler = _pickle.Pickler(f, 4)
+        pickler.dispatch_table = {Point: lambda p: (tuple, ((p.x, p.y),))}
+        pickler.dump(Point(1, 2))
+        self.assertEqual(_pickle.loads(f.getvalue()), (1, 2))
+
+    def test_reducer_override_is_called_for_instances(self):
+        class P(_pickle.Pickler):
+            def reducer_override(self, obj):
+                if isinstance(obj, Point):
+                    return str, ("point",)
+                return NotImplemented
+
+        f = io.BytesIO()
+        P(f, 4).dump([Point(1, 2), 3])
+        self.assertEqual(_pickle.loads(f.getvalue()), ["point", 3])
+
+    def test_dump_with_protocol_0_uses_memo_across_calls(self):
+        f = io.BytesIO()
+        pickler = _pickle.Pickler(f, 0)
+        value = ["shared"]
+        pickler.dump(value)
+        pickler.dump(value)
+        unpickler = _pickle.Unpickler(io.BytesIO(f.getvalue()))
+        self.assertIs(unpickler.load(), unpickler.load())
+
+
+class UnpicklerTests(unittest.TestCase):
+    def test_load_reads_consecutive_pickles_from_file(self):
+        f = io.BytesIO()
+        for protocol in range(0, pickle.HIGHEST_PROTOCOL + 1):
+            _pickle.dump(("value", protocol), f, protocol)
+        big = ["x" * 1000] * 100
+        _pickle.dump(big, f, 4)
+        f.write(b"trailing")
+        f.seek(0)
+        for protocol in range(0, pickle.HIGHEST_PROTOCOL + 1):
+            self.assertEqual(_pickle.load(f), ("value", protocol))
+        self.assertEqual(_pickle.load(f), big)
+        self.assertEqual(f.read(), b"trailing")
+
+    def test_load_from_empty_file_raises_eof_error(self):
+        with self.assertRaises(EOFError):
+            _pickle.load(io.BytesIO(b""))
+
+    def test_loads_with_str_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            _pickle.loads("\x80\x04N.")
+
+    def test_loads_bytearray_and_memoryview(self):
+        data = _pickle.dumps([1, 2], 4)
+        self.assertEqual(_pickle.loads(bytearray(data)), [1, 2])
+        self.assertEqual(_pickle.loads(memoryview(data)), [1, 2])
+
+    def test_loads_truncated_data_raises_error(self):
+        data = _pickle.dumps({"key": list(range(10))}, 4)
+        for end in range(2, len(data)):
+            with self.subTest(end=end):
+                with self.assertRaises((pickle.UnpicklingError, EOFError)):
+                    _pickle.loads(data[:end])
+
+    def test_loads_invalid_opcode_raises_unpickling_error(self):
+        with self.assertRaises(pickle.UnpicklingError):
+            _pickle.loads(b"\x80\x04\xff.")
+
+    def test_loads_unsupported_protocol_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            _pickle.loads(b"\x80\x06N.")
+
+    def test_loads_python2_string_with_encoding(self):
+        data = b"\x80\x02U\x03h\xe9y."
+        self.assertEqual(_pickle.loads(data, encoding="latin1"), "h\xe9y")
+        self.assertEqual(_pickle.loads(data, encoding="bytes"), b"h\xe9y")
+
+    def test_loads_protocol_2_maps_python2_names(self):
+        data = b"\x80\x02c__builtin__\nset\nq\x00."
+        self.assertIs(_pickle.loads(data), set)
+        with self.assertRaises((AttributeError, ImportError)):
+            _pickle.loads(data, fix_imports=False)
+
+    def test_find_class_can_be_overridden(self):
+        class U(_pickle.Unpickler):
+            def find_class(self, module, name):
+                return (module, name)
+
+        f = io.BytesIO(_pickle.dumps(Point, 4))
+        self.assertEqual(U(f).load(), (__name__, "Point"))
+
+
+if __name__ == "__main__":
+    unittest.main()
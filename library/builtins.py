@@ -150,6 +150,7 @@ from _builtins import (
     _list_getitem,
     _list_getslice,
     _list_guard,
+    _list_index,
     _list_len,
     _list_new,
     _list_setitem,
@@ -250,6 +251,7 @@ from _builtins import (
     _tuple_getitem,
     _tuple_getslice,
     _tuple_guard,
+    _tuple_index,
     _tuple_len,
     _tuple_new,
     _type,
@@ -1099,6 +1101,9 @@ class NotADirectoryError(OSError, bootstrap=True):
 
 
 class NotImplementedType(bootstrap=True):
+    def __reduce__(self):
+        return "NotImplemented"
+
     def __repr__(self):
         return "NotImplemented"
 
@@ -3614,6 +3619,9 @@ divmod = _divmod
 
 
 class ellipsis(bootstrap=True):
+    def __reduce__(self):
+        return "Ellipsis"
+
     def __repr__(self):
         return "Ellipsis"
 
@@ -5092,16 +5100,7 @@ class list(bootstrap=True):
         return list(self)
 
     def count(self, value):
-        _list_guard(self)
-        i = 0
-        length = _list_len(self)
-        result = 0
-        while i < length:
-            item = _list_getitem(self, i)
-            if item is value or item == value:
-                result += 1
-            i += 1
-        return result
+        _builtin()
 
     def extend(self, other):
         result = _list_extend(self, other)
@@ -5132,12 +5131,10 @@ class list(bootstrap=True):
             end += length
             if end < 0:
                 end = 0
-        while i < end:
-            item = _list_getitem(self, i)
-            if item is obj or item == obj:
-                return i
-            i += 1
-        raise ValueError(f"{repr(obj)} is not in list")
+        result = _list_index(self, obj, i, end)
+        if result < 0:
+            raise ValueError(f"{repr(obj)} is not in list")
+        return result
 
     def insert(self, index, value):
         _builtin()
@@ -5383,6 +5380,10 @@ class method(bootstrap=True):
             raise TypeError("self must not be None")
         return _bound_method(func, self)
 
+    def __reduce__(self):
+        _bound_method_guard(self)
+        return (getattr, (self.__self__, self.__func__.__name__))
+
 
 class memoryview(bootstrap=True):
     def __enter__(self):
@@ -6028,14 +6029,7 @@ class set(bootstrap=True):
         _builtin()
 
     def __or__(self, other):
-        _set_guard(self)
-        if not _anyset_check(other):
-            return NotImplemented
-        result = set_copy(self)
-        if self is other:
-            return result
-        set.update(result, other)
-        return result
+        _builtin()
 
     def __rand__(self, other):
         _unimplemented()
@@ -7000,16 +6994,7 @@ class tuple(bootstrap=True):
     __rmul__ = __mul__
 
     def count(self, value):
-        _tuple_guard(self)
-        i = 0
-        length = _tuple_len(self)
-        result = 0
-        while i < length:
-            item = _tuple_getitem(self, i)
-            if item is value or item == value:
-                result += 1
-            i += 1
-        return result
+        _builtin()
 
     def index(self, other, start=_Unbound, stop=_Unbound):
         _tuple_guard(self)
@@ -7022,13 +7007,10 @@ class tuple(bootstrap=True):
             stop = length
         else:
             stop = _slice_stop(_slice_index_not_none(stop), 1, length)
-        i = start
-        while i < stop:
-            item = _tuple_getitem(self, i)
-            if item is other or item == other:
-                return i
-            i += 1
-        raise ValueError("tuple.index(x): x not in tuple")
+        result = _tuple_index(self, other, start, stop)
+        if result < 0:
+            raise ValueError("tuple.index(x): x not in tuple")
+        return result
 
 
 class tuple_iterator(bootstrap=True):
@@ -259,9 +259,18 @@ class FloatTests(unittest.TestCase):
         with self.assertRaises(ValueError):
             float("1880.3a01")
 
+    def test_dunder_new_with_hex_str_raises_value_error(self):
+        with self.assertRaises(ValueError):
+            float("0x1p3")
+
     def test_dunder_new_with_str_returns_float(self):
         self.assertEqual(float("1.0"), 1.0)
 
+    def test_dunder_new_with_repr_str_returns_same_float(self):
+        for value in (0.1, 1 / 3, 1e23, 5e-324, 2.2250738585072014e-308):
+            self.assertEqual(float(repr(value)), value)
+            self.assertEqual(float(repr(-value)), -value)
+
     def test_dunder_new_with_huge_positive_str_returns_inf(self):
         self.assertEqual(float("1.18973e+4932"), float("inf"))
 
@@ -50,6 +50,24 @@ class IntTests(unittest.TestCase):
         self.assertEqual(int.__hash__(value), 2278332794247153219)
         self.assertEqual(int.__hash__(-value), -2278332794247153219)
 
+    def test_dunder_mul_with_huge_ints_matches_modular_product(self):
+        import random
+
+        rng = random.Random(0)
+        modulus = (1 << 61) - 1
+        for left_bits, right_bits in ((3000, 3000), (20000, 2600), (9000, 7000)):
+            left = rng.getrandbits(left_bits) | (1 << (left_bits - 1))
+            right = rng.getrandbits(right_bits) | (1 << (right_bits - 1))
+            for left_sign, right_sign in ((1, 1), (-1, 1), (1, -1), (-1, -1)):
+                a = left_sign * left
+                b = right_sign * right
+                product = a * b
+                self.assertEqual(product // b, a)
+                self.assertEqual(product % b, 0)
+                self.assertEqual(
+                    product % modulus, (a % modulus) * (b % modulus) % modulus
+                )
+
     def test_dunder_new_with_bool_class_raises_type_error(self):
         with self.assertRaisesRegex(
             TypeError, r"int\.__new__\(bool\) is not safe.*bool\.__new__\(\)"
@@ -206,6 +224,38 @@ class IntTests(unittest.TestCase):
         self.assertEqual(int.__new__(int, "-abc", 16), -0xABC)
         self.assertEqual(int.__new__(int, "0xabc", 0), 0xABC)
 
+    def test_dunder_new_with_long_str_returns_int(self):
+        import random
+
+        rng = random.Random(0)
+        for num_digits in (30, 700, 5000):
+            digits = "".join(rng.choice("0123456789abcdef") for _ in range(num_digits))
+            expected = int.from_bytes(bytes.fromhex(digits), "big")
+            self.assertEqual(int.__new__(int, digits, 16), expected)
+            self.assertEqual(int.__new__(int, "-" + digits, 16), -expected)
+            self.assertEqual(int.__new__(int, digits.encode(), 16), expected)
+            self.assertEqual(int.__new__(int, "1" + "0" * num_digits), 10 ** num_digits)
+            self.assertEqual(int.__new__(int, "1_" + "0" * num_digits), 10 ** num_digits)
+
+    def test_dunder_repr_with_huge_int_returns_str(self):
+        import random
+
+        def reference_repr(value):
+            chunks = []
+            while value >= 10 ** 19:
+                value, chunk = divmod(value, 10 ** 19)
+                chunks.append(f"{chunk:019}")
+            chunks.append(str(int.__int__(value)))
+            return "".join(reversed(chunks))
+
+        rng = random.Random(0)
+        for num_bits in (3000, 20000, 60000):
+            value = rng.getrandbits(num_bits)
+            self.assertEqual(int.__repr__(value), reference_repr(value))
+            self.assertEqual(int.__repr__(-value), "-" + reference_repr(value))
+        self.assertEqual(int.__repr__(10 ** 5000), "1" + "0" * 5000)
+        self.assertEqual(int.__repr__(10 ** 5000 - 1), "9" * 5000)
+
     def test_dunder_new_with_zero_args_returns_zero(self):
         self.assertIs(int.__new__(int), 0)
 
@@ -359,6 +359,18 @@ class ListTests(unittest.TestCase):
         self.assertEqual(n_list.count(n), 3)
         self.assertEqual(n_list.count(NeverEqual()), 0)
 
+    def test_count_with_dunder_eq_shrinking_list_stops_at_new_end(self):
+        ls = []
+
+        class ClearsList:
+            def __eq__(self, other):
+                ls.clear()
+                return True
+
+        ls.extend([ClearsList(), 1, 2])
+        self.assertEqual(ls.count(0), 1)
+        self.assertEqual(ls, [])
+
     def test_count_does_not_use_dunder_getitem_or_dunder_iter(self):
         class Foo(list):
             def __getitem__(self, idx):
@@ -727,6 +739,18 @@ class ListTests(unittest.TestCase):
             self.assertEqual(ls.index(4, 5), 4)
         self.assertEqual(str(context.exception), "4 is not in list")
 
+    def test_index_with_large_stop_searches_to_end(self):
+        ls = [1, 2, 3]
+        self.assertEqual(ls.index(3, 0, 1 << 100), 2)
+
+    def test_index_with_dunder_eq_raising_propagates_exception(self):
+        class RaisesOnEq:
+            def __eq__(self, other):
+                raise UserWarning("foo")
+
+        with self.assertRaises(UserWarning):
+            [RaisesOnEq()].index(1)
+
     def test_index_calls_dunder_eq(self):
         class AlwaysEqual:
             def __eq__(self, other):
@@ -1091,6 +1115,60 @@ class ListTests(unittest.TestCase):
         reversed_ls.sort()
         self.assertEqual(ls, reversed_ls)
 
+    def test_sort_with_floats(self):
+        ls = [2.5, -1.0, 3.25, 0.0, -7.5]
+        ls.sort()
+        self.assertEqual(ls, [-7.5, -1.0, 0.0, 2.5, 3.25])
+
+    def test_sort_with_mixed_int_and_float(self):
+        ls = [3, 2.5, 1, 0.5, 2]
+        ls.sort()
+        self.assertEqual(ls, [0.5, 1, 2, 2.5, 3])
+
+    def test_sort_with_partially_ordered_runs(self):
+        ls = list(range(500)) + list(range(1000, 499, -1)) + list(range(-10, 0))
+        expected = list(range(-10, 1001))
+        ls.sort()
+        self.assertEqual(ls, expected)
+
+    def test_sort_with_key_is_stable_over_many_duplicates(self):
+        ls = [(i % 7, i) for i in range(1000)]
+        result = sorted(ls, key=lambda item: item[0])
+        self.assertEqual(
+            result, [(key, i) for key in range(7) for i in range(key, 1000, 7)]
+        )
+
+    def test_sort_with_raising_dunder_lt_keeps_all_items(self):
+        class C:
+            def __init__(self, value):
+                self.value = value
+
+            def __lt__(self, other):
+                if self.value == 17 or other.value == 17:
+                    raise UserWarning("foo")
+                return self.value < other.value
+
+        ls = [C(i * 37 % 101) for i in range(101)]
+        items = set(ls)
+        with self.assertRaises(UserWarning):
+            ls.sort()
+        self.assertEqual(set(ls), items)
+        self.assertEqual(len(ls), 101)
+
+    def test_sort_with_list_modified_during_sort_raises_value_error(self):
+        class C:
+            def __init__(self, value):
+                self.value = value
+
+            def __lt__(self, other):
+                ls.append(self)
+                return self.value < other.value
+
+        ls = [C(i) for i in range(10, 0, -1)]
+        with self.assertRaisesRegex(ValueError, "list modified during sort"):
+            ls.sort()
+        self.assertEqual([item.value for item in ls], list(range(1, 11)))
+
     def test_sort_with_non_list_raises_type_error(self):
         self.assertRaisesRegex(
             TypeError,
@@ -2301,6 +2301,14 @@ class BoundMethodTests(unittest.TestCase):
         with self.assertRaises(AttributeError):
             f.__doc__ = "hey!"
 
+    def test_dunder_reduce_returns_getattr_of_self(self):
+        class Foo:
+            def foo(self):
+                pass
+
+        f = Foo()
+        self.assertEqual(f.foo.__reduce__(), (getattr, (f, "foo")))
+
     def test_getattribute_returns_function_attribute(self):
         class C:
             def meth(self):
@@ -4686,6 +4694,9 @@ class DunderBuildClassTests(unittest.TestCase):
 
 
 class EllipsisTypeTests(unittest.TestCase):
+    def test_dunder_reduce_returns_name(self):
+        self.assertEqual(Ellipsis.__reduce__(), "Ellipsis")
+
     def test_repr_returns_not_implemented(self):
         self.assertEqual(Ellipsis.__repr__(), "Ellipsis")
 
@@ -8711,6 +8722,9 @@ class NoneTests(unittest.TestCase):
 
 
 class NotImplementedTypeTests(unittest.TestCase):
+    def test_dunder_reduce_returns_name(self):
+        self.assertEqual(NotImplemented.__reduce__(), "NotImplemented")
+
     def test_repr_returns_not_implemented(self):
         self.assertEqual(NotImplemented.__repr__(), "NotImplemented")
 
@@ -10521,6 +10535,26 @@ class SetTests(unittest.TestCase):
             s.add(x)
         self.assertEqual(s, set(range(100)))
 
+    def test_copy_with_removed_colliding_item_keeps_other_items(self):
+        class CollidingKey:
+            def __init__(self, value):
+                self.value = value
+
+            def __hash__(self):
+                return 0
+
+            def __eq__(self, other):
+                return self.value == other.value
+
+        keys = [CollidingKey(i) for i in range(5)]
+        s = set(keys)
+        s.remove(keys[0])
+        result = s.copy()
+        self.assertEqual(len(result), 4)
+        for key in keys[1:]:
+            self.assertIn(key, result)
+        self.assertNotIn(keys[0], result)
+
     def test_copy_with_non_set_self_raises_type_error(self):
         self.assertRaisesRegex(
             TypeError,
@@ -10654,6 +10688,17 @@ class SetTests(unittest.TestCase):
             set(),
         )
 
+    def test_dunder_or_with_non_anyset_other_returns_notimplemented(self):
+        self.assertIs(set.__or__({1}, [2]), NotImplemented)
+
+    def test_dunder_or_returns_new_set_with_union(self):
+        a = {1, 2, 3}
+        b = frozenset({3, 4})
+        result = a | b
+        self.assertIs(type(result), set)
+        self.assertEqual(result, {1, 2, 3, 4})
+        self.assertEqual(a, {1, 2, 3})
+
     def test_dunder_xor_with_non_set_raises_type_error(self):
         self.assertRaisesRegex(
             TypeError,
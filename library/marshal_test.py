@@ -1329,6 +1329,30 @@ class DumpsTest(unittest.TestCase):
             marshal.dumps(instance, 2)
         self.assertIn("unmarshallable object", str(context.exception))
 
+    def test_dumps_with_int_subclass_version_uses_version(self):
+        class V(int):
+            pass
+
+        self.assertEqual(marshal.dumps([None], V(2)), b"[\x01\x00\x00\x00N")
+
+    def test_dumps_with_float_version_raises_type_error(self):
+        with self.assertRaises(TypeError):
+            marshal.dumps(None, 2.0)
+
+    def test_dumps_with_recursive_list_raises_value_error(self):
+        obj = []
+        obj.append(obj)
+        with self.assertRaises(ValueError) as context:
+            marshal.dumps(obj, 2)
+        self.assertIn("too deeply nested", str(context.exception))
+
+    def test_dumps_with_code_round_trips_through_loads(self):
+        code = compile("def f(x, *, y=2):\n    return [x, y, 1.5, 'z']", "<s>", "exec")
+        result = marshal.loads(marshal.dumps(code))
+        namespace = {}
+        exec(result, namespace)
+        self.assertEqual(namespace["f"](1), [1, 2, 1.5, "z"])
+
 
 if __name__ == "__main__":
     unittest.main()
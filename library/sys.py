@@ -189,6 +189,41 @@ _version = _VersionInfo(
 )
 
 
+def _bytecode_profile():
+    _builtin()
+
+
+def _bytecode_profile_disable():
+    _builtin()
+
+
+def _bytecode_profile_dump(file=None, limit=20):
+    """Writes a summary of the bytecode profile to `file` (default: stderr).
+    Meant to be called from a signal handler to inspect a running process."""
+    opcodes, sites, ic_sites = _bytecode_profile()
+    if file is None:
+        file = stderr
+    file.write("opcodes:\n")
+    for name, count in sorted(opcodes.items(), key=lambda x: -x[1])[:limit]:
+        file.write(f"  {count:12} {name}\n")
+    file.write("sites:\n")
+    for function, pc, name, count in sorted(sites, key=lambda x: -x[3])[:limit]:
+        file.write(f"  {count:12} {function.__qualname__}:{pc} {name}\n")
+    states = {}
+    for _function, _pc, _name, state in ic_sites:
+        states[state] = states.get(state, 0) + 1
+    file.write("inline caches:\n")
+    for state in ("anamorphic", "monomorphic", "polymorphic", "megamorphic"):
+        file.write(f"  {states.get(state, 0):12} {state}\n")
+    for function, pc, name, state in ic_sites:
+        if state == "megamorphic":
+            file.write(f"  {function.__qualname__}:{pc} {name}\n")
+
+
+def _bytecode_profile_enable():
+    _builtin()
+
+
 def _getframe(depth=0):
     _builtin()
 
@@ -188,6 +188,42 @@ class SysTests(unittest.TestCase):
         def __exit__(self, type, value, tb):
             return True
 
+    @pyro_only
+    def test_bytecode_profile_counts_function_sites(self):
+        class C:
+            def __init__(self, x):
+                self.x = x
+
+        def foo(objs):
+            result = 0
+            for obj in objs:
+                result += obj.x
+            return result
+
+        objs = [C(i) for i in range(10)]
+        sys._bytecode_profile_enable()
+        try:
+            foo(objs)
+        finally:
+            sys._bytecode_profile_disable()
+        opcodes, sites, ic_sites = sys._bytecode_profile()
+        self.assertGreater(sum(opcodes.values()), 0)
+        foo_sites = [site for site in sites if site[0] is foo]
+        self.assertTrue(foo_sites)
+        self.assertIn(max(count for _, _, _, count in foo_sites), (10, 11))
+        foo_ic_states = [site[3] for site in ic_sites if site[0] is foo]
+        self.assertIn("monomorphic", foo_ic_states)
+
+    @pyro_only
+    def test_bytecode_profile_dump_writes_summary(self):
+        sys._bytecode_profile_enable()
+        sys._bytecode_profile_disable()
+        file = StringIO()
+        sys._bytecode_profile_dump(file)
+        output = file.getvalue()
+        self.assertIn("opcodes:", output)
+        self.assertIn("inline caches:", output)
+
     def test_excepthook_initial_value(self):
         self.assertIs(sys.excepthook, sys.__excepthook__)
 
@@ -33,6 +33,8 @@ _os.py
 _parser_test.py
 _path.py
 _path_test.py
+_pickle.py
+_pickle_test.py
 _profiler.py
 _profiler_test.py
 _signal.py
@@ -104,7 +104,7 @@ inline word internedStrHash(RawObject name) {
   if (name.isImmediateObjectNotSmallInt()) {
     return SmallStr::cast(name).hash();
   }
-  word hash = LargeStr::cast(name).header().hashCode();
+  word hash = LargeStr::cast(name).hashCode();
   DCHECK(hash != Header::kUninitializedHash,
          "hash has not been computed (string not interned?)");
   return hash;
@@ -371,7 +371,6 @@ void rewriteBytecode(Thread* thread, const Function& function) {
     }
     return;
   }
-  word cache = num_global_caches;
   RawObject module = function.moduleObject();
   bool is_builtin_module = module.isModule() && Module::cast(module).isBuiltin();
 
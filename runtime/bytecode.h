@@ -30,12 +30,12 @@ namespace py {
   V(UNARY_POSITIVE, 10, doUnaryPositive)                                       \
   V(UNARY_NEGATIVE, 11, doUnaryNegative)                                       \
   V(UNARY_NOT, 12, doUnaryNot)                                                 \
-  V(UNUSED_BYTECODE_13, 13, doInvalidBytecode)                                 \
-  V(UNUSED_BYTECODE_14, 14, doInvalidBytecode)                                 \
+  V(LOAD_FAST_STR, 13, doLoadFastStr)                                          \
+  V(LOAD_FAST_STR_BUILDER, 14, doLoadFast)                                     \
   V(UNARY_INVERT, 15, doUnaryInvert)                                           \
   V(BINARY_MATRIX_MULTIPLY, 16, doBinaryMatrixMultiply)                        \
   V(INPLACE_MATRIX_MULTIPLY, 17, doInplaceMatrixMultiply)                      \
-  V(UNUSED_BYTECODE_18, 18, doInvalidBytecode)                                 \
+  V(INPLACE_ADD_STR_BUILDER, 18, doInplaceAddStrBuilder)                       \
   V(BINARY_POWER, 19, doBinaryPower)                                           \
   V(BINARY_MULTIPLY, 20, doBinaryMultiply)                                     \
   V(UNUSED_BYTECODE_21, 21, doInvalidBytecode)                                 \
@@ -31,6 +31,16 @@ RawObject bytesDecodeASCII(Thread* thread, const Bytes& bytes) {
   return buf.becomeStr();
 }
 
+// Returns a pointer to the bytes of `bytes`. Small bytes are copied into
+// `buffer`, which must hold at least `SmallBytes::kMaxLength` bytes.
+static const byte* bytesData(const Bytes& bytes, word length, byte* buffer) {
+  if (bytes.isSmallBytes()) {
+    bytes.copyTo(buffer, length);
+    return buffer;
+  }
+  return reinterpret_cast<const byte*>(HeapObject::cast(*bytes).address());
+}
+
 word bytesCount(const Bytes& haystack, word haystack_len, const Bytes& needle,
                 word needle_len, word start, word end) {
   DCHECK_BOUND(haystack_len, haystack.length());
@@ -40,7 +50,7 @@ word bytesCount(const Bytes& haystack, word haystack_len, const Bytes& needle,
   }
   Slice::adjustSearchIndices(&start, &end, haystack_len);
   if (needle_len == 0) {
-    return haystack_len - start + 1;
+    return start > end ? 0 : end - start + 1;
   }
   word count = 0;
   word index =
@@ -58,16 +68,20 @@ word bytesFind(const Bytes& haystack, word haystack_len, const Bytes& needle,
   DCHECK_BOUND(haystack_len, haystack.length());
   DCHECK_BOUND(needle_len, needle.length());
   Slice::adjustSearchIndices(&start, &end, haystack_len);
-  for (word i = start; i <= end - needle_len; i++) {
-    bool has_match = true;
-    for (word j = 0; has_match && j < needle_len; j++) {
-      has_match = haystack.byteAt(i + j) == needle.byteAt(j);
-    }
-    if (has_match) {
-      return i;
-    }
+  if (end - start < needle_len) {
+    return -1;
   }
-  return -1;
+  if (needle_len == 0) {
+    return start;
+  }
+  byte haystack_buffer[SmallBytes::kMaxLength];
+  byte needle_buffer[SmallBytes::kMaxLength];
+  const byte* haystack_data =
+      bytesData(haystack, haystack_len, haystack_buffer);
+  const byte* needle_data = bytesData(needle, needle_len, needle_buffer);
+  word result = Utils::memoryFind(haystack_data + start, end - start,
+                                  needle_data, needle_len);
+  return result == -1 ? -1 : start + result;
 }
 
 RawObject bytesHex(Thread* thread, const Bytes& bytes, word length) {
@@ -161,16 +175,20 @@ word bytesRFind(const Bytes& haystack, word haystack_len, const Bytes& needle,
   DCHECK_BOUND(haystack_len, haystack.length());
   DCHECK_BOUND(needle_len, needle.length());
   Slice::adjustSearchIndices(&start, &end, haystack_len);
-  for (word i = end - needle_len; i >= start; i--) {
-    bool has_match = true;
-    for (word j = 0; has_match && j < needle_len; j++) {
-      has_match = haystack.byteAt(i + j) == needle.byteAt(j);
-    }
-    if (has_match) {
-      return i;
-    }
+  if (end - start < needle_len) {
+    return -1;
   }
-  return -1;
+  if (needle_len == 0) {
+    return end;
+  }
+  byte haystack_buffer[SmallBytes::kMaxLength];
+  byte needle_buffer[SmallBytes::kMaxLength];
+  const byte* haystack_data =
+      bytesData(haystack, haystack_len, haystack_buffer);
+  const byte* needle_data = bytesData(needle, needle_len, needle_buffer);
+  word result = Utils::memoryFindReverse(haystack_data + start, end - start,
+                                         needle_data, needle_len);
+  return result == -1 ? -1 : start + result;
 }
 
 RawObject bytesReprSingleQuotes(Thread* thread, const Bytes& bytes) {
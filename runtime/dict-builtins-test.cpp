@@ -1,6 +1,7 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "dict-builtins.h"
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "builtins-module.h"
@@ -205,7 +206,7 @@ TEST_F(DictBuiltinsTest, DictAtPutGrowsDictWhenTwoThirdsUsed) {
   ASSERT_TRUE(dictAtPut(thread_, dict, last_key, last_key_hash, last_value)
                   .isNoneType());
   EXPECT_EQ(dict.numItems(), threshold + 1);
-  // 2 == kDictGrowthFactor.
+  // The new size is the next power of two above 3 * numItems().
   EXPECT_EQ(dict.numIndices(), initial_capacity * 2);
   EXPECT_EQ(dict.firstEmptyItemIndex() / kItemNumPointers, threshold + 1);
 
@@ -219,6 +220,365 @@ TEST_F(DictBuiltinsTest, DictAtPutGrowsDictWhenTwoThirdsUsed) {
   }
 }
 
+TEST_F(DictBuiltinsTest, DictAtPutWidensIndicesAsDictGrows) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  word num_items = 40000;
+  for (word i = 0; i < num_items; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    Object value(&scope, SmallInt::fromWord(-i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, hash, value).isNoneType());
+    word num_indices = dict.numIndices();
+    word length = MutableBytes::cast(dict.indices()).length();
+    if (num_indices <= 128) {
+      ASSERT_EQ(length, num_indices);
+    } else if (num_indices <= 32768) {
+      ASSERT_EQ(length, num_indices * 2);
+    } else {
+      ASSERT_EQ(length, num_indices * 4);
+    }
+  }
+  EXPECT_EQ(dict.numItems(), num_items);
+  EXPECT_EQ(dict.numIndices(), 65536);
+
+  for (word i = 0; i < num_items; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    RawObject value = dictAt(thread_, dict, key, hash);
+    ASSERT_FALSE(value.isError());
+    EXPECT_TRUE(isIntEqualsWord(value, -i));
+  }
+}
+
+TEST_F(DictBuiltinsTest, DictRemoveFromWideIndicesLeavesOtherKeys) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  word num_items = 300;
+  for (word i = 0; i < num_items; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    Object value(&scope, SmallInt::fromWord(-i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, hash, value).isNoneType());
+  }
+  ASSERT_EQ(MutableBytes::cast(dict.indices()).length(),
+            dict.numIndices() * 2);
+  for (word i = 0; i < num_items; i += 2) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    EXPECT_TRUE(isIntEqualsWord(dictRemove(thread_, dict, key, hash), -i));
+  }
+  EXPECT_EQ(dict.numItems(), num_items / 2);
+  for (word i = 0; i < num_items; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    RawObject value = dictAt(thread_, dict, key, hash);
+    if (i % 2 == 0) {
+      EXPECT_TRUE(value.isErrorNotFound());
+    } else {
+      EXPECT_TRUE(isIntEqualsWord(value, -i));
+    }
+  }
+}
+
+TEST_F(DictBuiltinsTest, DictAtPutWithDeletedItemsDoesNotGrowDict) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  Object value(&scope, NoneType::object());
+  for (word i = 0; i < 1000; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, hash, value).isNoneType());
+    if (i > 0) {
+      Object prev_key(&scope, SmallInt::fromWord(i - 1));
+      word prev_hash = intHash(*prev_key);
+      ASSERT_FALSE(dictRemove(thread_, dict, prev_key, prev_hash).isError());
+    }
+  }
+  EXPECT_EQ(dict.numItems(), 1);
+  EXPECT_EQ(dict.numIndices(), kInitialDictIndicesLength);
+}
+
+TEST_F(DictBuiltinsTest, NewDictWithSizeFitsItemsWithoutGrowing) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDictWithSize(10));
+  word num_indices = dict.numIndices();
+  EXPECT_EQ(num_indices, 32);
+  for (word i = 0; i < 10; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    word hash = intHash(*key);
+    Object value(&scope, SmallInt::fromWord(i));
+    ASSERT_TRUE(dictAtPut(thread_, dict, key, hash, value).isNoneType());
+  }
+  EXPECT_EQ(dict.numIndices(), num_indices);
+}
+
+TEST_F(DictBuiltinsTest, DictMergeOverrideIntoEmptyDictCopiesTables) {
+  HandleScope scope(thread_);
+  Dict other(&scope, runtime_->newDict());
+  for (word i = 0; i < 10; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    Object value(&scope, SmallInt::fromWord(-i));
+    ASSERT_TRUE(
+        dictAtPut(thread_, other, key, intHash(*key), value).isNoneType());
+  }
+  Dict dict(&scope, runtime_->newDict());
+  ASSERT_TRUE(dictMergeOverride(thread_, dict, other).isNoneType());
+  EXPECT_EQ(dict.numItems(), 10);
+  EXPECT_EQ(dict.numIndices(), other.numIndices());
+  EXPECT_NE(dict.indices(), other.indices());
+  EXPECT_NE(dict.data(), other.data());
+
+  Object key(&scope, SmallInt::fromWord(10));
+  Object value(&scope, SmallInt::fromWord(-10));
+  ASSERT_TRUE(dictAtPut(thread_, dict, key, intHash(*key), value).isNoneType());
+  EXPECT_TRUE(dictAt(thread_, other, key, intHash(*key)).isErrorNotFound());
+  for (word i = 0; i <= 10; i++) {
+    key = SmallInt::fromWord(i);
+    EXPECT_TRUE(isIntEqualsWord(dictAt(thread_, dict, key, intHash(*key)), -i));
+  }
+}
+
+TEST_F(DictBuiltinsTest, DictMergeOverrideIntoEmptyDictDropsDeletedItems) {
+  HandleScope scope(thread_);
+  Dict other(&scope, runtime_->newDict());
+  for (word i = 0; i < 10; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    Object value(&scope, SmallInt::fromWord(-i));
+    ASSERT_TRUE(
+        dictAtPut(thread_, other, key, intHash(*key), value).isNoneType());
+  }
+  Object key(&scope, SmallInt::fromWord(3));
+  ASSERT_FALSE(dictRemove(thread_, other, key, intHash(*key)).isError());
+
+  Dict dict(&scope, runtime_->newDict());
+  ASSERT_TRUE(dictMergeOverride(thread_, dict, other).isNoneType());
+  EXPECT_EQ(dict.numItems(), 9);
+  EXPECT_EQ(dict.firstEmptyItemIndex(), 9 * 3);
+  for (word i = 0; i < 10; i++) {
+    key = SmallInt::fromWord(i);
+    RawObject value = dictAt(thread_, dict, key, intHash(*key));
+    if (i == 3) {
+      EXPECT_TRUE(value.isErrorNotFound());
+    } else {
+      EXPECT_TRUE(isIntEqualsWord(value, -i));
+    }
+  }
+}
+
+TEST_F(DictBuiltinsTest, DictMergeOverrideIntoNonEmptyDictOverridesValues) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  Dict other(&scope, runtime_->newDict());
+  for (word i = 0; i < 100; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    Object value(&scope, SmallInt::fromWord(-i));
+    if (i % 10 == 0) {
+      ASSERT_TRUE(
+          dictAtPut(thread_, dict, key, intHash(*key), key).isNoneType());
+    }
+    ASSERT_TRUE(
+        dictAtPut(thread_, other, key, intHash(*key), value).isNoneType());
+  }
+  ASSERT_TRUE(dictMergeOverride(thread_, dict, other).isNoneType());
+  EXPECT_EQ(dict.numItems(), 100);
+  for (word i = 0; i < 100; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    EXPECT_TRUE(isIntEqualsWord(dictAt(thread_, dict, key, intHash(*key)), -i));
+  }
+}
+
+TEST_F(DictBuiltinsTest, DictShareKeysKeepsItems) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  for (word i = 0; i < 10; i++) {
+    Object key(&scope, SmallInt::fromWord(i));
+    Object value(&scope, SmallInt::fromWord(-i));
+    ASSERT_TRUE(
+        dictAtPut(thread_, dict, key, intHash(*key), value).isNoneType());
+  }
+  Object key(&scope, SmallInt::fromWord(3));
+  ASSERT_FALSE(dictRemove(thread_, dict, key, intHash(*key)).isError());
+
+  Object keys(&scope, dictShareKeys(thread_, dict));
+  ASSERT_TRUE(keys.isTuple());
+  EXPECT_TRUE(dictHasSharedKeys(dict));
+  EXPECT_EQ(dict.indices(), *keys);
+  EXPECT_EQ(dictShareKeys(thread_, dict), *keys);
+  EXPECT_EQ(dict.numItems(), 9);
+  for (word i = 0; i < 10; i++) {
+    key = SmallInt::fromWord(i);
+    RawObject value = dictAt(thread_, dict, key, intHash(*key));
+    if (i == 3) {
+      EXPECT_TRUE(value.isErrorNotFound());
+    } else {
+      EXPECT_TRUE(isIntEqualsWord(value, -i));
+    }
+  }
+  Object value(&scope, NoneType::object());
+  word expected = 0;
+  for (word i = 0; dictNextItem(dict, &i, &key, &value); expected++) {
+    if (expected == 3) expected++;
+    EXPECT_TRUE(isIntEqualsWord(*key, expected));
+    EXPECT_TRUE(isIntEqualsWord(*value, -expected));
+  }
+  EXPECT_EQ(expected, 10);
+}
+
+TEST_F(DictBuiltinsTest, DictShareKeysWithEmptyDictReturnsNotFound) {
+  HandleScope scope(thread_);
+  Dict dict(&scope, runtime_->newDict());
+  EXPECT_TRUE(dictShareKeys(thread_, dict).isErrorNotFound());
+  EXPECT_FALSE(dictHasSharedKeys(dict));
+}
+
+TEST_F(DictBuiltinsTest, DictUseSharedKeysStoresOnlyValues) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+template = {"a": 1, "b": 2, "c": 3}
+)")
+                   .isError());
+  Dict template_dict(&scope, mainModuleAt(runtime_, "template"));
+  Object keys(&scope, dictShareKeys(thread_, template_dict));
+  ASSERT_TRUE(keys.isTuple());
+
+  Dict dict(&scope, runtime_->newDict());
+  dictUseSharedKeys(thread_, dict, keys);
+  Object a(&scope, runtime_->newStrFromCStr("a"));
+  Object b(&scope, runtime_->newStrFromCStr("b"));
+  Object c(&scope, runtime_->newStrFromCStr("c"));
+  Object value(&scope, SmallInt::fromWord(10));
+  dictAtPutByStr(thread_, dict, a, value);
+  value = SmallInt::fromWord(20);
+  dictAtPutByStr(thread_, dict, b, value);
+  EXPECT_TRUE(dictHasSharedKeys(dict));
+  EXPECT_EQ(dict.indices(), *keys);
+  EXPECT_EQ(dict.numItems(), 2);
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, a), 10));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, b), 20));
+  EXPECT_TRUE(dictAtByStr(thread_, dict, c).isErrorNotFound());
+  EXPECT_EQ(dictIncludes(thread_, dict, c, strHash(thread_, *c)),
+            Bool::falseObj());
+
+  // Updating a key keeps sharing the keys.
+  value = SmallInt::fromWord(11);
+  dictAtPutByStr(thread_, dict, a, value);
+  EXPECT_TRUE(dictHasSharedKeys(dict));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, a), 11));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, template_dict, a), 1));
+
+  Dict copy(&scope, dictCopy(thread_, dict));
+  EXPECT_TRUE(dictHasSharedKeys(copy));
+  EXPECT_EQ(copy.indices(), *keys);
+  EXPECT_EQ(copy.numItems(), 2);
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, copy, b), 20));
+}
+
+TEST_F(DictBuiltinsTest, DictSharedKeysAppendStoresValueForNextKey) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+template = {"a": 1, "b": 2}
+)")
+                   .isError());
+  Dict template_dict(&scope, mainModuleAt(runtime_, "template"));
+  Object keys(&scope, dictShareKeys(thread_, template_dict));
+  EXPECT_TRUE(isStrEqualsCStr(dictSharedKeysAt(keys, 0), "a"));
+  EXPECT_TRUE(isStrEqualsCStr(dictSharedKeysAt(keys, 1), "b"));
+  EXPECT_TRUE(dictSharedKeysAt(keys, 2).isErrorNotFound());
+
+  Dict dict(&scope, runtime_->newDict());
+  dictUseSharedKeys(thread_, dict, keys);
+  Object value(&scope, SmallInt::fromWord(10));
+  dictSharedKeysAppend(dict, value);
+  value = SmallInt::fromWord(20);
+  dictSharedKeysAppend(dict, value);
+  EXPECT_TRUE(dictHasSharedKeys(dict));
+  EXPECT_EQ(dict.numItems(), 2);
+  Object a(&scope, runtime_->newStrFromCStr("a"));
+  Object b(&scope, runtime_->newStrFromCStr("b"));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, a), 10));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, b), 20));
+
+  // Appended values behave like inserted ones.
+  Object c(&scope, runtime_->newStrFromCStr("c"));
+  value = SmallInt::fromWord(30);
+  dictAtPutByStr(thread_, dict, c, value);
+  EXPECT_FALSE(dictHasSharedKeys(dict));
+  EXPECT_EQ(dict.numItems(), 3);
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, b), 20));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, c), 30));
+}
+
+TEST_F(DictBuiltinsTest, DictAtPutWithDivergentKeyUnsharesKeys) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+template = {"a": 1, "b": 2, "c": 3}
+)")
+                   .isError());
+  Dict template_dict(&scope, mainModuleAt(runtime_, "template"));
+  Object keys(&scope, dictShareKeys(thread_, template_dict));
+
+  Dict dict(&scope, runtime_->newDict());
+  dictUseSharedKeys(thread_, dict, keys);
+  Object a(&scope, runtime_->newStrFromCStr("a"));
+  Object c(&scope, runtime_->newStrFromCStr("c"));
+  Object value(&scope, SmallInt::fromWord(10));
+  dictAtPutByStr(thread_, dict, a, value);
+  value = SmallInt::fromWord(30);
+  dictAtPutByStr(thread_, dict, c, value);
+  EXPECT_FALSE(dictHasSharedKeys(dict));
+  EXPECT_TRUE(dictHasSharedKeys(template_dict));
+  EXPECT_EQ(dict.numItems(), 2);
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, a), 10));
+  EXPECT_TRUE(isIntEqualsWord(dictAtByStr(thread_, dict, c), 30));
+  Object key(&scope, NoneType::object());
+  word i = 0;
+  ASSERT_TRUE(dictNextKey(dict, &i, &key));
+  EXPECT_TRUE(isStrEqualsCStr(*key, "a"));
+  ASSERT_TRUE(dictNextKey(dict, &i, &key));
+  EXPECT_TRUE(isStrEqualsCStr(*key, "c"));
+  EXPECT_FALSE(dictNextKey(dict, &i, &key));
+}
+
+TEST_F(DictBuiltinsTest, DictRemoveWithSharedKeysUnsharesKeys) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+d = {"a": 1, "b": 2, "c": 3}
+)")
+                   .isError());
+  Dict dict(&scope, mainModuleAt(runtime_, "d"));
+  ASSERT_TRUE(dictShareKeys(thread_, dict).isTuple());
+  Object b(&scope, runtime_->newStrFromCStr("b"));
+  EXPECT_TRUE(isIntEqualsWord(dictRemoveByStr(thread_, dict, b), 2));
+  EXPECT_FALSE(dictHasSharedKeys(dict));
+  EXPECT_EQ(dict.numItems(), 2);
+  EXPECT_TRUE(dictAtByStr(thread_, dict, b).isErrorNotFound());
+}
+
+TEST_F(DictBuiltinsTest, PopitemWithSharedKeysKeepsSharingKeys) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+d = {"a": 1, "b": 2, "c": 3}
+)")
+                   .isError());
+  Dict dict(&scope, mainModuleAt(runtime_, "d"));
+  ASSERT_TRUE(dictShareKeys(thread_, dict).isTuple());
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+last = d.popitem()
+d["c"] = 4
+result = list(d.items())
+)")
+                   .isError());
+  EXPECT_TRUE(dictHasSharedKeys(dict));
+  Object last(&scope, mainModuleAt(runtime_, "last"));
+  ASSERT_TRUE(last.isTuple());
+  EXPECT_TRUE(isStrEqualsCStr(Tuple::cast(*last).at(0), "c"));
+  EXPECT_TRUE(isIntEqualsWord(Tuple::cast(*last).at(1), 3));
+  Object result(&scope, mainModuleAt(runtime_, "result"));
+  ASSERT_TRUE(result.isList());
+  EXPECT_EQ(List::cast(*result).numItems(), 3);
+}
+
 TEST_F(DictBuiltinsTest, CollidingKeys) {
   HandleScope scope(thread_);
   ASSERT_FALSE(runFromCStr(runtime_, R"(
@@ -1067,5 +1427,36 @@ TEST_F(DictBuiltinsTest, NumAttributesMatchesObjectSize) {
             (RawDict::kSize - RawHeapObject::kSize) / kPointerSize);
 }
 
+using DictBenchmark = RuntimeBenchmarkFixture;
+
+static RawObject dictFromRange(Thread* thread, word start, word stop) {
+  HandleScope scope(thread);
+  Dict dict(&scope, thread->runtime()->newDict());
+  Object key(&scope, NoneType::object());
+  for (word i = start; i < stop; i++) {
+    key = SmallInt::fromWord(i);
+    dictAtPut(thread, dict, key, intHash(*key), key);
+  }
+  return *dict;
+}
+
+BENCHMARK_F(DictBenchmark, UpdateEmptyDict)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Dict other(&scope, dictFromRange(thread_, 0, 1000));
+  for (auto _ : state) {
+    Dict dict(&scope, runtime_->newDict());
+    benchmark::DoNotOptimize(dictMergeOverride(thread_, dict, other));
+  }
+}
+
+BENCHMARK_F(DictBenchmark, UpdateNonEmptyDict)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Dict other(&scope, dictFromRange(thread_, 0, 1000));
+  for (auto _ : state) {
+    Dict dict(&scope, dictFromRange(thread_, -4, 0));
+    benchmark::DoNotOptimize(dictMergeOverride(thread_, dict, other));
+  }
+}
+
 }  // namespace testing
 }  // namespace py
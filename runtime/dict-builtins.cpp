@@ -17,10 +17,12 @@ namespace py {
 
 namespace {
 
-// Helper functions for accessing sparse array from dict.indices().
-static const uint32_t kTombstoneValue = 0xFFFFFFFE;
-static const uint32_t kEmptyValue = 0xFFFFFFFF;
-static const word kNumBytesExponent = 2;
+// Helper functions for accessing sparse array from dict.indices(). Entries are
+// 1, 2, 4 or 8 bytes wide depending on the number of indices (see
+// RawDict::numIndices); the two largest values of each width mark tombstones
+// and empty entries, which read back as the negative values below.
+static const word kTombstoneValue = -2;
+static const word kEmptyValue = -1;
 
 static word probeBegin(word num_indices, word hash, word* indices_mask,
                        uword* perturb) {
@@ -43,37 +45,79 @@ static word probeNext(word current, word indices_mask, uword* perturb) {
   return (current * 5 + 1 + *perturb) & indices_mask;
 }
 
-// Returns the bytes offset into the indices array given an index
-static word indexOffset(word index) { return index << kNumBytesExponent; }
-
-// Return the item index stored at indices[bytes_offset].
-static uint32_t itemIndexAt(RawMutableBytes indices, word bytes_offset) {
-  DCHECK(bytes_offset % 4 == 0, "bytes_offset must be a multiple of 4");
-  return indices.uint32At(bytes_offset);
-}
-
-// Set `item_index` at indices[bytes_offset].
-static void itemIndexAtPut(RawMutableBytes indices, word bytes_offset,
-                           uint32_t item_index) {
-  indices.uint32AtPut(bytes_offset, item_index);
-}
-
-// Set a tombstone at indices[bytes_offset] given `data_length` from
-// data.length().
-static void indicesSetTombstone(RawMutableBytes indices, word bytes_offset) {
-  itemIndexAtPut(indices, bytes_offset, kTombstoneValue);
-}
-
-// Return true if the indices[bytes_offset] is filled with an active item.
-static bool indicesIsFull(RawMutableBytes indices, word bytes_offset,
-                          uint32_t* item_index) {
-  *item_index = itemIndexAt(indices, bytes_offset);
-  return *item_index < kTombstoneValue;
-}
-
-// Return true if the indices[bytes_offset] is never used.
-static bool indicesIsEmpty(RawMutableBytes indices, word bytes_offset) {
-  return itemIndexAt(indices, bytes_offset) == kEmptyValue;
+// Returns the log2 of the entry width of indices with `num_indices` entries.
+static word indicesWidthLog2(word num_indices) {
+  if (num_indices <= RawDict::kMaxNumIndicesWidth1) return 0;
+  if (num_indices <= RawDict::kMaxNumIndicesWidth2) return 1;
+  if (num_indices <= RawDict::kMaxNumIndicesWidth4) return 2;
+  return 3;
+}
+
+// Returns the length in bytes of indices with `num_indices` entries.
+static word indicesLength(word num_indices) {
+  return num_indices << indicesWidthLog2(num_indices);
+}
+
+// Return the item index stored at indices[index], or kTombstoneValue or
+// kEmptyValue.
+static word itemIndexAt(RawMutableBytes indices, word width_log2, word index) {
+  uword value;
+  switch (width_log2) {
+    case 0:
+      value = indices.byteAt(index);
+      break;
+    case 1:
+      value = indices.uint16At(index << 1);
+      break;
+    case 2:
+      value = indices.uint32At(index << 2);
+      break;
+    default:
+      value = indices.uint64At(index << 3);
+      break;
+  }
+  uword empty = ~uword{0} >> (kBitsPerWord - (kBitsPerByte << width_log2));
+  if (value < empty - 1) return value;
+  return static_cast<word>(value - empty) + kEmptyValue;
+}
+
+// Set `item_index` at indices[index].
+static void itemIndexAtPut(RawMutableBytes indices, word width_log2,
+                           word index, word item_index) {
+  // Truncation maps kTombstoneValue and kEmptyValue to the reserved values.
+  switch (width_log2) {
+    case 0:
+      indices.byteAtPut(index, static_cast<byte>(item_index));
+      break;
+    case 1:
+      indices.uint16AtPut(index << 1, static_cast<uint16_t>(item_index));
+      break;
+    case 2:
+      indices.uint32AtPut(index << 2, static_cast<uint32_t>(item_index));
+      break;
+    default:
+      indices.uint64AtPut(index << 3, static_cast<uint64_t>(item_index));
+      break;
+  }
+}
+
+// Set a tombstone at indices[index].
+static void indicesSetTombstone(RawMutableBytes indices, word width_log2,
+                                word index) {
+  itemIndexAtPut(indices, width_log2, index, kTombstoneValue);
+}
+
+// Return true if the indices[index] is filled with an active item.
+static bool indicesIsFull(RawMutableBytes indices, word width_log2, word index,
+                          word* item_index) {
+  *item_index = itemIndexAt(indices, width_log2, index);
+  return *item_index >= 0;
+}
+
+// Return true if the indices[index] is never used.
+static bool indicesIsEmpty(RawMutableBytes indices, word width_log2,
+                           word index) {
+  return itemIndexAt(indices, width_log2, index) == kEmptyValue;
 }
 
 // Helper functions for accessing dict items from dict.data().
@@ -129,10 +173,75 @@ static bool itemIsTombstone(RawMutableTuple data, word index) {
   return data.at(index + kItemHashOffset).isUnbound();
 }
 
+// Helper functions for dicts sharing their keys (see dictShareKeys()). The
+// shared keys table is an immutable tuple holding the indices followed by a
+// hash and a key for each item; the indices store the item number. The dict
+// keeps the table in dict.indices() and only its values in dict.data(), one
+// per key of the table. It holds values for the first numItems() keys.
+
+// Shared keys table layout.
+static const word kSharedKeysIndicesOffset = 0;
+static const word kSharedKeysItemsOffset = 1;
+static const word kSharedKeysItemNumPointers = 2;
+
+static word sharedKeysNumItems(RawTuple keys) {
+  return (keys.length() - kSharedKeysItemsOffset) / kSharedKeysItemNumPointers;
+}
+
+static RawObject sharedKeysKey(RawTuple keys, word item) {
+  return keys.at(kSharedKeysItemsOffset + item * kSharedKeysItemNumPointers +
+                 1);
+}
+
+static RawObject sharedKeysHashRaw(RawTuple keys, word item) {
+  return keys.at(kSharedKeysItemsOffset + item * kSharedKeysItemNumPointers);
+}
+
+static word sharedKeysHash(RawTuple keys, word item) {
+  return SmallInt::cast(sharedKeysHashRaw(keys, item)).value();
+}
+
 }  // namespace
 
+bool dictHasSharedKeys(const Dict& dict) { return dict.indices().isTuple(); }
+
+// Returns one of the three possible values:
+// - `key` is the `n`th key of the shared keys table: SmallInt::fromWord(n)
+// - `key` was not found : SmallInt::fromWord(-1)
+// - Exception that was raised from key comparison __eq__ function.
+static RawObject sharedKeysLookup(Thread* thread, const Tuple& keys,
+                                  word num_indices, const Object& key,
+                                  word hash) {
+  RawMutableBytes indices =
+      MutableBytes::cast(keys.at(kSharedKeysIndicesOffset));
+  uword perturb;
+  word indices_mask;
+  word width_log2 = indicesWidthLog2(num_indices);
+  RawSmallInt hash_int = SmallInt::fromWord(hash);
+  for (word current_index =
+           probeBegin(num_indices, hash, &indices_mask, &perturb);
+       ; current_index = probeNext(current_index, indices_mask, &perturb)) {
+    word item = itemIndexAt(indices, width_log2, current_index);
+    if (item == kEmptyValue) {
+      return SmallInt::fromWord(-1);
+    }
+    if (sharedKeysHashRaw(*keys, item) == hash_int) {
+      RawObject eq =
+          Runtime::objectEquals(thread, sharedKeysKey(*keys, item), *key);
+      if (eq == Bool::trueObj()) {
+        return SmallInt::fromWord(item);
+      }
+      if (UNLIKELY(eq.isErrorException())) {
+        return eq;
+      }
+      indices = MutableBytes::cast(keys.at(kSharedKeysIndicesOffset));
+    }
+  }
+  UNREACHABLE("Expected to have found an empty index");
+}
+
 // Returns one of the three possible values:
-// - `key` was found at indices[bytes_offset] : SmallInt::fromWord(bytes_offset)
+// - `key` was found at indices[index] : SmallInt::fromWord(index)
 // - `key` was not found : SmallInt::fromWord(-1)
 // - Exception that was raised from key comparison __eq__ function.
 static RawObject dictLookup(Thread* thread, const MutableTuple& data,
@@ -141,18 +250,18 @@ static RawObject dictLookup(Thread* thread, const MutableTuple& data,
   DCHECK(data.length() > 0, "data shouldn't be empty");
   uword perturb;
   word indices_mask;
+  word width_log2 = indicesWidthLog2(num_indices);
   RawSmallInt hash_int = SmallInt::fromWord(hash);
   for (word current_index =
            probeBegin(num_indices, hash, &indices_mask, &perturb);
        ; current_index = probeNext(current_index, indices_mask, &perturb)) {
-    word bytes_offset = indexOffset(current_index);
-    uint32_t item_index;
-    if (indicesIsFull(*indices, bytes_offset, &item_index)) {
+    word item_index;
+    if (indicesIsFull(*indices, width_log2, current_index, &item_index)) {
       if (itemHashRaw(*data, item_index) == hash_int) {
         RawObject eq =
             Runtime::objectEquals(thread, itemKey(*data, item_index), *key);
         if (eq == Bool::trueObj()) {
-          return SmallInt::fromWord(bytes_offset);
+          return SmallInt::fromWord(current_index);
         }
         if (UNLIKELY(eq.isErrorException())) {
           return eq;
@@ -160,7 +269,7 @@ static RawObject dictLookup(Thread* thread, const MutableTuple& data,
       }
       continue;
     }
-    if (indicesIsEmpty(*indices, bytes_offset)) {
+    if (item_index == kEmptyValue) {
       return SmallInt::fromWord(-1);
     }
   }
@@ -168,9 +277,9 @@ static RawObject dictLookup(Thread* thread, const MutableTuple& data,
 }
 
 // Returns one of the three possible values:
-// - `key` was found at indices[bytes_offset] : SmallInt::fromWord(bytes_offset)
-// - `key` was not found, but insertion can be done to indices[bytes_offset] :
-//   SmallInt::fromWord(bytes_offset - data.length())
+// - `key` was found at indices[index] : SmallInt::fromWord(index)
+// - `key` was not found, but insertion can be done to indices[index] :
+//   SmallInt::fromWord(index - num_indices)
 // - Exception that was raised from key comparison __eq__ function.
 static RawObject dictLookupForInsertion(Thread* thread,
                                         const MutableTuple& data,
@@ -180,18 +289,18 @@ static RawObject dictLookupForInsertion(Thread* thread,
   word next_free_index = -1;
   uword perturb;
   word indices_mask;
+  word width_log2 = indicesWidthLog2(num_indices);
   RawSmallInt hash_int = SmallInt::fromWord(hash);
   for (word current_index =
            probeBegin(num_indices, hash, &indices_mask, &perturb);
        ; current_index = probeNext(current_index, indices_mask, &perturb)) {
-    word bytes_offset = indexOffset(current_index);
-    uint32_t item_index;
-    if (indicesIsFull(*indices, bytes_offset, &item_index)) {
+    word item_index;
+    if (indicesIsFull(*indices, width_log2, current_index, &item_index)) {
       if (itemHashRaw(*data, item_index) == hash_int) {
         RawObject eq =
             Runtime::objectEquals(thread, itemKey(*data, item_index), *key);
         if (eq == Bool::trueObj()) {
-          return SmallInt::fromWord(bytes_offset);
+          return SmallInt::fromWord(current_index);
         }
         if (UNLIKELY(eq.isErrorException())) {
           return eq;
@@ -200,10 +309,10 @@ static RawObject dictLookupForInsertion(Thread* thread,
       continue;
     }
     if (next_free_index == -1) {
-      next_free_index = bytes_offset;
+      next_free_index = current_index;
     }
-    if (indicesIsEmpty(*indices, bytes_offset)) {
-      return SmallInt::fromWord(next_free_index - indexOffset(num_indices));
+    if (item_index == kEmptyValue) {
+      return SmallInt::fromWord(next_free_index - num_indices);
     }
   }
   UNREACHABLE("Expected to have found an empty index");
@@ -218,8 +327,26 @@ static word nextItemIndex(RawObject data, word* index, word end) {
   return -1;
 }
 
+// Returns the number of the item at `*index` of a dict sharing its keys and
+// advances `*index` past it, or returns -1 if there are no more items. The
+// index counts like that of the combined form so that iteration carries on
+// across dictUnshareKeys().
+static word nextSharedKeysItem(const Dict& dict, word* index) {
+  word i = *index;
+  if (i >= dict.firstEmptyItemIndex()) return -1;
+  *index = i + kItemNumPointers;
+  return i / kItemNumPointers;
+}
+
 bool dictNextItem(const Dict& dict, word* index, Object* key_out,
                   Object* value_out) {
+  if (dictHasSharedKeys(dict)) {
+    word item = nextSharedKeysItem(dict, index);
+    if (item < 0) return false;
+    *key_out = sharedKeysKey(Tuple::cast(dict.indices()), item);
+    *value_out = MutableTuple::cast(dict.data()).at(item);
+    return true;
+  }
   RawObject data = dict.data();
   word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
   if (next_item_index < 0) {
@@ -232,6 +359,15 @@ bool dictNextItem(const Dict& dict, word* index, Object* key_out,
 
 bool dictNextItemHash(const Dict& dict, word* index, Object* key_out,
                       Object* value_out, word* hash_out) {
+  if (dictHasSharedKeys(dict)) {
+    word item = nextSharedKeysItem(dict, index);
+    if (item < 0) return false;
+    RawTuple keys = Tuple::cast(dict.indices());
+    *key_out = sharedKeysKey(keys, item);
+    *value_out = MutableTuple::cast(dict.data()).at(item);
+    *hash_out = sharedKeysHash(keys, item);
+    return true;
+  }
   RawObject data = dict.data();
   word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
   if (next_item_index < 0) {
@@ -244,6 +380,12 @@ bool dictNextItemHash(const Dict& dict, word* index, Object* key_out,
 }
 
 bool dictNextKey(const Dict& dict, word* index, Object* key_out) {
+  if (dictHasSharedKeys(dict)) {
+    word item = nextSharedKeysItem(dict, index);
+    if (item < 0) return false;
+    *key_out = sharedKeysKey(Tuple::cast(dict.indices()), item);
+    return true;
+  }
   RawObject data = dict.data();
   word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
   if (next_item_index < 0) {
@@ -255,6 +397,14 @@ bool dictNextKey(const Dict& dict, word* index, Object* key_out) {
 
 bool dictNextKeyHash(const Dict& dict, word* index, Object* key_out,
                      word* hash_out) {
+  if (dictHasSharedKeys(dict)) {
+    word item = nextSharedKeysItem(dict, index);
+    if (item < 0) return false;
+    RawTuple keys = Tuple::cast(dict.indices());
+    *key_out = sharedKeysKey(keys, item);
+    *hash_out = sharedKeysHash(keys, item);
+    return true;
+  }
   RawObject data = dict.data();
   word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
   if (next_item_index < 0) {
@@ -266,6 +416,12 @@ bool dictNextKeyHash(const Dict& dict, word* index, Object* key_out,
 }
 
 bool dictNextValue(const Dict& dict, word* index, Object* value_out) {
+  if (dictHasSharedKeys(dict)) {
+    word item = nextSharedKeysItem(dict, index);
+    if (item < 0) return false;
+    *value_out = MutableTuple::cast(dict.data()).at(item);
+    return true;
+  }
   RawObject data = dict.data();
   word next_item_index = nextItemIndex(data, index, dict.firstEmptyItemIndex());
   if (next_item_index < 0) {
@@ -277,7 +433,10 @@ bool dictNextValue(const Dict& dict, word* index, Object* value_out) {
 
 static word sizeOfDataTuple(word num_indices) { return (num_indices * 2) / 3; }
 
-static const word kDictGrowthFactor = 2;
+// When a dict runs out of items it is resized to the next power of two above
+// this multiple of its live items, like CPython's GROWTH_RATE. A dict that
+// only grows doubles in size; one with deleted items can stay the same size.
+static const word kDictGrowthRate = 3;
 // Initial size of the dict. According to comments in CPython's
 // dictobject.c this accommodates the majority of dictionaries without needing
 // a resize (obviously this depends on the load factor used to resize the
@@ -293,7 +452,7 @@ void dictAllocateArrays(Thread* thread, const Dict& dict, word num_indices) {
                                         kItemNumPointers));
   MutableTuple::cast(dict.data()).fill(NoneType::object());
   dict.setIndices(
-      runtime->mutableBytesWith(indexOffset(num_indices), kMaxByte));
+      runtime->mutableBytesWith(indicesLength(num_indices), kMaxByte));
   dict.setFirstEmptyItemIndex(0);
 }
 
@@ -312,38 +471,31 @@ static void dictInsertNoUpdate(const MutableTuple& data,
   DCHECK(data.length() > 0, "dict must not be empty");
   uword perturb;
   word indices_mask;
+  word width_log2 = indicesWidthLog2(num_indices);
   for (word current_index =
            probeBegin(num_indices, hash, &indices_mask, &perturb);
        ; current_index = probeNext(current_index, indices_mask, &perturb)) {
-    word bytes_offset = indexOffset(current_index);
-    if (indicesIsEmpty(*indices, bytes_offset)) {
-      uint32_t item_index = item_count * kItemNumPointers;
+    if (indicesIsEmpty(*indices, width_log2, current_index)) {
+      word item_index = item_count * kItemNumPointers;
       itemSet(*data, item_index, hash, *key, *value);
-      itemIndexAtPut(*indices, bytes_offset, item_index);
+      itemIndexAtPut(*indices, width_log2, current_index, item_index);
       return;
     }
   }
 }
 
-static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
-  DCHECK(dict.numIndices() && Utils::isPowerOfTwo(dict.numIndices()),
-         "dict capacity must be power of two, greater than zero");
-  if (dictHasUsableItem(dict)) {
-    return;
-  }
-
-  // TODO(T44247845): Handle overflow here.
-  word new_num_indices = dict.numIndices() * kDictGrowthFactor;
-  DCHECK(new_num_indices < kTombstoneValue,
-         "new_num_indices is expected to be less than kTombstoneValue");
+// Rebuilds the combined `dict` with `new_num_indices` indices, dropping any
+// tombstones.
+static void dictResize(Thread* thread, const Dict& dict, word new_num_indices) {
   HandleScope scope(thread);
   Runtime* runtime = thread->runtime();
   MutableTuple new_data(
       &scope, runtime->newMutableTuple(sizeOfDataTuple(new_num_indices) *
                                        kItemNumPointers));
   new_data.fill(NoneType::object());
-  MutableBytes new_indices(&scope, runtime->mutableBytesWith(
-                                       indexOffset(new_num_indices), kMaxByte));
+  MutableBytes new_indices(
+      &scope,
+      runtime->mutableBytesWith(indicesLength(new_num_indices), kMaxByte));
 
   // Re-insert items
   Object key(&scope, NoneType::object());
@@ -361,10 +513,172 @@ static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
   dict.setFirstEmptyItemIndex(dict.numItems() * kItemNumPointers);
 }
 
+static void dictEnsureCapacity(Thread* thread, const Dict& dict) {
+  DCHECK(dict.numIndices() && Utils::isPowerOfTwo(dict.numIndices()),
+         "dict capacity must be power of two, greater than zero");
+  if (dictHasUsableItem(dict)) {
+    return;
+  }
+
+  // TODO(T44247845): Handle overflow here.
+  dictResize(thread, dict,
+             Utils::maximum(
+                 Utils::nextPowerOfTwo(dict.numItems() * kDictGrowthRate),
+                 kInitialDictIndicesLength));
+}
+
+// Makes room in the combined `dict` for `num_new_items` insertions without
+// intermediate resizes.
+static void dictReserve(Thread* thread, const Dict& dict, word num_new_items) {
+  word num_indices = dict.numIndices();
+  word first_empty_item = dict.firstEmptyItemIndex() / kItemNumPointers;
+  // The last insertion must still leave an empty item behind.
+  if (num_indices > 0 &&
+      first_empty_item + num_new_items < sizeOfDataTuple(num_indices)) {
+    return;
+  }
+  word num_items = dict.numItems() + num_new_items;
+  word new_num_indices = Utils::nextPowerOfTwo(((num_items + 1) * 3 + 1) / 2);
+  if (num_indices == 0) {
+    dictAllocateArrays(thread, dict, new_num_indices);
+    return;
+  }
+  dictResize(thread, dict, new_num_indices);
+}
+
+// Converts a dict sharing its keys to the combined form, which stores the
+// hashes and keys next to the values.
+static void dictUnshareKeys(Thread* thread, const Dict& dict) {
+  DCHECK(dictHasSharedKeys(dict), "dict is expected to share its keys");
+  HandleScope scope(thread);
+  Tuple keys(&scope, dict.indices());
+  MutableTuple values(&scope, dict.data());
+  word num_items = dict.numItems();
+  dictAllocateArrays(thread, dict,
+                     Utils::nextPowerOfTwo(num_items * kDictGrowthRate));
+  MutableTuple data(&scope, dict.data());
+  MutableBytes indices(&scope, dict.indices());
+  word num_indices = dict.numIndices();
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  for (word i = 0; i < num_items; i++) {
+    key = sharedKeysKey(*keys, i);
+    value = values.at(i);
+    dictInsertNoUpdate(data, indices, num_indices, i, key,
+                       sharedKeysHash(*keys, i), value);
+  }
+  dict.setFirstEmptyItemIndex(num_items * kItemNumPointers);
+}
+
+RawObject dictShareKeys(Thread* thread, const Dict& dict) {
+  if (dictHasSharedKeys(dict)) {
+    return dict.indices();
+  }
+  word num_items = dict.numItems();
+  if (num_items == 0) {
+    return Error::notFound();
+  }
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  // Keep the indices at most 2/3 full, like those of a combined dict.
+  word num_indices = Utils::nextPowerOfTwo(num_items * 3 / 2 + 1);
+  word width_log2 = indicesWidthLog2(num_indices);
+  MutableBytes indices(
+      &scope, runtime->mutableBytesWith(indicesLength(num_indices), kMaxByte));
+  MutableTuple keys(&scope,
+                    runtime->newMutableTuple(kSharedKeysItemsOffset +
+                                             num_items *
+                                                 kSharedKeysItemNumPointers));
+  keys.atPut(kSharedKeysIndicesOffset, *indices);
+  MutableTuple values(&scope, runtime->newMutableTuple(num_items));
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  word hash;
+  word item = 0;
+  for (word i = 0; dictNextItemHash(dict, &i, &key, &value, &hash); item++) {
+    word key_index = kSharedKeysItemsOffset + item * kSharedKeysItemNumPointers;
+    keys.atPut(key_index, SmallInt::fromWordTruncated(hash));
+    keys.atPut(key_index + 1, *key);
+    values.atPut(item, *value);
+    uword perturb;
+    word indices_mask;
+    for (word current_index =
+             probeBegin(num_indices, hash, &indices_mask, &perturb);
+         ; current_index = probeNext(current_index, indices_mask, &perturb)) {
+      if (indicesIsEmpty(*indices, width_log2, current_index)) {
+        itemIndexAtPut(*indices, width_log2, current_index, item);
+        break;
+      }
+    }
+  }
+  DCHECK(item == num_items, "found entries != dictNumItems()");
+  dict.setIndices(keys.becomeImmutable());
+  dict.setData(*values);
+  dict.setFirstEmptyItemIndex(num_items * kItemNumPointers);
+  return dict.indices();
+}
+
+void dictUseSharedKeys(Thread* thread, const Dict& dict, const Object& keys) {
+  DCHECK(dict.numItems() == 0, "dict is expected to be empty");
+  DCHECK(keys.isTuple(), "expected a shared keys table");
+  word num_keys = sharedKeysNumItems(Tuple::cast(*keys));
+  dict.setData(thread->runtime()->newMutableTuple(num_keys));
+  dict.setIndices(*keys);
+  dict.setFirstEmptyItemIndex(0);
+}
+
+RawObject dictSharedKeysAt(const Object& keys, word index) {
+  DCHECK(keys.isTuple(), "expected a shared keys table");
+  RawTuple table = Tuple::cast(*keys);
+  if (index >= sharedKeysNumItems(table)) return Error::notFound();
+  return sharedKeysKey(table, index);
+}
+
+void dictSharedKeysAppend(const Dict& dict, const Object& value) {
+  DCHECK(dictHasSharedKeys(dict), "expected dict with shared keys");
+  word num_items = dict.numItems();
+  DCHECK(num_items < sharedKeysNumItems(Tuple::cast(dict.indices())),
+         "all shared keys are present");
+  MutableTuple::cast(dict.data()).atPut(num_items, *value);
+  dict.setNumItems(num_items + 1);
+  dict.setFirstEmptyItemIndex((num_items + 1) * kItemNumPointers);
+}
+
+// Stores `value` for `key` in a dict sharing its keys, if `key` already has
+// a value or is the next key of the shared keys table. Returns
+// `Error::notFound()` if the dict needs to be unshared to store `key`.
+static RawObject dictAtPutSharedKeys(Thread* thread, const Dict& dict,
+                                     const Object& key, word hash,
+                                     const Object& value) {
+  HandleScope scope(thread);
+  Tuple keys(&scope, dict.indices());
+  RawObject lookup_result =
+      sharedKeysLookup(thread, keys, dict.numIndices(), key, hash);
+  if (UNLIKELY(lookup_result.isErrorException())) {
+    return lookup_result;
+  }
+  word item = SmallInt::cast(lookup_result).value();
+  word num_items = dict.numItems();
+  // `__eq__` may have changed the dict.
+  if (item < 0 || item > num_items || dict.indices() != *keys) {
+    return Error::notFound();
+  }
+  MutableTuple::cast(dict.data()).atPut(item, *value);
+  if (item == num_items) {
+    dict.setNumItems(num_items + 1);
+    dict.setFirstEmptyItemIndex((num_items + 1) * kItemNumPointers);
+  }
+  return NoneType::object();
+}
+
 RawObject dictAtPut(Thread* thread, const Dict& dict, const Object& key,
                     word hash, const Object& value) {
   if (dict.indices() == SmallInt::fromWord(0)) {
     dictAllocateArrays(thread, dict, kInitialDictIndicesLength);
+  } else if (dictHasSharedKeys(dict)) {
+    RawObject result = dictAtPutSharedKeys(thread, dict, key, hash, value);
+    if (!result.isErrorNotFound()) return result;
+    dictUnshareKeys(thread, dict);
   }
   HandleScope scope(thread);
   MutableTuple data(&scope, dict.data());
@@ -375,18 +689,19 @@ RawObject dictAtPut(Thread* thread, const Dict& dict, const Object& key,
   if (UNLIKELY(lookup_result.isErrorException())) {
     return lookup_result;
   }
-  word bytes_offset = SmallInt::cast(lookup_result).value();
-  if (bytes_offset >= 0) {
-    uint32_t item_index = itemIndexAt(*indices, bytes_offset);
+  word width_log2 = indicesWidthLog2(num_indices);
+  word index = SmallInt::cast(lookup_result).value();
+  if (index >= 0) {
+    word item_index = itemIndexAt(*indices, width_log2, index);
     itemSetValue(*data, item_index, *value);
     return NoneType::object();
   }
 
-  bytes_offset += indexOffset(num_indices);
+  index += num_indices;
   word item_index = dict.firstEmptyItemIndex();
   DCHECK(itemIsEmpty(*data, item_index), "item is expected to be empty");
   itemSet(*data, item_index, hash, *key, *value);
-  itemIndexAtPut(*indices, bytes_offset, item_index);
+  itemIndexAtPut(*indices, width_log2, index, item_index);
   dict.setNumItems(dict.numItems() + 1);
   dict.setFirstEmptyItemIndex(dict.firstEmptyItemIndex() + kItemNumPointers);
   dictEnsureCapacity(thread, dict);
@@ -415,15 +730,30 @@ RawObject dictAt(Thread* thread, const Dict& dict, const Object& key,
   }
   HandleScope scope(thread);
   MutableTuple data(&scope, dict.data());
+  if (dictHasSharedKeys(dict)) {
+    Tuple keys(&scope, dict.indices());
+    word num_items = dict.numItems();
+    RawObject lookup_result =
+        sharedKeysLookup(thread, keys, dict.numIndices(), key, hash);
+    if (UNLIKELY(lookup_result.isErrorException())) {
+      return lookup_result;
+    }
+    word item = SmallInt::cast(lookup_result).value();
+    if (item >= 0 && item < num_items) {
+      return data.at(item);
+    }
+    return Error::notFound();
+  }
   MutableBytes indices(&scope, dict.indices());
   RawObject lookup_result =
       dictLookup(thread, data, indices, dict.numIndices(), key, hash);
   if (UNLIKELY(lookup_result.isErrorException())) {
     return lookup_result;
   }
-  word bytes_offset = SmallInt::cast(lookup_result).value();
-  if (bytes_offset >= 0) {
-    uint32_t item_index = itemIndexAt(*indices, bytes_offset);
+  word index = SmallInt::cast(lookup_result).value();
+  if (index >= 0) {
+    word item_index =
+        itemIndexAt(*indices, indicesWidthLog2(dict.numIndices()), index);
     return itemValue(*data, item_index);
   }
   return Error::notFound();
@@ -444,6 +774,8 @@ RawObject dictAtPutInValueCellByStr(Thread* thread, const Dict& dict,
                                     const Object& name, const Object& value) {
   if (dict.indices() == SmallInt::fromWord(0)) {
     dictAllocateArrays(thread, dict, kInitialDictIndicesLength);
+  } else if (dictHasSharedKeys(dict)) {
+    dictUnshareKeys(thread, dict);
   }
   HandleScope scope(thread);
   MutableTuple data(&scope, dict.data());
@@ -455,19 +787,20 @@ RawObject dictAtPutInValueCellByStr(Thread* thread, const Dict& dict,
   if (UNLIKELY(lookup_result.isErrorException())) {
     return lookup_result;
   }
-  word bytes_offset = SmallInt::cast(lookup_result).value();
-  if (bytes_offset >= 0) {
-    uint32_t item_index = itemIndexAt(*indices, bytes_offset);
+  word width_log2 = indicesWidthLog2(num_indices);
+  word index = SmallInt::cast(lookup_result).value();
+  if (index >= 0) {
+    word item_index = itemIndexAt(*indices, width_log2, index);
     RawValueCell value_cell = ValueCell::cast(itemValue(*data, item_index));
     value_cell.setValue(*value);
     return value_cell;
   }
-  bytes_offset += indexOffset(num_indices);
+  index += num_indices;
   word item_index = dict.firstEmptyItemIndex();
   DCHECK(itemIsEmpty(*data, item_index), "item is expected to be empty");
   ValueCell value_cell(&scope, thread->runtime()->newValueCell());
   itemSet(*data, item_index, hash, *name, *value_cell);
-  itemIndexAtPut(*indices, bytes_offset, item_index);
+  itemIndexAtPut(*indices, width_log2, index, item_index);
   dict.setNumItems(dict.numItems() + 1);
   dict.setFirstEmptyItemIndex(dict.firstEmptyItemIndex() + kItemNumPointers);
   dictEnsureCapacity(thread, dict);
@@ -478,6 +811,15 @@ RawObject dictAtPutInValueCellByStr(Thread* thread, const Dict& dict,
 
 void dictClear(Thread* thread, const Dict& dict) {
   if (dict.indices() == SmallInt::fromWord(0)) return;
+  if (dictHasSharedKeys(dict)) {
+    // Go back to the state of a new dict rather than keep values for keys
+    // that are unlikely to be inserted again in the same order.
+    dict.setNumItems(0);
+    dict.setData(SmallInt::fromWord(0));
+    dict.setIndices(SmallInt::fromWord(0));
+    dict.setFirstEmptyItemIndex(0);
+    return;
+  }
 
   HandleScope scope(thread);
   MutableTuple data(&scope, dict.data());
@@ -494,6 +836,17 @@ RawObject dictIncludes(Thread* thread, const Dict& dict, const Object& key,
     return Bool::falseObj();
   }
   HandleScope scope(thread);
+  if (dictHasSharedKeys(dict)) {
+    Tuple keys(&scope, dict.indices());
+    word num_items = dict.numItems();
+    RawObject lookup_result =
+        sharedKeysLookup(thread, keys, dict.numIndices(), key, hash);
+    if (UNLIKELY(lookup_result.isErrorException())) {
+      return lookup_result;
+    }
+    word item = SmallInt::cast(lookup_result).value();
+    return Bool::fromBool(item >= 0 && item < num_items);
+  }
   MutableTuple data(&scope, dict.data());
   MutableBytes indices(&scope, dict.indices());
   word num_indices = dict.numIndices();
@@ -516,6 +869,9 @@ RawObject dictRemove(Thread* thread, const Dict& dict, const Object& key,
   if (dict.numItems() == 0) {
     return Error::notFound();
   }
+  if (dictHasSharedKeys(dict)) {
+    dictUnshareKeys(thread, dict);
+  }
   HandleScope scope(thread);
   MutableTuple data(&scope, dict.data());
   MutableBytes indices(&scope, dict.indices());
@@ -525,14 +881,15 @@ RawObject dictRemove(Thread* thread, const Dict& dict, const Object& key,
   if (UNLIKELY(lookup_result.isErrorException())) {
     return lookup_result;
   }
-  word bytes_offset = SmallInt::cast(lookup_result).value();
-  if (bytes_offset < 0) {
+  word index = SmallInt::cast(lookup_result).value();
+  if (index < 0) {
     return Error::notFound();
   }
-  uint32_t item_index = itemIndexAt(*indices, bytes_offset);
+  word width_log2 = indicesWidthLog2(num_indices);
+  word item_index = itemIndexAt(*indices, width_log2, index);
   Object result(&scope, itemValue(*data, item_index));
   itemSetTombstone(*data, item_index);
-  indicesSetTombstone(*indices, bytes_offset);
+  indicesSetTombstone(*indices, width_log2, index);
   dict.setNumItems(dict.numItems() - 1);
   return *result;
 }
@@ -568,6 +925,39 @@ RawObject dictCopy(Thread* thread, const Dict& dict) {
   return *copy;
 }
 
+// Turns the empty `dict` into a copy of `other` by copying its tables
+// wholesale. Returns false if `other` has deleted items that the copy should
+// not carry over.
+static bool dictCloneInto(Thread* thread, const Dict& dict, const Dict& other) {
+  DCHECK(dict.numItems() == 0, "dict must be empty");
+  bool shared_keys = dictHasSharedKeys(other);
+  if (!shared_keys && other.firstEmptyItemIndex() !=
+                          other.numItems() * kItemNumPointers) {
+    return false;
+  }
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  MutableTuple data(&scope, other.data());
+  word data_length = data.length();
+  MutableTuple new_data(&scope, runtime->newMutableTuple(data_length));
+  new_data.replaceFromWith(0, *data, data_length);
+  if (shared_keys) {
+    // The keys table is immutable and can be shared with the copy.
+    dict.setIndices(other.indices());
+  } else {
+    MutableBytes indices(&scope, other.indices());
+    word indices_length = indices.length();
+    MutableBytes new_indices(
+        &scope, runtime->newMutableBytesUninitialized(indices_length));
+    new_indices.replaceFromWith(0, *indices, indices_length);
+    dict.setIndices(*new_indices);
+  }
+  dict.setData(*new_data);
+  dict.setNumItems(other.numItems());
+  dict.setFirstEmptyItemIndex(other.firstEmptyItemIndex());
+  return true;
+}
+
 namespace {
 enum class Override {
   kIgnore,
@@ -580,10 +970,20 @@ RawObject dictMergeDict(Thread* thread, const Dict& dict, const Object& mapping,
   HandleScope scope(thread);
   if (*mapping == *dict) return NoneType::object();
 
+  Dict other(&scope, *mapping);
+  word num_other_items = other.numItems();
+  if (num_other_items == 0) return NoneType::object();
+  if (dict.numItems() == 0) {
+    if (dictCloneInto(thread, dict, other)) return NoneType::object();
+    if (dictHasSharedKeys(dict)) dictClear(thread, dict);
+  }
+  if (!dictHasSharedKeys(dict)) {
+    dictReserve(thread, dict, num_other_items);
+  }
+
   Object key(&scope, NoneType::object());
   Object value(&scope, NoneType::object());
   word hash;
-  Dict other(&scope, *mapping);
   Object included(&scope, NoneType::object());
   Object dict_result(&scope, NoneType::object());
   for (word i = 0; dictNextItemHash(other, &i, &key, &value, &hash);) {
@@ -1017,6 +1417,18 @@ RawObject METH(dict, popitem)(Thread* thread, Arguments args) {
     return thread->raiseWithFmt(LayoutId::kKeyError,
                                 "popitem(): dictionary is empty");
   }
+  if (dictHasSharedKeys(dict)) {
+    // The last item is always the last key with a value, so the dict can
+    // keep sharing its keys.
+    word item = dict.numItems() - 1;
+    Object key(&scope, sharedKeysKey(Tuple::cast(dict.indices()), item));
+    MutableTuple values(&scope, dict.data());
+    Object value(&scope, values.at(item));
+    values.atPut(item, NoneType::object());
+    dict.setNumItems(item);
+    dict.setFirstEmptyItemIndex(item * kItemNumPointers);
+    return runtime->newTupleWith2(key, value);
+  }
   MutableTuple data(&scope, dict.data());
   for (word item_index = dict.firstEmptyItemIndex() - kItemNumPointers;
        item_index >= 0; item_index -= kItemNumPointers) {
@@ -1033,12 +1445,12 @@ RawObject METH(dict, popitem)(Thread* thread, Arguments args) {
       word indices_mask;
       word hash = itemHash(*data, item_index);
       word num_indices = dict.numIndices();
+      word width_log2 = indicesWidthLog2(num_indices);
       for (word current_index =
                probeBegin(num_indices, hash, &indices_mask, &perturb);
            ; current_index = probeNext(current_index, indices_mask, &perturb)) {
-        word bytes_offset = indexOffset(current_index);
-        uint32_t comp;
-        if (indicesIsFull(*indices, bytes_offset, &comp) &&
+        word comp;
+        if (indicesIsFull(*indices, width_log2, current_index, &comp) &&
             comp == item_index) {
           indices_index = current_index;
           break;
@@ -1046,7 +1458,7 @@ RawObject METH(dict, popitem)(Thread* thread, Arguments args) {
       }
       DCHECK(indices_index >= 0, "cannot find index for entry in dict.sparse");
       itemSetTombstone(*data, item_index);
-      indicesSetTombstone(*indices, indexOffset(indices_index));
+      indicesSetTombstone(*indices, width_log2, indices_index);
       dict.setNumItems(dict.numItems() - 1);
       return *result;
     }
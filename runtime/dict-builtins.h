@@ -65,6 +65,28 @@ RawObject dictAtById(Thread* thread, const Dict& dict, SymbolId id);
 RawObject dictAtPutInValueCellByStr(Thread* thread, const Dict& dict,
                                     const Object& name, const Object& value);
 
+// Makes `dict` share its keys with other dicts: the keys and hashes move to
+// an immutable keys table and `dict` only keeps its values. Returns the keys
+// table, which can be passed to `dictUseSharedKeys()`, or `Error::notFound()`
+// if `dict` is empty.
+RawObject dictShareKeys(Thread* thread, const Dict& dict);
+
+// Returns true if `dict` shares its keys with other dicts.
+bool dictHasSharedKeys(const Dict& dict);
+
+// Makes the empty `dict` use the keys table `keys` returned by
+// `dictShareKeys()`. Inserting the keys of the table in order then only
+// stores values; any other change converts `dict` back to the usual form.
+void dictUseSharedKeys(Thread* thread, const Dict& dict, const Object& keys);
+
+// Returns the `index`th key of the keys table `keys` returned by
+// `dictShareKeys()` or `Error::notFound()` if the table has fewer keys.
+RawObject dictSharedKeysAt(const Object& keys, word index);
+
+// Stores `value` for the next key of the keys table shared by `dict`, which is
+// `dictSharedKeysAt(dict.indices(), dict.numItems())`.
+void dictSharedKeysAppend(const Dict& dict, const Object& value);
+
 // Remove all items from a Dict.
 void dictClear(Thread* thread, const Dict& dict);
 
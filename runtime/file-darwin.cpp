@@ -78,6 +78,14 @@ ssize_t File::write(int fd, const void* buffer, size_t size) {
   return result < 0 ? -errno : result;
 }
 
+ssize_t File::writev(int fd, const struct iovec* iov, int iov_count) {
+  ssize_t result;
+  do {
+    result = ::writev(fd, iov, iov_count);
+  } while (result == -1 && errno == EINTR);
+  return result < 0 ? -errno : result;
+}
+
 const word File::kBinaryFlag = 0;
 const word File::kCreate = O_CREAT;
 const word File::kNoInheritFlag = O_CLOEXEC;
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include "globals.h"
 
@@ -45,6 +46,10 @@ class File {
   // Return number of bytes written. Return -errno on error.
   static ssize_t write(int fd, const void* buffer, size_t size);
 
+  // Write the `iov_count` buffers of `iov` in order with a single system call.
+  // Return number of bytes written. Return -errno on error.
+  static ssize_t writev(int fd, const struct iovec* iov, int iov_count);
+
   // TODO(T61930691): Remove these flags in favor of a simpler interface like a
   // mode string
 
@@ -101,23 +101,22 @@ RawObject floatFromDigits(Thread* thread, const char* str, word length) {
     }
     dup = new_str;
   }
-  double result = std::strtod(dup, &end);
-  // Overflow, return infinity or negative infinity.
-  if (result == HUGE_VAL) {
-    result = std::numeric_limits<double>::infinity();
-  } else if (result == -HUGE_VAL) {
-    result = -std::numeric_limits<double>::infinity();
-  } else if (dup_length == 0 || end - dup != dup_length) {
+  // Overflow results in infinity or negative infinity.
+  ConversionResult conversion_result;
+  double result = parseFloat(dup, &end, &conversion_result);
+  word parsed_length = end - dup;
+  if (release_memory) {
+    delete[] new_str;
+  }
+  if (conversion_result == ConversionResult::kOutOfMemory) {
+    return thread->raiseMemoryError();
+  }
+  if (conversion_result == ConversionResult::kInvalid ||
+      parsed_length != dup_length) {
     // Conversion was incomplete; the string was not a valid float.
-    if (release_memory) {
-      delete[] new_str;
-    }
     return thread->raiseWithFmt(LayoutId::kValueError,
                                 "could not convert string to float: '%s'", str);
   }
-  if (release_memory) {
-    delete[] new_str;
-  }
   return thread->runtime()->newFloat(result);
 }
 
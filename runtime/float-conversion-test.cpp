@@ -2,8 +2,11 @@
 #include "float-conversion.h"
 
 #include <cmath>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <random>
+#include <string>
 
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
@@ -103,5 +106,144 @@ TEST_F(FloatConversionTest, ParseFloatWithInfinityReturnsDouble) {
   EXPECT_TRUE(std::isinf(value));
 }
 
+static std::string reprOf(double value) {
+  unique_c_ptr<char> buf(
+      doubleToString(value, 'r', 0, false, false, false, nullptr));
+  return buf.get();
+}
+
+TEST_F(FloatConversionTest, DoubleToStringWithReprReturnsShortestString) {
+  EXPECT_EQ(reprOf(0.1), "0.1");
+  EXPECT_EQ(reprOf(-0.3), "-0.3");
+  EXPECT_EQ(reprOf(0.1 + 0.2), "0.30000000000000004");
+  EXPECT_EQ(reprOf(100.0), "100");
+  EXPECT_EQ(reprOf(1e16), "1e+16");
+  EXPECT_EQ(reprOf(123456789012345680.0), "1.2345678901234568e+17");
+  EXPECT_EQ(reprOf(1e23), "1e+23");
+  EXPECT_EQ(reprOf(5e-324), "5e-324");
+  EXPECT_EQ(reprOf(2.2250738585072014e-308), "2.2250738585072014e-308");
+  EXPECT_EQ(reprOf(1.7976931348623157e308), "1.7976931348623157e+308");
+}
+
+// Returns the significant digits of a string produced by doubleToString.
+static std::string significantDigitsOf(const char* str) {
+  std::string digits;
+  for (const char* p = str; *p != '\0' && *p != 'e'; p++) {
+    if ('0' <= *p && *p <= '9' && (*p != '0' || !digits.empty())) {
+      digits += *p;
+    }
+  }
+  while (digits.size() > 1 && digits.back() == '0') {
+    digits.pop_back();
+  }
+  return digits;
+}
+
+TEST_F(FloatConversionTest,
+       DoubleToStringWithReprMatchesCorrectlyRoundedDigits) {
+  // The shortest representation that reads back as the same double is the
+  // one correctly rounded to as many digits, which is still computed with
+  // the arbitrary precision dtoa, and rounding to one digit less does not
+  // read back as the same double.
+  std::mt19937_64 random(0x5eed);
+  for (int i = 0; i < 100000; i++) {
+    uint64_t bits = random();
+    // Make values around 1.0 and subnormals more likely.
+    if (i % 4 == 1) {
+      bits = (bits & ~(uint64_t{0x7f8} << 52)) | (uint64_t{0x3f8} << 52);
+    } else if (i % 4 == 2) {
+      bits &= ~(uint64_t{0x7ff} << 52);
+    }
+    double value = bit_cast<double>(bits);
+    if (!std::isfinite(value) || value == 0.0) continue;
+    std::string repr = reprOf(value);
+    ASSERT_EQ(std::strtod(repr.c_str(), nullptr), value) << repr;
+    std::string digits = significantDigitsOf(repr.c_str());
+    int num_digits = static_cast<int>(digits.size());
+    unique_c_ptr<char> rounded(doubleToString(value, 'e', num_digits - 1,
+                                              false, false, false, nullptr));
+    ASSERT_EQ(significantDigitsOf(rounded.get()), digits) << repr;
+    if (num_digits > 1) {
+      unique_c_ptr<char> shorter(doubleToString(
+          value, 'e', num_digits - 2, false, false, false, nullptr));
+      ASSERT_NE(std::strtod(shorter.get(), nullptr), value) << repr;
+    }
+  }
+}
+
+static double parseFloatOrDie(const char* str) {
+  char* endptr;
+  ConversionResult result;
+  double value = parseFloat(str, &endptr, &result);
+  EXPECT_EQ(result, ConversionResult::kSuccess) << str;
+  EXPECT_EQ(*endptr, '\0') << str;
+  return value;
+}
+
+TEST_F(FloatConversionTest, ParseFloatWithHalfwayCasesRoundsToEven) {
+  EXPECT_EQ(parseFloatOrDie("9007199254740993"), 9007199254740992.0);
+  EXPECT_EQ(parseFloatOrDie("9007199254740995"), 9007199254740996.0);
+  EXPECT_EQ(parseFloatOrDie("1e23"), 1e23);
+  EXPECT_EQ(parseFloatOrDie("2.2250738585072011e-308"),
+            std::strtod("0x0.fffffffffffffp-1022", nullptr));
+  EXPECT_EQ(parseFloatOrDie("4.9406564584124654e-324"), 5e-324);
+  EXPECT_EQ(parseFloatOrDie("0.000000000000000000000000000001"), 1e-30);
+  EXPECT_EQ(parseFloatOrDie("123456789012345678901234567890"),
+            1.2345678901234568e29);
+}
+
+TEST_F(FloatConversionTest, ParseFloatWithOverflowReturnsInfinity) {
+  char* endptr;
+  ConversionResult result;
+  double value = parseFloat("-1e500", &endptr, &result);
+  EXPECT_EQ(result, ConversionResult::kOverflow);
+  EXPECT_TRUE(std::isinf(value));
+  EXPECT_TRUE(value < 0);
+}
+
+TEST_F(FloatConversionTest, ParseFloatWithTrailingExponentMarkerStopsBefore) {
+  const char* str = "12.5e+";
+  char* endptr;
+  ConversionResult result;
+  double value = parseFloat(str, &endptr, &result);
+  EXPECT_EQ(endptr - str, 4);
+  EXPECT_EQ(result, ConversionResult::kSuccess);
+  EXPECT_EQ(value, 12.5);
+}
+
+TEST_F(FloatConversionTest, ParseFloatMatchesStrtod) {
+  std::mt19937_64 random(0xf10a7);
+  char buf[64];
+  for (int i = 0; i < 100000; i++) {
+    uint64_t significand = random() >> (random() % 64);
+    int exponent = static_cast<int>(random() % 700) - 350;
+    std::snprintf(buf, sizeof(buf), "%llue%d",
+                  static_cast<unsigned long long>(significand), exponent);
+    char* endptr;
+    ConversionResult result;
+    ASSERT_EQ(parseFloat(buf, &endptr, &result), std::strtod(buf, nullptr))
+        << buf;
+    double value = bit_cast<double>(random());
+    if (!std::isfinite(value)) continue;
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    ASSERT_EQ(parseFloatOrDie(buf), value) << buf;
+    std::snprintf(buf, sizeof(buf), "%.*g", static_cast<int>(random() % 17) + 1,
+                  value);
+    ASSERT_EQ(parseFloat(buf, &endptr, &result), std::strtod(buf, nullptr))
+        << buf;
+  }
+}
+
+TEST_F(FloatConversionTest, ParseFloatOfReprReturnsSameDouble) {
+  // Doubles with all 53 significand bits set, which always need many digits.
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 10000; i++) {
+    double value = std::ldexp(static_cast<double>(random() >> 11), -60);
+    std::string repr = reprOf(value);
+    ASSERT_EQ(parseFloatOrDie(repr.c_str()), value) << repr;
+    ASSERT_EQ(reprOf(-value), "-" + repr);
+  }
+}
+
 }  // namespace testing
 }  // namespace py
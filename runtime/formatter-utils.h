@@ -9,6 +9,8 @@ namespace py {
 
 extern const byte kLowerCaseHexDigitArray[16];
 extern const byte kUpperCaseHexDigitArray[16];
+// "00", "01", ..., "99" concatenated.
+extern const char kDecimalDigitPairs[201];
 
 // Converts an uword to ascii decimal digits. The digits can only be efficiently
 // produced from least to most significant without knowing the exact number of
@@ -16,10 +18,19 @@ extern const byte kUpperCaseHexDigitArray[16];
 // and writes the digit before it. Returns a pointer to the last byte written.
 inline byte* uwordToDecimal(uword num, byte* buffer_end) {
   byte* start = buffer_end;
-  do {
-    *--start = '0' + num % 10;
-    num /= 10;
-  } while (num > 0);
+  while (num >= 100) {
+    const char* pair = &kDecimalDigitPairs[(num % 100) * 2];
+    num /= 100;
+    *--start = pair[1];
+    *--start = pair[0];
+  }
+  if (num >= 10) {
+    const char* pair = &kDecimalDigitPairs[num * 2];
+    *--start = pair[1];
+    *--start = pair[0];
+  } else {
+    *--start = '0' + num;
+  }
   return start;
 }
 
@@ -20,6 +20,17 @@ const byte kLowerCaseHexDigitArray[] = {'0', '1', '2', '3', '4', '5', '6', '7',
                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
 const byte kUpperCaseHexDigitArray[] = {'0', '1', '2', '3', '4', '5', '6', '7',
                                         '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'};
+const char kDecimalDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
 
 struct FloatWidths {
   word left_padding;
@@ -573,10 +584,108 @@ static word estimateNumDecimalDigits(RawLargeInt value) {
   return 1 + bit_length * 309 / 1024;
 }
 
-static byte* writeLargeIntDecimalDigits(byte* buffer_end, RawLargeInt value) {
+// Writes the decimal digits of the unsigned number `digits[0:num_digits]` in
+// front of `buffer_end`, clobbering `digits`. Returns the first byte written.
+static byte* writeUnsignedDecimalDigits(byte* buffer_end, uword* digits,
+                                        word num_digits) {
+  // The strategy here is to divide the large integer by continually dividing it
+  // by `kUwordDigits10Pow`. `uwordToDecimal` can convert those remainders to
+  // decimal digits.
+  byte* start = buffer_end;
+  do {
+    uword remainder =
+        divIntSingleDigit(digits, digits, num_digits, kUwordDigits10Pow);
+    byte* new_start = uwordToDecimal(remainder, start);
+
+    while (num_digits > 0 && digits[num_digits - 1] == 0) {
+      num_digits--;
+    }
+    // Produce leading zeros if this wasn't the last round.
+    if (num_digits > 0) {
+      for (word i = 0, n = kUwordDigits10 - (start - new_start); i < n; i++) {
+        *--new_start = '0';
+      }
+    }
+    start = new_start;
+  } while (num_digits > 0);
+  return start;
+}
+
+// Numbers with more digits than this are split at a power of
+// `kUwordDigits10Pow` and both halves are converted recursively. Every
+// division by `kUwordDigits10Pow` walks the whole number, so converting it in
+// one piece takes time quadratic in its length.
+static const word kDecimalSplitThreshold = 32;
+
+// Writes the decimal digits of the non-negative `value` in front of
+// `buffer_end`, padded with leading zeros to at least `min_length` characters.
+// `powers` caches `kUwordDigits10Pow**(2**k)` at index `k`.
+static byte* writeNonNegativeIntDecimalDigits(Thread* thread, const Int& value,
+                                              word min_length,
+                                              const List& powers,
+                                              byte* buffer_end) {
+  DCHECK(!value.isNegative(), "value must not be negative");
+  word num_digits = value.numDigits();
+  byte* start;
+  if (num_digits <= kDecimalSplitThreshold) {
+    uword temp_digits[kDecimalSplitThreshold];
+    for (word i = 0; i < num_digits; ++i) {
+      temp_digits[i] = value.digitAt(i);
+    }
+    start = writeUnsignedDecimalDigits(buffer_end, temp_digits, num_digits);
+  } else {
+    // Pick the largest power with about half as many digits as `value`.
+    HandleScope scope(thread);
+    Runtime* runtime = thread->runtime();
+    Int power(&scope, powers.at(0));
+    word k = 0;
+    while (power.numDigits() * 4 <= num_digits) {
+      if (k + 1 == powers.numItems()) {
+        Object square(&scope, runtime->intMultiply(thread, power, power));
+        runtime->listAdd(thread, powers, square);
+      }
+      power = powers.at(++k);
+    }
+    Object quotient(&scope, NoneType::object());
+    Object remainder(&scope, NoneType::object());
+    bool success =
+        runtime->intDivideModulo(thread, value, power, &quotient, &remainder);
+    DCHECK(success, "division by a power of ten must succeed");
+    word low_length = kUwordDigits10 << k;
+    Int low(&scope, *remainder);
+    Int high(&scope, *quotient);
+    start = writeNonNegativeIntDecimalDigits(thread, low, low_length, powers,
+                                             buffer_end);
+    if (!high.isZero() || min_length > low_length) {
+      start = writeNonNegativeIntDecimalDigits(
+          thread, high, min_length - low_length, powers, start);
+    }
+  }
+  while (buffer_end - start < min_length) {
+    *--start = '0';
+  }
+  return start;
+}
+
+static byte* writeLargeIntDecimalDigits(Thread* thread, byte* buffer_end,
+                                        const LargeInt& value) {
+  word num_digits = value.numDigits();
+  if (num_digits > kDecimalSplitThreshold) {
+    HandleScope scope(thread);
+    Runtime* runtime = thread->runtime();
+    Int magnitude(&scope, *value);
+    if (value.isNegative()) {
+      magnitude = runtime->intNegate(thread, magnitude);
+    }
+    List powers(&scope, runtime->newList());
+    Object power(&scope, runtime->newIntFromUnsigned(kUwordDigits10Pow));
+    runtime->listAdd(thread, powers, power);
+    return writeNonNegativeIntDecimalDigits(thread, magnitude, 0, powers,
+                                            buffer_end);
+  }
+
   // Allocate space for intermediate results. We also convert a negative number
   // to a positive number of the same magnitude here.
-  word num_digits = value.numDigits();
   std::unique_ptr<uword[]> temp_digits(new uword[num_digits]);
   bool negative = value.isNegative();
   if (!negative) {
@@ -593,33 +702,7 @@ static byte* writeLargeIntDecimalDigits(byte* buffer_end, RawLargeInt value) {
     // cannot overflow.
     DCHECK(carry == 0, "overflow");
   }
-  word num_temp_digits = num_digits;
-
-  // The strategy here is to divide the large integer by continually dividing it
-  // by `kUwordDigits10Pow`. `uwordToDecimal` can convert those remainders to
-  // decimal digits.
-  //
-  // TODO(matthiasb): Future optimization ideas:
-  // It seems cpythons algorithm is faster (for big numbers) in practive.
-  // Their source claims it is (Knuth TAOCP, vol 2, section 4.4, method 1b).
-  byte* start = buffer_end;
-  do {
-    uword remainder = divIntSingleDigit(temp_digits.get(), temp_digits.get(),
-                                        num_temp_digits, kUwordDigits10Pow);
-    byte* new_start = uwordToDecimal(remainder, start);
-
-    while (num_temp_digits > 0 && temp_digits[num_temp_digits - 1] == 0) {
-      num_temp_digits--;
-    }
-    // Produce leading zeros if this wasn't the last round.
-    if (num_temp_digits > 0) {
-      for (word i = 0, n = kUwordDigits10 - (start - new_start); i < n; i++) {
-        *--new_start = '0';
-      }
-    }
-    start = new_start;
-  } while (num_temp_digits > 0);
-  return start;
+  return writeUnsignedDecimalDigits(buffer_end, temp_digits.get(), num_digits);
 }
 
 RawObject formatIntDecimalSimple(Thread* thread, const Int& value) {
@@ -635,13 +718,14 @@ RawObject formatIntDecimalSimple(Thread* thread, const Int& value) {
     return thread->runtime()->newStrWithAll(View<byte>(start, end - start));
   }
 
-  RawLargeInt value_large = LargeInt::cast(*value);
+  HandleScope scope(thread);
+  LargeInt value_large(&scope, *value);
   bool is_negative = value_large.isNegative();
   word max_chars =
-      estimateNumDecimalDigits(value_large) + (is_negative ? 1 : 0);
+      estimateNumDecimalDigits(*value_large) + (is_negative ? 1 : 0);
   std::unique_ptr<byte[]> buffer(new byte[max_chars]);
   byte* end = buffer.get() + max_chars;
-  byte* start = writeLargeIntDecimalDigits(end, value_large);
+  byte* start = writeLargeIntDecimalDigits(thread, end, value_large);
   if (is_negative) {
     *--start = '-';
   }
@@ -887,10 +971,12 @@ RawObject formatIntDecimal(Thread* thread, const Int& value,
   byte* digits;
   word result_n_digits;
   if (value.isLargeInt()) {
-    word max_chars = estimateNumDecimalDigits(LargeInt::cast(*value));
+    HandleScope scope(thread);
+    LargeInt value_large(&scope, *value);
+    word max_chars = estimateNumDecimalDigits(*value_large);
     buffer = new byte[max_chars];
     byte* end = buffer + max_chars;
-    digits = writeLargeIntDecimalDigits(end, LargeInt::cast(*value));
+    digits = writeLargeIntDecimalDigits(thread, end, value_large);
     result_n_digits = end - digits;
   } else {
     buffer = fixed_buffer;
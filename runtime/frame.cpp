@@ -59,6 +59,12 @@ RawObject frameLocals(Thread* thread, Frame* frame) {
     // TODO(T89882231) Remove check when we can verify locals have been
     // initialized
     if (value.isInternal()) continue;
+    if (value.isStrArray()) {
+      // Locals extended with `+=` may hold a str builder; finish it.
+      StrArray array(&scope, *value);
+      value = runtime->strFromStrArray(array);
+      frame->setLocal(i, *value);
+    }
     dictAtPutByStr(thread, result, name, value);
   }
   for (word i = 0, j = var_names_length; i < freevar_names_length; ++i, ++j) {
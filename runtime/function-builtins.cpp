@@ -53,6 +53,10 @@ static const BuiltinAttribute kFunctionAttributes[] = {
     {ID(_function__dict), RawFunction::kDictOffset, AttributeFlags::kHidden},
     {ID(_function__intrinsic), RawFunction::kIntrinsicOffset,
      AttributeFlags::kHidden},
+    {ID(_function__jit_deopt_count), RawFunction::kJitDeoptCountOffset,
+     AttributeFlags::kHidden},
+    {ID(_function__jit_deopts), RawFunction::kJitDeoptsOffset,
+     AttributeFlags::kHidden},
 };
 
 static const BuiltinAttribute kBoundMethodAttributes[] = {
@@ -236,7 +236,8 @@ class HandleBenchmark : public benchmark::Fixture {
     Interpreter* interpreter = createCppInterpreter();
     RandomState random_state = randomStateFromSeed(0);
     runtime_ = new Runtime(heap_size, interpreter, random_state,
-                           StdioState::kBuffered);
+                           StdioState::kBuffered,
+                           StrHashAlgorithm::kSiphash24);
   }
 
   void TearDown(benchmark::State&) { delete runtime_; }
@@ -3,10 +3,13 @@
 
 #include <cmath>
 #include <limits>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "builtins.h"
+#include "formatter.h"
 #include "handles.h"
 #include "objects.h"
 #include "runtime.h"
@@ -850,6 +853,129 @@ TEST_F(IntBuiltinsTest, DunderMulWithPositiveNegativeLargeIntsReturnsLargeInt) {
   EXPECT_TRUE(isIntEqualsDigits(*result, expected_digits));
 }
 
+// Returns `2**(64 * num_digits) - 1`.
+static RawObject newAllOnesLargeInt(Runtime* runtime, word num_digits) {
+  std::vector<uword> digits(num_digits, kMaxUword);
+  digits.push_back(0);
+  return runtime->newLargeIntWithDigits(
+      {digits.data(), static_cast<word>(digits.size())});
+}
+
+// Returns the digits of `(2**(64 * m) - 1) * (2**(64 * n) - 1)` for `m >= n`.
+static std::vector<uword> allOnesProductDigits(word m, word n) {
+  std::vector<uword> digits;
+  digits.push_back(1);
+  digits.resize(n, 0);
+  digits.resize(m, kMaxUword);
+  digits.push_back(kMaxUword - 1);
+  digits.resize(m + n, kMaxUword);
+  digits.push_back(0);
+  return digits;
+}
+
+TEST_F(IntBuiltinsTest, DunderMulWithHugeLargeIntsReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int num(&scope, newAllOnesLargeInt(runtime_, 100));
+  Object result(&scope, runBuiltin(METH(int, __mul__), num, num));
+  std::vector<uword> expected_digits = allOnesProductDigits(100, 100);
+  EXPECT_TRUE(isIntEqualsDigits(
+      *result, {expected_digits.data(),
+                static_cast<word>(expected_digits.size())}));
+}
+
+TEST_F(IntBuiltinsTest, DunderMulWithHugeLopsidedLargeIntsReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int left(&scope, newAllOnesLargeInt(runtime_, 60));
+  Int right(&scope, newAllOnesLargeInt(runtime_, 301));
+  Object result(&scope, runBuiltin(METH(int, __mul__), left, right));
+  std::vector<uword> expected_digits = allOnesProductDigits(301, 60);
+  EXPECT_TRUE(isIntEqualsDigits(
+      *result, {expected_digits.data(),
+                static_cast<word>(expected_digits.size())}));
+}
+
+TEST_F(IntBuiltinsTest,
+       DunderMulWithHugeNegativePositiveLargeIntsReturnsLargeInt) {
+  HandleScope scope(thread_);
+
+  Int num(&scope, newAllOnesLargeInt(runtime_, 100));
+  Int negative(&scope, runBuiltin(METH(int, __neg__), num));
+  Object result(&scope, runBuiltin(METH(int, __mul__), negative, num));
+  // Negate the digits of the positive product.
+  std::vector<uword> expected_digits = allOnesProductDigits(100, 100);
+  uword carry = 1;
+  for (uword& digit : expected_digits) {
+    digit = ~digit + carry;
+    carry = carry != 0 && digit == 0;
+  }
+  EXPECT_TRUE(isIntEqualsDigits(
+      *result, {expected_digits.data(),
+                static_cast<word>(expected_digits.size())}));
+}
+
+// Returns `num_digits` pseudo-random digits with the top bit of the last
+// digit cleared, so that they form a positive number.
+static std::vector<uword> pseudoRandomDigits(word num_digits, uword seed) {
+  std::vector<uword> digits;
+  for (word i = 0; i < num_digits; i++) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    digits.push_back(seed);
+  }
+  digits.back() >>= 1;
+  return digits;
+}
+
+// Multiplies two positive numbers digit by digit and returns the normalized
+// digits of the product.
+static std::vector<uword> schoolbookProductDigits(
+    const std::vector<uword>& left, const std::vector<uword>& right) {
+  std::vector<uword> result(left.size() + right.size() + 1, 0);
+  for (size_t i = 0; i < left.size(); i++) {
+    uword carry = 0;
+    for (size_t j = 0; j < right.size(); j++) {
+      __uint128_t product = static_cast<__uint128_t>(left[i]) * right[j] +
+                            result[i + j] + carry;
+      result[i + j] = static_cast<uword>(product);
+      carry = static_cast<uword>(product >> 64);
+    }
+    result[i + right.size()] = carry;
+  }
+  while (result.size() > 1 && result.back() == 0 &&
+         static_cast<word>(result[result.size() - 2]) >= 0) {
+    result.pop_back();
+  }
+  return result;
+}
+
+TEST_F(IntBuiltinsTest,
+       DunderMulAroundKaratsubaThresholdMatchesSchoolbookProduct) {
+  HandleScope scope(thread_);
+
+  // Karatsuba is used once both operands have 40 or more digits.
+  const word sizes[][2] = {{39, 39}, {39, 40}, {40, 40}, {41, 40},
+                           {80, 80}, {81, 79}, {40, 121}, {97, 123}};
+  uword seed = 0x9e3779b97f4a7c15;
+  for (const auto& size : sizes) {
+    std::vector<uword> left_digits = pseudoRandomDigits(size[0], seed++);
+    std::vector<uword> right_digits = pseudoRandomDigits(size[1], seed++);
+    Int left(&scope, runtime_->newLargeIntWithDigits(
+                         {left_digits.data(),
+                          static_cast<word>(left_digits.size())}));
+    Int right(&scope, runtime_->newLargeIntWithDigits(
+                          {right_digits.data(),
+                           static_cast<word>(right_digits.size())}));
+    Object result(&scope, runBuiltin(METH(int, __mul__), left, right));
+    std::vector<uword> expected_digits =
+        schoolbookProductDigits(left_digits, right_digits);
+    EXPECT_TRUE(isIntEqualsDigits(
+        *result, {expected_digits.data(),
+                  static_cast<word>(expected_digits.size())}))
+        << size[0] << "x" << size[1];
+  }
+}
+
 TEST_F(IntBuiltinsTest, DunderMulWithNonIntSelfRaisesTypeError) {
   HandleScope scope(thread_);
 
@@ -2331,6 +2457,35 @@ TEST_F(IntBuiltinsTest, DunderReprWithLargeIntCarriesReturnsStr) {
       isStrEqualsCStr(*result, "-170141183460469231731687303715884105729"));
 }
 
+// Returns `10**exponent`.
+static RawObject newPowerOfTen(Thread* thread, word exponent) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Int result(&scope, SmallInt::fromWord(1));
+  Int ten(&scope, SmallInt::fromWord(10));
+  for (word i = 0; i < exponent; i++) {
+    result = runtime->intMultiply(thread, result, ten);
+  }
+  return *result;
+}
+
+TEST_F(IntBuiltinsTest, DunderReprWithHugeLargeIntReturnsStr) {
+  HandleScope scope(thread_);
+  Int power(&scope, newPowerOfTen(thread_, 3000));
+  Object result(&scope, runBuiltin(METH(int, __repr__), power));
+  std::string expected = "1" + std::string(3000, '0');
+  EXPECT_TRUE(isStrEqualsCStr(*result, expected.c_str()));
+
+  // Subtracting one turns every digit into a 9, including the ones that are
+  // padded with zeros in `power`.
+  Int one(&scope, SmallInt::fromWord(1));
+  Int nines(&scope, runtime_->intSubtract(thread_, power, one));
+  Int negative(&scope, runtime_->intNegate(thread_, nines));
+  result = runBuiltin(METH(int, __repr__), negative);
+  expected = "-" + std::string(3000, '9');
+  EXPECT_TRUE(isStrEqualsCStr(*result, expected.c_str()));
+}
+
 TEST_F(IntBuiltinsTest, DunderReprWithIntSubclassReturnsStr) {
   HandleScope scope(thread_);
   ASSERT_FALSE(runFromCStr(runtime_, R"(
@@ -3191,5 +3346,30 @@ TEST_F(IntBuiltinsTest, CompareWithBigNegativeNumber) {
   EXPECT_GT(b.compare(*a), 0);
 }
 
+TEST_F(IntBuiltinsTest, IntFromDigitsWithFewDigitsReturnsSmallInt) {
+  const byte digits[] = {1, 2, 0, 9};
+  EXPECT_TRUE(isIntEqualsWord(intFromDigits(thread_, digits, 4, 10), 1209));
+  EXPECT_TRUE(isIntEqualsWord(intFromDigits(thread_, digits, 4, 16), 0x1209));
+}
+
+TEST_F(IntBuiltinsTest, IntFromDigitsWithUwordDigitsReturnsLargeInt) {
+  // 18446744073709551615 is the largest uword.
+  const byte digits[] = {1, 8, 4, 4, 6, 7, 4, 4, 0, 7,
+                         3, 7, 0, 9, 5, 5, 1, 6, 1, 5};
+  const uword expected_digits[] = {kMaxUword, 0};
+  EXPECT_TRUE(isIntEqualsDigits(
+      intFromDigits(thread_, digits, ARRAYSIZE(digits), 10), expected_digits));
+}
+
+TEST_F(IntBuiltinsTest, IntFromDigitsWithManyDigitsReturnsLargeInt) {
+  HandleScope scope(thread_);
+  std::vector<byte> digits(3001, 0);
+  digits[0] = 1;
+  Int result(&scope,
+             intFromDigits(thread_, digits.data(), digits.size(), 10));
+  Int expected(&scope, newPowerOfTen(thread_, 3000));
+  EXPECT_EQ(result.compare(*expected), 0);
+}
+
 }  // namespace testing
 }  // namespace py
@@ -4,6 +4,7 @@
 #include <cinttypes>
 #include <climits>
 #include <cmath>
+#include <memory>
 
 #include "builtins.h"
 #include "bytes-builtins.h"
@@ -1070,6 +1071,112 @@ bool doubleEqualsInt(Thread* thread, double left, const Int& right) {
   return rounding == NoRounding && left == right_double;
 }
 
+// Inputs with more uword sized chunks than this are split in halves.
+static const word kIntFromDigitsSplitThreshold = 32;
+
+// Converts `digits` by folding one uword sized chunk of digits at a time into
+// the result. This is quadratic in the number of chunks.
+static RawObject intFromDigitsSchoolbook(Thread* thread, const byte* digits,
+                                         word num_digits, word base,
+                                         word chunk_length) {
+  word first_chunk_length = num_digits % chunk_length;
+  if (first_chunk_length == 0) first_chunk_length = chunk_length;
+  Runtime* runtime = thread->runtime();
+  if (num_digits == first_chunk_length) {
+    uword value = 0;
+    for (word i = 0; i < num_digits; i++) {
+      value = value * base + digits[i];
+    }
+    return runtime->newIntFromUnsigned(value);
+  }
+
+  // Every chunk adds at most one uword; reserve one more for the sign.
+  word max_length = (num_digits + chunk_length - 1) / chunk_length + 1;
+  std::unique_ptr<uword[]> words(new uword[max_length]);
+  word length = 0;
+  for (word i = 0, end = first_chunk_length; i < num_digits;
+       end += chunk_length) {
+    uword chunk = 0;
+    uword multiplier = 1;
+    for (; i < end; i++) {
+      chunk = chunk * base + digits[i];
+      multiplier *= base;
+    }
+    uword carry = chunk;
+    for (word w = 0; w < length; w++) {
+      auto product =
+          __extension__ static_cast<unsigned __int128>(words[w]) * multiplier +
+          carry;
+      words[w] = static_cast<uword>(product);
+      carry = static_cast<uword>(product >> kBitsPerWord);
+    }
+    if (carry != 0) words[length++] = carry;
+  }
+  words[length++] = 0;
+  HandleScope scope(thread);
+  LargeInt result(&scope, runtime->createLargeInt(length));
+  for (word w = 0; w < length; w++) {
+    result.digitAtPut(w, words[w]);
+  }
+  return runtime->normalizeLargeInt(thread, result);
+}
+
+// Converts `digits` as `high * base**low_length + low` where `low` is made of
+// the last `chunk_length * 2**k` digits. `powers` caches
+// `base**(chunk_length * 2**k)` at index `k`.
+static RawObject intFromDigitsRecursive(Thread* thread, const byte* digits,
+                                        word num_digits, word base,
+                                        word chunk_length, const List& powers) {
+  word num_chunks = (num_digits + chunk_length - 1) / chunk_length;
+  if (num_chunks <= kIntFromDigitsSplitThreshold) {
+    return intFromDigitsSchoolbook(thread, digits, num_digits, base,
+                                   chunk_length);
+  }
+  word k = 0;
+  while ((word{2} << k) < num_chunks) k++;
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  while (powers.numItems() <= k) {
+    Int last(&scope, powers.at(powers.numItems() - 1));
+    Object square(&scope, runtime->intMultiply(thread, last, last));
+    runtime->listAdd(thread, powers, square);
+  }
+  word low_length = chunk_length << k;
+  word high_length = num_digits - low_length;
+  Int high(&scope, intFromDigitsRecursive(thread, digits, high_length, base,
+                                          chunk_length, powers));
+  Int low(&scope, intFromDigitsRecursive(thread, digits + high_length,
+                                         low_length, base, chunk_length,
+                                         powers));
+  Int power(&scope, powers.at(k));
+  high = runtime->intMultiply(thread, high, power);
+  return runtime->intAdd(thread, high, low);
+}
+
+RawObject intFromDigits(Thread* thread, const byte* digits, word num_digits,
+                        word base) {
+  DCHECK(base >= 2 && base <= 36, "invalid base");
+  DCHECK(num_digits > 0, "expected at least one digit");
+  // Find the longest run of digits whose value always fits into a uword.
+  word chunk_length = 1;
+  uword chunk_power = base;
+  while (chunk_power <= kMaxUword / base) {
+    chunk_power *= base;
+    chunk_length++;
+  }
+  if (num_digits <= chunk_length * kIntFromDigitsSplitThreshold) {
+    return intFromDigitsSchoolbook(thread, digits, num_digits, base,
+                                   chunk_length);
+  }
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List powers(&scope, runtime->newList());
+  Object power(&scope, runtime->newIntFromUnsigned(chunk_power));
+  runtime->listAdd(thread, powers, power);
+  return intFromDigitsRecursive(thread, digits, num_digits, base, chunk_length,
+                                powers);
+}
+
 RawObject intFromIndex(Thread* thread, const Object& obj) {
   Runtime* runtime = thread->runtime();
   if (runtime->isInstanceOfInt(*obj)) {
@@ -30,6 +30,13 @@ bool compareDoubleWithInt(Thread* thread, double left, const Int& right,
 bool intDivmodNear(Thread* thread, const Int& dividend, const Int& divisor,
                    Object* quotient, Object* remainder);
 
+// Returns the non-negative int whose digits in `base` are `digits`, most
+// significant first. The bytes are digit values below `base`, not characters.
+// Long inputs are split in halves joined by a multiplication, which makes the
+// conversion subquadratic.
+RawObject intFromDigits(Thread* thread, const byte* digits, word num_digits,
+                        word base);
+
 // Converts obj into an integer using __index__. Equivalent to `PyNumber_Index`.
 // Returns obj if obj is an instance of Int. Raises a TypeError if a non-Int obj
 // does not have __index__ or if __index__ returns non-int.
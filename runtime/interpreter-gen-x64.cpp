@@ -8,12 +8,14 @@
 
 #include "assembler-x64.h"
 #include "bytecode.h"
+#include "dict-builtins.h"
 #include "event.h"
 #include "frame.h"
 #include "ic.h"
 #include "interpreter.h"
 #include "memory-region.h"
 #include "os.h"
+#include "profiling.h"
 #include "register-state.h"
 #include "runtime.h"
 #include "thread.h"
@@ -187,7 +189,9 @@ struct EmitEnv {
   RegisterState register_state;
   word handler_offset;
   word counting_handler_offset;
+  word profiling_handler_offset;
   bool count_opcodes;
+  bool profile_opcodes = false;
   bool in_jit = false;
 };
 
@@ -3063,6 +3067,11 @@ void emitInterpreter(EmitEnv* env) {
   env->count_opcodes = true;
   env->counting_handler_offset = emitHandlerTable(env);
 
+  env->count_opcodes = false;
+  env->profile_opcodes = true;
+  env->profiling_handler_offset = emitHandlerTable(env);
+  env->profile_opcodes = false;
+
   emitSharedCode(env);
   env->register_state.reset();
 }
@@ -3347,6 +3356,21 @@ void emitBeforeHandler(EmitEnv* env) {
   }
 }
 
+// Record the current opcode with `profiling_opcode()` and continue in the
+// generic C++ handler. Everything but the thread and the handler base is
+// reloaded from memory after the call because the profiler may allocate.
+void emitProfilingHandler(EmitEnv* env) {
+  __ movq(kArgRegs[0], env->thread);
+  CHECK(env->oparg == kArgRegs[1], "oparg expect to be in rsi");
+  emitSaveInterpreterState(env, kVMPC | kVMStack | kVMFrame);
+  emitCall<word (*)(Thread*, word)>(env, profiling_opcode);
+  emitRestoreInterpreterState(env, kGenericHandler);
+  env->register_state.assign(&env->oparg, kOpargReg);
+  __ movq(env->oparg, kReturnRegs[0]);
+  env->register_state.check(env->handler_assignment);
+  __ jmp(genericHandlerLabel(env), Assembler::kFarJump);
+}
+
 word emitHandlerTable(EmitEnv* env) {
   // UNWIND pseudo-handler
   static_assert(static_cast<int>(Interpreter::Continue::UNWIND) == 1,
@@ -3444,8 +3468,12 @@ word emitHandlerTable(EmitEnv* env) {
     env->current_handler = #name;                                              \
     HandlerSizer sizer(env, kHandlerSize);                                     \
     env->register_state.resetTo(env->handler_assignment);                      \
-    emitBeforeHandler(env);                                                    \
-    emitHandler<name>(env);                                                    \
+    if (env->profile_opcodes && name != EXTENDED_ARG) {                        \
+      emitProfilingHandler(env);                                               \
+    } else {                                                                   \
+      emitBeforeHandler(env);                                                  \
+      emitHandler<name>(env);                                                  \
+    }                                                                          \
   }
   FOREACH_BYTECODE(BC)
 #undef BC
@@ -3511,6 +3539,7 @@ class X64Interpreter : public Interpreter {
   void setupThread(Thread* thread) override;
   void* entryAsm(const Function& function) override;
   void setOpcodeCounting(bool enabled) override;
+  void setBytecodeProfiling(bool enabled) override;
 
  private:
   byte* code_;
@@ -3523,7 +3552,9 @@ class X64Interpreter : public Interpreter {
 
   void* default_handler_table_ = nullptr;
   void* counting_handler_table_ = nullptr;
+  void* profiling_handler_table_ = nullptr;
   bool count_opcodes_ = false;
+  bool profile_opcodes_ = false;
 };
 
 X64Interpreter::X64Interpreter() {
@@ -3552,20 +3583,30 @@ X64Interpreter::X64Interpreter() {
 
   default_handler_table_ = code_ + env.handler_offset;
   counting_handler_table_ = code_ + env.counting_handler_offset;
+  profiling_handler_table_ = code_ + env.profiling_handler_offset;
 }
 
 X64Interpreter::~X64Interpreter() { OS::freeMemory(code_, size_); }
 
 void X64Interpreter::setupThread(Thread* thread) {
   thread->setInterpreterFunc(reinterpret_cast<Thread::InterpreterFunc>(code_));
-  thread->setInterpreterData(count_opcodes_ ? counting_handler_table_
-                                            : default_handler_table_);
+  void* handler_table = default_handler_table_;
+  if (profile_opcodes_) {
+    handler_table = profiling_handler_table_;
+  } else if (count_opcodes_) {
+    handler_table = counting_handler_table_;
+  }
+  thread->setInterpreterData(handler_table);
 }
 
 void X64Interpreter::setOpcodeCounting(bool enabled) {
   count_opcodes_ = enabled;
 }
 
+void X64Interpreter::setBytecodeProfiling(bool enabled) {
+  profile_opcodes_ = enabled;
+}
+
 void* X64Interpreter::entryAsm(const Function& function) {
   if (function.intrinsic() != nullptr) {
     return function_entry_with_intrinsic_;
@@ -3588,6 +3629,50 @@ void* X64Interpreter::entryAsm(const Function& function) {
 
 }  // namespace
 
+void jitRecordDeopt(Thread* thread, const Function& function, word pc) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  if (function.jitDeopts().isNoneType()) {
+    function.setJitDeopts(runtime->newDict());
+  }
+  Dict deopts(&scope, function.jitDeopts());
+  byte bc = MutableBytes::cast(function.rewrittenBytecode()).byteAt(pc);
+  Object key(&scope, SmallInt::fromWord(pc << kBitsPerByte | bc));
+  word key_hash = SmallInt::cast(*key).hash();
+  Object count(&scope, dictAt(thread, deopts, key, key_hash));
+  count = SmallInt::fromWord(count.isErrorNotFound()
+                                 ? 1
+                                 : SmallInt::cast(*count).value() + 1);
+  dictAtPut(thread, deopts, key, key_hash, count);
+
+  word total = function.jitDeoptCount() + 1;
+  function.setJitDeoptCount(total);
+  if (total >= kJitMaxDeopts) {
+    function.setFlags(function.flags() | Function::Flags::kJitBlacklisted);
+  }
+}
+
+RawObject jitDeoptStats(Thread* thread, const Function& function) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  List result(&scope, runtime->newList());
+  if (function.jitDeopts().isNoneType()) return *result;
+  Dict deopts(&scope, function.jitDeopts());
+  Object key(&scope, NoneType::object());
+  Object count(&scope, NoneType::object());
+  Object pc(&scope, NoneType::object());
+  Object name(&scope, NoneType::object());
+  Object entry(&scope, NoneType::object());
+  for (word i = 0; dictNextItem(deopts, &i, &key, &count);) {
+    word encoded = SmallInt::cast(*key).value();
+    pc = SmallInt::fromWord(encoded >> kBitsPerByte);
+    name = runtime->newStrFromCStr(kBytecodeNames[encoded & kMaxByte]);
+    entry = runtime->newTupleWith3(pc, name, count);
+    runtime->listAdd(thread, result, entry);
+  }
+  return *result;
+}
+
 static void deoptimizeCurrentFunction(Thread* thread) {
   EVENT(DEOPT_FUNCTION);
   Frame* frame = thread->currentFrame();
@@ -3596,6 +3681,7 @@ static void deoptimizeCurrentFunction(Thread* thread) {
   frame->setVirtualPC(frame->virtualPC() - kCodeUnitSize);
   HandleScope scope(thread);
   Function function(&scope, frame->function());
+  jitRecordDeopt(thread, function, frame->virtualPC());
   thread->runtime()->populateEntryAsm(function);
   function.setFlags(function.flags() & ~Function::Flags::kCompiled);
 }
@@ -3619,6 +3705,12 @@ bool canCompileFunction(Thread* thread, const Function& function) {
         unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get());
     return false;
   }
+  if (function.isJitBlacklisted()) {
+    std::fprintf(
+        stderr, "Could not compile '%s' (deoptimized too often)\n",
+        unique_c_ptr<char>(Str::cast(function.qualname()).toCStr()).get());
+    return false;
+  }
   HandleScope scope(thread);
   MutableBytes code(&scope, function.rewrittenBytecode());
   word num_opcodes = rewrittenBytecodeLength(code);
@@ -8,8 +8,20 @@ namespace py {
 
 class Interpreter;
 
+// Number of deoptimizations after which a function is no longer compiled.
+const word kJitMaxDeopts = 4;
+
 Interpreter* createAsmInterpreter();
 bool canCompileFunction(Thread* thread, const Function& function);
 void compileFunction(Thread* thread, const Function& function);
 
+// Records that the compiled code of `function` deoptimized at the guard of the
+// opcode at `pc`. Blacklists the function once it has deoptimized
+// `kJitMaxDeopts` times.
+void jitRecordDeopt(Thread* thread, const Function& function, word pc);
+
+// Returns a list of `(pc, opname, count)` tuples describing the
+// deoptimizations recorded for `function`.
+RawObject jitDeoptStats(Thread* thread, const Function& function);
+
 }  // namespace py
@@ -18,6 +18,7 @@
 #include "modules.h"
 #include "object-builtins.h"
 #include "objects.h"
+#include "profiling.h"
 #include "runtime.h"
 #include "str-builtins.h"
 #include "test-utils.h"
@@ -840,6 +841,148 @@ def non_type():
   EXPECT_TRUE(containsBytecode(function, CALL_FUNCTION));
 }
 
+TEST_F(InterpreterTest, CallFunctionTypeInitRecordsExpectedLayout) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self):
+    self.init_rest()
+  def init_rest(self):
+    self.x = 1
+    self.y = 2
+def foo(fn):
+  return fn()
+)")
+                   .isError());
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  Type type(&scope, mainModuleAt(runtime_, "C"));
+  Layout initial_layout(&scope, type.instanceLayout());
+  EXPECT_EQ(initial_layout.expectedLayout(), NoneType::object());
+
+  Object first(&scope, Interpreter::call1(thread_, function, type));
+  ASSERT_TRUE(first.isInstance());
+  EXPECT_TRUE(containsBytecode(function, CALL_FUNCTION_TYPE_INIT));
+  EXPECT_EQ(initial_layout.expectedLayout(), runtime_->layoutOf(*first));
+
+  Instance fresh(&scope, objectNew(thread_, type));
+  instancePreallocateOverflow(thread_, fresh, initial_layout);
+  EXPECT_EQ(fresh.layoutId(), initial_layout.id());
+  Tuple overflow(&scope,
+                 fresh.instanceVariableAt(initial_layout.overflowOffset()));
+  EXPECT_EQ(overflow.length(), 2);
+
+  Instance second(&scope, Interpreter::call1(thread_, function, type));
+  EXPECT_EQ(second.layoutId(), first.layoutId());
+  Str x(&scope, runtime_->newStrFromCStr("x"));
+  Str y(&scope, runtime_->newStrFromCStr("y"));
+  EXPECT_TRUE(isIntEqualsWord(instanceGetAttribute(thread_, second, x), 1));
+  EXPECT_TRUE(isIntEqualsWord(instanceGetAttribute(thread_, second, y), 2));
+}
+
+TEST_F(InterpreterTest, CallFunctionTypeInitGrowsInObjectAttributes) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self):
+    self.init_rest()
+  def init_rest(self):
+    self.x = 1
+    self.y = 2
+def foo(fn):
+  return fn()
+def bar(fn):
+  return fn()
+bar(C)
+)")
+                   .isError());
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  Function bar(&scope, mainModuleAt(runtime_, "bar"));
+  Type type(&scope, mainModuleAt(runtime_, "C"));
+  LayoutId initial_id = type.instanceLayoutId();
+  EXPECT_EQ(Layout::cast(type.instanceLayout()).numInObjectAttributes(), 0);
+
+  // The call to `bar` above recorded the expected layout; the second
+  // construction confirms it.
+  Object second(&scope, Interpreter::call1(thread_, foo, type));
+  ASSERT_TRUE(second.isInstance());
+  EXPECT_NE(type.instanceLayoutId(), initial_id);
+  EXPECT_EQ(Layout::cast(type.instanceLayout()).numInObjectAttributes(), 2);
+
+  Instance third(&scope, Interpreter::call1(thread_, foo, type));
+  EXPECT_TRUE(containsBytecode(foo, CALL_FUNCTION_TYPE_INIT));
+  Layout third_layout(&scope, runtime_->layoutOf(*third));
+  EXPECT_EQ(Tuple::cast(third_layout.overflowAttributes()).length(), 0);
+  EXPECT_EQ(Tuple::cast(third_layout.inObjectAttributes()).length(), 2);
+  Str x(&scope, runtime_->newStrFromCStr("x"));
+  Str y(&scope, runtime_->newStrFromCStr("y"));
+  EXPECT_TRUE(isIntEqualsWord(instanceGetAttribute(thread_, third, x), 1));
+  EXPECT_TRUE(isIntEqualsWord(instanceGetAttribute(thread_, third, y), 2));
+
+  // `bar` cached the constructor for the initial layout.
+  Object fourth(&scope, Interpreter::call1(thread_, bar, type));
+  EXPECT_EQ(fourth.layoutId(), third.layoutId());
+  EXPECT_TRUE(containsBytecode(bar, CALL_FUNCTION_TYPE_INIT));
+}
+
+TEST_F(InterpreterTest, CallFunctionTypeInitWithCollectedCachedLayoutRefills) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self):
+    pass
+class D:
+  def __init__(self):
+    pass
+def foo(fn):
+  return fn()
+foo(C)
+)")
+                   .isError());
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  ASSERT_TRUE(containsBytecode(foo, CALL_FUNCTION_TYPE_INIT));
+  LayoutId c_id = Type::cast(mainModuleAt(runtime_, "C")).instanceLayoutId();
+  ASSERT_FALSE(runFromCStr(runtime_, "del C").isError());
+  runtime_->collectGarbage();
+  ASSERT_FALSE(runtime_->layoutAt(c_id).isLayout());
+
+  Type type(&scope, mainModuleAt(runtime_, "D"));
+  Object result(&scope, Interpreter::call1(thread_, foo, type));
+  EXPECT_EQ(result.layoutId(), type.instanceLayoutId());
+  EXPECT_TRUE(containsBytecode(foo, CALL_FUNCTION_TYPE_INIT));
+}
+
+TEST_F(InterpreterTest,
+       CallFunctionTypeInitWithVaryingAttributesGrowsInObjectAttributesOnce) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __init__(self, n):
+    for i in range(n):
+      setattr(self, "a" + str(i), i)
+def foo(fn, n):
+  return fn(n)
+foo(C, 2)
+foo(C, 2)
+)")
+                   .isError());
+  Function foo(&scope, mainModuleAt(runtime_, "foo"));
+  Type type(&scope, mainModuleAt(runtime_, "C"));
+  EXPECT_TRUE(containsBytecode(foo, CALL_FUNCTION_TYPE_INIT));
+  Layout grown_layout(&scope, type.instanceLayout());
+  EXPECT_EQ(grown_layout.numGrowths(), 1);
+  EXPECT_EQ(grown_layout.numInObjectAttributes(), 2);
+
+  // Two more matching constructions with more attributes do not grow the
+  // layout again.
+  Object n(&scope, SmallInt::fromWord(4));
+  for (word i = 0; i < 3; i++) {
+    Object instance(&scope, Interpreter::call2(thread_, foo, type, n));
+    ASSERT_TRUE(instance.isInstance());
+  }
+  EXPECT_EQ(type.instanceLayout(), *grown_layout);
+  EXPECT_TRUE(containsBytecode(foo, CALL_FUNCTION_TYPE_INIT));
+}
+
 TEST_F(InterpreterTest,
        CallFunctionTypeInitWithNewDunderInitRewritesToCallFunction) {
   HandleScope scope(thread_);
@@ -2731,6 +2874,154 @@ TEST_F(InterpreterTest,
       "local variable 'var2' referenced before assignment"));
 }
 
+TEST_F(InterpreterTest, DoLoadFastStrFinishesStrArray) {
+  HandleScope scope(thread_);
+
+  Str str(&scope, runtime_->newStrFromCStr("hello world"));
+  StrArray array(&scope, runtime_->newStrArray());
+  runtime_->strArrayAddStr(thread_, array, str);
+  Tuple consts(&scope, runtime_->newTupleWith1(array));
+  Tuple names(&scope, runtime_->emptyTuple());
+  Locals locals;
+  locals.varcount = 1;
+  const byte bytecode[] = {
+      LOAD_CONST, 0, 0, 0, STORE_FAST,  0, 0, 0, LOAD_FAST_STR, 0, 0, 0,
+      LOAD_FAST,  0, 0, 0, BUILD_TUPLE, 2, 0, 0, RETURN_VALUE,  0, 0, 0,
+  };
+  Code code(&scope, newCodeWithBytesConstsNamesLocals(bytecode, consts, names,
+                                                      &locals));
+
+  Object result_obj(&scope, runCodeNoBytecodeRewriting(code));
+  ASSERT_TRUE(result_obj.isTuple());
+  Tuple result(&scope, *result_obj);
+  ASSERT_EQ(result.length(), 2);
+  EXPECT_TRUE(isStrEqualsCStr(result.at(0), "hello world"));
+  EXPECT_EQ(result.at(1), result.at(0));
+}
+
+TEST_F(InterpreterTest, DoInplaceAddStrBuilderWithShortStrsReturnsStr) {
+  HandleScope scope(thread_);
+
+  Object left(&scope, runtime_->newStrFromCStr("foo"));
+  Object right(&scope, runtime_->newStrFromCStr("bar"));
+  Tuple consts(&scope, runtime_->newTupleWith2(left, right));
+  const byte bytecode[] = {
+      LOAD_CONST,              0, 0, 0, LOAD_CONST,   1, 0, 0,
+      INPLACE_ADD_STR_BUILDER, 0, 0, 0, RETURN_VALUE, 0, 0, 0,
+  };
+  Code code(&scope, newCodeWithBytesConsts(bytecode, consts));
+
+  EXPECT_TRUE(isStrEqualsCStr(runCodeNoBytecodeRewriting(code), "foobar"));
+}
+
+TEST_F(InterpreterTest, DoInplaceAddStrBuilderAppendsLongStrsToStrArray) {
+  HandleScope scope(thread_);
+
+  Object left(&scope, runtime_->newStrFromCStr(
+                          "0123456789012345678901234567890123456789"));
+  Object right(&scope, runtime_->newStrFromCStr(
+                           "abcdefghijabcdefghijabcdefghijabcdefghij"));
+  Tuple consts(&scope, runtime_->newTupleWith2(left, right));
+  Tuple names(&scope, runtime_->emptyTuple());
+  Locals locals;
+  locals.varcount = 1;
+  const byte bytecode[] = {
+      LOAD_CONST,              0, 0, 0, STORE_FAST,    0, 0, 0,
+      LOAD_FAST_STR_BUILDER,   0, 0, 0, LOAD_CONST,    1, 0, 0,
+      INPLACE_ADD_STR_BUILDER, 0, 0, 0, STORE_FAST,    0, 0, 0,
+      LOAD_FAST_STR_BUILDER,   0, 0, 0, LOAD_CONST,    0, 0, 0,
+      INPLACE_ADD_STR_BUILDER, 0, 0, 0, STORE_FAST,    0, 0, 0,
+      LOAD_FAST,               0, 0, 0, LOAD_FAST_STR, 0, 0, 0,
+      BUILD_TUPLE,             2, 0, 0, RETURN_VALUE,  0, 0, 0,
+  };
+  Code code(&scope, newCodeWithBytesConstsNamesLocals(bytecode, consts, names,
+                                                      &locals));
+
+  Object result_obj(&scope, runCodeNoBytecodeRewriting(code));
+  ASSERT_TRUE(result_obj.isTuple());
+  Tuple result(&scope, *result_obj);
+  ASSERT_EQ(result.length(), 2);
+  EXPECT_TRUE(result.at(0).isStrArray());
+  EXPECT_TRUE(isStrEqualsCStr(result.at(1),
+                              "0123456789012345678901234567890123456789"
+                              "abcdefghijabcdefghijabcdefghijabcdefghij"
+                              "0123456789012345678901234567890123456789"));
+}
+
+TEST_F(InterpreterTest, DoLoadFastStrAfterOneLongAppendTakesOverStrArray) {
+  HandleScope scope(thread_);
+
+  Object left(&scope, runtime_->newStrFromCStr(
+                          "0123456789012345678901234567890123456789"));
+  Object right(&scope, runtime_->newStrFromCStr(
+                           "abcdefghijabcdefghijabcdefghijabcdefghij"));
+  Tuple consts(&scope, runtime_->newTupleWith2(left, right));
+  Tuple names(&scope, runtime_->emptyTuple());
+  Locals locals;
+  locals.varcount = 1;
+  const byte bytecode[] = {
+      LOAD_CONST,              0, 0, 0, STORE_FAST,    0, 0, 0,
+      LOAD_FAST_STR_BUILDER,   0, 0, 0, LOAD_CONST,    1, 0, 0,
+      INPLACE_ADD_STR_BUILDER, 0, 0, 0, STORE_FAST,    0, 0, 0,
+      LOAD_FAST,               0, 0, 0, LOAD_FAST_STR, 0, 0, 0,
+      BUILD_TUPLE,             2, 0, 0, RETURN_VALUE,  0, 0, 0,
+  };
+  Code code(&scope, newCodeWithBytesConstsNamesLocals(bytecode, consts, names,
+                                                      &locals));
+
+  Object result_obj(&scope, runCodeNoBytecodeRewriting(code));
+  ASSERT_TRUE(result_obj.isTuple());
+  Tuple result(&scope, *result_obj);
+  ASSERT_EQ(result.length(), 2);
+  ASSERT_TRUE(result.at(0).isStrArray());
+  StrArray array(&scope, result.at(0));
+  EXPECT_EQ(array.numItems(), 0);
+  EXPECT_EQ(array.items(), runtime_->emptyMutableBytes());
+  EXPECT_TRUE(isStrEqualsCStr(result.at(1),
+                              "0123456789012345678901234567890123456789"
+                              "abcdefghijabcdefghijabcdefghijabcdefghij"));
+}
+
+TEST_F(InterpreterTest, DoInplaceAddStrBuilderWithNonStrRaisesTypeError) {
+  HandleScope scope(thread_);
+
+  Str str(&scope, runtime_->newStrFromCStr("hello"));
+  StrArray array(&scope, runtime_->newStrArray());
+  runtime_->strArrayAddStr(thread_, array, str);
+  Object number(&scope, SmallInt::fromWord(1));
+  Tuple consts(&scope, runtime_->newTupleWith2(array, number));
+  const byte bytecode[] = {
+      LOAD_CONST,              0, 0, 0, LOAD_CONST,   1, 0, 0,
+      INPLACE_ADD_STR_BUILDER, 0, 0, 0, RETURN_VALUE, 0, 0, 0,
+  };
+  Code code(&scope, newCodeWithBytesConsts(bytecode, consts));
+
+  EXPECT_TRUE(raised(runCodeNoBytecodeRewriting(code), LayoutId::kTypeError));
+}
+
+TEST_F(InterpreterTest, StrBuilderLocalThatIsOnlyExtendedRuns) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def only_extended():
+  s = ""
+  for i in range(100):
+    s += "ab"
+  return 1
+def read_through_eval():
+  s = ""
+  for i in range(100):
+    s += "ab"
+  return eval("s")
+result0 = only_extended()
+result1 = read_through_eval()
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result0"), 1));
+  Object result1(&scope, mainModuleAt(runtime_, "result1"));
+  ASSERT_TRUE(result1.isStr());
+  EXPECT_EQ(Str::cast(*result1).length(), 200);
+}
+
 TEST_F(InterpreterTest, DoStoreFastReverseStoresValue) {
   HandleScope scope(thread_);
 
@@ -5430,6 +5721,96 @@ func()
   EXPECT_TRUE(20 < count && count < 40);
 }
 
+TEST_F(InterpreterTest, BytecodeProfilingCountsOpcodesAndSites) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def a(a, b):
+  return a + b
+def func():
+  return a(7, 88)
+)")
+                   .isError());
+  Object func(&scope, mainModuleAt(runtime_, "func"));
+  Object a(&scope, mainModuleAt(runtime_, "a"));
+
+  profiling_bytecode_enable(thread_);
+  word count_before = thread_->opcodeCount();
+  ASSERT_FALSE(Interpreter::call0(thread_, func).isError());
+  EXPECT_EQ(thread_->opcodeCount() - count_before, 9);
+  profiling_bytecode_disable(thread_);
+  ASSERT_FALSE(Interpreter::call0(thread_, func).isError());
+
+  EXPECT_EQ(thread_->opcodeCountFor(RETURN_VALUE), 2);
+  Dict profile(&scope, runtime_->bytecodeProfile());
+  EXPECT_EQ(profile.numItems(), 2);
+  MutableTuple counts(&scope,
+                      dictAt(thread_, profile, a, runtime_->hash(*a)));
+  EXPECT_EQ(counts.length(), 4);
+  for (word i = 0; i < counts.length(); i++) {
+    EXPECT_EQ(counts.at(i), SmallInt::fromWord(1));
+  }
+
+  Tuple results(&scope, profiling_bytecode_results(thread_));
+  ASSERT_EQ(results.length(), 3);
+  Dict opcodes(&scope, results.at(0));
+  Str return_value(&scope, runtime_->newStrFromCStr("RETURN_VALUE"));
+  EXPECT_TRUE(
+      isIntEqualsWord(dictAtByStr(thread_, opcodes, return_value), 2));
+  List sites(&scope, results.at(1));
+  EXPECT_EQ(sites.numItems(), 9);
+}
+
+TEST_F(InterpreterTest, BytecodeProfilingResultsWithFunctionWithoutCaches) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def func():
+  return 1
+)")
+                   .isError());
+  Function func(&scope, mainModuleAt(runtime_, "func"));
+  ASSERT_TRUE(func.caches().isNoneType());
+
+  profiling_bytecode_enable(thread_);
+  ASSERT_FALSE(Interpreter::call0(thread_, func).isError());
+  profiling_bytecode_disable(thread_);
+
+  Tuple results(&scope, profiling_bytecode_results(thread_));
+  ASSERT_EQ(results.length(), 3);
+  List sites(&scope, results.at(1));
+  EXPECT_EQ(sites.numItems(), 2);
+  List ic_sites(&scope, results.at(2));
+  EXPECT_EQ(ic_sites.numItems(), 0);
+}
+
+TEST_F(InterpreterTest, BytecodeProfilingWithCppInterpreterRecordsNothing) {
+  if (!useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+def func():
+  return 1
+)")
+                   .isError());
+  Object func(&scope, mainModuleAt(runtime_, "func"));
+
+  profiling_bytecode_enable(thread_);
+  EXPECT_TRUE(isIntEqualsWord(Interpreter::call0(thread_, func), 1));
+  profiling_bytecode_disable(thread_);
+
+  Dict profile(&scope, runtime_->bytecodeProfile());
+  EXPECT_EQ(profile.numItems(), 0);
+}
+
 TEST_F(InterpreterTest, FunctionCallWithNonFunctionRaisesTypeError) {
   HandleScope scope(thread_);
   Str not_a_func(&scope, Str::empty());
@@ -8333,6 +8714,82 @@ foo(1, 1)
   EXPECT_EQ(function.entryAsm(), entry_before);
 }
 
+TEST_F(JitTest, DeoptimizationRecordsFailedGuard) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+def foo(left, right):
+  return left + right
+
+# Rewrite BINARY_OP_ANAMORPHIC to BINARY_ADD_SMALLINT
+foo(1, 1)
+)")
+                   .isError());
+
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  compileFunction(thread_, function);
+  List stats(&scope, jitDeoptStats(thread_, function));
+  EXPECT_EQ(stats.numItems(), 0);
+  Object left_str(&scope, SmallStr::fromCStr("hello"));
+  Object right_str(&scope, SmallStr::fromCStr(" world"));
+  Function deopt_caller(
+      &scope, createTrampolineFunction2(thread_, left_str, right_str));
+  Object result(&scope, Interpreter::call0(thread_, deopt_caller));
+  EXPECT_TRUE(isStrEqualsCStr(*result, "hello world"));
+  EXPECT_FALSE(function.isCompiled());
+
+  EXPECT_EQ(function.jitDeoptCount(), 1);
+  EXPECT_FALSE(function.isJitBlacklisted());
+  stats = jitDeoptStats(thread_, function);
+  ASSERT_EQ(stats.numItems(), 1);
+  Tuple entry(&scope, stats.at(0));
+  EXPECT_TRUE(isIntEqualsWord(entry.at(0), 2 * kCodeUnitSize));
+  EXPECT_TRUE(isStrEqualsCStr(entry.at(1), "BINARY_ADD_SMALLINT"));
+  EXPECT_TRUE(isIntEqualsWord(entry.at(2), 1));
+}
+
+TEST_F(JitTest, RepeatedDeoptimizationBlacklistsFunction) {
+  if (useCppInterpreter()) {
+    GTEST_SKIP();
+  }
+  EXPECT_FALSE(runFromCStr(runtime_, R"(
+def foo(left, right):
+  return left + right
+
+# Rewrite BINARY_OP_ANAMORPHIC to BINARY_ADD_SMALLINT
+foo(1, 1)
+)")
+                   .isError());
+
+  HandleScope scope(thread_);
+  Function function(&scope, mainModuleAt(runtime_, "foo"));
+  word pc = 2 * kCodeUnitSize;
+  for (word i = 0; i < kJitMaxDeopts - 1; i++) {
+    jitRecordDeopt(thread_, function, pc);
+  }
+  EXPECT_FALSE(function.isJitBlacklisted());
+  ASSERT_TRUE(canCompileFunction(thread_, function));
+  compileFunction(thread_, function);
+  Object left_str(&scope, SmallStr::fromCStr("hello"));
+  Object right_str(&scope, SmallStr::fromCStr(" world"));
+  Function deopt_caller(
+      &scope, createTrampolineFunction2(thread_, left_str, right_str));
+  Object result(&scope, Interpreter::call0(thread_, deopt_caller));
+  EXPECT_TRUE(isStrEqualsCStr(*result, "hello world"));
+
+  EXPECT_EQ(function.jitDeoptCount(), kJitMaxDeopts);
+  EXPECT_TRUE(function.isJitBlacklisted());
+  EXPECT_FALSE(canCompileFunction(thread_, function));
+  List stats(&scope, jitDeoptStats(thread_, function));
+  ASSERT_EQ(stats.numItems(), 1);
+  Tuple entry(&scope, stats.at(0));
+  EXPECT_TRUE(isIntEqualsWord(entry.at(0), pc));
+  EXPECT_TRUE(isStrEqualsCStr(entry.at(1), "BINARY_ADD_SMALLINT"));
+  EXPECT_TRUE(isIntEqualsWord(entry.at(2), kJitMaxDeopts));
+}
+
 TEST_F(JitTest, BinarySubscrListReturnsItem) {
   if (useCppInterpreter()) {
     GTEST_SKIP();
@@ -10103,19 +10560,7 @@ instance = D()
 }
 
 // Benchmarks
-class InterpreterBenchmark : public benchmark::Fixture {
- public:
-  void SetUp(benchmark::State&) {
-    runtime_ = createTestRuntime();
-    thread_ = Thread::current();
-  }
-
-  void TearDown(benchmark::State&) { delete runtime_; }
-
- protected:
-  Runtime* runtime_;
-  Thread* thread_;
-};
+using InterpreterBenchmark = RuntimeBenchmarkFixture;
 
 BENCHMARK_F(InterpreterBenchmark, SimpleFunction)(benchmark::State& state) {
   EXPECT_FALSE(runFromCStr(runtime_, R"(
@@ -4403,6 +4403,38 @@ HANDLER_INLINE Continue Interpreter::doLoadFast(Thread* thread, word arg) {
   return Continue::NEXT;
 }
 
+HANDLER_INLINE Continue Interpreter::doLoadFastStr(Thread* thread, word arg) {
+  Frame* frame = thread->currentFrame();
+  RawObject value = frame->local(arg);
+  if (UNLIKELY(value.isStrArray())) {
+    // The local accumulated `+=` appends in a str builder; finish it so the
+    // builder never escapes the frame. An exactly sized builder turns into
+    // the str in place; the compiler never emits this opcode while the same
+    // builder is on the stack.
+    HandleScope scope(thread);
+    StrArray array(&scope, value);
+    word length = array.numItems();
+    if (length == array.capacity() && length > SmallStr::kMaxLength) {
+      value = MutableBytes::cast(array.items()).becomeStr();
+      array.setItems(thread->runtime()->emptyMutableBytes());
+      array.setNumItems(0);
+    } else {
+      value = thread->runtime()->strFromStrArray(array);
+    }
+    frame->setLocal(arg, value);
+  }
+  if (UNLIKELY(value.isErrorNotFound())) {
+    HandleScope scope(thread);
+    Str name(&scope, Tuple::cast(Code::cast(frame->code()).varnames()).at(arg));
+    thread->raiseWithFmt(LayoutId::kUnboundLocalError,
+                         "local variable '%S' referenced before assignment",
+                         &name);
+    return Continue::UNWIND;
+  }
+  thread->stackPush(value);
+  return Continue::NEXT;
+}
+
 HANDLER_INLINE Continue Interpreter::doLoadFastReverse(Thread* thread,
                                                        word arg) {
   Frame* frame = thread->currentFrame();
@@ -4714,6 +4746,31 @@ Continue Interpreter::callFunctionTypeNewUpdateCache(Thread* thread, word arg,
   return doCallFunctionTypeNew(thread, arg);
 }
 
+// Returns true if the constructor cache at `cache` was filled for `type`
+// before its instance layout was replaced (see `typeGrowInstanceLayout()`),
+// or if the cached layout has been collected since.
+static bool isStaleConstructorCache(Thread* thread, RawMutableTuple caches,
+                                    word cache, RawType type) {
+  RawObject key = caches.at(cache * kIcPointersPerEntry + kIcEntryKeyOffset);
+  if (!key.isSmallInt()) return false;
+  LayoutId layout_id = static_cast<LayoutId>(SmallInt::cast(key).value());
+  RawObject layout = thread->runtime()->layoutAt(layout_id);
+  // Layouts are weakly referenced; a collected layout is never reused.
+  if (!layout.isLayout()) return true;
+  return Layout::cast(layout).describedType() == type;
+}
+
+// Clears a stale constructor cache and fills it again for the current
+// instance layout of the receiver.
+Continue Interpreter::retryCallFunctionTypeCached(Thread* thread, word arg,
+                                                  word cache) {
+  RawMutableTuple caches = MutableTuple::cast(thread->currentFrame()->caches());
+  word index = cache * kIcPointersPerEntry;
+  caches.atPut(index + kIcEntryKeyOffset, NoneType::object());
+  caches.atPut(index + kIcEntryValueOffset, NoneType::object());
+  return callFunctionTypeNewUpdateCache(thread, arg, cache);
+}
+
 HANDLER_INLINE Continue Interpreter::doCallFunctionTypeNew(Thread* thread,
                                                            word arg) {
   HandleScope scope(thread);
@@ -4733,6 +4790,10 @@ HANDLER_INLINE Continue Interpreter::doCallFunctionTypeNew(Thread* thread,
                           Type::cast(*receiver).instanceLayoutId(), &is_found));
   if (!is_found) {
     EVENT_CACHE(CALL_FUNCTION_TYPE_NEW);
+    if (isStaleConstructorCache(thread, *caches, cache,
+                                Type::cast(*receiver))) {
+      return retryCallFunctionTypeCached(thread, arg, cache);
+    }
     rewriteCurrentBytecode(frame, CALL_FUNCTION);
     return doCallFunction(thread, arg);
   }
@@ -4740,6 +4801,9 @@ HANDLER_INLINE Continue Interpreter::doCallFunctionTypeNew(Thread* thread,
   // cls as the first parameter, but specialized cached ctors such as
   // _str_ctor_obj need only take one argument: the arg to be converted. Avoid
   // the stack shuffle in the fast case.
+  // Unlike CALL_FUNCTION_TYPE_INIT, this does not predict the instance layout:
+  // the cached constructor allocates the instance itself, and the handler
+  // tail calls it, so there is no point to observe the finished instance.
   DCHECK(ctor.isFunction(), "cached is expected to be a function");
   thread->stackSetAt(callable_idx, *ctor);
   thread->stackInsertAt(callable_idx, *receiver);
@@ -4765,11 +4829,20 @@ HANDLER_INLINE Continue Interpreter::doCallFunctionTypeInit(Thread* thread,
                           Type::cast(*receiver).instanceLayoutId(), &is_found));
   if (!is_found) {
     EVENT_CACHE(CALL_FUNCTION_TYPE_INIT);
+    if (isStaleConstructorCache(thread, *caches, cache,
+                                Type::cast(*receiver))) {
+      return retryCallFunctionTypeCached(thread, arg, cache);
+    }
     rewriteCurrentBytecode(frame, CALL_FUNCTION);
     return doCallFunction(thread, arg);
   }
   Type type(&scope, *receiver);
-  Object instance(&scope, objectNew(thread, type));
+  Object new_object(&scope, objectNew(thread, type));
+  if (new_object.isErrorException()) return Continue::UNWIND;
+  Instance instance(&scope, *new_object);
+  Runtime* runtime = thread->runtime();
+  Layout initial_layout(&scope, type.instanceLayout());
+  instancePreallocateOverflow(thread, instance, initial_layout);
   DCHECK(init.isFunction(), "cached is expected to be a function");
   thread->stackSetAt(callable_idx, *init);
   thread->stackInsertAt(callable_idx, *instance);
@@ -4786,6 +4859,32 @@ HANDLER_INLINE Continue Interpreter::doCallFunctionTypeInit(Thread* thread,
     }
     return Continue::UNWIND;
   }
+  if (instance.layoutId() != initial_layout.id()) {
+    Layout final_layout(&scope, runtime->layoutOf(*instance));
+    if (initial_layout.expectedLayout() != *final_layout) {
+      initial_layout.setExpectedLayout(*final_layout);
+    } else if (final_layout.hasTupleOverflow() &&
+               type.instanceLayout() == *initial_layout) {
+      // Slack tracking: the second construction in a row ended up with the
+      // same overflow attributes, so reserve in-object slots for them in new
+      // instances of the type.
+      word num_overflow =
+          Tuple::cast(final_layout.overflowAttributes()).length();
+      word num_in_object = initial_layout.numInObjectAttributes();
+      if (num_overflow > 0 &&
+          initial_layout.numGrowths() < kMaxInstanceLayoutGrowths &&
+          num_in_object + num_overflow < RawHeader::kCountMax) {
+        typeGrowInstanceLayout(thread, type, num_overflow);
+        word index = cache * kIcPointersPerEntry;
+        if (caches.at(index + kIcEntryKeyOffset) ==
+            SmallInt::fromWord(static_cast<word>(initial_layout.id()))) {
+          caches.atPut(index + kIcEntryKeyOffset,
+                       SmallInt::fromWord(
+                           static_cast<word>(type.instanceLayoutId())));
+        }
+      }
+    }
+  }
   thread->stackPush(*instance);
   return Continue::NEXT;
 }
@@ -6102,6 +6201,60 @@ Continue Interpreter::doInplaceAddFloat(Thread* thread, word arg) {
   return inplaceOpUpdateCache(thread, arg, cache);
 }
 
+// Below this length `+=` produces a plain str; above it the result is kept in
+// an exactly sized StrArray. A read turns that array into a str in place, so
+// `+=` followed by a read costs one copy like a plain concat. A second `+=`
+// without a read in between grows the array geometrically, which makes
+// further appends to the same local amortized O(1).
+static const word kStrBuilderMinLength = 64;
+
+HANDLER_INLINE
+Continue Interpreter::doInplaceAddStrBuilder(Thread* thread, word) {
+  RawObject left_raw = thread->stackPeek(1);
+  RawObject right_raw = thread->stackPeek(0);
+  Runtime* runtime = thread->runtime();
+  HandleScope scope(thread);
+  if (right_raw.isStr()) {
+    Str right(&scope, right_raw);
+    if (left_raw.isStrArray()) {
+      StrArray array(&scope, left_raw);
+      runtime->strArrayAddStr(thread, array, right);
+      thread->stackDrop(1);
+      return Continue::NEXT;
+    }
+    if (left_raw.isStr()) {
+      Str left(&scope, left_raw);
+      word length = left.length() + right.length();
+      if (length < kStrBuilderMinLength) {
+        thread->stackDrop(1);
+        thread->stackSetTop(runtime->strConcat(thread, left, right));
+        return Continue::NEXT;
+      }
+      MutableBytes items(&scope, runtime->newMutableBytesUninitialized(length));
+      word left_length = left.length();
+      byte* dst = reinterpret_cast<byte*>(items.address());
+      left.copyTo(dst, left_length);
+      right.copyTo(dst + left_length, length - left_length);
+      StrArray array(&scope, runtime->newStrArray());
+      array.setItems(*items);
+      array.setNumItems(length);
+      thread->stackDrop(1);
+      thread->stackSetTop(*array);
+      return Continue::NEXT;
+    }
+  }
+  Object right(&scope, thread->stackPop());
+  Object left(&scope, thread->stackPop());
+  if (left.isStrArray()) {
+    StrArray array(&scope, *left);
+    left = runtime->strFromStrArray(array);
+  }
+  RawObject result = inplaceOperation(thread, BinaryOp::ADD, left, right);
+  if (result.isErrorException()) return Continue::UNWIND;
+  thread->stackPush(result);
+  return Continue::NEXT;
+}
+
 HANDLER_INLINE
 Continue Interpreter::doInplaceSubSmallInt(Thread* thread, word arg) {
   RawObject left = thread->stackPeek(1);
@@ -6679,6 +6832,7 @@ class CppInterpreter : public Interpreter {
   void setupThread(Thread* thread) override;
   void* entryAsm(const Function& function) override;
   void setOpcodeCounting(bool) override;
+  void setBytecodeProfiling(bool) override;
 
  private:
   static RawObject interpreterLoop(Thread* thread);
@@ -6696,6 +6850,10 @@ void CppInterpreter::setOpcodeCounting(bool) {
   UNIMPLEMENTED("opcode counting not supported by C++ interpreter");
 }
 
+void CppInterpreter::setBytecodeProfiling(bool) {
+  // The C++ interpreter has no profiling dispatch; the profile stays empty.
+}
+
 RawObject CppInterpreter::interpreterLoop(Thread* thread) {
   // Silence warnings about computed goto
 #pragma GCC diagnostic push
@@ -94,6 +94,11 @@ class Interpreter {
 
   virtual void setOpcodeCounting(bool enabled) = 0;
 
+  // Route every opcode through `profiling_opcode()` before executing it. This
+  // collects per-opcode and per-(function, pc) execution counts and implies
+  // opcode counting.
+  virtual void setBytecodeProfiling(bool enabled) = 0;
+
   static RawObject execute(Thread* thread);
   static RawObject resumeGenerator(Thread* thread,
                                    const GeneratorBase& generator,
@@ -439,6 +444,7 @@ class Interpreter {
   static Continue doInplaceAdd(Thread* thread, word arg);
   static Continue doInplaceAddSmallInt(Thread* thread, word arg);
   static Continue doInplaceAddFloat(Thread* thread, word arg);
+  static Continue doInplaceAddStrBuilder(Thread* thread, word arg);
   static Continue doInplaceAnd(Thread* thread, word arg);
   static Continue doInplaceFloorDivide(Thread* thread, word arg);
   static Continue doInplaceLshift(Thread* thread, word arg);
@@ -472,6 +478,7 @@ class Interpreter {
   static Continue doLoadDeref(Thread* thread, word arg);
   static Continue doLoadFast(Thread* thread, word arg);
   static Continue doLoadFastReverse(Thread* thread, word arg);
+  static Continue doLoadFastStr(Thread* thread, word arg);
   static Continue doLoadFastReverseUnchecked(Thread* thread, word arg);
   static Continue doLoadMethod(Thread* thread, word arg);
   static Continue doLoadMethodAnamorphic(Thread* thread, word arg);
@@ -642,6 +649,8 @@ class Interpreter {
 
   static Continue retryLoadAttrCached(Thread* thread, word arg, word cache);
   static Continue retryLoadMethodCached(Thread* thread, word arg, word cache);
+  static Continue retryCallFunctionTypeCached(Thread* thread, word arg,
+                                              word cache);
   static Continue loadAttrUpdateCache(Thread* thread, word arg, word cache);
   static Continue storeAttrUpdateCache(Thread* thread, word arg, word cache);
   static Continue storeSubscr(Thread* thread, RawObject set_item_method);
@@ -14,6 +14,8 @@ static const BuiltinAttribute kLayoutAttributes[] = {
     {ID(_layout__deletions), RawLayout::kDeletionsOffset},
     {ID(_layout__num_in_object_attributes),
      RawLayout::kNumInObjectAttributesOffset},
+    {ID(_layout__expected_layout), RawLayout::kExpectedLayoutOffset},
+    {ID(_layout__num_growths), RawLayout::kNumGrowthsOffset},
 };
 
 void initializeLayoutType(Thread* thread) {
@@ -1,6 +1,7 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "list-builtins.h"
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "builtins-module.h"
@@ -510,6 +511,76 @@ result = [1, 2, 3] * -3
   EXPECT_PYLIST_EQ(result, {});
 }
 
+TEST_F(ListBuiltinsTest, ReplicateListWithManyRepetitionsRepeatsItems) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(0, 3));
+  Object result(&scope, listReplicate(thread_, list, 7));
+  EXPECT_PYLIST_EQ(result, {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0,
+                            1, 2, 0, 1, 2});
+}
+
+TEST_F(ListBuiltinsTest, DunderImulWithManyRepetitionsRepeatsItems) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(1, 3));
+  Object times(&scope, SmallInt::fromWord(5));
+  Object result(&scope, runBuiltin(METH(list, __imul__), list, times));
+  ASSERT_EQ(*result, *list);
+  EXPECT_PYLIST_EQ(result, {1, 2, 1, 2, 1, 2, 1, 2, 1, 2});
+}
+
+TEST_F(ListBuiltinsTest, DunderImulWithDunderIndexRepeatsItems) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __index__(self):
+    return 3
+result = [1, 2]
+result *= C()
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object result(&scope, mainModuleAt(runtime_, "result"));
+  EXPECT_PYLIST_EQ(result, {1, 2, 1, 2, 1, 2});
+}
+
+TEST_F(ListBuiltinsTest, CountWithIdentityDoesNotCallDunderEq) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __eq__(self, other):
+    raise UserWarning("foo")
+c = C()
+result = [c, c, c].count(c)
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 3));
+}
+
+TEST_F(ListBuiltinsTest, CountPropagatesDunderEqException) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __eq__(self, other):
+    raise UserWarning("foo")
+list = [1, C()]
+)")
+                   .isError());
+  HandleScope scope(thread_);
+  Object list(&scope, mainModuleAt(runtime_, "list"));
+  Object value(&scope, SmallInt::fromWord(1));
+  EXPECT_TRUE(raisedWithStr(runBuiltin(METH(list, count), list, value),
+                            LayoutId::kUserWarning, "foo"));
+}
+
+TEST_F(ListBuiltinsTest, ListIndexReturnsFirstMatchInRange) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(0, 10));
+  Object value(&scope, SmallInt::fromWord(4));
+  EXPECT_TRUE(isIntEqualsWord(listIndex(thread_, list, value, 0, 10), 4));
+  EXPECT_TRUE(isIntEqualsWord(listIndex(thread_, list, value, 4, 5), 4));
+  EXPECT_TRUE(isIntEqualsWord(
+      listIndex(thread_, list, value, 2, SmallInt::kMaxValue), 4));
+  EXPECT_TRUE(isIntEqualsWord(listIndex(thread_, list, value, 5, 10), -1));
+  EXPECT_TRUE(isIntEqualsWord(listIndex(thread_, list, value, 0, 4), -1));
+}
+
 TEST_F(ListBuiltinsTest, SliceWithPositiveStepReturnsForwardsList) {
   HandleScope scope(thread_);
   List list1(&scope, listFromRange(1, 6));
@@ -1054,5 +1125,34 @@ l = [C()]
   EXPECT_EQ(ref.referent(), NoneType::object());
 }
 
+using ListBenchmark = RuntimeBenchmarkFixture;
+
+BENCHMARK_F(ListBenchmark, DunderMul)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(0, 16));
+  Object times(&scope, SmallInt::fromWord(1000));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runBuiltin(METH(list, __mul__), list, times));
+  }
+}
+
+BENCHMARK_F(ListBenchmark, Count)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(0, 1000));
+  Object value(&scope, SmallInt::fromWord(999));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runBuiltin(METH(list, count), list, value));
+  }
+}
+
+BENCHMARK_F(ListBenchmark, Index)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  List list(&scope, listFromRange(0, 1000));
+  Object value(&scope, SmallInt::fromWord(999));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(listIndex(thread_, list, value, 0, 1000));
+  }
+}
+
 }  // namespace testing
 }  // namespace py
@@ -27,6 +27,16 @@ void listExtend(Thread* thread, const List& dst, const Tuple& src,
   MutableTuple::cast(dst.items()).replaceFromWith(old_length, *src, src_length);
 }
 
+RawObject listIndex(Thread* thread, const List& list, const Object& value,
+                    word start, word stop) {
+  for (word i = start; i < Utils::minimum(stop, list.numItems()); i++) {
+    RawObject eq = Runtime::objectEquals(thread, list.at(i), *value);
+    if (eq == Bool::trueObj()) return SmallInt::fromWord(i);
+    if (eq.isErrorException()) return eq;
+  }
+  return SmallInt::fromWord(-1);
+}
+
 void listInsert(Thread* thread, const List& list, const Object& value,
                 word index) {
   thread->runtime()->listAdd(thread, list, value);
@@ -62,9 +72,8 @@ RawObject listReplicate(Thread* thread, const List& list, word ntimes) {
   HandleScope scope(thread);
   Tuple list_items(&scope, list.items());
   MutableTuple items(&scope, runtime->newMutableTuple(result_len));
-  for (word i = 0; i < result_len; i += len) {
-    items.replaceFromWith(i, *list_items, len);
-  }
+  items.replaceFromWith(0, *list_items, len);
+  tupleRepeatPrefix(items, len, ntimes);
   List result(&scope, runtime->newList());
   result.setItems(*items);
   result.setNumItems(result_len);
@@ -104,9 +113,6 @@ RawObject listSlice(Thread* thread, const List& list, word start, word stop,
   return *result;
 }
 
-// TODO(T63900795): Investigate this threshold on a realistic benchmark.
-static const int kListInsertionSortSize = 8;
-
 static RawObject objectLessThan(Thread* thread, const Object& left,
                                 const Object& right,
                                 const Object& compare_func) {
@@ -120,93 +126,623 @@ static RawObject objectLessThan(Thread* thread, const Object& left,
   return Interpreter::call2(thread, compare_func, left, right);
 }
 
-static RawObject listInsertionSort(Thread* thread, const MutableTuple& data,
-                                   const Object& compare_func, word start,
-                                   word end) {
-  HandleScope scope(thread);
-  Object item_i(&scope, NoneType::object());
-  Object item_j(&scope, NoneType::object());
-  Object compare_result(&scope, NoneType::object());
-  for (word i = start + 1; i < end; i++) {
-    item_i = data.at(i);
-    word j = i - 1;
-    for (; j >= start; j--) {
-      item_j = data.at(j);
-      compare_result = objectLessThan(thread, item_i, item_j, compare_func);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-      compare_result = Interpreter::isTrue(thread, *compare_result);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-      if (!Bool::cast(*compare_result).value()) {
+// The sort below is Timsort as described in CPython's
+// `Objects/listsort.txt`: it finds the natural runs in the input, extends
+// short runs to `minrun` items with binary insertion sort, and merges the
+// pending runs while keeping their lengths balanced. Merges switch to
+// galloping mode when one run keeps winning and only need temporary space for
+// the smaller of the two runs.
+
+// Initial threshold for entering galloping mode.
+static const word kSortMinGallop = 7;
+
+// Enough pending runs to sort lists of up to 2**64 items.
+static const word kSortMaxPendingRuns = 85;
+
+// Comparisons specialized for lists whose sort keys all have the same type.
+enum class SortKeyKind {
+  kGeneric,
+  kSmallInt,
+  kFloat,
+  kStr,
+};
+
+struct SortRun {
+  word base;
+  word length;
+};
+
+struct SortState {
+  Thread* thread;
+  // The items to sort.
+  MutableTuple* data;
+  // Temporary storage for merges; `None` until the first merge.
+  Object* temp;
+  // Comparison function used by `SortKeyKind::kGeneric`.
+  Object* compare_func;
+  SortKeyKind key_kind;
+  // Whether the items are `(key, value)` tuples created by `list.sort()`.
+  bool key_tuples;
+  word min_gallop;
+  word num_runs;
+  SortRun runs[kSortMaxPendingRuns];
+};
+
+static RawObject sortKey(SortState* state, RawObject item) {
+  return state->key_tuples ? Tuple::cast(item).at(0) : item;
+}
+
+static SortKeyKind sortKeyKind(SortState* state, word num_items) {
+  RawMutableTuple data = **state->data;
+  RawObject first = sortKey(state, data.at(0));
+  SortKeyKind kind;
+  if (first.isSmallInt()) {
+    kind = SortKeyKind::kSmallInt;
+  } else if (first.isFloat()) {
+    kind = SortKeyKind::kFloat;
+  } else if (first.isStr()) {
+    kind = SortKeyKind::kStr;
+  } else {
+    return SortKeyKind::kGeneric;
+  }
+  for (word i = 1; i < num_items; i++) {
+    RawObject key = sortKey(state, data.at(i));
+    bool same_kind = false;
+    switch (kind) {
+      case SortKeyKind::kSmallInt:
+        same_kind = key.isSmallInt();
+        break;
+      case SortKeyKind::kFloat:
+        same_kind = key.isFloat();
         break;
+      case SortKeyKind::kStr:
+        same_kind = key.isStr();
+        break;
+      case SortKeyKind::kGeneric:
+        UNREACHABLE("generic keys are rejected above");
+    }
+    if (!same_kind) return SortKeyKind::kGeneric;
+  }
+  return kind;
+}
+
+// Returns 1 if `left < right`, 0 if not, and -1 if the comparison raised an
+// exception.
+static word sortLessThan(SortState* state, const Object& left,
+                         const Object& right) {
+  switch (state->key_kind) {
+    case SortKeyKind::kSmallInt:
+      return SmallInt::cast(sortKey(state, *left)).value() <
+             SmallInt::cast(sortKey(state, *right)).value();
+    case SortKeyKind::kFloat:
+      return Float::cast(sortKey(state, *left)).value() <
+             Float::cast(sortKey(state, *right)).value();
+    case SortKeyKind::kStr:
+      return Str::cast(sortKey(state, *left))
+                 .compare(Str::cast(sortKey(state, *right))) < 0;
+    case SortKeyKind::kGeneric:
+      break;
+  }
+  Thread* thread = state->thread;
+  HandleScope scope(thread);
+  Object result(&scope,
+                objectLessThan(thread, left, right, *state->compare_func));
+  if (result.isErrorException()) return -1;
+  result = Interpreter::isTrue(thread, *result);
+  if (result.isErrorException()) return -1;
+  return result == Bool::trueObj();
+}
+
+// Sorts `data[lo:hi]` with binary insertion sort, given that `data[lo:start]`
+// is already sorted.
+static RawObject sortBinaryInsertion(SortState* state, word lo, word hi,
+                                     word start) {
+  HandleScope scope(state->thread);
+  MutableTuple data(&scope, **state->data);
+  Object pivot(&scope, NoneType::object());
+  Object item(&scope, NoneType::object());
+  for (; start < hi; start++) {
+    pivot = data.at(start);
+    word left = lo;
+    word right = start;
+    while (left < right) {
+      word middle = left + ((right - left) >> 1);
+      item = data.at(middle);
+      word is_less = sortLessThan(state, pivot, item);
+      if (is_less < 0) return Error::exception();
+      if (is_less) {
+        right = middle;
+      } else {
+        left = middle + 1;
       }
-      data.atPut(j + 1, *item_j);
     }
-    data.atPut(j + 1, *item_i);
+    data.replaceFromWithStartAt(left + 1, *data, start - left, left);
+    data.atPut(left, *pivot);
   }
   return NoneType::object();
 }
 
-// Merge 2 sublists, input[left: right], input[right: end] into
-// output[left: end].
-static RawObject listMerge(Thread* thread, const MutableTuple& input,
-                           const MutableTuple& output,
-                           const Object& compare_func, word left, word right,
-                           word end) {
-  HandleScope scope(thread);
-  Object item_i(&scope, NoneType::object());
-  Object item_j(&scope, NoneType::object());
-  Object compare_result(&scope, NoneType::object());
-  word i = left;
-  word j = right;
-  word k = left;
-  while (i < right && j < end) {
-    item_i = input.at(i);
-    item_j = input.at(j);
-    compare_result = objectLessThan(thread, item_j, item_i, compare_func);
-    if (compare_result.isError()) {
-      return *compare_result;
+// Returns the length of the run starting at `data[lo]`, which is either
+// non-descending or strictly descending. Returns -1 on error.
+static word sortCountRun(SortState* state, word lo, word hi,
+                         bool* descending) {
+  *descending = false;
+  if (lo + 1 == hi) return 1;
+  HandleScope scope(state->thread);
+  MutableTuple data(&scope, **state->data);
+  Object item(&scope, data.at(lo + 1));
+  Object previous(&scope, data.at(lo));
+  word is_less = sortLessThan(state, item, previous);
+  if (is_less < 0) return -1;
+  *descending = is_less;
+  word length = 2;
+  for (word i = lo + 2; i < hi; i++, length++) {
+    item = data.at(i);
+    previous = data.at(i - 1);
+    is_less = sortLessThan(state, item, previous);
+    if (is_less < 0) return -1;
+    if (is_less != *descending) break;
+  }
+  return length;
+}
+
+// Returns `k` such that `array[base + k - 1] < key <= array[base + k]`,
+// searching `array[base:base + length]` outwards from `base + hint`. Returns
+// -1 on error.
+static word sortGallopLeft(SortState* state, const Object& key,
+                           const MutableTuple& array, word base, word length,
+                           word hint) {
+  HandleScope scope(state->thread);
+  Object item(&scope, array.at(base + hint));
+  word last_offset = 0;
+  word offset = 1;
+  word is_less = sortLessThan(state, item, key);
+  if (is_less < 0) return -1;
+  if (is_less) {
+    // array[hint] < key: gallop right until
+    // array[hint + last_offset] < key <= array[hint + offset].
+    word max_offset = length - hint;
+    while (offset < max_offset) {
+      item = array.at(base + hint + offset);
+      is_less = sortLessThan(state, item, key);
+      if (is_less < 0) return -1;
+      if (!is_less) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
     }
-    compare_result = Interpreter::isTrue(thread, *compare_result);
-    if (compare_result.isError()) {
-      return *compare_result;
+    if (offset > max_offset) offset = max_offset;
+    last_offset += hint;
+    offset += hint;
+  } else {
+    // key <= array[hint]: gallop left until
+    // array[hint - offset] < key <= array[hint - last_offset].
+    word max_offset = hint + 1;
+    while (offset < max_offset) {
+      item = array.at(base + hint - offset);
+      is_less = sortLessThan(state, item, key);
+      if (is_less < 0) return -1;
+      if (is_less) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
     }
-    if (*compare_result == Bool::trueObj()) {
-      output.atPut(k++, *item_j);
-      j++;
+    if (offset > max_offset) offset = max_offset;
+    word tmp = last_offset;
+    last_offset = hint - offset;
+    offset = hint - tmp;
+  }
+  // Binary search with the invariant array[last_offset] < key <=
+  // array[offset].
+  last_offset++;
+  while (last_offset < offset) {
+    word middle = last_offset + ((offset - last_offset) >> 1);
+    item = array.at(base + middle);
+    is_less = sortLessThan(state, item, key);
+    if (is_less < 0) return -1;
+    if (is_less) {
+      last_offset = middle + 1;
     } else {
-      DCHECK(compare_result == Bool::falseObj(), "expected to be false");
-      output.atPut(k++, *item_i);
-      i++;
+      offset = middle;
     }
   }
-  for (; i < right; i++) {
-    output.atPut(k++, input.at(i));
+  return offset;
+}
+
+// Like `sortGallopLeft()`, but returns `k` such that
+// `array[base + k - 1] <= key < array[base + k]` so that equal items stay in
+// order.
+static word sortGallopRight(SortState* state, const Object& key,
+                            const MutableTuple& array, word base, word length,
+                            word hint) {
+  HandleScope scope(state->thread);
+  Object item(&scope, array.at(base + hint));
+  word last_offset = 0;
+  word offset = 1;
+  word is_less = sortLessThan(state, key, item);
+  if (is_less < 0) return -1;
+  if (is_less) {
+    // key < array[hint]: gallop left until
+    // array[hint - offset] <= key < array[hint - last_offset].
+    word max_offset = hint + 1;
+    while (offset < max_offset) {
+      item = array.at(base + hint - offset);
+      is_less = sortLessThan(state, key, item);
+      if (is_less < 0) return -1;
+      if (!is_less) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
+    }
+    if (offset > max_offset) offset = max_offset;
+    word tmp = last_offset;
+    last_offset = hint - offset;
+    offset = hint - tmp;
+  } else {
+    // array[hint] <= key: gallop right until
+    // array[hint + last_offset] <= key < array[hint + offset].
+    word max_offset = length - hint;
+    while (offset < max_offset) {
+      item = array.at(base + hint + offset);
+      is_less = sortLessThan(state, key, item);
+      if (is_less < 0) return -1;
+      if (is_less) break;
+      last_offset = offset;
+      offset = (offset << 1) + 1;
+    }
+    if (offset > max_offset) offset = max_offset;
+    last_offset += hint;
+    offset += hint;
+  }
+  // Binary search with the invariant array[last_offset] <= key <
+  // array[offset].
+  last_offset++;
+  while (last_offset < offset) {
+    word middle = last_offset + ((offset - last_offset) >> 1);
+    item = array.at(base + middle);
+    is_less = sortLessThan(state, key, item);
+    if (is_less < 0) return -1;
+    if (is_less) {
+      offset = middle;
+    } else {
+      last_offset = middle + 1;
+    }
+  }
+  return offset;
+}
+
+// Returns temporary storage for at least `length` items.
+static RawMutableTuple sortTemp(SortState* state, word length) {
+  Object* temp = state->temp;
+  if (temp->isNoneType() || MutableTuple::cast(**temp).length() < length) {
+    *temp = state->thread->runtime()->newMutableTuple(length);
+  }
+  return MutableTuple::cast(**temp);
+}
+
+// Merges the adjacent runs `data[base_a:base_a + length_a]` and
+// `data[base_b:base_b + length_b]` in place, given that `length_a <=
+// length_b`, that the first item of run B belongs before the first item of
+// run A, and that the last item of run A belongs after the last item of run B.
+static RawObject sortMergeLow(SortState* state, word base_a, word length_a,
+                              word base_b, word length_b) {
+  DCHECK(length_a > 0 && length_b > 0 && base_a + length_a == base_b,
+         "runs must be adjacent and non-empty");
+  HandleScope scope(state->thread);
+  MutableTuple data(&scope, **state->data);
+  MutableTuple temp(&scope, sortTemp(state, length_a));
+  Object item_a(&scope, NoneType::object());
+  Object item_b(&scope, NoneType::object());
+  temp.replaceFromWithStartAt(0, *data, length_a, base_a);
+  word dest = base_a;
+  word index_a = 0;
+  word index_b = base_b;
+  word min_gallop = state->min_gallop;
+  RawObject result = NoneType::object();
+
+  data.atPut(dest++, data.at(index_b++));
+  if (--length_b == 0) goto done;
+  if (length_a == 1) goto copy_b;
+
+  for (;;) {
+    // Merge one item at a time until one run wins `min_gallop` times in a row.
+    word count_a = 0;
+    word count_b = 0;
+    for (;;) {
+      item_a = temp.at(index_a);
+      item_b = data.at(index_b);
+      word is_less = sortLessThan(state, item_b, item_a);
+      if (is_less < 0) goto error;
+      if (is_less) {
+        data.atPut(dest++, *item_b);
+        index_b++;
+        count_b++;
+        count_a = 0;
+        if (--length_b == 0) goto done;
+        if (count_b >= min_gallop) break;
+      } else {
+        data.atPut(dest++, *item_a);
+        index_a++;
+        count_a++;
+        count_b = 0;
+        if (--length_a == 1) goto copy_b;
+        if (count_a >= min_gallop) break;
+      }
+    }
+
+    // Gallop until neither run wins `kSortMinGallop` times in a row.
+    min_gallop++;
+    do {
+      min_gallop -= min_gallop > 1;
+      state->min_gallop = min_gallop;
+      item_b = data.at(index_b);
+      word k = sortGallopRight(state, item_b, temp, index_a, length_a, 0);
+      if (k < 0) goto error;
+      count_a = k;
+      if (k > 0) {
+        data.replaceFromWithStartAt(dest, *temp, k, index_a);
+        dest += k;
+        index_a += k;
+        length_a -= k;
+        if (length_a == 1) goto copy_b;
+        // Only possible with an inconsistent comparison function.
+        if (length_a == 0) goto done;
+      }
+      data.atPut(dest++, data.at(index_b++));
+      if (--length_b == 0) goto done;
+
+      item_a = temp.at(index_a);
+      k = sortGallopLeft(state, item_a, data, index_b, length_b, 0);
+      if (k < 0) goto error;
+      count_b = k;
+      if (k > 0) {
+        data.replaceFromWithStartAt(dest, *data, k, index_b);
+        dest += k;
+        index_b += k;
+        length_b -= k;
+        if (length_b == 0) goto done;
+      }
+      data.atPut(dest++, temp.at(index_a++));
+      if (--length_a == 1) goto copy_b;
+    } while (count_a >= kSortMinGallop || count_b >= kSortMinGallop);
+    min_gallop++;
+    state->min_gallop = min_gallop;
   }
-  for (; j < end; j++) {
-    output.atPut(k++, input.at(j));
+
+error:
+  result = Error::exception();
+done:
+  // Put the remaining items of run A back so that the list stays a
+  // permutation of its items even if a comparison failed.
+  if (length_a > 0) {
+    data.replaceFromWithStartAt(dest, *temp, length_a, index_a);
   }
-  DCHECK(k == end, "sublists were not fully copied");
+  return result;
+
+copy_b:
+  DCHECK(length_a == 1 && length_b > 0, "unexpected run lengths");
+  data.replaceFromWithStartAt(dest, *data, length_b, index_b);
+  data.atPut(dest + length_b, temp.at(index_a));
   return NoneType::object();
 }
 
+// Like `sortMergeLow()`, but merges from the right and requires `length_a >=
+// length_b`.
+static RawObject sortMergeHigh(SortState* state, word base_a, word length_a,
+                               word base_b, word length_b) {
+  DCHECK(length_a > 0 && length_b > 0 && base_a + length_a == base_b,
+         "runs must be adjacent and non-empty");
+  HandleScope scope(state->thread);
+  MutableTuple data(&scope, **state->data);
+  MutableTuple temp(&scope, sortTemp(state, length_b));
+  Object item_a(&scope, NoneType::object());
+  Object item_b(&scope, NoneType::object());
+  temp.replaceFromWithStartAt(0, *data, length_b, base_b);
+  word dest = base_b + length_b - 1;
+  word index_a = base_a + length_a - 1;
+  word index_b = length_b - 1;
+  word min_gallop = state->min_gallop;
+  RawObject result = NoneType::object();
+
+  data.atPut(dest--, data.at(index_a--));
+  if (--length_a == 0) goto done;
+  if (length_b == 1) goto copy_a;
+
+  for (;;) {
+    word count_a = 0;
+    word count_b = 0;
+    for (;;) {
+      item_a = data.at(index_a);
+      item_b = temp.at(index_b);
+      word is_less = sortLessThan(state, item_b, item_a);
+      if (is_less < 0) goto error;
+      if (is_less) {
+        data.atPut(dest--, *item_a);
+        index_a--;
+        count_a++;
+        count_b = 0;
+        if (--length_a == 0) goto done;
+        if (count_a >= min_gallop) break;
+      } else {
+        data.atPut(dest--, *item_b);
+        index_b--;
+        count_b++;
+        count_a = 0;
+        if (--length_b == 1) goto copy_a;
+        if (count_b >= min_gallop) break;
+      }
+    }
+
+    min_gallop++;
+    do {
+      min_gallop -= min_gallop > 1;
+      state->min_gallop = min_gallop;
+      item_b = temp.at(index_b);
+      word k = sortGallopRight(state, item_b, data, base_a, length_a,
+                               length_a - 1);
+      if (k < 0) goto error;
+      k = length_a - k;
+      count_a = k;
+      if (k > 0) {
+        dest -= k;
+        index_a -= k;
+        data.replaceFromWithStartAt(dest + 1, *data, k, index_a + 1);
+        length_a -= k;
+        if (length_a == 0) goto done;
+      }
+      data.atPut(dest--, temp.at(index_b--));
+      if (--length_b == 1) goto copy_a;
+
+      item_a = data.at(index_a);
+      k = sortGallopLeft(state, item_a, temp, 0, length_b, length_b - 1);
+      if (k < 0) goto error;
+      k = length_b - k;
+      count_b = k;
+      if (k > 0) {
+        dest -= k;
+        index_b -= k;
+        data.replaceFromWithStartAt(dest + 1, *temp, k, index_b + 1);
+        length_b -= k;
+        if (length_b == 1) goto copy_a;
+        // Only possible with an inconsistent comparison function.
+        if (length_b == 0) goto done;
+      }
+      data.atPut(dest--, data.at(index_a--));
+      if (--length_a == 0) goto done;
+    } while (count_a >= kSortMinGallop || count_b >= kSortMinGallop);
+    min_gallop++;
+    state->min_gallop = min_gallop;
+  }
+
+error:
+  result = Error::exception();
+done:
+  if (length_b > 0) {
+    data.replaceFromWithStartAt(dest - (length_b - 1), *temp, length_b, 0);
+  }
+  return result;
+
+copy_a:
+  DCHECK(length_b == 1 && length_a > 0, "unexpected run lengths");
+  dest -= length_a;
+  index_a -= length_a;
+  data.replaceFromWithStartAt(dest + 1, *data, length_a, index_a + 1);
+  data.atPut(dest, temp.at(index_b));
+  return NoneType::object();
+}
+
+// Merges the pending runs at `index` and `index + 1`.
+static RawObject sortMergeAt(SortState* state, word index) {
+  DCHECK(index == state->num_runs - 2 || index == state->num_runs - 3,
+         "can only merge one of the last two pairs of runs");
+  word base_a = state->runs[index].base;
+  word length_a = state->runs[index].length;
+  word base_b = state->runs[index + 1].base;
+  word length_b = state->runs[index + 1].length;
+  state->runs[index].length = length_a + length_b;
+  if (index == state->num_runs - 3) {
+    state->runs[index + 1] = state->runs[index + 2];
+  }
+  state->num_runs--;
+
+  HandleScope scope(state->thread);
+  MutableTuple data(&scope, **state->data);
+  // Items of run A that are not greater than the first item of run B are
+  // already in place.
+  Object key(&scope, data.at(base_b));
+  word k = sortGallopRight(state, key, data, base_a, length_a, 0);
+  if (k < 0) return Error::exception();
+  base_a += k;
+  length_a -= k;
+  if (length_a == 0) return NoneType::object();
+  // Likewise for items of run B that are not less than the last item of A.
+  key = data.at(base_a + length_a - 1);
+  length_b =
+      sortGallopLeft(state, key, data, base_b, length_b, length_b - 1);
+  if (length_b < 0) return Error::exception();
+  if (length_b == 0) return NoneType::object();
+  if (length_a <= length_b) {
+    return sortMergeLow(state, base_a, length_a, base_b, length_b);
+  }
+  return sortMergeHigh(state, base_a, length_a, base_b, length_b);
+}
+
+// Merges pending runs until the run lengths satisfy the invariants from
+// `listsort.txt`, which keeps merges balanced.
+static RawObject sortMergeCollapse(SortState* state) {
+  SortRun* runs = state->runs;
+  while (state->num_runs > 1) {
+    word n = state->num_runs - 2;
+    if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length) ||
+        (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length)) {
+      if (runs[n - 1].length < runs[n + 1].length) n--;
+    } else if (runs[n].length > runs[n + 1].length) {
+      break;
+    }
+    RawObject result = sortMergeAt(state, n);
+    if (result.isErrorException()) return result;
+  }
+  return NoneType::object();
+}
+
+static RawObject sortMergeForceCollapse(SortState* state) {
+  SortRun* runs = state->runs;
+  while (state->num_runs > 1) {
+    word n = state->num_runs - 2;
+    if (n > 0 && runs[n - 1].length < runs[n + 1].length) n--;
+    RawObject result = sortMergeAt(state, n);
+    if (result.isErrorException()) return result;
+  }
+  return NoneType::object();
+}
+
+// Returns the minimum run length for `num_items` items, chosen such that
+// `num_items / minrun` is a power of 2 or slightly less.
+static word sortMinRun(word num_items) {
+  word remainder = 0;
+  while (num_items >= 64) {
+    remainder |= num_items & 1;
+    num_items >>= 1;
+  }
+  return num_items + remainder;
+}
+
+static RawObject sortItems(SortState* state, word num_items) {
+  word min_run = sortMinRun(num_items);
+  word lo = 0;
+  word remaining = num_items;
+  while (remaining > 0) {
+    bool descending;
+    word run_length = sortCountRun(state, lo, lo + remaining, &descending);
+    if (run_length < 0) return Error::exception();
+    if (descending) {
+      RawMutableTuple data = **state->data;
+      for (word i = lo, j = lo + run_length - 1; i < j; i++, j--) {
+        data.swap(i, j);
+      }
+    }
+    if (run_length < min_run) {
+      word forced = Utils::minimum(remaining, min_run);
+      RawObject result =
+          sortBinaryInsertion(state, lo, lo + forced, lo + run_length);
+      if (result.isErrorException()) return result;
+      run_length = forced;
+    }
+    DCHECK(state->num_runs < kSortMaxPendingRuns, "too many pending runs");
+    state->runs[state->num_runs++] = {lo, run_length};
+    RawObject result = sortMergeCollapse(state);
+    if (result.isErrorException()) return result;
+    lo += run_length;
+    remaining -= run_length;
+  }
+  return sortMergeForceCollapse(state);
+}
+
 RawObject listSort(Thread* thread, const List& list) {
   return listSortWithCompareMethod(thread, list, ID(_lt));
 }
 
-// This uses an adaptation of merge sort. It sorts sublists of size
-// kListInsertionSortSize or less using insertion sort first. Afterwards, it is
-// using a bottom-up merge sort to increase the sublists' size by power of 2.
-// Also, this function allocates a temporary space to ease merging and swaps
-// `input` and `output` to avoid further allocation.
-// TODO(T39107329): Consider using Timsort for further optimization.
 RawObject listSortWithCompareMethod(Thread* thread, const List& list,
                                     SymbolId compare_method) {
   word num_items = list.numItems();
-  if (num_items == 0) {
+  if (num_items < 2) {
     return NoneType::object();
   }
   HandleScope scope(thread);
@@ -214,37 +750,31 @@ RawObject listSortWithCompareMethod(Thread* thread, const List& list,
   Object compare_func(&scope, runtime->lookupNameInModule(thread, ID(_builtins),
                                                           compare_method));
   if (compare_func.isError()) return *compare_func;
-  MutableTuple input(&scope, list.items());
-  Object compare_result(&scope, NoneType::object());
-  for (word left = 0; left < num_items; left += kListInsertionSortSize) {
-    word right = Utils::minimum(left + kListInsertionSortSize, num_items);
-    compare_result =
-        listInsertionSort(thread, input, compare_func, left, right);
-    if (compare_result.isError()) {
-      return *compare_result;
-    }
+  // Detach the items while sorting so that comparisons that modify the list
+  // cannot corrupt the sort.
+  MutableTuple data(&scope, list.items());
+  Object empty(&scope, runtime->emptyTuple());
+  list.setItems(*empty);
+  list.setNumItems(0);
+  Object temp(&scope, NoneType::object());
+  SortState state;
+  state.thread = thread;
+  state.data = &data;
+  state.temp = &temp;
+  state.compare_func = &compare_func;
+  state.key_tuples = compare_method == ID(_lt_key);
+  state.key_kind = sortKeyKind(&state, num_items);
+  state.min_gallop = kSortMinGallop;
+  state.num_runs = 0;
+  Object result(&scope, sortItems(&state, num_items));
+  bool modified = list.numItems() != 0 || list.items() != *empty;
+  list.setItems(*data);
+  list.setNumItems(num_items);
+  if (result.isErrorException()) return *result;
+  if (modified) {
+    return thread->raiseWithFmt(LayoutId::kValueError,
+                                "list modified during sort");
   }
-  if (num_items <= kListInsertionSortSize) {
-    // The input list is small enough to be sorted by insertion sort.
-    return NoneType::object();
-  }
-  MutableTuple output(&scope, runtime->newMutableTuple(input.length()));
-  Object tmp(&scope, NoneType::object());
-  for (word width = kListInsertionSortSize; width < num_items; width *= 2) {
-    for (word left = 0; left < num_items; left += width * 2) {
-      word right = Utils::minimum(num_items, left + width);
-      word end = Utils::minimum(num_items, left + width * 2);
-      compare_result =
-          listMerge(thread, input, output, compare_func, left, right, end);
-      if (compare_result.isError()) {
-        return *compare_result;
-      }
-    }
-    tmp = *output;
-    output = *input;
-    input = MutableTuple::cast(*tmp);
-  }
-  list.setItems(*input);
   return NoneType::object();
 }
 
@@ -393,6 +923,27 @@ RawObject METH(list, clear)(Thread* thread, Arguments args) {
   return NoneType::object();
 }
 
+RawObject METH(list, count)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfList(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(list));
+  }
+  List self(&scope, *self_obj);
+  Object value(&scope, args.get(1));
+  word count = 0;
+  // `__eq__` may shrink the list, so re-read the length on every step.
+  for (word i = 0; i < self.numItems(); i++) {
+    RawObject eq = Runtime::objectEquals(thread, self.at(i), *value);
+    if (eq == Bool::trueObj()) {
+      count++;
+    } else if (eq.isErrorException()) {
+      return eq;
+    }
+  }
+  return SmallInt::fromWord(count);
+}
+
 RawObject METH(list, __len__)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object self(&scope, args.get(0));
@@ -504,7 +1055,6 @@ RawObject METH(list, remove)(Thread* thread, Arguments args) {
 }
 
 RawObject METH(list, __imul__)(Thread* thread, Arguments args) {
-  RawObject other = args.get(1);
   HandleScope scope(thread);
   Object self(&scope, args.get(0));
   Runtime* runtime = thread->runtime();
@@ -520,18 +1070,17 @@ RawObject METH(list, __imul__)(Thread* thread, Arguments args) {
                                 "cannot fit '%T' into an index-sized integer",
                                 &count_index);
   }
-  word ntimes = SmallInt::cast(other).value();
-  if (ntimes == 1) {
+  if (count == 1) {
     return *self;
   }
   List list(&scope, *self);
-  if (ntimes <= 0) {
+  if (count <= 0) {
     list.clearFrom(0);
     return *list;
   }
   word new_length;
   word len = list.numItems();
-  if (__builtin_mul_overflow(len, ntimes, &new_length) ||
+  if (__builtin_mul_overflow(len, count, &new_length) ||
       !SmallInt::isValid(new_length)) {
     return thread->raiseMemoryError();
   }
@@ -540,9 +1089,8 @@ RawObject METH(list, __imul__)(Thread* thread, Arguments args) {
   }
   runtime->listEnsureCapacity(thread, list, new_length);
   list.setNumItems(new_length);
-  for (word i = 0; i < ntimes; i++) {
-    list.replaceFromWith(i * len, *list, len);
-  }
+  MutableTuple items(&scope, list.items());
+  tupleRepeatPrefix(items, len, count);
   return *list;
 }
 
@@ -16,6 +16,13 @@ RawObject listContains(Thread* thread, const List& list, const Object& key);
 void listExtend(Thread* thread, const List& dst, const Tuple& src,
                 word src_length);
 
+// Returns the index of the first item in `list[start:stop]` that is `value` or
+// compares equal to it, -1 if there is none, or Error if `__eq__` raised.
+// `stop` is clamped to the length of the list, which may change while
+// comparing.
+RawObject listIndex(Thread* thread, const List& list, const Object& value,
+                    word start, word stop);
+
 // Inserts an element to the specified index of the list.
 // When index >= len(list) it is equivalent to appending to the list.
 void listInsert(Thread* thread, const List& list, const Object& value,
@@ -3,6 +3,7 @@
 #include "bytes-builtins.h"
 #include "frame.h"
 #include "globals.h"
+#include "int-builtins.h"
 #include "marshal.h"
 #include "module-builtins.h"
 #include "modules.h"
@@ -25,6 +26,28 @@ void FUNC(marshal, __init_module__)(Thread* thread, const Module& module,
   executeFrozenModule(thread, module, bytecode);
 }
 
+RawObject FUNC(marshal, dumps)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object value(&scope, args.get(0));
+  Object version_obj(&scope, args.get(1));
+  version_obj = intFromIndex(thread, version_obj);
+  if (version_obj.isError()) return *version_obj;
+  Int version_int(&scope, intUnderlying(*version_obj));
+  word version = version_int.asWordSaturated();
+  if (version < kMinInt32 || version > kMaxInt32) {
+    return thread->raiseWithFmt(LayoutId::kOverflowError,
+                                "Python int too large to convert to C int");
+  }
+  if (version != 2 && version != 3) {
+    // TODO(T63932405): Support marshal versions other than 2 and 3
+    UNIMPLEMENTED("marshal.dumps with versions other than 2 and 3");
+  }
+  Marshal::Writer writer(&scope, thread, version);
+  Object result(&scope, writer.writeObject(value));
+  if (result.isErrorException()) return *result;
+  return writer.result();
+}
+
 RawObject FUNC(marshal, loads)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object bytes_obj(&scope, args.get(0));
@@ -15,6 +15,7 @@ namespace testing {
 
 using MarshalReaderDeathTest = RuntimeFixture;
 using MarshalReaderTest = RuntimeFixture;
+using MarshalWriterTest = RuntimeFixture;
 
 TEST_F(MarshalReaderTest, ReadBytes) {
   HandleScope scope(thread_);
@@ -640,5 +641,84 @@ TEST_F(MarshalReaderTest,
   EXPECT_TRUE(isIntEqualsWord(*result, -0x8000000000000000));
 }
 
+TEST_F(MarshalWriterTest, WriteObjectWithLargeIntWritesFifteenBitDigits) {
+  HandleScope scope(thread_);
+  // This is: -0x8000000000000000_0000000000000001
+  const uword digits[] = {kMaxUword, static_cast<uword>(kMaxWord), kMaxUword};
+  Object value(&scope, runtime_->newLargeIntWithDigits(digits));
+  Marshal::Writer writer(&scope, thread_, 2);
+  ASSERT_TRUE(writer.writeObject(value).isNoneType());
+  const byte expected[] =
+      "l"
+      "\xf7\xff\xff\xff"
+      "\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+      "\x00\x00\x00\x80\x00";
+  Object result(&scope, writer.result());
+  EXPECT_TRUE(
+      isBytesEqualsBytes(result, View<byte>(expected, sizeof(expected) - 1)));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithVersionThreeWritesRefs) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+shared = [1.5]
+value = (shared, shared)
+)")
+                   .isError());
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Marshal::Writer writer(&scope, thread_, 3);
+  ASSERT_TRUE(writer.writeObject(value).isNoneType());
+  const byte expected[] =
+      "(\x02\x00\x00\x00\xdb\x01\x00\x00\x00g\x00\x00\x00\x00\x00\x00\xf8?"
+      "r\x00\x00\x00\x00";
+  Object result(&scope, writer.result());
+  EXPECT_TRUE(
+      isBytesEqualsBytes(result, View<byte>(expected, sizeof(expected) - 1)));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithVersionTwoCopiesSharedObjects) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+shared = [None]
+value = (shared, shared)
+)")
+                   .isError());
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Marshal::Writer writer(&scope, thread_, 2);
+  ASSERT_TRUE(writer.writeObject(value).isNoneType());
+  const byte expected[] =
+      "(\x02\x00\x00\x00[\x01\x00\x00\x00N[\x01\x00\x00\x00N";
+  Object result(&scope, writer.result());
+  EXPECT_TRUE(
+      isBytesEqualsBytes(result, View<byte>(expected, sizeof(expected) - 1)));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithUnmarshallableRaisesValueError) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  pass
+value = [1, C()]
+)")
+                   .isError());
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Marshal::Writer writer(&scope, thread_, 3);
+  EXPECT_TRUE(raisedWithStr(writer.writeObject(value), LayoutId::kValueError,
+                            "unmarshallable object"));
+}
+
+TEST_F(MarshalWriterTest, WriteObjectWithRecursiveListRaisesValueError) {
+  HandleScope scope(thread_);
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+value = []
+value.append(value)
+)")
+                   .isError());
+  Object value(&scope, mainModuleAt(runtime_, "value"));
+  Marshal::Writer writer(&scope, thread_, 2);
+  EXPECT_TRUE(raisedWithStr(writer.writeObject(value), LayoutId::kValueError,
+                            "object too deeply nested to marshal"));
+}
+
 }  // namespace testing
 }  // namespace py
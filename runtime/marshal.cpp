@@ -5,6 +5,8 @@
 #include <cstring>
 #include <memory>
 
+#include "byteslike.h"
+#include "dict-builtins.h"
 #include "handles.h"
 #include "heap.h"
 #include "modules.h"
@@ -557,4 +559,373 @@ RawObject Marshal::Reader::readLongObject() {
   return *result;
 }
 
+Marshal::Writer::Writer(HandleScope* scope, Thread* thread, word version)
+    : thread_(thread),
+      runtime_(thread->runtime()),
+      version_(version),
+      ids_(scope, runtime_->newDict()) {}
+
+RawObject Marshal::Writer::writeObject(const Object& value) {
+  if (version_ >= 3) {
+    RawObject result = countReferences(value, 0);
+    if (result.isErrorException()) return result;
+  }
+  return writeValue(value, 0);
+}
+
+RawObject Marshal::Writer::result() {
+  return runtime_->newBytesWithAll(View<byte>(buffer_.data(), buffer_.size()));
+}
+
+void Marshal::Writer::writeBinaryFloat(double value) {
+  byte buffer[sizeof(value)];
+  std::memcpy(buffer, &value, sizeof(value));
+  writeBytes(buffer, sizeof(buffer));
+}
+
+void Marshal::Writer::writeByte(byte value) { buffer_.push_back(value); }
+
+void Marshal::Writer::writeBytes(const byte* data, word length) {
+  buffer_.insert(buffer_.end(), data, data + length);
+}
+
+void Marshal::Writer::writeLong(int32_t value) {
+  uint32_t bits = static_cast<uint32_t>(value);
+  for (word i = 0; i < 4; i++) {
+    writeByte(static_cast<byte>(bits >> (i * kBitsPerByte)));
+  }
+}
+
+void Marshal::Writer::writeShort(int16_t value) {
+  uint16_t bits = static_cast<uint16_t>(value);
+  writeByte(static_cast<byte>(bits));
+  writeByte(static_cast<byte>(bits >> kBitsPerByte));
+}
+
+// Returns the marshal type code of the objects that are always written
+// without a reference, or 0 for any other object.
+static byte singletonType(Runtime* runtime, RawObject value) {
+  if (value.isNoneType()) return TYPE_NONE;
+  if (value == runtime->typeAt(LayoutId::kStopIteration)) return TYPE_STOPITER;
+  if (value.isEllipsis()) return TYPE_ELLIPSIS;
+  if (value == Bool::falseObj()) return TYPE_FALSE;
+  if (value == Bool::trueObj()) return TYPE_TRUE;
+  return 0;
+}
+
+// Returns whether `value` is written without looking at any other object.
+static bool isShallow(Runtime* runtime, RawObject value) {
+  return value.isSmallInt() || value.isLargeInt() || value.isFloat() ||
+         value.isComplex() || value.isStr() || runtime->isByteslike(value);
+}
+
+RawObject Marshal::Writer::countReferences(const Object& value, word depth) {
+  if (singletonType(runtime_, *value) != 0) return NoneType::object();
+  if (depth > kMaxDepth) return raiseTooDeep();
+  // Like CPython, the contents of an object are only visited once: every
+  // later occurrence is written as a reference to the whole object.
+  if (++counts_[referenceId(value)] > 1 || isShallow(runtime_, *value)) {
+    return NoneType::object();
+  }
+
+  HandleScope scope(thread_);
+  Object item(&scope, NoneType::object());
+  if (value.isTuple()) {
+    Tuple tuple(&scope, *value);
+    for (word i = 0, length = tuple.length(); i < length; i++) {
+      item = tuple.at(i);
+      RawObject result = countReferences(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isList()) {
+    List list(&scope, *value);
+    for (word i = 0; i < list.numItems(); i++) {
+      item = list.at(i);
+      RawObject result = countReferences(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isDict()) {
+    Dict dict(&scope, *value);
+    Object dict_value(&scope, NoneType::object());
+    for (word i = 0; dictNextItem(dict, &i, &item, &dict_value);) {
+      RawObject result = countReferences(item, depth + 1);
+      if (result.isErrorException()) return result;
+      result = countReferences(dict_value, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isSet() || value.isFrozenSet()) {
+    SetBase set(&scope, *value);
+    RawObject raw_item = NoneType::object();
+    for (word i = 0; setNextItem(set, &i, &raw_item);) {
+      item = raw_item;
+      RawObject result = countReferences(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isCode()) {
+    Code code(&scope, *value);
+    item = code.code();
+    RawObject result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.consts();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.names();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.varnames();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.freevars();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.cellvars();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.filename();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.name();
+    result = countReferences(item, depth + 1);
+    if (result.isErrorException()) return result;
+    item = code.lnotab();
+    return countReferences(item, depth + 1);
+  }
+  return raiseUnmarshallable();
+}
+
+word Marshal::Writer::referenceId(const Object& value) {
+  HandleScope scope(thread_);
+  Object key(&scope, SmallInt::fromWordTruncated(runtime_->hash(*value)));
+  word key_hash = SmallInt::cast(*key).hash();
+  Object bucket(&scope, dictAt(thread_, ids_, key, key_hash));
+  if (bucket.isErrorNotFound()) {
+    bucket = runtime_->newList();
+    dictAtPut(thread_, ids_, key, key_hash, bucket);
+  }
+  List entries(&scope, *bucket);
+  for (word i = 0; i < entries.numItems(); i += 2) {
+    if (entries.at(i) == *value) {
+      return SmallInt::cast(entries.at(i + 1)).value();
+    }
+  }
+  word id = counts_.size();
+  counts_.push_back(0);
+  addresses_.push_back(-1);
+  runtime_->listAdd(thread_, entries, value);
+  Object id_obj(&scope, SmallInt::fromWord(id));
+  runtime_->listAdd(thread_, entries, id_obj);
+  return id;
+}
+
+RawObject Marshal::Writer::writeValue(const Object& value, word depth) {
+  byte singleton = singletonType(runtime_, *value);
+  if (singleton != 0) {
+    writeByte(singleton);
+    return NoneType::object();
+  }
+  if (depth > kMaxDepth) return raiseTooDeep();
+
+  byte flag = 0;
+  if (version_ >= 3) {
+    word id = referenceId(value);
+    if (addresses_[id] >= 0) {
+      writeByte(TYPE_REF);
+      writeLong(addresses_[id]);
+      return NoneType::object();
+    }
+    if (counts_[id] > 1) {
+      if (num_addresses_ == kMaxInt32) {
+        return thread_->raiseWithFmt(LayoutId::kValueError,
+                                     "too many objects to marshal");
+      }
+      addresses_[id] = num_addresses_++;
+      flag = static_cast<byte>(FLAG_REF);
+    }
+  }
+
+  HandleScope scope(thread_);
+  if (value.isSmallInt() || value.isLargeInt()) {
+    Int value_int(&scope, *value);
+    writeInt(value_int, flag);
+    return NoneType::object();
+  }
+  if (value.isFloat()) {
+    writeByte(TYPE_BINARY_FLOAT | flag);
+    writeBinaryFloat(Float::cast(*value).value());
+    return NoneType::object();
+  }
+  if (value.isComplex()) {
+    writeByte(TYPE_BINARY_COMPLEX | flag);
+    writeBinaryFloat(Complex::cast(*value).real());
+    writeBinaryFloat(Complex::cast(*value).imag());
+    return NoneType::object();
+  }
+  if (value.isStr()) {
+    // TODO(T63932056): Check if a string is interned and emit TYPE_INTERNED
+    Str str(&scope, *value);
+    word length = str.length();
+    if (length > kMaxInt32) return raiseUnmarshallable();
+    writeByte(TYPE_UNICODE | flag);
+    writeLong(static_cast<int32_t>(length));
+    word start = buffer_.size();
+    buffer_.resize(start + length);
+    str.copyTo(buffer_.data() + start, length);
+    return NoneType::object();
+  }
+  if (runtime_->isByteslike(*value)) {
+    Byteslike bytes(&scope, thread_, *value);
+    word length = bytes.length();
+    if (length > kMaxInt32) return raiseUnmarshallable();
+    writeByte(TYPE_STRING | flag);
+    writeLong(static_cast<int32_t>(length));
+    word start = buffer_.size();
+    buffer_.resize(start + length);
+    bytes.copyTo(buffer_.data() + start, length);
+    return NoneType::object();
+  }
+
+  Object item(&scope, NoneType::object());
+  if (value.isTuple()) {
+    Tuple tuple(&scope, *value);
+    word length = tuple.length();
+    writeByte(TYPE_TUPLE | flag);
+    writeLong(static_cast<int32_t>(length));
+    for (word i = 0; i < length; i++) {
+      item = tuple.at(i);
+      RawObject result = writeValue(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isList()) {
+    List list(&scope, *value);
+    writeByte(TYPE_LIST | flag);
+    writeLong(static_cast<int32_t>(list.numItems()));
+    for (word i = 0; i < list.numItems(); i++) {
+      item = list.at(i);
+      RawObject result = writeValue(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isDict()) {
+    Dict dict(&scope, *value);
+    Object dict_value(&scope, NoneType::object());
+    writeByte(TYPE_DICT | flag);
+    for (word i = 0; dictNextItem(dict, &i, &item, &dict_value);) {
+      RawObject result = writeValue(item, depth + 1);
+      if (result.isErrorException()) return result;
+      result = writeValue(dict_value, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    writeByte(TYPE_NULL);
+    return NoneType::object();
+  }
+  if (value.isSet() || value.isFrozenSet()) {
+    SetBase set(&scope, *value);
+    writeByte((value.isSet() ? TYPE_SET : TYPE_FROZENSET) | flag);
+    writeLong(static_cast<int32_t>(set.numItems()));
+    RawObject raw_item = NoneType::object();
+    for (word i = 0; setNextItem(set, &i, &raw_item);) {
+      item = raw_item;
+      RawObject result = writeValue(item, depth + 1);
+      if (result.isErrorException()) return result;
+    }
+    return NoneType::object();
+  }
+  if (value.isCode()) {
+    Code code(&scope, *value);
+    return writeCode(code, flag, depth);
+  }
+  return raiseUnmarshallable();
+}
+
+void Marshal::Writer::writeInt(const Int& value, byte flag) {
+  if (value.isSmallInt()) {
+    word small = SmallInt::cast(*value).value();
+    if (small >= kMinInt32 && small <= kMaxInt32) {
+      writeByte(TYPE_INT | flag);
+      writeLong(static_cast<int32_t>(small));
+      return;
+    }
+  }
+  // Write the magnitude in 15-bit digits, least significant first, with the
+  // sign carried by the digit count.
+  writeByte(TYPE_LONG | flag);
+  HandleScope scope(thread_);
+  bool negative = value.isNegative();
+  Int magnitude(&scope,
+                negative ? runtime_->intNegate(thread_, value) : *value);
+  word num_digits =
+      (magnitude.bitLength() + kBitsPerLongDigit - 1) / kBitsPerLongDigit;
+  writeLong(static_cast<int32_t>(negative ? -num_digits : num_digits));
+  for (word i = 0; i < num_digits; i++) {
+    word bit = i * kBitsPerLongDigit;
+    word index = bit / kBitsPerWord;
+    word shift = bit % kBitsPerWord;
+    uword digit = magnitude.digitAt(index) >> shift;
+    if (shift + kBitsPerLongDigit > kBitsPerWord &&
+        index + 1 < magnitude.numDigits()) {
+      digit |= magnitude.digitAt(index + 1) << (kBitsPerWord - shift);
+    }
+    writeShort(static_cast<int16_t>(digit & ((1 << kBitsPerLongDigit) - 1)));
+  }
+}
+
+RawObject Marshal::Writer::writeCode(const Code& code, byte flag,
+                                     word depth) {
+  writeByte(TYPE_CODE | flag);
+  writeLong(static_cast<int32_t>(code.argcount()));
+  writeLong(static_cast<int32_t>(code.posonlyargcount()));
+  writeLong(static_cast<int32_t>(code.kwonlyargcount()));
+  writeLong(static_cast<int32_t>(code.nlocals()));
+  writeLong(static_cast<int32_t>(code.stacksize()));
+  writeLong(static_cast<int32_t>(code.flags()));
+  HandleScope scope(thread_);
+  Object field(&scope, code.code());
+  RawObject result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.consts();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.names();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.varnames();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.freevars();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.cellvars();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.filename();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  field = code.name();
+  result = writeValue(field, depth + 1);
+  if (result.isErrorException()) return result;
+  writeLong(static_cast<int32_t>(code.firstlineno()));
+  field = code.lnotab();
+  return writeValue(field, depth + 1);
+}
+
+RawObject Marshal::Writer::raiseTooDeep() {
+  return thread_->raiseWithFmt(LayoutId::kValueError,
+                               "object too deeply nested to marshal");
+}
+
+RawObject Marshal::Writer::raiseUnmarshallable() {
+  return thread_->raiseWithFmt(LayoutId::kValueError, "unmarshallable object");
+}
+
 }  // namespace py
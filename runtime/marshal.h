@@ -1,6 +1,8 @@
 /* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
 #pragma once
 
+#include <vector>
+
 #include "globals.h"
 #include "handles.h"
 #include "modules.h"
@@ -89,6 +91,61 @@ class Marshal {
     DISALLOW_HEAP_ALLOCATION();
   };
 
+  class Writer {
+   public:
+    Writer(HandleScope* scope, Thread* thread, word version);
+
+    // Appends the serialized form of `value`. Returns None on success, or
+    // raises `ValueError` for values that cannot be marshalled. Version 3
+    // shares every object referenced more than once, like CPython.
+    RawObject writeObject(const Object& value);
+
+    // Returns a bytes object with everything written so far.
+    RawObject result();
+
+    void writeBinaryFloat(double value);
+
+    void writeByte(byte value);
+
+    void writeBytes(const byte* data, word length);
+
+    void writeLong(int32_t value);
+
+    void writeShort(int16_t value);
+
+   private:
+    RawObject countReferences(const Object& value, word depth);
+    word referenceId(const Object& value);
+
+    RawObject writeValue(const Object& value, word depth);
+    void writeInt(const Int& value, byte flag);
+    RawObject writeCode(const Code& code, byte flag, word depth);
+
+    RawObject raiseTooDeep();
+    RawObject raiseUnmarshallable();
+
+    Thread* thread_;
+    Runtime* runtime_;
+    word version_;
+
+    // Maps the hash of every object seen to a list of alternating objects and
+    // reference ids. Objects are compared by identity.
+    Dict ids_;
+    // Number of references to each object, indexed by reference id.
+    std::vector<word> counts_;
+    // Reference address of each object, or -1 if it was not written yet.
+    std::vector<int32_t> addresses_;
+    int32_t num_addresses_ = 0;
+
+    std::vector<byte> buffer_;
+
+    static const int kBitsPerLongDigit = 15;
+    static const word kMaxDepth = 2000;
+
+    DISALLOW_COPY_AND_ASSIGN(Writer);
+    DISALLOW_HEAP_ALLOCATION();
+  };
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(Marshal);
 };
 
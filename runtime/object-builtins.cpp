@@ -148,6 +148,19 @@ void instanceGrowOverflow(Thread* thread, const Instance& instance,
   instance.instanceVariableAtPut(layout.overflowOffset(), *new_overflow);
 }
 
+void instancePreallocateOverflow(Thread* thread, const Instance& instance,
+                                 const Layout& layout) {
+  DCHECK(instance.layoutId() == layout.id(), "unexpected layout");
+  RawObject expected = layout.expectedLayout();
+  if (expected.isNoneType() || !layout.hasTupleOverflow()) return;
+  RawLayout expected_layout = Layout::cast(expected);
+  if (!expected_layout.hasTupleOverflow()) return;
+  word length = Tuple::cast(expected_layout.overflowAttributes()).length();
+  if (length == 0) return;
+  instance.instanceVariableAtPut(layout.overflowOffset(),
+                                 thread->runtime()->newMutableTuple(length));
+}
+
 static RawObject instanceSetAttrSetLocation(Thread* thread,
                                             const Instance& instance,
                                             const Object& name,
@@ -20,6 +20,12 @@ RawObject instanceGetAttributeSetLocation(Thread* thread,
 void instanceGrowOverflow(Thread* thread, const Instance& instance,
                           word length);
 
+// Sizes the overflow tuple of a freshly allocated `instance` of `layout` for
+// the attributes that `layout.expectedLayout()` predicts `__init__` will add,
+// so the stores in `__init__` do not need to grow it one slot at a time.
+void instancePreallocateOverflow(Thread* thread, const Instance& instance,
+                                 const Layout& layout);
+
 RawObject instanceSetAttr(Thread* thread, const Instance& instance,
                           const Object& name, const Object& value);
 
@@ -951,6 +951,50 @@ TEST_F(LargeStrTest, CopyTo) {
   EXPECT_EQ(array[4], 'o');
 }
 
+TEST_F(LargeStrTest, IsASCIICachesResultWithoutChangingHash) {
+  HandleScope scope(thread_);
+  LargeStr ascii(&scope, runtime_->newStrFromCStr("hello world!"));
+  word hash = runtime_->hash(*ascii);
+  EXPECT_EQ(ascii.header().hashCode() & LargeStr::kASCIIKnownFlag, 0);
+  EXPECT_TRUE(ascii.isASCII());
+  EXPECT_NE(ascii.header().hashCode() & LargeStr::kASCIIKnownFlag, 0);
+  EXPECT_TRUE(ascii.isASCII());
+  EXPECT_EQ(ascii.hashCode(), hash);
+  EXPECT_EQ(runtime_->hash(*ascii), hash);
+
+  LargeStr unicode(&scope, runtime_->newStrFromCStr("hello wörld!"));
+  EXPECT_FALSE(unicode.isASCII());
+  EXPECT_NE(unicode.header().hashCode() & LargeStr::kASCIIKnownFlag, 0);
+  EXPECT_FALSE(unicode.isASCII());
+  EXPECT_EQ(unicode.hashCode(), 0);
+}
+
+TEST_F(LargeStrTest, CodePointLengthCachesASCII) {
+  HandleScope scope(thread_);
+  LargeStr ascii(&scope, runtime_->newStrFromCStr("hello world!"));
+  EXPECT_EQ(ascii.codePointLength(), 12);
+  EXPECT_NE(ascii.header().hashCode() & LargeStr::kASCIIFlag, 0);
+  EXPECT_EQ(ascii.codePointLength(), 12);
+
+  LargeStr unicode(&scope, runtime_->newStrFromCStr("hello wörld!"));
+  EXPECT_EQ(unicode.codePointLength(), 12);
+  EXPECT_NE(unicode.header().hashCode() & LargeStr::kASCIIKnownFlag, 0);
+  EXPECT_EQ(unicode.header().hashCode() & LargeStr::kASCIIFlag, 0);
+  EXPECT_EQ(unicode.codePointLength(), 12);
+}
+
+TEST_F(LargeStrTest, OffsetByCodePointsWithASCIIStr) {
+  HandleScope scope(thread_);
+  LargeStr ascii(&scope, runtime_->newStrFromCStr("hello world!"));
+  EXPECT_EQ(ascii.offsetByCodePoints(0, 0), 0);
+  EXPECT_EQ(ascii.offsetByCodePoints(2, 3), 5);
+  EXPECT_EQ(ascii.offsetByCodePoints(2, 30), 12);
+  EXPECT_EQ(ascii.offsetByCodePoints(14, 0), 12);
+  EXPECT_EQ(ascii.offsetByCodePoints(12, -1), 11);
+  EXPECT_EQ(ascii.offsetByCodePoints(12, -12), 0);
+  EXPECT_EQ(ascii.offsetByCodePoints(12, -13), -1);
+}
+
 TEST_F(StringTest, CompareSmallStrCStrASCII) {
   HandleScope scope(thread_);
 
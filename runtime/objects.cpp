@@ -517,8 +517,6 @@ static bool includes1(const byte* haystack, word haystack_len, byte needle) {
 }
 
 bool RawLargeStr::includes(RawObject that) const {
-  enum { kMask = kBitsPerWord - 1 };
-
   if (that == Str::empty()) {
     return true;
   }
@@ -547,39 +545,7 @@ bool RawLargeStr::includes(RawObject that) const {
     needle = dataArrayData(LargeStr::cast(that));
   }
 
-  word needle_last = needle_len - 1;
-  word skip = needle_last - 1;
-  uword delta1 = 0;
-  for (word i = 0; i < needle_last; i++) {
-    delta1 |= (1 << (needle[i] & kMask));
-    if (needle[i] == needle[needle_last]) {
-      skip = needle_last - i - 1;
-    }
-  }
-  delta1 |= (1 << (needle[needle_last] & kMask));
-  for (word i = 0; i <= diff; i++) {
-    if (haystack[i + needle_last] == needle[needle_last]) {
-      word j = 0;
-      for (; j < needle_last; j++) {
-        if (haystack[i + j] != needle[j]) {
-          break;
-        }
-      }
-      if (j == needle_last) {
-        return true;
-      }
-      if ((delta1 & (1 << (haystack[i + needle_len] & kMask))) == 0) {
-        i += needle_len;
-      } else {
-        i += skip;
-      }
-    } else {
-      if ((delta1 & (1 << (haystack[i + needle_len] & kMask))) == 0) {
-        i += needle_len;
-      }
-    }
-  }
-  return false;
+  return Utils::memoryFind(haystack, haystack_len, needle, needle_len) != -1;
 }
 
 word RawLargeStr::occurrencesOf(RawObject that) const {
@@ -858,7 +824,11 @@ RawObject RawMutableBytes::becomeStr() const {
   if (len <= SmallStr::kMaxLength) {
     return SmallStr::fromBytes({dataArrayData(*this), len});
   }
-  setHeader(header().withLayoutId(LayoutId::kLargeStr));
+  // Clear any identity hash; LargeStr keeps its value hash and cached
+  // properties in these bits.
+  setHeader(header()
+                .withLayoutId(LayoutId::kLargeStr)
+                .withHashCode(RawHeader::kUninitializedHash));
   return *this;
 }
 
@@ -1470,6 +1470,11 @@ class RawDataArray : public RawHeapObject {
 
   word length() const;
 
+  // The value hash of the contents as cached in the header, or
+  // `RawHeader::kUninitializedHash` if it has not been computed yet.
+  word hashCode() const;
+  void setHashCode(word value) const;
+
   // Conversion to an unescaped C string.  The underlying memory is allocated
   // with malloc and must be freed by the caller.
   char* toCStr() const;
@@ -1485,6 +1490,11 @@ class RawDataArray : public RawHeapObject {
   static word allocationSize(word length);
   static RawObject initialize(uword address, word length, LayoutId layout_id);
 
+  // Value hashes only use the low bits of the header hash code. The top bits
+  // are left for `RawLargeStr` to cache properties of its contents.
+  static const int kHashCodeBits = RawHeader::kHashCodeBits - 2;
+  static const uword kHashCodeMask = (uword{1} << kHashCodeBits) - 1;
+
   RAW_OBJECT_COMMON(DataArray);
 };
 
@@ -1501,6 +1511,13 @@ class RawLargeBytes : public RawDataArray {
 
 class RawLargeStr : public RawDataArray {
  public:
+  // Like the `RawDataArray` versions, but the ASCII-ness of the string is
+  // computed once and cached in the header so that ASCII strings answer in
+  // constant time.
+  word codePointLength() const;
+  bool isASCII() const;
+  word offsetByCodePoints(word index, word count) const;
+
   bool includes(RawObject that) const;
 
   word occurrencesOf(RawObject that) const;
@@ -1508,7 +1525,14 @@ class RawLargeStr : public RawDataArray {
   // Sizing. Sizing should only be done by the Runtime.
   static word allocationSize(word length);
 
+  // Bits of the header hash code above `RawDataArray::kHashCodeBits`.
+  static const word kASCIIKnownFlag = word{1} << kHashCodeBits;
+  static const word kASCIIFlag = kASCIIKnownFlag << 1;
+
   RAW_OBJECT_COMMON(LargeStr);
+
+ private:
+  void setIsASCII(bool is_ascii) const;
 };
 
 class RawMutableBytes : public RawLargeBytes {
@@ -1519,6 +1543,8 @@ class RawMutableBytes : public RawLargeBytes {
 
   void uint32AtPut(word index, uint32_t value) const;
 
+  void uint64AtPut(word index, uint64_t value) const;
+
   // Find the first occurrence from a specified start of any byte in the given
   // byte sequence, return the number of bytes read before the occurrence
   word indexOfAny(View<byte> needle, word start) const;
@@ -2403,7 +2429,8 @@ class RawFunction : public RawInstance {
     kInterpreted = RawCode::Flags::kLast << 2,  // Executable by the interpreter
     kExtension = RawCode::Flags::kLast << 3,    // C-API extension function
     kCompiled = RawCode::Flags::kLast << 4,     // JIT-compiled
-    kLast = kCompiled,
+    kJitBlacklisted = RawCode::Flags::kLast << 5,  // Deoptimized too often
+    kLast = kJitBlacklisted,
   };
 
   // Getters and setters.
@@ -2470,6 +2497,9 @@ class RawFunction : public RawInstance {
   // Returns true if function has `kCompiled` flag set.
   bool isCompiled() const;
 
+  // Returns true if function has `kJitBlacklisted` flag set.
+  bool isJitBlacklisted() const;
+
   // Returns true if the function is a coroutine, a generator, or an async
   // generator.
   bool isGeneratorLike() const;
@@ -2558,6 +2588,15 @@ class RawFunction : public RawInstance {
   RawObject dict() const;
   void setDict(RawObject dict) const;
 
+  // Number of times the JIT-compiled code of this function deoptimized.
+  word jitDeoptCount() const;
+  void setJitDeoptCount(word count) const;
+
+  // Dict mapping `pc << kBitsPerByte | bytecode` of each failed JIT guard to
+  // the number of deoptimizations it caused, or `None`.
+  RawObject jitDeopts() const;
+  void setJitDeopts(RawObject deopts) const;
+
   // Layout.
   static const int kCodeOffset = RawHeapObject::kSize;
   static const int kFlagsOffset = kCodeOffset + kPointerSize;
@@ -2582,7 +2621,9 @@ class RawFunction : public RawInstance {
   static const int kCachesOffset = kRewrittenBytecodeOffset + kPointerSize;
   static const int kDictOffset = kCachesOffset + kPointerSize;
   static const int kIntrinsicOffset = kDictOffset + kPointerSize;
-  static const int kSize = kIntrinsicOffset + kPointerSize;
+  static const int kJitDeoptCountOffset = kIntrinsicOffset + kPointerSize;
+  static const int kJitDeoptsOffset = kJitDeoptCountOffset + kPointerSize;
+  static const int kSize = kJitDeoptsOffset + kPointerSize;
 
   RAW_OBJECT_COMMON(Function);
 };
@@ -2857,9 +2898,13 @@ class RawDeque : public RawInstance {
 //   [Header  ]
 //   [NumItems] - Number of items currently in the dict
 //   [Data    ] - RawTuple that stores the underlying data.
-//   [Indices ] - RawTuple storing indices into the data tuple.
+//   [Indices ] - RawMutableBytes storing indices into the data tuple.
 //   [FirstEmptyItemIndex] - Index pointing to the first empty item in data.
 //
+// A dict may instead share its keys with other dicts of the same shape. Its
+// indices are then an immutable RawTuple holding the indices and the keys,
+// and its data only holds the values (see dictShareKeys()).
+//
 class RawDict : public RawInstance {
  public:
   // Number of items currently in the dict
@@ -2871,7 +2916,9 @@ class RawDict : public RawInstance {
   RawObject data() const;
   void setData(RawObject data) const;
 
-  // RawTuple storing indices into the data tuple.
+  // RawMutableBytes storing indices into the data tuple. Each entry is 1, 2,
+  // 4 or 8 bytes wide, the smallest width that can hold every data tuple
+  // index of a dict with that many indices.
   RawObject indices() const;
   void setIndices(RawObject index_data) const;
 
@@ -2882,6 +2929,14 @@ class RawDict : public RawInstance {
   // Number of indices.
   word numIndices() const;
 
+  // Largest number of indices stored with each entry width. Indices are at
+  // most 2/3 full, so the largest stored data tuple index is just below twice
+  // the number of indices, and the two largest values of each width are
+  // reserved for empty and tombstone entries.
+  static const word kMaxNumIndicesWidth1 = 128;
+  static const word kMaxNumIndicesWidth2 = 32768;
+  static const word kMaxNumIndicesWidth4 = word{1} << 31;
+
   // Layout.
   static const int kNumItemsOffset = RawHeapObject::kSize;
   static const int kDataOffset = kNumItemsOffset + kPointerSize;
@@ -3340,6 +3395,17 @@ class RawLayout : public RawInstance {
   // Returns true if the layout stores its overflow attributes in a tuple.
   bool hasTupleOverflow() const;
 
+  // Returns the layout that instances created with this layout had after
+  // their type's `__init__` returned the last time one was constructed through
+  // `CALL_FUNCTION_TYPE_INIT`, or `None` if there is no such layout yet.
+  RawObject expectedLayout() const;
+  void setExpectedLayout(RawObject layout) const;
+
+  // Number of times the instance layout of the described type was grown (see
+  // `typeGrowInstanceLayout()`) to arrive at this layout.
+  word numGrowths() const;
+  void setNumGrowths(word count) const;
+
   // Layout.
   static const int kDescribedTypeOffset = RawHeapObject::kSize;
   static const int kInObjectAttributesOffset =
@@ -3350,7 +3416,10 @@ class RawLayout : public RawInstance {
   static const int kDeletionsOffset = kAdditionsOffset + kPointerSize;
   static const int kNumInObjectAttributesOffset =
       kDeletionsOffset + kPointerSize;
-  static const int kSize = kNumInObjectAttributesOffset + kPointerSize;
+  static const int kExpectedLayoutOffset =
+      kNumInObjectAttributesOffset + kPointerSize;
+  static const int kNumGrowthsOffset = kExpectedLayoutOffset + kPointerSize;
+  static const int kSize = kNumGrowthsOffset + kPointerSize;
 
   RAW_OBJECT_COMMON(Layout);
 };
@@ -5541,6 +5610,16 @@ inline void RawDataArray::copyToStartAt(byte* dst, word length,
 
 inline word RawDataArray::length() const { return headerCountOrOverflow(); }
 
+inline word RawDataArray::hashCode() const {
+  return header().hashCode() & kHashCodeMask;
+}
+
+inline void RawDataArray::setHashCode(word value) const {
+  DCHECK((value & ~kHashCodeMask) == 0, "hash code does not fit");
+  RawHeader header = this->header();
+  setHeader(header.withHashCode((header.hashCode() & ~kHashCodeMask) | value));
+}
+
 inline uint16_t RawDataArray::uint16At(word index) const {
   uint16_t result;
   DCHECK_INDEX(index, length() - static_cast<word>(sizeof(result) - 1));
@@ -5602,6 +5681,12 @@ inline void RawMutableBytes::uint32AtPut(word index, uint32_t value) const {
               sizeof(value));
 }
 
+inline void RawMutableBytes::uint64AtPut(word index, uint64_t value) const {
+  DCHECK_INDEX(index, length() - static_cast<word>(sizeof(value) - 1));
+  std::memcpy(reinterpret_cast<char*>(address() + index), &value,
+              sizeof(value));
+}
+
 // RawArray
 
 inline RawObject RawArray::buffer() const {
@@ -6522,7 +6607,15 @@ inline void RawDict::setFirstEmptyItemIndex(word first_empty_item_index) const {
 inline word RawDict::numIndices() const {
   RawObject indices_obj = indices();
   if (indices_obj == RawSmallInt::fromWord(0)) return 0;
-  return RawMutableBytes::cast(indices_obj).length() >> 2;
+  if (indices_obj.isTuple()) {
+    // The first element of a shared keys table holds the indices.
+    indices_obj = RawTuple::cast(indices_obj).at(0);
+  }
+  word length = RawMutableBytes::cast(indices_obj).length();
+  if (length <= kMaxNumIndicesWidth1) return length;
+  if (length <= kMaxNumIndicesWidth2 * 2) return length >> 1;
+  if (length <= kMaxNumIndicesWidth4 * 4) return length >> 2;
+  return length >> 3;
 }
 
 // RawDictIteratorBase
@@ -6666,6 +6759,10 @@ inline bool RawFunction::isCompiled() const {
   return flags() & Flags::kCompiled;
 }
 
+inline bool RawFunction::isJitBlacklisted() const {
+  return flags() & Flags::kJitBlacklisted;
+}
+
 inline bool RawFunction::isGeneratorLike() const {
   return flags() &
          (Flags::kCoroutine | Flags::kGenerator | Flags::kAsyncGenerator);
@@ -6808,6 +6905,22 @@ inline void RawFunction::setCaches(RawObject cache) const {
   instanceVariableAtPut(kCachesOffset, cache);
 }
 
+inline word RawFunction::jitDeoptCount() const {
+  return RawSmallInt::cast(instanceVariableAt(kJitDeoptCountOffset)).value();
+}
+
+inline void RawFunction::setJitDeoptCount(word count) const {
+  instanceVariableAtPut(kJitDeoptCountOffset, RawSmallInt::fromWord(count));
+}
+
+inline RawObject RawFunction::jitDeopts() const {
+  return instanceVariableAt(kJitDeoptsOffset);
+}
+
+inline void RawFunction::setJitDeopts(RawObject deopts) const {
+  instanceVariableAtPut(kJitDeoptsOffset, deopts);
+}
+
 inline RawObject RawFunction::dict() const {
   return instanceVariableAt(kDictOffset);
 }
@@ -7218,6 +7331,39 @@ inline word RawLargeStr::allocationSize(word length) {
   return RawDataArray::allocationSize(length);
 }
 
+inline word RawLargeStr::codePointLength() const {
+  word flags = header().hashCode();
+  if (flags & kASCIIFlag) return length();
+  word result = RawDataArray::codePointLength();
+  if ((flags & kASCIIKnownFlag) == 0) setIsASCII(result == length());
+  return result;
+}
+
+inline bool RawLargeStr::isASCII() const {
+  word flags = header().hashCode();
+  if (flags & kASCIIKnownFlag) return (flags & kASCIIFlag) != 0;
+  bool result = RawDataArray::isASCII();
+  setIsASCII(result);
+  return result;
+}
+
+inline word RawLargeStr::offsetByCodePoints(word index, word count) const {
+  if (!isASCII()) {
+    return RawDataArray::offsetByCodePoints(index, count);
+  }
+  word result = index + count;
+  if (count < 0) {
+    return result < 0 ? -1 : result;
+  }
+  return Utils::minimum(result, length());
+}
+
+inline void RawLargeStr::setIsASCII(bool is_ascii) const {
+  RawHeader header = this->header();
+  word flags = kASCIIKnownFlag | (is_ascii ? kASCIIFlag : 0);
+  setHeader(header.withHashCode(header.hashCode() | flags));
+}
+
 // RawValueCell
 
 inline RawObject RawValueCell::value() const {
@@ -7518,6 +7664,22 @@ inline void RawLayout::setNumInObjectAttributes(word count) const {
                         RawSmallInt::fromWord(count));
 }
 
+inline RawObject RawLayout::expectedLayout() const {
+  return instanceVariableAt(kExpectedLayoutOffset);
+}
+
+inline void RawLayout::setExpectedLayout(RawObject layout) const {
+  instanceVariableAtPut(kExpectedLayoutOffset, layout);
+}
+
+inline word RawLayout::numGrowths() const {
+  return RawSmallInt::cast(instanceVariableAt(kNumGrowthsOffset)).value();
+}
+
+inline void RawLayout::setNumGrowths(word count) const {
+  instanceVariableAtPut(kNumGrowthsOffset, RawSmallInt::fromWord(count));
+}
+
 inline void RawLayout::seal() const {
   setOverflowAttributes(RawNoneType::object());
 }
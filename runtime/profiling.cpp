@@ -2,7 +2,10 @@
 #include "profiling.h"
 
 #include "bytecode.h"
+#include "dict-builtins.h"
 #include "frame.h"
+#include "ic.h"
+#include "interpreter.h"
 #include "runtime.h"
 #include "thread.h"
 
@@ -85,4 +88,128 @@ void profiling_return(Thread* thread) {
   thread->enableProfiling();
 }
 
+word profiling_opcode(Thread* thread, word arg) {
+  Frame* frame = thread->currentFrame();
+  word pc = frame->virtualPC() - kCodeUnitSize;
+  thread->countOpcodes(1);
+  thread->countOpcode(static_cast<Bytecode>(frame->bytecode().byteAt(pc)));
+
+  Runtime* runtime = thread->runtime();
+  if (runtime->bytecodeProfile().isNoneType()) return arg;
+  HandleScope scope(thread);
+  Dict profile(&scope, runtime->bytecodeProfile());
+  Object function(&scope, frame->function());
+  word hash = runtime->hash(*function);
+  Object counts_obj(&scope, dictAt(thread, profile, function, hash));
+  if (counts_obj.isErrorNotFound()) {
+    word num_opcodes = frame->bytecode().length() / kCodeUnitSize;
+    counts_obj = runtime->newMutableTuple(num_opcodes);
+    MutableTuple::cast(*counts_obj).fill(SmallInt::fromWord(0));
+    dictAtPut(thread, profile, function, hash, counts_obj);
+  }
+  RawMutableTuple counts = MutableTuple::cast(*counts_obj);
+  word index = pc / kCodeUnitSize;
+  counts.atPut(index,
+               SmallInt::fromWord(SmallInt::cast(counts.at(index)).value() + 1));
+  return arg;
+}
+
+void profiling_bytecode_enable(Thread* thread) {
+  Runtime* runtime = thread->runtime();
+  runtime->setBytecodeProfile(runtime->newDict());
+  for (Thread* t = runtime->mainThread(); t != nullptr; t = t->next()) {
+    t->clearOpcodeCounts();
+  }
+  runtime->interpreter()->setBytecodeProfiling(true);
+  runtime->reinitInterpreter();
+}
+
+void profiling_bytecode_disable(Thread* thread) {
+  Runtime* runtime = thread->runtime();
+  runtime->interpreter()->setBytecodeProfiling(false);
+  runtime->reinitInterpreter();
+}
+
+static const char* icStateName(RawMutableTuple caches, word cache) {
+  word index = cache * kIcPointersPerEntry;
+  RawObject key = caches.at(index + kIcEntryKeyOffset);
+  if (key.isNoneType()) return "anamorphic";
+  if (!key.isUnbound()) return "monomorphic";
+  RawMutableTuple polymorphic_cache =
+      MutableTuple::cast(caches.at(index + kIcEntryValueOffset));
+  for (word j = 0; j < kIcPointersPerPolyCache; j += kIcPointersPerEntry) {
+    if (polymorphic_cache.at(j + kIcEntryKeyOffset).isNoneType()) {
+      return "polymorphic";
+    }
+  }
+  // All entries are in use; the next new receiver type flushes the cache.
+  return "megamorphic";
+}
+
+RawObject profiling_bytecode_results(Thread* thread) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+
+  Dict opcodes(&scope, runtime->newDict());
+  Object name(&scope, NoneType::object());
+  Object count(&scope, NoneType::object());
+  for (word i = 0; i < kNumBytecodes; i++) {
+    Bytecode bc = static_cast<Bytecode>(i);
+    word total = 0;
+    for (Thread* t = runtime->mainThread(); t != nullptr; t = t->next()) {
+      total += t->opcodeCountFor(bc);
+    }
+    if (total == 0) continue;
+    name = runtime->newStrFromCStr(kBytecodeNames[i]);
+    count = runtime->newInt(total);
+    dictAtPutByStr(thread, opcodes, name, count);
+  }
+
+  List sites(&scope, runtime->newList());
+  List ic_sites(&scope, runtime->newList());
+  Object profile_obj(&scope, runtime->bytecodeProfile());
+  if (profile_obj.isNoneType()) {
+    return runtime->newTupleWith3(opcodes, sites, ic_sites);
+  }
+  Dict profile(&scope, *profile_obj);
+  Object value(&scope, NoneType::object());
+  Object pc(&scope, NoneType::object());
+  Object state(&scope, NoneType::object());
+  Object entry(&scope, NoneType::object());
+  Object function(&scope, NoneType::object());
+  MutableBytes bytecode(&scope, runtime->emptyMutableBytes());
+  Object caches(&scope, NoneType::object());
+  for (word i = 0; dictNextItem(profile, &i, &function, &value);) {
+    bytecode = Function::cast(*function).rewrittenBytecode();
+    for (word j = 0, length = MutableTuple::cast(*value).length(); j < length;
+         j++) {
+      word site_count =
+          SmallInt::cast(MutableTuple::cast(*value).at(j)).value();
+      if (site_count == 0) continue;
+      pc = SmallInt::fromWord(j * kCodeUnitSize);
+      name = runtime->newStrFromCStr(
+          kBytecodeNames[rewrittenBytecodeOpAt(bytecode, j)]);
+      count = SmallInt::fromWord(site_count);
+      entry = runtime->newTupleWith4(function, pc, name, count);
+      runtime->listAdd(thread, sites, entry);
+    }
+
+    // Functions without inline caches have `None` instead of a tuple.
+    caches = Function::cast(*function).caches();
+    if (caches.isNoneType()) continue;
+    word num_opcodes = rewrittenBytecodeLength(bytecode);
+    for (word j = 0; j < num_opcodes;) {
+      BytecodeOp op = nextBytecodeOp(bytecode, &j);
+      if (!isByteCodeWithCache(op.bc)) continue;
+      pc = SmallInt::fromWord(op.index * kCodeUnitSize);
+      name = runtime->newStrFromCStr(kBytecodeNames[op.bc]);
+      state = runtime->newStrFromCStr(
+          icStateName(MutableTuple::cast(*caches), op.cache));
+      entry = runtime->newTupleWith4(function, pc, name, state);
+      runtime->listAdd(thread, ic_sites, entry);
+    }
+  }
+  return runtime->newTupleWith3(opcodes, sites, ic_sites);
+}
+
 }  // namespace py
@@ -1,6 +1,9 @@
 /* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
 #pragma once
 
+#include "globals.h"
+#include "objects.h"
+
 namespace py {
 
 class Thread;
@@ -9,4 +12,23 @@ void profiling_call(Thread* thread);
 
 void profiling_return(Thread* thread);
 
+// Records one execution of the opcode at the current pc for the bytecode
+// profile. Returns `arg` unchanged so the assembly interpreter can restore its
+// oparg register after the call.
+word profiling_opcode(Thread* thread, word arg);
+
+// Discards previous results and starts collecting a bytecode profile.
+void profiling_bytecode_enable(Thread* thread);
+
+// Stops collecting the bytecode profile. Results collected so far are kept.
+void profiling_bytecode_disable(Thread* thread);
+
+// Returns a tuple `(opcodes, sites, ic_sites)` describing the bytecode profile:
+// - `opcodes` is a dict mapping opcode names to execution counts.
+// - `sites` is a list of `(function, pc, opname, count)` tuples.
+// - `ic_sites` is a list of `(function, pc, opname, state)` tuples for every
+//   caching opcode of the profiled functions; `state` is one of "anamorphic",
+//   "monomorphic", "polymorphic" or "megamorphic".
+RawObject profiling_bytecode_results(Thread* thread);
+
 }  // namespace py
@@ -4,6 +4,7 @@
 #include <csignal>
 #include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -93,8 +94,9 @@ TEST(RuntimeTestNoFixture, AllocateAndCollectGarbage) {
       roundAllocationSize(array_length + HeapObject::headerSize(array_length));
   const word total_allocation_size = heap_size * 10;
   RandomState random_seed = randomStateFromSeed(0);
-  std::unique_ptr<Runtime> runtime(new Runtime(
-      heap_size, createCppInterpreter(), random_seed, StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime(
+      new Runtime(heap_size, createCppInterpreter(), random_seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
 
   ASSERT_TRUE(runtime->heap()->verify());
   for (word i = 0; i < total_allocation_size; i += allocation_size) {
@@ -1151,10 +1153,10 @@ TEST_F(RuntimeTest, HashStr) {
 
   // LargeStr instances have their hash codes computed lazily.
   Object str1(&scope, runtime_->newStrFromCStr("testing 123"));
-  EXPECT_EQ(HeapObject::cast(*str1).header().hashCode(), 0);
+  EXPECT_EQ(LargeStr::cast(*str1).hashCode(), 0);
   word hash1 = runtime_->hash(*str1);
-  EXPECT_NE(HeapObject::cast(*str1).header().hashCode(), 0);
-  EXPECT_EQ(HeapObject::cast(*str1).header().hashCode(), hash1);
+  EXPECT_NE(LargeStr::cast(*str1).hashCode(), 0);
+  EXPECT_EQ(LargeStr::cast(*str1).hashCode(), hash1);
 
   // Str with different values should (ideally) hash differently.
   Str str2(&scope, runtime_->newStrFromCStr("321 testing"));
@@ -1169,14 +1171,17 @@ TEST_F(RuntimeTest, HashStr) {
 
 TEST(RuntimeTestNoFixture, InitializeRandomSetsRandomRandomRNGSeed) {
   word heap_size = 32 * kMiB;
-  std::unique_ptr<Runtime> runtime0(new Runtime(
-      heap_size, createCppInterpreter(), randomState(), StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime0(
+      new Runtime(heap_size, createCppInterpreter(), randomState(),
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
   uword r0 = runtime0->random();
-  std::unique_ptr<Runtime> runtime1(new Runtime(
-      heap_size, createCppInterpreter(), randomState(), StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime1(
+      new Runtime(heap_size, createCppInterpreter(), randomState(),
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
   uword r1 = runtime1->random();
-  std::unique_ptr<Runtime> runtime2(new Runtime(
-      heap_size, createCppInterpreter(), randomState(), StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime2(
+      new Runtime(heap_size, createCppInterpreter(), randomState(),
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
   uword r2 = runtime2->random();
   // Having 3 random numbers be the same will practically never happen.
   EXPECT_TRUE(r0 != r1 || r0 != r2);
@@ -1186,19 +1191,76 @@ TEST(RuntimeTestNoFixture,
      InitializeRandomWithPyroHashSeedEnvVarSetsDeterministicRNGSeed) {
   word heap_size = 32 * kMiB;
   RandomState seed = randomStateFromSeed(42);
-  std::unique_ptr<Runtime> runtime0(new Runtime(
-      heap_size, createCppInterpreter(), seed, StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime0(
+      new Runtime(heap_size, createCppInterpreter(), seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
   uword r0_a = runtime0->random();
   uword r0_b = runtime0->random();
   EXPECT_NE(r0_a, r0_b);
-  std::unique_ptr<Runtime> runtime1(new Runtime(
-      heap_size, createCppInterpreter(), seed, StdioState::kBuffered));
+  std::unique_ptr<Runtime> runtime1(
+      new Runtime(heap_size, createCppInterpreter(), seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
   uword r1_a = runtime1->random();
   uword r1_b = runtime1->random();
   EXPECT_EQ(r0_a, r1_a);
   EXPECT_EQ(r0_b, r1_b);
 }
 
+TEST(RuntimeTestNoFixture, BytesHashWithWyhashIsDeterministicForSeed) {
+  word heap_size = 32 * kMiB;
+  RandomState seed = randomStateFromSeed(42);
+  std::unique_ptr<Runtime> runtime0(
+      new Runtime(heap_size, createCppInterpreter(), seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kWyhash));
+  std::unique_ptr<Runtime> runtime1(
+      new Runtime(heap_size, createCppInterpreter(), seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kWyhash));
+  std::unique_ptr<Runtime> runtime2(
+      new Runtime(heap_size, createCppInterpreter(), seed,
+                  StdioState::kBuffered, StrHashAlgorithm::kSiphash24));
+  EXPECT_EQ(runtime0->strHashAlgorithm(), StrHashAlgorithm::kWyhash);
+  byte data[100];
+  for (word i = 0; i < 100; i++) {
+    data[i] = 'a' + i % 26;
+  }
+  std::vector<word> hashes;
+  // Cover every length class of the algorithm.
+  for (word length = 0; length <= 100; length++) {
+    View<byte> bytes(data, length);
+    word hash = runtime0->bytesHash(bytes);
+    EXPECT_EQ(hash, runtime1->bytesHash(bytes)) << length;
+    EXPECT_NE(hash, runtime2->bytesHash(bytes)) << length;
+    for (word other : hashes) {
+      EXPECT_NE(hash, other) << length;
+    }
+    hashes.push_back(hash);
+  }
+}
+
+TEST(RuntimeTestNoFixture, BytesHashWithWyhashDependsOnEveryByte) {
+  word heap_size = 32 * kMiB;
+  std::unique_ptr<Runtime> runtime(
+      new Runtime(heap_size, createCppInterpreter(), randomStateFromSeed(42),
+                  StdioState::kBuffered, StrHashAlgorithm::kWyhash));
+  const word length = 4096;
+  std::vector<byte> data(length);
+  for (word i = 0; i < length; i++) {
+    data[i] = 'a' + i % 26;
+  }
+  View<byte> bytes(data.data(), length);
+  word hash = runtime->bytesHash(bytes);
+  std::vector<byte> copy(data);
+  EXPECT_EQ(runtime->bytesHash(View<byte>(copy.data(), length)), hash);
+  // Long inputs are read in 48 byte blocks with a 16 byte tail; change one
+  // byte at every offset of the first blocks and of the tail.
+  for (word i = 0; i < length; i++) {
+    if (i >= 96 && i < length - 16) continue;
+    copy[i] ^= 1;
+    EXPECT_NE(runtime->bytesHash(View<byte>(copy.data(), length)), hash) << i;
+    copy[i] ^= 1;
+  }
+}
+
 TEST_F(RuntimeTest, TypeDictOnlyLayoutReturnsLayoutWithDictOverflow) {
   ASSERT_FALSE(runFromCStr(runtime_, R"(
 class C: pass
@@ -146,11 +146,13 @@ RandomState randomStateFromSeed(uint64_t seed) {
 }
 
 Runtime::Runtime(word heap_size, Interpreter* interpreter,
-                 RandomState random_seed, StdioState stdio_state)
+                 RandomState random_seed, StdioState stdio_state,
+                 StrHashAlgorithm str_hash_algorithm)
     : heap_(heap_size),
       interpreter_(interpreter),
       random_state_(random_seed),
-      stdio_state_(stdio_state) {
+      stdio_state_(stdio_state),
+      str_hash_algorithm_(str_hash_algorithm) {
   Thread* thread = newThread();
   thread->begin();
   // This must be called before initializeTypes is called. Methods in
@@ -226,6 +228,8 @@ RawObject Runtime::newLayout(LayoutId id) {
   layout.setAdditions(newList());
   layout.setDeletions(newList());
   layout.setNumInObjectAttributes(0);
+  layout.setExpectedLayout(NoneType::object());
+  layout.setNumGrowths(0);
   return *layout;
 }
 
@@ -612,6 +616,7 @@ RawObject Runtime::newFunction(Thread* thread, const Object& name,
   function.setEntryKw(entry_kw);
   function.setEntryEx(entry_ex);
   function.setIntrinsic(nullptr);
+  function.setJitDeoptCount(0);
   populateEntryAsm(function);
   return *function;
 }
@@ -1475,6 +1480,79 @@ word Runtime::siphash24(View<byte> array) {
   return result;
 }
 
+static uint64_t wyhashRead8(const byte* p) {
+  uint64_t result;
+  std::memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+static uint64_t wyhashRead4(const byte* p) {
+  uint32_t result;
+  std::memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+static uint64_t wyhashMix(uint64_t a, uint64_t b) {
+  __uint128_t product = static_cast<__uint128_t>(a) * b;
+  return static_cast<uint64_t>(product) ^
+         static_cast<uint64_t>(product >> 64);
+}
+
+// wyhash (final version 4) by Wang Yi, keyed with the siphash secret so that
+// PYTHONHASHSEED controls both algorithms.
+word Runtime::wyhash(View<byte> array) {
+  static const uint64_t kSecret[] = {0xa0761d6478bd642f, 0xe7037ed1a0b428db,
+                                     0x8ebc6af09c88c6e3, 0x589965cc75374cc3};
+  const byte* p = array.data();
+  uint64_t length = array.length();
+  uint64_t seed = random_state_.siphash24_secret;
+  seed ^= wyhashMix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a, b;
+  if (length <= 16) {
+    if (length >= 4) {
+      uint64_t middle = (length >> 3) << 2;
+      a = (wyhashRead4(p) << 32) | wyhashRead4(p + middle);
+      b = (wyhashRead4(p + length - 4) << 32) |
+          wyhashRead4(p + length - 4 - middle);
+    } else if (length > 0) {
+      a = (uint64_t{p[0]} << 16) | (uint64_t{p[length >> 1]} << 8) |
+          p[length - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    uint64_t i = length;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = wyhashMix(wyhashRead8(p) ^ kSecret[1],
+                         wyhashRead8(p + 8) ^ seed);
+        see1 = wyhashMix(wyhashRead8(p + 16) ^ kSecret[2],
+                         wyhashRead8(p + 24) ^ see1);
+        see2 = wyhashMix(wyhashRead8(p + 32) ^ kSecret[3],
+                         wyhashRead8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = wyhashMix(wyhashRead8(p) ^ kSecret[1], wyhashRead8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = wyhashRead8(p + i - 16);
+    b = wyhashRead8(p + i - 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  __uint128_t product = static_cast<__uint128_t>(a) * b;
+  a = static_cast<uint64_t>(product);
+  b = static_cast<uint64_t>(product >> 64);
+  return static_cast<word>(wyhashMix(a ^ kSecret[0] ^ length, b ^ kSecret[1]));
+}
+
 uint64_t Runtime::hashWithKey(const Bytes& bytes, uint64_t key) {
   uint64_t result = 0;
   word length = bytes.length();
@@ -1492,20 +1570,21 @@ uint64_t Runtime::hashWithKey(const Bytes& bytes, uint64_t key) {
 }
 
 word Runtime::bytesHash(View<byte> array) {
-  word result = siphash24(array);
-  result &= RawHeader::kHashCodeMask;
+  word result = str_hash_algorithm_ == StrHashAlgorithm::kWyhash
+                    ? wyhash(array)
+                    : siphash24(array);
+  result &= RawDataArray::kHashCodeMask;
   return (result == RawHeader::kUninitializedHash) ? result + 1 : result;
 }
 
 word Runtime::valueHash(RawObject object) {
-  RawHeapObject src = HeapObject::cast(object);
-  RawHeader header = src.header();
-  word code = header.hashCode();
+  RawDataArray src = DataArray::cast(object);
+  word code = src.hashCode();
   if (code == RawHeader::kUninitializedHash) {
-    word size = src.headerCountOrOverflow();
+    word size = src.length();
     code = bytesHash(View<byte>(reinterpret_cast<byte*>(src.address()), size));
-    src.setHeader(header.withHashCode(code));
-    DCHECK(code == src.header().hashCode(), "hash failure");
+    src.setHashCode(code);
+    DCHECK(code == src.hashCode(), "hash failure");
   }
   return code;
 }
@@ -1726,6 +1805,13 @@ void Runtime::initializeTypes(Thread* thread) {
 
 void Runtime::collectGarbageInto(CompactionDestination destination) {
   EVENT(CollectGarbage);
+  {
+    MutexGuard lock(&threads_mutex_);
+    for (Thread* thread = main_thread_; thread != nullptr;
+         thread = thread->next()) {
+      thread->clearStrOffsetBreadcrumbs();
+    }
+  }
   bool run_callback = callbacks_ == NoneType::object();
   RawObject cb = (destination == CompactionDestination::kImmortalPartition)
                      ? scavengeImmortalize(this)
@@ -2132,6 +2218,7 @@ void Runtime::visitRuntimeRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&profiling_new_thread_, PointerKind::kRuntime);
   visitor->visitPointer(&profiling_call_, PointerKind::kRuntime);
   visitor->visitPointer(&profiling_return_, PointerKind::kRuntime);
+  visitor->visitPointer(&bytecode_profile_, PointerKind::kRuntime);
 
   // Visit finalizable native instances
   visitor->visitPointer(&finalizable_references_, PointerKind::kRuntime);
@@ -2678,10 +2765,10 @@ RawObject Runtime::newDict() {
 RawObject Runtime::newDictWithSize(word initial_size) {
   Thread* thread = Thread::current();
   HandleScope scope(thread);
-  // NOTE: Multiplying 2 will leave (initial_size * 2 * 2/3) - initial_size
-  // items available after initial_size items are inserted before dict is
-  // expanded.
-  word indices_len = Utils::nextPowerOfTwo(initial_size) * 2;
+  // Pick the smallest power of two whose 2/3 load factor still leaves an
+  // empty item after initial_size items are inserted, so that filling the dict
+  // does not expand it.
+  word indices_len = Utils::nextPowerOfTwo(initial_size * 3 / 2 + 1);
   Dict dict(&scope, newDict());
   dictAllocateArrays(thread, dict, indices_len);
   return *dict;
@@ -4292,6 +4379,198 @@ static void fullMultiply(uword x, uword y, uword* result_low,
   *result_high = static_cast<uword>(result >> 64);
 }
 
+// Operands with fewer digits than this are multiplied with the schoolbook
+// algorithm; the Karatsuba split only pays off for larger ones.
+static const word kKaratsubaThreshold = 40;
+
+// Adds the unsigned number `src[0:src_length]` to `dst[0:dst_length]` in place
+// and returns the carry out of `dst`.
+static uword digitsAddInPlace(uword* dst, word dst_length, const uword* src,
+                              word src_length) {
+  DCHECK(src_length <= dst_length, "destination too short");
+  uword carry = 0;
+  word i = 0;
+  for (; i < src_length; i++) {
+    dst[i] = addWithCarry(dst[i], src[i], carry, &carry);
+  }
+  for (; carry != 0 && i < dst_length; i++) {
+    dst[i] = addWithCarry(dst[i], 0, carry, &carry);
+  }
+  return carry;
+}
+
+// Subtracts the unsigned number `src[0:src_length]` from `dst[0:dst_length]`
+// in place. The difference must not be negative.
+static void digitsSubtractInPlace(uword* dst, word dst_length, const uword* src,
+                                  word src_length) {
+  DCHECK(src_length <= dst_length, "destination too short");
+  uword borrow = 0;
+  word i = 0;
+  for (; i < src_length; i++) {
+    dst[i] = subtractWithBorrow(dst[i], src[i], borrow, &borrow);
+  }
+  for (; borrow != 0 && i < dst_length; i++) {
+    dst[i] = subtractWithBorrow(dst[i], 0, borrow, &borrow);
+  }
+  DCHECK(borrow == 0, "difference must not be negative");
+}
+
+// Stores the sum of the unsigned numbers `left` and `right` into
+// `result[0:max(left_length, right_length) + 1]`.
+static word digitsAdd(uword* result, const uword* left, word left_length,
+                      const uword* right, word right_length) {
+  if (left_length < right_length) {
+    std::swap(left, right);
+    std::swap(left_length, right_length);
+  }
+  std::memcpy(result, left, left_length * kWordSize);
+  result[left_length] =
+      digitsAddInPlace(result, left_length, right, right_length);
+  return left_length + 1;
+}
+
+// Stores the unsigned product of `left` and `right` into
+// `result[0:left_length + right_length]`.
+static void digitsMultiplySchoolbook(uword* result, const uword* left,
+                                     word left_length, const uword* right,
+                                     word right_length) {
+  std::memset(result, 0, (left_length + right_length) * kWordSize);
+  for (word l = 0; l < left_length; l++) {
+    uword digit_left = left[l];
+    uword carry = 0;
+    for (word r = 0; r < right_length; r++) {
+      uword product_low;
+      uword product_high;
+      fullMultiply(digit_left, right[r], &product_low, &product_high);
+      uword carry0;
+      uword sum0 = addWithCarry(result[l + r], product_low, 0, &carry0);
+      uword carry1;
+      uword sum1 = addWithCarry(sum0, carry, 0, &carry1);
+      result[l + r] = sum1;
+      carry = product_high + carry0 + carry1;
+    }
+    result[l + right_length] = carry;
+  }
+}
+
+// Number of scratch digits `digitsMultiplyKaratsuba` needs when the longer
+// operand has `length` digits.
+static word karatsubaScratchLength(word length) {
+  if (length < kKaratsubaThreshold) return 0;
+  word high_length = length - length / 2;
+  return 4 * (high_length + 1) + karatsubaScratchLength(high_length + 1);
+}
+
+// Stores the unsigned product of `left` and `right` into
+// `result[0:left_length + right_length]` using Karatsuba's method.
+// `scratch` must provide `karatsubaScratchLength(max(left_length,
+// right_length))` digits; all recursion levels share it.
+static void digitsMultiplyKaratsuba(uword* result, const uword* left,
+                                    word left_length, const uword* right,
+                                    word right_length, uword* scratch) {
+  if (left_length < right_length) {
+    std::swap(left, right);
+    std::swap(left_length, right_length);
+  }
+  if (right_length < kKaratsubaThreshold) {
+    digitsMultiplySchoolbook(result, left, left_length, right, right_length);
+    return;
+  }
+  word result_length = left_length + right_length;
+  if (2 * right_length <= left_length) {
+    // Lopsided operands: multiply `right` with slices of `left` of the same
+    // size so that every partial product is balanced.
+    std::memset(result, 0, result_length * kWordSize);
+    uword* product = scratch;
+    for (word offset = 0; offset < left_length; offset += right_length) {
+      word slice_length = Utils::minimum(right_length, left_length - offset);
+      digitsMultiplyKaratsuba(product, left + offset, slice_length, right,
+                              right_length, scratch + 2 * right_length);
+      uword carry =
+          digitsAddInPlace(result + offset, result_length - offset, product,
+                           slice_length + right_length);
+      DCHECK(carry == 0, "product must fit into result");
+    }
+    return;
+  }
+
+  // With `left = high_l * B**shift + low_l` and likewise for `right`:
+  //   left * right = z2 * B**(2 * shift) + z1 * B**shift + z0
+  // where z0 = low_l * low_r, z2 = high_l * high_r and
+  // z1 = (low_l + high_l) * (low_r + high_r) - z0 - z2.
+  word shift = left_length / 2;
+  word high_left_length = left_length - shift;
+  word high_right_length = right_length - shift;
+  digitsMultiplyKaratsuba(result, left, shift, right, shift, scratch);
+  digitsMultiplyKaratsuba(result + 2 * shift, left + shift, high_left_length,
+                          right + shift, high_right_length, scratch);
+
+  uword* sum_left = scratch;
+  uword* sum_right = sum_left + high_left_length + 1;
+  uword* z1 = sum_right + high_left_length + 1;
+  word sum_left_length =
+      digitsAdd(sum_left, left, shift, left + shift, high_left_length);
+  word sum_right_length =
+      digitsAdd(sum_right, right, shift, right + shift, high_right_length);
+  word z1_length = sum_left_length + sum_right_length;
+  digitsMultiplyKaratsuba(z1, sum_left, sum_left_length, sum_right,
+                          sum_right_length, z1 + z1_length);
+  digitsSubtractInPlace(z1, z1_length, result, 2 * shift);
+  digitsSubtractInPlace(z1, z1_length, result + 2 * shift,
+                        result_length - 2 * shift);
+  // The middle term fits into the result, so its excess digits are zero.
+  word add_length = Utils::minimum(z1_length, result_length - shift);
+  uword carry = digitsAddInPlace(result + shift, result_length - shift, z1,
+                                 add_length);
+  DCHECK(carry == 0, "product must fit into result");
+}
+
+// Copies the absolute value of `value` into `digits[0:value.numDigits()]`.
+static void intAbsDigits(const Int& value, uword* digits) {
+  word num_digits = value.numDigits();
+  for (word i = 0; i < num_digits; i++) {
+    digits[i] = value.digitAt(i);
+  }
+  if (value.isNegative()) {
+    uword carry = 1;
+    for (word i = 0; i < num_digits; i++) {
+      digits[i] = addWithCarry(~digits[i], 0, carry, &carry);
+    }
+  }
+}
+
+static RawObject intMultiplyKaratsuba(Thread* thread, const Int& left,
+                                      const Int& right) {
+  word left_digits = left.numDigits();
+  word right_digits = right.numDigits();
+  word result_digits = left_digits + right_digits;
+  std::unique_ptr<uword[]> left_abs(new uword[left_digits]);
+  std::unique_ptr<uword[]> right_abs(new uword[right_digits]);
+  intAbsDigits(left, left_abs.get());
+  intAbsDigits(right, right_abs.get());
+  std::unique_ptr<uword[]> product(new uword[result_digits]);
+  std::unique_ptr<uword[]> scratch(new uword[karatsubaScratchLength(
+      Utils::maximum(left_digits, right_digits))]);
+  digitsMultiplyKaratsuba(product.get(), left_abs.get(), left_digits,
+                          right_abs.get(), right_digits, scratch.get());
+
+  // Each absolute value is at most `2**(64 * digits - 1)`, so the top bit of
+  // the product is clear and it fits a signed number of `result_digits`.
+  HandleScope scope(thread);
+  LargeInt result(&scope, thread->runtime()->createLargeInt(result_digits));
+  if (left.isNegative() != right.isNegative()) {
+    uword carry = 1;
+    for (word i = 0; i < result_digits; i++) {
+      result.digitAtPut(i, addWithCarry(~product[i], 0, carry, &carry));
+    }
+  } else {
+    for (word i = 0; i < result_digits; i++) {
+      result.digitAtPut(i, product[i]);
+    }
+  }
+  return thread->runtime()->normalizeLargeInt(thread, result);
+}
+
 RawObject Runtime::intMultiply(Thread* thread, const Int& left,
                                const Int& right) {
   // See also Hackers Delight Chapter 8 Multiplication.
@@ -4306,6 +4585,11 @@ RawObject Runtime::intMultiply(Thread* thread, const Int& left,
     }
   }
 
+  if (left_digits >= kKaratsubaThreshold &&
+      right_digits >= kKaratsubaThreshold) {
+    return intMultiplyKaratsuba(thread, left, right);
+  }
+
   HandleScope scope(thread);
   word result_digits = left.numDigits() + right.numDigits();
   LargeInt result(&scope, createLargeInt(result_digits));
@@ -4647,27 +4931,31 @@ RawObject Runtime::intToBytes(Thread* thread, const Int& num, word length,
              : *result;
 }
 
-// Str replacement when the result can fit in SmallStr.
-static RawObject strReplaceSmallStr(const Str& src, const Str& oldstr,
-                                    const Str& newstr, word count,
-                                    word result_len) {
-  DCHECK_BOUND(result_len, SmallStr::kMaxLength);
+// Write `src` to `dst` with the first `count` occurrences of `oldstr`
+// replaced by `newstr`. An empty `oldstr` matches before every code point and
+// at the end of `src`.
+static void strReplaceInto(byte* dst, const Str& src, const Str& oldstr,
+                           const Str& newstr, word count) {
   word src_len = src.length();
   word old_len = oldstr.length();
   word new_len = newstr.length();
-  byte buffer[SmallStr::kMaxLength];
-  byte* dst = buffer;
-  for (word i = 0, match_count = 0; i < src_len;) {
-    if (match_count == count || !strHasPrefix(src, oldstr, i)) {
-      *dst++ = src.byteAt(i++);
-      continue;
+  word i = 0;
+  for (word match_count = 0; match_count < count; match_count++) {
+    word match;
+    if (old_len > 0) {
+      match = strFindByteOffset(src, oldstr, i, src_len);
+    } else {
+      match = match_count == 0 ? 0 : src.offsetByCodePoints(i, 1);
     }
+    DCHECK(match != -1, "expected to find count occurrences");
+    src.copyToStartAt(dst, match - i, i);
+    dst += match - i;
     newstr.copyTo(dst, new_len);
     dst += new_len;
-    i += old_len;
-    match_count++;
+    i = match + old_len;
   }
-  return SmallStr::fromBytes(View<byte>(buffer, result_len));
+  // Copy the rest of the string.
+  src.copyToStartAt(dst, src_len - i, i);
 }
 
 RawObject Runtime::strReplace(Thread* thread, const Str& src, const Str& oldstr,
@@ -4685,53 +4973,28 @@ RawObject Runtime::strReplace(Thread* thread, const Str& src, const Str& oldstr,
 
   // Update the count to the number of occurences of oldstr in src, capped by
   // the given count.
-  count = strCountSubStr(src, oldstr, count);
-  if (count == 0) {
-    return *src;
+  if (oldstr.length() == 0) {
+    count = Utils::minimum(count, src.codePointLength() + 1);
+  } else {
+    count = strCountSubStr(src, oldstr, count);
+    if (count == 0) {
+      return *src;
+    }
   }
 
   word old_len = oldstr.length();
   word new_len = newstr.length();
   word result_len = src_len + (new_len - old_len) * count;
   if (result_len <= SmallStr::kMaxLength) {
-    return strReplaceSmallStr(src, oldstr, newstr, count, result_len);
+    byte buffer[SmallStr::kMaxLength];
+    strReplaceInto(buffer, src, oldstr, newstr, count);
+    return SmallStr::fromBytes(View<byte>(buffer, result_len));
   }
 
   HandleScope scope(thread);
   LargeStr result(&scope, createLargeStr(result_len));
-  word diff = new_len - old_len;
-  word offset = 0;
-  word match_count = 0;
-  word i;
-  for (i = 0; i < src_len && match_count < count;) {
-    // TODO(T41400083): Use a different search algorithm
-    if (strHasPrefix(src, oldstr, i)) {
-      byte* dst = reinterpret_cast<byte*>(LargeStr::cast(*result).address());
-      newstr.copyTo(dst + i + offset, new_len);
-      match_count++;
-      offset += diff;
-      i += old_len;
-      continue;
-    }
-    byte* dst = reinterpret_cast<byte*>(result.address());
-    dst[i + offset] = src.byteAt(i);
-    i++;
-  }
-
-  // Copy the rest of the string.
-  if (i < src_len) {
-    if (src.isLargeStr()) {
-      byte* src_byte = reinterpret_cast<byte*>(LargeStr::cast(*src).address());
-      byte* dst = reinterpret_cast<byte*>(result.address());
-      std::memcpy(dst + i + offset, src_byte + i, src_len - i);
-    } else {
-      for (; i < src_len; i++) {
-        byte* dst = reinterpret_cast<byte*>(result.address());
-        dst[i + offset] = src.byteAt(i);
-      }
-    }
-  }
-
+  strReplaceInto(reinterpret_cast<byte*>(result.address()), src, oldstr, newstr,
+                 count);
   return *result;
 }
 
@@ -51,10 +51,18 @@ enum class StdioState {
   kUnbuffered,
 };
 
+// Hash function used for str and bytes values. `kWyhash` is faster but not
+// designed to resist hash flooding, so it should only be selected for
+// deployments that never hash untrusted input.
+enum class StrHashAlgorithm {
+  kSiphash24,
+  kWyhash,
+};
+
 class Runtime {
  public:
   Runtime(word heap_size, Interpreter* interpreter, RandomState random_seed,
-          StdioState stdio_state);
+          StdioState stdio_state, StrHashAlgorithm str_hash_algorithm);
   ~Runtime();
 
   // Completes the runtime initialization. Should be called after
@@ -319,6 +327,11 @@ class Runtime {
   void setProfiling(const Object& new_thread_func, const Object& call_func,
                     const Object& return_func);
 
+  // Dict mapping functions to a MutableTuple of per-pc execution counts while
+  // bytecode profiling is enabled; `None` otherwise.
+  RawObject bytecodeProfile() { return bytecode_profile_; }
+  void setBytecodeProfile(RawObject profile) { bytecode_profile_ = profile; }
+
   void reinitInterpreter();
 
   void builtinTypeCreated(Thread* thread, const Type& type);
@@ -884,6 +897,8 @@ class Runtime {
 
   bool useBufferedStdio() { return stdio_state_ == StdioState::kBuffered; }
 
+  StrHashAlgorithm strHashAlgorithm() { return str_hash_algorithm_; }
+
  private:
   Runtime(word heap_size);
 
@@ -902,6 +917,7 @@ class Runtime {
   void visitThreadRoots(PointerVisitor* visitor);
 
   word siphash24(View<byte> array);
+  word wyhash(View<byte> array);
 
   RawObject createLargeBytes(word length);
   RawObject createMutableBytes(word length);
@@ -990,6 +1006,8 @@ class Runtime {
   RawObject profiling_call_ = NoneType::object();
   RawObject profiling_return_ = NoneType::object();
 
+  RawObject bytecode_profile_ = NoneType::object();
+
   // Interned strings
   RawObject interned_ = NoneType::object();
   word interned_remaining_ = 0;
@@ -1040,6 +1058,8 @@ class Runtime {
 
   StdioState stdio_state_;
 
+  StrHashAlgorithm str_hash_algorithm_;
+
   DISALLOW_COPY_AND_ASSIGN(Runtime);
 };
 
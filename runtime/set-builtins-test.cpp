@@ -1,9 +1,11 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "set-builtins.h"
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "builtins.h"
+#include "int-builtins.h"
 #include "runtime.h"
 #include "test-utils.h"
 
@@ -953,6 +955,28 @@ TEST_F(SetBuiltinsTest, SetCopy) {
   EXPECT_TRUE(setIncludes(thread, set, key));
 }
 
+TEST_F(SetBuiltinsTest, SetCopyWithRemovedCollidingItemKeepsOtherItems) {
+  HandleScope scope(thread_);
+  // 0, 16 and 32 land in the same bucket of a new set, so removing 0 leaves a
+  // tombstone at the start of the probe sequence of the others.
+  Set set(&scope, runtime_->newSet());
+  Object key(&scope, NoneType::object());
+  for (word i = 0; i < 3; i++) {
+    key = SmallInt::fromWord(i * 16);
+    setHashAndAdd(thread_, set, key);
+  }
+  key = SmallInt::fromWord(0);
+  ASSERT_TRUE(setRemove(thread_, set, key, intHash(*key)));
+
+  Set copy(&scope, setCopy(thread_, set));
+  EXPECT_EQ(copy.numItems(), 2);
+  EXPECT_FALSE(setIncludes(thread_, copy, key, intHash(*key)));
+  key = SmallInt::fromWord(16);
+  EXPECT_TRUE(setIncludes(thread_, copy, key, intHash(*key)));
+  key = SmallInt::fromWord(32);
+  EXPECT_TRUE(setIncludes(thread_, copy, key, intHash(*key)));
+}
+
 TEST_F(SetBuiltinsTest, SetEqualsWithSameSetReturnsTrue) {
   // s = {0, 1, 2}; (s == s) is True
   Thread* thread = Thread::current();
@@ -1173,6 +1197,19 @@ result.update({5})
   EXPECT_EQ(result.numItems(), 1);
 }
 
+TEST_F(SetBuiltinsTest, UpdateWithSetIntoNonEmptySetAddsElements) {
+  HandleScope scope(thread_);
+  Set set(&scope, setFromRange(0, 3));
+  Object other(&scope, setFromRange(2, 100));
+  ASSERT_EQ(setUpdate(thread_, set, other), *set);
+  EXPECT_EQ(set.numItems(), 100);
+  Object key(&scope, NoneType::object());
+  for (word i = 0; i < 100; i++) {
+    key = SmallInt::fromWord(i);
+    EXPECT_TRUE(setIncludes(thread_, set, key, intHash(*key)));
+  }
+}
+
 TEST_F(SetBuiltinsTest, UpdateWithMultipleSetsAddsAllElements) {
   ASSERT_FALSE(runFromCStr(runtime_, R"(
 result = set()
@@ -1218,5 +1255,25 @@ TEST_F(SetBuiltinsTest, DunderOrReturnsSetContainingUnionOfElements) {
   EXPECT_TRUE(setIncludes(thread, result, three));
 }
 
+using SetBenchmark = RuntimeBenchmarkFixture;
+
+BENCHMARK_F(SetBenchmark, DunderOr)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Set set(&scope, setFromRange(0, 1000));
+  Set other(&scope, setFromRange(500, 1500));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runBuiltin(METH(set, __or__), set, other));
+  }
+}
+
+BENCHMARK_F(SetBenchmark, Intersection)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Set set(&scope, setFromRange(0, 1000));
+  Object other(&scope, setFromRange(500, 1500));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(setIntersection(thread_, set, other));
+  }
+}
+
 }  // namespace testing
 }  // namespace py
@@ -200,13 +200,10 @@ static word setLookupForInsertion(Thread* thread, const Tuple& data,
   }
 }
 
-static RawTuple setGrow(Thread* thread, const SetBase& set) {
+// Returns a new data tuple of `new_length` holding the items of `set`,
+// dropping any tombstones.
+static RawTuple setRehash(Thread* thread, const SetBase& set, word new_length) {
   HandleScope scope(thread);
-  Tuple data(&scope, set.data());
-  word new_length = data.length() * Runtime::kSetGrowthFactor;
-  if (new_length == 0) {
-    new_length = Runtime::kInitialSetCapacity * kNumPointers;
-  }
   MutableTuple new_data(&scope, thread->runtime()->newMutableTuple(new_length));
   new_data.fill(NoneType::object());
   // Re-insert items
@@ -220,6 +217,44 @@ static RawTuple setGrow(Thread* thread, const SetBase& set) {
   return *new_data;
 }
 
+static RawTuple setGrow(Thread* thread, const SetBase& set) {
+  word new_length =
+      Tuple::cast(set.data()).length() * Runtime::kSetGrowthFactor;
+  if (new_length == 0) {
+    new_length = Runtime::kInitialSetCapacity * kNumPointers;
+  }
+  return setRehash(thread, set, new_length);
+}
+
+// Grows `set` so that adding `num_new_items` items does not resize it again.
+static void setReserve(Thread* thread, const SetBase& set,
+                       word num_new_items) {
+  if (num_new_items == 0) return;
+  word length = Tuple::cast(set.data()).length();
+  if (length > 0 && 10 * (set.numFilled() + num_new_items) < 3 * length) {
+    return;
+  }
+  // Smallest power of two that keeps the load below the growth threshold.
+  word new_length = Utils::maximum(
+      Utils::nextPowerOfTwo(10 * (set.numItems() + num_new_items) / 3),
+      word{Runtime::kInitialSetCapacity * kNumPointers});
+  set.setData(setRehash(thread, set, new_length));
+}
+
+// Makes the empty `dst` a copy of `src` by copying its data tuple wholesale.
+// Tombstones are copied too so that the probe sequences stay intact.
+static void setCopyData(Thread* thread, const SetBase& dst,
+                        const SetBase& src) {
+  HandleScope scope(thread);
+  Tuple data(&scope, src.data());
+  word length = data.length();
+  MutableTuple new_data(&scope, thread->runtime()->newMutableTuple(length));
+  new_data.replaceFromWith(0, *data, length);
+  dst.setData(*new_data);
+  dst.setNumItems(src.numItems());
+  dst.setNumFilled(src.numFilled());
+}
+
 RawObject setAdd(Thread* thread, const SetBase& set, const Object& value,
                  word hash) {
   HandleScope scope(thread);
@@ -354,6 +389,7 @@ RawObject setUpdate(Thread* thread, const SetBase& dst,
       word hash = SmallInt::cast(*hash_obj).value();
       setAdd(thread, dst, elt, hash);
     }
+    return *dst;
   }
   // Special case for tuples
   if (iterable.isTuple()) {
@@ -372,17 +408,24 @@ RawObject setUpdate(Thread* thread, const SetBase& dst,
   // Special case for built-in set types
   if (thread->runtime()->isInstanceOfSetBase(*iterable)) {
     SetBase src(&scope, *iterable);
-    if (src.numItems() > 0) {
-      for (word i = 0, hash; setNextItemHash(src, &i, &elt, &hash);) {
-        // take hash from data to avoid recomputing it.
-        setAdd(thread, dst, elt, hash);
-      }
+    if (src.numItems() == 0) {
+      return *dst;
+    }
+    if (dst.numItems() == 0) {
+      setCopyData(thread, dst, src);
+      return *dst;
+    }
+    setReserve(thread, dst, src.numItems());
+    for (word i = 0, hash; setNextItemHash(src, &i, &elt, &hash);) {
+      // take hash from data to avoid recomputing it.
+      setAdd(thread, dst, elt, hash);
     }
     return *dst;
   }
   // Special case for dicts
   if (iterable.isDict()) {
     Dict dict(&scope, *iterable);
+    setReserve(thread, dst, dict.numItems());
     for (word i = 0, hash; dictNextKeyHash(dict, &i, &elt, &hash);) {
       setAdd(thread, dst, elt, hash);
     }
@@ -838,17 +881,7 @@ RawObject setCopy(Thread* thread, const SetBase& set) {
   SetBase new_set(&scope, runtime->isInstanceOfSet(*set)
                               ? runtime->newSet()
                               : runtime->newFrozenSet());
-  Tuple data(&scope, set.data());
-  MutableTuple new_data(&scope, runtime->newMutableTuple(data.length()));
-  new_data.fill(NoneType::object());
-  Object value(&scope, NoneType::object());
-  for (word i = 0, hash; setNextItemHash(set, &i, &value, &hash);) {
-    word dst_index = i - kNumPointers;
-    itemAtPut(*new_data, dst_index, hash, *value);
-  }
-  new_set.setData(*new_data);
-  new_set.setNumItems(set.numItems());
-  new_set.setNumFilled(set.numItems());
+  setCopyData(thread, new_set, set);
   return *new_set;
 }
 
@@ -1027,6 +1060,25 @@ RawObject METH(set, __new__)(Thread* thread, Arguments args) {
   return *result;
 }
 
+RawObject METH(set, __or__)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfSet(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(set));
+  }
+  Object other(&scope, args.get(1));
+  if (!runtime->isInstanceOfSetBase(*other)) {
+    return NotImplementedType::object();
+  }
+  Set self(&scope, *self_obj);
+  Set result(&scope, setCopy(thread, self));
+  if (*self == *other) {
+    return *result;
+  }
+  return setUpdate(thread, result, other);
+}
+
 RawObject METH(set, add)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object self(&scope, args.get(0));
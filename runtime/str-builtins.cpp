@@ -84,6 +84,27 @@ void strCopyToWCStr(wchar_t* buf, size_t buf_length, const Str& str) {
   buf[wchar_index] = '\0';
 }
 
+// Returns a pointer to the bytes of `str`. Small strings are copied into
+// `buffer`, which must hold at least `SmallStr::kMaxLength` bytes.
+static const byte* strBytes(const Str& str, byte* buffer) {
+  if (str.isSmallStr()) {
+    str.copyTo(buffer, str.length());
+    return buffer;
+  }
+  return reinterpret_cast<const byte*>(LargeStr::cast(*str).address());
+}
+
+// Returns the number of code points in the bytes [start, end) of `str`.
+static word strCodePointsBetween(const Str& str, word start, word end) {
+  byte buffer[SmallStr::kMaxLength];
+  const byte* data = strBytes(str, buffer);
+  word result = 0;
+  for (word i = start; i < end; i++) {
+    result += !UTF8::isTrailByte(data[i]);
+  }
+  return result;
+}
+
 static word strCountCharFromTo(const Str& haystack, byte needle, word start,
                                word end) {
   word result = 0;
@@ -103,6 +124,12 @@ static word strCountCharFromTo(const Str& haystack, byte needle, word start,
 
 RawObject strCount(const Str& haystack, const Str& needle, word start,
                    word end) {
+  if (needle.length() == 0) {
+    // The empty string matches before and after every code point.
+    word length = haystack.codePointLength();
+    Slice::adjustSearchIndices(&start, &end, length);
+    return SmallInt::fromWord(start > end ? 0 : end - start + 1);
+  }
   if (end < 0 || start < 0) {
     // N.B.: If end is negative we may be able to cheaply walk backward. We
     // should avoid calling adjustSearchIndices here since the underlying
@@ -132,7 +159,6 @@ RawObject strCount(const Str& haystack, const Str& needle, word start,
         haystack, SmallStr::cast(*needle).byteAt(0), start_index, end_index));
   }
 
-  // TODO(T41400083): Use a different search algorithm
   return SmallInt::fromWord(strCountSubStrFromTo(haystack, needle, start_index,
                                                  end_index, haystack.length()));
 }
@@ -140,16 +166,14 @@ RawObject strCount(const Str& haystack, const Str& needle, word start,
 word strCountSubStrFromTo(const Str& haystack, const Str& needle, word start,
                           word end, word max_count) {
   DCHECK(max_count >= 0, "max_count must be non-negative");
+  DCHECK(needle.length() > 0, "needle must not be empty");
   word needle_len = needle.length();
   word num_match = 0;
   // Loop is in byte space, not code point space
-  for (word i = start; i <= end - needle_len && num_match < max_count;) {
-    if (strHasPrefix(haystack, needle, i)) {
-      i += needle_len;
-      num_match++;
-      continue;
-    }
-    i++;
+  for (word i = strFindByteOffset(haystack, needle, start, end);
+       i != -1 && num_match < max_count;
+       i = strFindByteOffset(haystack, needle, i + needle_len, end)) {
+    num_match++;
   }
   return num_match;
 }
@@ -309,15 +333,13 @@ RawObject strSplit(Thread* thread, const Str& str, const Str& sep,
   MutableTuple result_items(&scope, runtime->newMutableTuple(result_len));
   word last_idx = 0;
   word sep_len = sep.length();
-  for (word i = 0, result_idx = 0; result_idx < num_splits;) {
-    if (strHasPrefix(str, sep, i)) {
-      result_items.atPut(result_idx++,
-                         strSubstr(thread, str, last_idx, i - last_idx));
-      i += sep_len;
-      last_idx = i;
-    } else {
-      i = str.offsetByCodePoints(i, 1);
-    }
+  word str_len = str.length();
+  for (word result_idx = 0; result_idx < num_splits; result_idx++) {
+    word i = strFindByteOffset(str, sep, last_idx, str_len);
+    DCHECK(i != -1, "expected to find num_splits separators");
+    result_items.atPut(result_idx,
+                       strSubstr(thread, str, last_idx, i - last_idx));
+    last_idx = i + sep_len;
   }
   result_items.atPut(num_splits,
                      strSubstr(thread, str, last_idx, str.length() - last_idx));
@@ -852,16 +874,9 @@ word strFind(const Str& haystack, const Str& needle) {
   if (needle_len == 1 && haystack.isASCII()) {
     return strFindAsciiChar(haystack, needle.byteAt(0));
   }
-  // Loop is in byte space, not code point space
-  word result = 0;
-  // TODO(T41400083): Use a different search algorithm
-  for (word i = 0; i <= haystack_len - needle_len; result++) {
-    if (strHasPrefix(haystack, needle, i)) {
-      return result;
-    }
-    i = haystack.offsetByCodePoints(i, 1);
-  }
-  return -1;
+  word offset = strFindByteOffset(haystack, needle, 0, haystack_len);
+  if (offset == -1) return -1;
+  return strCodePointsBetween(haystack, 0, offset);
 }
 
 word strFindWithRange(const Str& haystack, const Str& needle, word start,
@@ -869,41 +884,38 @@ word strFindWithRange(const Str& haystack, const Str& needle, word start,
   if (end < 0 || start < 0) {
     Slice::adjustSearchIndices(&start, &end, haystack.codePointLength());
   }
+  if (start > end) return -1;
 
   word start_index = haystack.offsetByCodePoints(0, start);
-  if (start_index == haystack.length() && needle.length() > 0) {
-    // Haystack is too small; fast early return
-    return -1;
+  if (start_index == haystack.length()) {
+    // The empty string is found at the end of the string, but not past it
+    if (needle.length() > 0) return -1;
+    return start == haystack.codePointLength() ? start : -1;
   }
   word end_index = haystack.offsetByCodePoints(start_index, end - start);
 
-  if ((end_index - start_index) < needle.length() || start_index > end_index) {
+  if ((end_index - start_index) < needle.length()) {
     // Haystack is too small; fast early return
     return -1;
   }
+  if (needle.length() == 0) return start;
 
-  // Loop is in byte space, not code point space
-  word result = start;
-  // TODO(T41400083): Use a different search algorithm
-  for (word i = start_index; i <= end_index - needle.length(); result++) {
-    bool has_match = strHasPrefix(haystack, needle, i);
-    word next = haystack.offsetByCodePoints(i, 1);
-    if (i == next) {
-      // We've reached a fixpoint; offsetByCodePoints will not advance past the
-      // length of the string.
-      if (start_index >= i) {
-        // The start is greater than the length of the string.
-        return -1;
-      }
-      // If the start is within bounds, just return the last found index.
-      break;
-    }
-    if (has_match) {
-      return result;
-    }
-    i = next;
-  }
-  return -1;
+  word offset = strFindByteOffset(haystack, needle, start_index, end_index);
+  if (offset == -1) return -1;
+  return start + strCodePointsBetween(haystack, start_index, offset);
+}
+
+word strFindByteOffset(const Str& haystack, const Str& needle, word start,
+                       word end) {
+  DCHECK_BOUND(start, end);
+  DCHECK_BOUND(end, haystack.length());
+  byte haystack_buffer[SmallStr::kMaxLength];
+  byte needle_buffer[SmallStr::kMaxLength];
+  const byte* haystack_data = strBytes(haystack, haystack_buffer);
+  const byte* needle_data = strBytes(needle, needle_buffer);
+  word result = Utils::memoryFind(haystack_data + start, end - start,
+                                  needle_data, needle.length());
+  return result == -1 ? -1 : start + result;
 }
 
 word strFindAsciiChar(const Str& haystack, byte needle) {
@@ -954,23 +966,26 @@ word strRFind(const Str& haystack, const Str& needle, word start, word end) {
     return -1;
   }
   word end_index = haystack.offsetByCodePoints(start_index, end - start);
-  if ((end_index - start_index) < needle.length() || start_index > end_index) {
+  if ((end_index - start_index) < needle.length()) {
     // Haystack is too small; fast early return
     return -1;
   }
-  // Loop is in byte space, not code point space
-  // Invariant: cp_offset and byte_offset describe the same offset into the
-  // string, but one is in code point space and the other is in byte space
-  // TODO(T41400083): Use a different search algorithm
-  for (word cp_offset = end - 1,
-            byte_offset = haystack.offsetByCodePoints(end_index, -1);
-       byte_offset >= 0; cp_offset--,
-            byte_offset = haystack.offsetByCodePoints(byte_offset, -1)) {
-    if (strHasPrefix(haystack, needle, byte_offset)) {
-      return cp_offset;
-    }
-  }
-  return -1;
+  word offset = strRFindByteOffset(haystack, needle, start_index, end_index);
+  if (offset == -1) return -1;
+  return start + strCodePointsBetween(haystack, start_index, offset);
+}
+
+word strRFindByteOffset(const Str& haystack, const Str& needle, word start,
+                        word end) {
+  DCHECK_BOUND(start, end);
+  DCHECK_BOUND(end, haystack.length());
+  byte haystack_buffer[SmallStr::kMaxLength];
+  byte needle_buffer[SmallStr::kMaxLength];
+  const byte* haystack_data = strBytes(haystack, haystack_buffer);
+  const byte* needle_data = strBytes(needle, needle_buffer);
+  word result = Utils::memoryFindReverse(haystack_data + start, end - start,
+                                         needle_data, needle.length());
+  return result == -1 ? -1 : start + result;
 }
 
 word strRFindAsciiChar(const Str& haystack, byte needle) {
@@ -47,6 +47,12 @@ word strFind(const Str& haystack, const Str& needle);
 word strFindWithRange(const Str& haystack, const Str& needle, word start,
                       word end);
 
+// Look for needle in the bytes [start, end) of haystack. Return the byte
+// offset of the first occurrence, or -1 if needle was not found. Uses a
+// linear-time search so long haystacks do not degrade to quadratic time.
+word strFindByteOffset(const Str& haystack, const Str& needle, word start,
+                       word end);
+
 word strFindAsciiChar(const Str& haystack, byte needle);
 
 // Find the index of the first non-whitespace character in the string. If there
@@ -82,6 +88,11 @@ RawObject strJoinWithTupleOrList(Thread* thread, const Str& sep,
 // and end are code point offsets, not byte offsets.
 word strRFind(const Str& haystack, const Str& needle, word start, word end);
 
+// Like `strFindByteOffset`, but returns the byte offset of the last
+// occurrence.
+word strRFindByteOffset(const Str& haystack, const Str& needle, word start,
+                        word end);
+
 word strRFindAsciiChar(const Str& haystack, byte needle);
 
 RawObject strStrip(Thread* thread, const Str& src, const Str& str);
@@ -27,7 +27,7 @@ RawObject internSetGrow(Thread* thread, RawMutableTuple data_raw,
     if (slot == SmallInt::fromWord(0)) {
       continue;
     }
-    word hash = LargeStr::cast(slot).header().hashCode();
+    word hash = LargeStr::cast(slot).hashCode();
     word index = hash & mask;
     word num_probes = 0;
     while (new_data.at(index) != SmallInt::fromWord(0)) {
@@ -43,7 +43,7 @@ RawObject internSetGrow(Thread* thread, RawMutableTuple data_raw,
 }
 
 bool internSetContains(RawMutableTuple data, RawLargeStr str) {
-  word hash = str.header().hashCode();
+  word hash = str.hashCode();
   if (hash == Header::kUninitializedHash) {
     return false;
   }
@@ -43,7 +43,7 @@ inline bool internSetAddFromAll(Thread* thread, RawMutableTuple data,
     RawObject slot = data.at(index);
     if (slot == SmallInt::fromWord(0)) {
       RawLargeStr new_str = LargeStr::cast(runtime->newStrWithAll(bytes));
-      new_str.setHeader(new_str.header().withHashCode(hash));
+      new_str.setHashCode(hash);
       data.atPut(index, new_str);
       *result = new_str;
       return true;
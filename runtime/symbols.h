@@ -69,6 +69,8 @@ class Runtime;
   V(PAGESIZE)                                                                  \
   V(PendingDeprecationWarning)                                                 \
   V(PermissionError)                                                           \
+  V(PickleBuffer)                                                              \
+  V(PicklingError)                                                             \
   V(ProcessLookupError)                                                        \
   V(PROT_EXEC)                                                                 \
   V(PROT_READ)                                                                 \
@@ -106,6 +108,7 @@ class Runtime;
   V(UnicodeError)                                                              \
   V(UnicodeTranslateError)                                                     \
   V(UnicodeWarning)                                                            \
+  V(UnpicklingError)                                                           \
   V(UserWarning)                                                               \
   V(ValueError)                                                                \
   V(Warning)                                                                   \
@@ -225,6 +228,8 @@ class Runtime;
   V(__radd__)                                                                  \
   V(__rand__)                                                                  \
   V(__rdivmod__)                                                               \
+  V(__reduce__)                                                                \
+  V(__reduce_ex__)                                                             \
   V(__repr__)                                                                  \
   V(__rfloordiv__)                                                             \
   V(__rlshift__)                                                               \
@@ -258,6 +263,7 @@ class Runtime;
   V(__weaklink__prev)                                                          \
   V(__weaklink__referent)                                                      \
   V(__xor__)                                                                   \
+  V(_additems)                                                                 \
   V(_appending)                                                                \
   V(_array__buffer)                                                            \
   V(_array__length)                                                            \
@@ -285,6 +291,7 @@ class Runtime;
   V(_buffer_num_bytes)                                                         \
   V(_buffer_size)                                                              \
   V(_buffered_reader__read_buf)                                                \
+  V(_build)                                                                    \
   V(_builtins)                                                                 \
   V(_bytearray__bytes)                                                         \
   V(_bytearray__num_items)                                                     \
@@ -311,6 +318,7 @@ class Runtime;
   V(_coroutine__origin)                                                        \
   V(_coroutine_wrapper__cw_coroutine)                                          \
   V(_created)                                                                  \
+  V(_decode_string)                                                            \
   V(_decode_with_cls)                                                          \
   V(_decoded_chars)                                                            \
   V(_decoded_chars_used)                                                       \
@@ -336,6 +344,7 @@ class Runtime;
   V(_dict_item_iterator__iterable)                                             \
   V(_dict_item_iterator__num_found)                                            \
   V(_dict_items__dict)                                                         \
+  V(_dict_items_list)                                                          \
   V(_dict_key_iterator__index)                                                 \
   V(_dict_key_iterator__iterable)                                              \
   V(_dict_key_iterator__num_found)                                             \
@@ -344,7 +353,9 @@ class Runtime;
   V(_dict_value_iterator__iterable)                                            \
   V(_dict_value_iterator__num_found)                                           \
   V(_dict_values__dict)                                                        \
+  V(_dumps)                                                                    \
   V(_enable_threads)                                                           \
+  V(_encode_with_cls)                                                          \
   V(_encoder)                                                                  \
   V(_encoding)                                                                 \
   V(_err_program_text)                                                         \
@@ -355,6 +366,7 @@ class Runtime;
   V(_exception_state__traceback)                                               \
   V(_exception_state__type)                                                    \
   V(_exception_state__value)                                                   \
+  V(_extend)                                                                   \
   V(_fd)                                                                       \
   V(_float)                                                                    \
   V(_frozen_importlib)                                                         \
@@ -375,6 +387,8 @@ class Runtime;
   V(_function__entry_ex)                                                       \
   V(_function__entry_kw)                                                       \
   V(_function__flags)                                                          \
+  V(_function__jit_deopt_count)                                                \
+  V(_function__jit_deopts)                                                     \
   V(_function__kw_defaults)                                                    \
   V(_function__rewritten_bytecode)                                             \
   V(_function__stack_size)                                                     \
@@ -384,6 +398,8 @@ class Runtime;
   V(_generator__exception_state)                                               \
   V(_generator__frame)                                                         \
   V(_generator__yield_from)                                                    \
+  V(_get_extension)                                                            \
+  V(_global_info)                                                              \
   V(_has_read1)                                                                \
   V(_import_all_from)                                                          \
   V(_index_or_int)                                                             \
@@ -398,7 +414,9 @@ class Runtime;
   V(_iterator__iterable)                                                       \
   V(_json)                                                                     \
   V(_layout__described_type)                                                   \
+  V(_layout__expected_layout)                                                  \
   V(_layout__in_object_attributes)                                             \
+  V(_layout__num_growths)                                                      \
   V(_layout__overflow_attributes)                                              \
   V(_layout__additions)                                                        \
   V(_layout__deletions)                                                        \
@@ -409,6 +427,7 @@ class Runtime;
   V(_list_iterator__index)                                                     \
   V(_list_ctor)                                                                \
   V(_list_iterator__iterable)                                                  \
+  V(_load)                                                                     \
   V(_longrange_iterator__next)                                                 \
   V(_longrange_iterator__step)                                                 \
   V(_longrange_iterator__stop)                                                 \
@@ -455,7 +474,13 @@ class Runtime;
   V(_new_member_set_pyobject)                                                  \
   V(_new_member_set_readonly)                                                  \
   V(_new_member_set_readonly_strings)                                          \
+  V(_newobj)                                                                   \
+  V(_newobj_ex)                                                                \
+  V(_newobj_ex_partial)                                                        \
+  V(_next_buffer)                                                              \
   V(_pendingcr)                                                                \
+  V(_pickle)                                                                   \
+  V(_picklebuffer_info)                                                        \
   V(_pointer)                                                                  \
   V(_pointer__cptr)                                                            \
   V(_pointer__length)                                                          \
@@ -471,8 +496,11 @@ class Runtime;
   V(_readable)                                                                 \
   V(_reader)                                                                   \
   V(_readnl)                                                                   \
+  V(_readonly_buffer)                                                          \
   V(_readtranslate)                                                            \
   V(_readuniversal)                                                            \
+  V(_reduce_bytes)                                                             \
+  V(_reduce_set)                                                               \
   V(_ref__callback)                                                            \
   V(_ref__hash)                                                                \
   V(_ref__link)                                                                \
@@ -487,6 +515,7 @@ class Runtime;
   V(_set_iterator__consumed_count)                                             \
   V(_set_iterator__index)                                                      \
   V(_set_iterator__iterable)                                                   \
+  V(_setitems)                                                                 \
   V(_signal)                                                                   \
   V(_slice_index)                                                              \
   V(_slot_descriptor__offset)                                                  \
@@ -568,6 +597,7 @@ class Runtime;
   V(backslashreplace)                                                          \
   V(big)                                                                       \
   V(bool)                                                                      \
+  V(buffer)                                                                    \
   V(buffer_size)                                                               \
   V(builtin_module_names)                                                      \
   V(builtins)                                                                  \
@@ -632,6 +662,7 @@ class Runtime;
   V(fget)                                                                      \
   V(filename)                                                                  \
   V(fileno)                                                                    \
+  V(find_class)                                                                \
   V(float)                                                                     \
   V(floordiv)                                                                  \
   V(flush)                                                                     \
@@ -641,6 +672,7 @@ class Runtime;
   V(fset)                                                                      \
   V(function)                                                                  \
   V(generator)                                                                 \
+  V(get)                                                                       \
   V(getline)                                                                   \
   V(getsizeof)                                                                 \
   V(gi_running)                                                                \
@@ -703,6 +735,7 @@ class Runtime;
   V(maxlen)                                                                    \
   V(maxsize)                                                                   \
   V(maxunicode)                                                                \
+  V(memo)                                                                      \
   V(memoryview)                                                                \
   V(method)                                                                    \
   V(mmap)                                                                      \
@@ -729,11 +762,13 @@ class Runtime;
   V(owner)                                                                     \
   V(partition)                                                                 \
   V(path)                                                                      \
+  V(persistent_load)                                                           \
   V(platform)                                                                  \
   V(pos)                                                                       \
   V(pow)                                                                       \
   V(print_file_and_line)                                                       \
   V(property)                                                                  \
+  V(proto)                                                                     \
   V(proxy)                                                                     \
   V(pycache_prefix)                                                            \
   V(range)                                                                     \
@@ -811,6 +846,7 @@ class Runtime;
   V(weakcallableproxy)                                                         \
   V(weakproxy)                                                                 \
   V(write)                                                                     \
+  V(wyhash)                                                                    \
   V(xor)
 
 // clang-format off
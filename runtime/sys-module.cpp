@@ -25,6 +25,7 @@
 #include "modules.h"
 #include "objects.h"
 #include "os.h"
+#include "profiling.h"
 #include "runtime.h"
 #include "str-builtins.h"
 #include "thread.h"
@@ -102,7 +103,11 @@ void FUNC(sys, __init_module__)(Thread* thread, const Module& module,
   Object hash_inf(&scope, SmallInt::fromWord(kHashInf));
   Object hash_nan(&scope, SmallInt::fromWord(kHashNan));
   Object hash_imag(&scope, SmallInt::fromWord(kHashImag));
-  Object hash_algorithm(&scope, runtime->symbols()->at(ID(siphash24)));
+  Object hash_algorithm(
+      &scope, runtime->symbols()->at(
+                  runtime->strHashAlgorithm() == StrHashAlgorithm::kWyhash
+                      ? ID(wyhash)
+                      : ID(siphash24)));
   Object hash_bits(&scope, SmallInt::fromWord(64));
   Object hash_seed_bits(&scope, SmallInt::fromWord(128));
   Object hash_cutoff(&scope, SmallInt::fromWord(SmallStr::kMaxLength));
@@ -269,6 +274,20 @@ void writeStderrV(Thread* thread, const char* format, va_list va) {
   writeImpl(thread, sys_stderr, stderr, format, va);
 }
 
+RawObject FUNC(sys, _bytecode_profile)(Thread* thread, Arguments) {
+  return profiling_bytecode_results(thread);
+}
+
+RawObject FUNC(sys, _bytecode_profile_disable)(Thread* thread, Arguments) {
+  profiling_bytecode_disable(thread);
+  return NoneType::object();
+}
+
+RawObject FUNC(sys, _bytecode_profile_enable)(Thread* thread, Arguments) {
+  profiling_bytecode_enable(thread);
+  return NoneType::object();
+}
+
 RawObject FUNC(sys, _getframe)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Runtime* runtime = thread->runtime();
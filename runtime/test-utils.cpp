@@ -83,7 +83,8 @@ Runtime* createTestRuntime() {
       use_cpp_interpreter ? createCppInterpreter() : createAsmInterpreter();
   RandomState random_state = randomState();
   Runtime* runtime =
-      new Runtime(heap_size, interpreter, random_state, StdioState::kBuffered);
+      new Runtime(heap_size, interpreter, random_state, StdioState::kBuffered,
+                  StrHashAlgorithm::kSiphash24);
   Thread* thread = Thread::current();
   CHECK(initializeSysWithDefaults(thread).isNoneType(),
         "initializeSys() failed");
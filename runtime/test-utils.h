@@ -4,6 +4,7 @@
 #include <functional>
 #include <string>
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "handles.h"
@@ -48,6 +49,20 @@ class RuntimeFixture : public ::testing::Test {
   Thread* thread_;
 };
 
+class RuntimeBenchmarkFixture : public benchmark::Fixture {
+ public:
+  void SetUp(benchmark::State&) {
+    runtime_ = createTestRuntime();
+    thread_ = Thread::current();
+  }
+
+  void TearDown(benchmark::State&) { delete runtime_; }
+
+ protected:
+  Runtime* runtime_;
+  Thread* thread_;
+};
+
 // Basic variant wrapper for a subset of Python values, used by
 // EXPECT_PYLIST_EQ().
 class Value {
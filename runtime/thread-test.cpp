@@ -2,6 +2,7 @@
 #include "thread.h"
 
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
 
@@ -2115,5 +2116,52 @@ TEST_F(ThreadTest, StrOffsetWithCacheMissReturnsCorrectOffsets) {
   EXPECT_EQ(thread_->strOffset(str, 2), 2);
 }
 
+TEST_F(ThreadTest, StrOffsetWithLargeNonASCIIStrReturnsCorrectOffsets) {
+  HandleScope scope(thread_);
+  std::string text;
+  for (word i = 0; i < 1000; i++) {
+    text += i % 3 == 0 ? "\u20ac" : "a";
+  }
+  Str str(&scope, runtime_->newStrFromCStr(text.c_str()));
+  ASSERT_TRUE(str.isLargeStr());
+  word num_code_points = str.codePointLength();
+  for (word index : {999, 0, 500, 63, 64, 65, 998, 129, 700, 1}) {
+    EXPECT_EQ(thread_->strOffset(str, index), str.offsetByCodePoints(0, index))
+        << index;
+  }
+  EXPECT_EQ(thread_->strOffset(str, num_code_points), str.length());
+  EXPECT_EQ(thread_->strOffset(str, num_code_points + 100), str.length());
+  EXPECT_EQ(thread_->strOffset(str, -1000), -1);
+}
+
+TEST_F(ThreadTest, StrOffsetWithInterleavedLargeNonASCIIStrsReturnsOffsets) {
+  HandleScope scope(thread_);
+  std::string text1, text2;
+  for (word i = 0; i < 2000; i++) {
+    text1 += i % 2 == 0 ? "\u00e9" : "b";
+    text2 += i % 5 == 0 ? "\U0001f600" : "c";
+  }
+  Str str1(&scope, runtime_->newStrFromCStr(text1.c_str()));
+  Str str2(&scope, runtime_->newStrFromCStr(text2.c_str()));
+  Str other(&scope, Str::empty());
+  for (word i = 0; i < 100; i++) {
+    word index = (i * 769) % 2000;
+    EXPECT_EQ(thread_->strOffset(str1, index),
+              str1.offsetByCodePoints(0, index));
+    EXPECT_EQ(thread_->strOffset(str2, index),
+              str2.offsetByCodePoints(0, index));
+    if (i % 10 == 0) {
+      // Evict both strings from the breadcrumb cache.
+      for (word j = 0; j < Thread::kStrOffsetBreadcrumbCacheSize; j++) {
+        std::string filler = text1 + std::to_string(j);
+        other = runtime_->newStrFromCStr(filler.c_str());
+        EXPECT_EQ(thread_->strOffset(other, 1500),
+                  other.offsetByCodePoints(0, 1500));
+      }
+      runtime_->collectGarbage();
+    }
+  }
+}
+
 }  // namespace testing
 }  // namespace py
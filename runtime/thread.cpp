@@ -68,6 +68,7 @@ void Thread::visitRoots(PointerVisitor* visitor) {
   visitor->visitPointer(&pending_exc_type_, PointerKind::kThread);
   visitor->visitPointer(&pending_exc_value_, PointerKind::kThread);
   visitor->visitPointer(&profiling_data_, PointerKind::kThread);
+  visitor->visitPointer(&str_offset_breadcrumbs_, PointerKind::kThread);
   visitor->visitPointer(&str_offset_str_, PointerKind::kThread);
 }
 
@@ -835,6 +836,10 @@ void Thread::enableProfiling() { interrupt(kProfile); }
 
 void Thread::disableProfiling() { clearInterrupt(kProfile); }
 
+void Thread::clearOpcodeCounts() {
+  std::memset(opcode_counts_, 0, sizeof(opcode_counts_));
+}
+
 RawObject Thread::reprEnter(const Object& obj) {
   HandleScope scope(this);
   if (api_repr_list_.isNoneType()) {
@@ -862,20 +867,85 @@ void Thread::reprLeave(const Object& obj) {
   }
 }
 
+static bool strUsesOffsetBreadcrumbs(const Str& str) {
+  return str.isLargeStr() &&
+         str.length() >= Thread::kStrOffsetBreadcrumbMinLength &&
+         !LargeStr::cast(*str).isASCII();
+}
+
 word Thread::strOffset(const Str& str, word index) {
-  if (str != str_offset_str_) {
+  if (str == str_offset_str_) {
+    word index_diff = index - str_offset_index_;
+    if ((-kStrOffsetBreadcrumbInterval <= index_diff &&
+         index_diff <= kStrOffsetBreadcrumbInterval) ||
+        !strUsesOffsetBreadcrumbs(str)) {
+      word offset = str.offsetByCodePoints(str_offset_offset_, index_diff);
+      if (0 <= offset && offset < str.length()) {
+        str_offset_index_ = index;
+        str_offset_offset_ = offset;
+      }
+      return offset;
+    }
+  } else if (index <= kStrOffsetBreadcrumbInterval ||
+             !strUsesOffsetBreadcrumbs(str)) {
     str_offset_str_ = *str;
     str_offset_index_ = index;
     str_offset_offset_ = str.offsetByCodePoints(0, index);
     return str_offset_offset_;
   }
-  word index_diff = index - str_offset_index_;
-  word offset = str.offsetByCodePoints(str_offset_offset_, index_diff);
+  word offset = strOffsetFromBreadcrumbs(str, index);
   if (0 <= offset && offset < str.length()) {
+    str_offset_str_ = *str;
     str_offset_index_ = index;
     str_offset_offset_ = offset;
   }
   return offset;
 }
 
+void Thread::clearStrOffsetBreadcrumbs() {
+  str_offset_breadcrumbs_ = NoneType::object();
+  str_offset_breadcrumbs_next_ = 0;
+}
+
+word Thread::strOffsetFromBreadcrumbs(const Str& str, word index) {
+  if (index < 0) return -1;
+  HandleScope scope(this);
+  if (str_offset_breadcrumbs_.isNoneType()) {
+    MutableTuple cache(
+        &scope, runtime_->newMutableTuple(kStrOffsetBreadcrumbCacheSize * 2));
+    cache.fill(NoneType::object());
+    str_offset_breadcrumbs_ = *cache;
+  }
+  MutableTuple cache(&scope, str_offset_breadcrumbs_);
+  Object breadcrumbs_obj(&scope, NoneType::object());
+  for (word i = 0; i < cache.length(); i += 2) {
+    if (cache.at(i) == *str) {
+      breadcrumbs_obj = cache.at(i + 1);
+      break;
+    }
+  }
+  if (breadcrumbs_obj.isNoneType()) {
+    word num_breadcrumbs =
+        (str.codePointLength() + kStrOffsetBreadcrumbInterval - 1) /
+        kStrOffsetBreadcrumbInterval;
+    MutableTuple breadcrumbs(&scope,
+                             runtime_->newMutableTuple(num_breadcrumbs));
+    for (word i = 0, offset = 0; i < num_breadcrumbs; i++) {
+      breadcrumbs.atPut(i, SmallInt::fromWord(offset));
+      offset = str.offsetByCodePoints(offset, kStrOffsetBreadcrumbInterval);
+    }
+    word slot = str_offset_breadcrumbs_next_;
+    str_offset_breadcrumbs_next_ = (slot + 2) % cache.length();
+    cache.atPut(slot, *str);
+    cache.atPut(slot + 1, *breadcrumbs);
+    breadcrumbs_obj = *breadcrumbs;
+  }
+  MutableTuple breadcrumbs(&scope, *breadcrumbs_obj);
+  word crumb = Utils::minimum(index / kStrOffsetBreadcrumbInterval,
+                              breadcrumbs.length() - 1);
+  word crumb_offset = SmallInt::cast(breadcrumbs.at(crumb)).value();
+  return str.offsetByCodePoints(crumb_offset,
+                                index - crumb * kStrOffsetBreadcrumbInterval);
+}
+
 }  // namespace py
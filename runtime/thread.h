@@ -1,6 +1,7 @@
 /* Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com) */
 #pragma once
 
+#include "bytecode.h"
 #include "frame.h"
 #include "globals.h"
 #include "handles-decl.h"
@@ -377,6 +378,12 @@ class Thread {
   // to be accurate when `Runtime::supportProfiling()` is enabled.
   word opcodeCount() { return opcode_count_; }
 
+  void countOpcode(Bytecode bc) { opcode_counts_[bc]++; }
+  // Returns number of times `bc` was executed in this thread while bytecode
+  // profiling was enabled.
+  word opcodeCountFor(Bytecode bc) { return opcode_counts_[bc]; }
+  void clearOpcodeCounts();
+
   bool profilingEnabled();
   void enableProfiling();
   void disableProfiling();
@@ -384,8 +391,24 @@ class Thread {
   RawObject profilingData() { return profiling_data_; }
   void setProfilingData(RawObject data) { profiling_data_ = data; }
 
+  // Returns the byte offset of the code point at `index` in `str`. Large
+  // non-ASCII strings keep a side table of byte offsets every
+  // `kStrOffsetBreadcrumbInterval` code points so that random access walks at
+  // most that many code points.
   word strOffset(const Str& str, word index);
 
+  // Returns the byte offset of code point `index` in `str`, starting the walk
+  // at the closest breadcrumb.
+  word strOffsetFromBreadcrumbs(const Str& str, word index);
+
+  // Drops the breadcrumb tables. Called before each collection so that the
+  // cache does not keep otherwise dead strings alive.
+  void clearStrOffsetBreadcrumbs();
+
+  static const word kStrOffsetBreadcrumbInterval = 64;
+  static const word kStrOffsetBreadcrumbMinLength = 1024;
+  static const word kStrOffsetBreadcrumbCacheSize = 4;
+
   bool wouldStackOverflow(word size);
   bool handleInterrupt(word size);
 
@@ -408,6 +431,7 @@ class Thread {
   Frame* openAndLinkFrame(word size, word locals_offset);
 
   void handleInterruptWithFrame();
+
   Frame* handleInterruptPushCallFrame(RawFunction function, word max_stack_size,
                                       word initial_stack_size,
                                       word locals_offset);
@@ -464,12 +488,22 @@ class Thread {
   word str_offset_index_;
   word str_offset_offset_;
 
+  // MutableTuple of (LargeStr, MutableTuple of byte offsets) pairs, replaced
+  // round-robin.
+  RawObject str_offset_breadcrumbs_ = RawNoneType::object();
+  word str_offset_breadcrumbs_next_ = 0;
+
   // C-API current recursion depth used via _PyThreadState_GetRecursionDepth
   int recursion_depth_ = 0;
 
   // C-API recursion limit as set via Py_SetRecursionLimit.
   int recursion_limit_ = 1000;  // CPython's default: Py_DEFAULT_RECURSION_LIMIT
 
+  // Number of times each opcode was executed in the thread while bytecode
+  // profiling was enabled. Kept behind the fields used by the assembly
+  // interpreter so that their offsets still fit in 8-bit displacements.
+  word opcode_counts_[kNumBytecodes] = {};
+
   static thread_local Thread* current_thread_;
 
   DISALLOW_COPY_AND_ASSIGN(Thread);
@@ -1,6 +1,7 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "tuple-builtins.h"
 
+#include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 
 #include "builtins.h"
@@ -193,6 +194,31 @@ TEST_F(TupleBuiltinsTest,
   EXPECT_TRUE(isIntEqualsWord(result.at(5), 3));
 }
 
+TEST_F(TupleBuiltinsTest, DunderMulWithManyRepetitionsRepeatsItems) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, tupleFromRange(1, 4));
+  Int times(&scope, SmallInt::fromWord(5));
+  Object result_obj(&scope, runBuiltin(METH(tuple, __mul__), tuple, times));
+  ASSERT_TRUE(result_obj.isTuple());
+  Tuple result(&scope, *result_obj);
+  ASSERT_EQ(result.length(), 15);
+  for (word i = 0; i < result.length(); i++) {
+    EXPECT_TRUE(isIntEqualsWord(result.at(i), i % 3 + 1));
+  }
+}
+
+TEST_F(TupleBuiltinsTest, TupleRepeatPrefixCopiesPrefix) {
+  HandleScope scope(thread_);
+  MutableTuple tuple(&scope, runtime_->newMutableTuple(14));
+  tuple.fill(NoneType::object());
+  tuple.atPut(0, SmallInt::fromWord(0));
+  tuple.atPut(1, SmallInt::fromWord(1));
+  tupleRepeatPrefix(tuple, 2, 7);
+  for (word i = 0; i < tuple.length(); i++) {
+    EXPECT_TRUE(isIntEqualsWord(tuple.at(i), i % 2));
+  }
+}
+
 TEST_F(TupleBuiltinsTest, DunderMulWithEmptyTuple) {
   HandleScope scope(thread_);
   Tuple tuple(&scope, runtime_->emptyTuple());
@@ -621,5 +647,48 @@ tuple.__lt__(t1, t2)
   EXPECT_FALSE(Thread::current()->hasPendingException());
 }
 
+TEST_F(TupleBuiltinsTest, CountReturnsNumberOfEqualItems) {
+  ASSERT_FALSE(runFromCStr(runtime_, R"(
+class C:
+  def __eq__(self, other):
+    raise UserWarning("foo")
+c = C()
+result = (1, 2.0, 2, 1, 1.0).count(1)
+identical = (c, c).count(c)
+)")
+                   .isError());
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "result"), 3));
+  EXPECT_TRUE(isIntEqualsWord(mainModuleAt(runtime_, "identical"), 2));
+}
+
+TEST_F(TupleBuiltinsTest, TupleIndexReturnsFirstMatchInRange) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, tupleFromRange(0, 10));
+  Object value(&scope, SmallInt::fromWord(4));
+  EXPECT_TRUE(isIntEqualsWord(tupleIndex(thread_, tuple, value, 0, 10), 4));
+  EXPECT_TRUE(isIntEqualsWord(tupleIndex(thread_, tuple, value, 5, 10), -1));
+  EXPECT_TRUE(isIntEqualsWord(tupleIndex(thread_, tuple, value, 0, 4), -1));
+}
+
+using TupleBenchmark = RuntimeBenchmarkFixture;
+
+BENCHMARK_F(TupleBenchmark, DunderMul)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, tupleFromRange(0, 16));
+  Object times(&scope, SmallInt::fromWord(1000));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runBuiltin(METH(tuple, __mul__), tuple, times));
+  }
+}
+
+BENCHMARK_F(TupleBenchmark, Count)(benchmark::State& state) {
+  HandleScope scope(thread_);
+  Tuple tuple(&scope, tupleFromRange(0, 1000));
+  Object value(&scope, SmallInt::fromWord(999));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runBuiltin(METH(tuple, count), tuple, value));
+  }
+}
+
 }  // namespace testing
 }  // namespace py
@@ -69,6 +69,26 @@ RawObject tupleHash(Thread* thread, const Tuple& tuple) {
   return SmallInt::fromWordTruncated(result);
 }
 
+RawObject tupleIndex(Thread* thread, const Tuple& tuple, const Object& value,
+                     word start, word stop) {
+  for (word i = start, end = Utils::minimum(stop, tuple.length()); i < end;
+       i++) {
+    RawObject eq = Runtime::objectEquals(thread, tuple.at(i), *value);
+    if (eq == Bool::trueObj()) return SmallInt::fromWord(i);
+    if (eq.isErrorException()) return eq;
+  }
+  return SmallInt::fromWord(-1);
+}
+
+void tupleRepeatPrefix(const MutableTuple& dst, word length, word times) {
+  word new_length = length * times;
+  for (word filled = length; filled < new_length;) {
+    word count = Utils::minimum(filled, new_length - filled);
+    dst.replaceFromWith(filled, *dst, count);
+    filled += count;
+  }
+}
+
 static const BuiltinAttribute kUserTupleBaseAttributes[] = {
     {ID(_UserTuple__value), RawUserTupleBase::kValueOffset,
      AttributeFlags::kHidden},
@@ -206,9 +226,8 @@ RawObject METH(tuple, __mul__)(Thread* thread, Arguments args) {
     new_tuple.fill(self.at(0));
     return new_tuple.becomeImmutable();
   }
-  for (word i = 0; i < times; i++) {
-    new_tuple.replaceFromWith(i * length, *self, length);
-  }
+  new_tuple.replaceFromWith(0, *self, length);
+  tupleRepeatPrefix(new_tuple, length, times);
   return new_tuple.becomeImmutable();
 }
 
@@ -223,6 +242,26 @@ RawObject METH(tuple, __iter__)(Thread* thread, Arguments args) {
   return runtime->newTupleIterator(tuple, tuple.length());
 }
 
+RawObject METH(tuple, count)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!thread->runtime()->isInstanceOfTuple(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(tuple));
+  }
+  Tuple self(&scope, tupleUnderlying(*self_obj));
+  Object value(&scope, args.get(1));
+  word count = 0;
+  for (word i = 0, length = self.length(); i < length; i++) {
+    RawObject eq = Runtime::objectEquals(thread, self.at(i), *value);
+    if (eq == Bool::trueObj()) {
+      count++;
+    } else if (eq.isErrorException()) {
+      return eq;
+    }
+  }
+  return SmallInt::fromWord(count);
+}
+
 RawObject METH(tuple_iterator, __iter__)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object self(&scope, args.get(0));
@@ -12,6 +12,11 @@ namespace py {
 RawObject tupleContains(Thread* thread, const Tuple& tuple,
                         const Object& value);
 
+// Returns the index of the first item in `tuple[start:stop]` that is `value`
+// or compares equal to it, -1 if there is none, or Error if `__eq__` raised.
+RawObject tupleIndex(Thread* thread, const Tuple& tuple, const Object& value,
+                     word start, word stop);
+
 // Return the next item from the iterator, or Error if there are no items left.
 RawObject tupleIteratorNext(Thread* thread, const TupleIterator& iter);
 
@@ -21,6 +26,10 @@ RawObject tupleSlice(Thread* thread, const Tuple& tuple, word start, word stop,
 
 RawObject tupleHash(Thread* thread, const Tuple& tuple);
 
+// Fills `dst[length:length * times]` with copies of `dst[:length]`, doubling
+// the size of each copy so only O(log times) block moves are needed.
+void tupleRepeatPrefix(const MutableTuple& dst, word length, word times);
+
 void initializeTupleTypes(Thread* thread);
 
 }  // namespace py
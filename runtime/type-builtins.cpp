@@ -692,6 +692,19 @@ static word estimateNumAttributes(Thread* thread, const Type& type) {
   return attr_names.numItems();
 }
 
+void typeGrowInstanceLayout(Thread* thread, const Type& type,
+                            word num_attributes) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Layout layout(&scope, type.instanceLayout());
+  Layout new_layout(&scope, runtime->layoutCreateCopy(thread, layout));
+  new_layout.setNumInObjectAttributes(layout.numInObjectAttributes() +
+                                      num_attributes);
+  new_layout.setNumGrowths(layout.numGrowths() + 1);
+  type.setInstanceLayout(*new_layout);
+  type.setInstanceLayoutId(new_layout.id());
+}
+
 static void setSlotAttributes(Thread* thread, const MutableTuple& dst,
                               word start_index, const List& slots) {
   HandleScope scope(thread);
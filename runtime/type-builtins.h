@@ -65,6 +65,17 @@ RawObject typeAtPutById(Thread* thread, const Type& type, SymbolId id,
 RawObject typeDeleteAttribute(Thread* thread, const Type& receiver,
                               const Object& name);
 
+// Maximum number of times `typeGrowInstanceLayout()` is applied to a type.
+// Every growth allocates a new layout id, which drops the layout transitions
+// of the old layout and misses the caches keyed by it.
+const word kMaxInstanceLayoutGrowths = 1;
+
+// Replaces the instance layout of `type` with a copy that reserves
+// `num_attributes` additional in-object attribute slots. Existing instances
+// keep their layouts; instances created afterwards use the new one.
+void typeGrowInstanceLayout(Thread* thread, const Type& type,
+                            word num_attributes);
+
 RawObject typeRemove(Thread* thread, const Type& type, const Object& name);
 
 RawObject typeRemoveById(Thread* thread, const Type& type, SymbolId id);
@@ -3,6 +3,7 @@
 
 #include <cerrno>
 #include <cmath>
+#include <memory>
 #include <sstream>
 
 #include "attributedict.h"
@@ -3230,11 +3231,16 @@ static RawObject intFromByteslike(Thread* thread, const Byteslike& byteslike,
     base = 10;
   }
 
-  Runtime* runtime = thread->runtime();
-  HandleScope scope(thread);
-  Int result(&scope, SmallInt::fromWord(0));
-  Int digit(&scope, SmallInt::fromWord(0));
-  Int base_obj(&scope, SmallInt::fromWord(base));
+  // Collect the digit values first so they can be converted in bulk.
+  word max_digits = length - idx + 1;
+  byte fixed_digits[64];
+  std::unique_ptr<byte[]> heap_digits;
+  byte* digits = fixed_digits;
+  if (max_digits > static_cast<word>(sizeof(fixed_digits))) {
+    heap_digits.reset(new byte[max_digits]);
+    digits = heap_digits.get();
+  }
+  word num_digits = 0;
   word num_start = idx;
   for (;;) {
     if (b == '_') {
@@ -3246,14 +3252,14 @@ static RawObject intFromByteslike(Thread* thread, const Byteslike& byteslike,
     }
     word digit_val = digitValue(b, base);
     if (digit_val == -1) return Error::error();
-    digit = Int::cast(SmallInt::fromWord(digit_val));
-    result = runtime->intAdd(thread, result, digit);
+    digits[num_digits++] = digit_val;
     if (idx >= length) break;
     b = byteslike.byteAt(idx++);
-    result = runtime->intMultiply(thread, result, base_obj);
   }
+  HandleScope scope(thread);
+  Int result(&scope, intFromDigits(thread, digits, num_digits, base));
   if (sign < 0) {
-    result = runtime->intNegate(thread, result);
+    result = thread->runtime()->intNegate(thread, result);
   }
   return *result;
 }
@@ -3338,11 +3344,16 @@ static RawObject intFromStr(Thread* thread, const Str& str, word base) {
       return Error::error();
     }
   }
-  Runtime* runtime = thread->runtime();
-  HandleScope scope(thread);
-  Int result(&scope, SmallInt::fromWord(0));
-  Int digit(&scope, SmallInt::fromWord(0));
-  Int base_obj(&scope, SmallInt::fromWord(base));
+  // Collect the digit values first so they can be converted in bulk.
+  word max_digits = str.length() - start;
+  byte fixed_digits[64];
+  std::unique_ptr<byte[]> heap_digits;
+  byte* digits = fixed_digits;
+  if (max_digits > static_cast<word>(sizeof(fixed_digits))) {
+    heap_digits.reset(new byte[max_digits]);
+    digits = heap_digits.get();
+  }
+  word num_digits = 0;
   for (word i = start; i < str.length(); i++) {
     byte digit_char = str.byteAt(i);
     if (digit_char == '_') {
@@ -3354,12 +3365,12 @@ static RawObject intFromStr(Thread* thread, const Str& str, word base) {
     }
     word digit_val = digitValue(digit_char, base);
     if (digit_val == -1) return Error::error();
-    digit = Int::cast(SmallInt::fromWord(digit_val));
-    result = runtime->intMultiply(thread, result, base_obj);
-    result = runtime->intAdd(thread, result, digit);
+    digits[num_digits++] = digit_val;
   }
+  HandleScope scope(thread);
+  Int result(&scope, intFromDigits(thread, digits, num_digits, base));
   if (sign < 0) {
-    result = runtime->intNegate(thread, result);
+    result = thread->runtime()->intNegate(thread, result);
   }
   return *result;
 }
@@ -3417,6 +3428,17 @@ RawObject FUNC(_builtins, _jit)(Thread* thread, Arguments args) {
   return Bool::trueObj();
 }
 
+RawObject FUNC(_builtins, _jit_deopt_stats)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object obj(&scope, args.get(0));
+  obj = unpackFunction(obj);
+  if (!obj.isFunction()) {
+    return thread->runtime()->newList();
+  }
+  Function function(&scope, *obj);
+  return jitDeoptStats(thread, function);
+}
+
 RawObject FUNC(_builtins, _jit_iscompiled)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Object obj(&scope, args.get(0));
@@ -3615,6 +3637,15 @@ RawObject FUNC(_builtins, _list_guard)(Thread* thread, Arguments args) {
   return raiseRequiresFromCaller(thread, args, ID(list));
 }
 
+RawObject FUNC(_builtins, _list_index)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  List self(&scope, args.get(0));
+  Object value(&scope, args.get(1));
+  word start = intUnderlying(args.get(2)).asWordSaturated();
+  word stop = intUnderlying(args.get(3)).asWordSaturated();
+  return listIndex(thread, self, value, start, stop);
+}
+
 RawObject FUNC(_builtins, _list_len)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   List self(&scope, args.get(0));
@@ -5388,27 +5419,6 @@ RawObject FUNC(_builtins, _str_mod_fast_path)(Thread* thread, Arguments args) {
   return result.becomeStr();
 }
 
-static word strScan(const Str& haystack, word haystack_len, const Str& needle,
-                    word needle_len,
-                    word (*find_func)(const byte* haystack, word haystack_len,
-                                      const byte* needle, word needle_len)) {
-  byte haystack_buf[SmallStr::kMaxLength];
-  byte* haystack_ptr = haystack_buf;
-  if (haystack.isSmallStr()) {
-    haystack.copyTo(haystack_buf, haystack_len);
-  } else {
-    haystack_ptr = reinterpret_cast<byte*>(LargeStr::cast(*haystack).address());
-  }
-  byte needle_buf[SmallStr::kMaxLength];
-  byte* needle_ptr = needle_buf;
-  if (needle.isSmallStr()) {
-    needle.copyTo(needle_buf, needle_len);
-  } else {
-    needle_ptr = reinterpret_cast<byte*>(LargeStr::cast(*needle).address());
-  }
-  return (*find_func)(haystack_ptr, haystack_len, needle_ptr, needle_len);
-}
-
 // Look for needle in haystack, starting from the left. Return a tuple
 // containing:
 // * haystack up to but not including needle
@@ -5430,8 +5440,7 @@ RawObject FUNC(_builtins, _str_partition)(Thread* thread, Arguments args) {
     // Fast path when needle is bigger than haystack
     return result.becomeImmutable();
   }
-  word prefix_len =
-      strScan(haystack, haystack_len, needle, needle_len, Utils::memoryFind);
+  word prefix_len = strFindByteOffset(haystack, needle, 0, haystack_len);
   if (prefix_len < 0) return result.becomeImmutable();
   result.atPut(0, strSubstr(thread, haystack, 0, prefix_len));
   result.atPut(1, *needle);
@@ -5550,8 +5559,7 @@ RawObject FUNC(_builtins, _str_rpartition)(Thread* thread, Arguments args) {
     // Fast path when needle is bigger than haystack
     return result.becomeImmutable();
   }
-  word prefix_len = strScan(haystack, haystack_len, needle, needle_len,
-                            Utils::memoryFindReverse);
+  word prefix_len = strRFindByteOffset(haystack, needle, 0, haystack_len);
   if (prefix_len < 0) return result.becomeImmutable();
   result.atPut(0, strSubstr(thread, haystack, 0, prefix_len));
   result.atPut(1, *needle);
@@ -5858,6 +5866,15 @@ RawObject FUNC(_builtins, _tuple_guard)(Thread* thread, Arguments args) {
   return raiseRequiresFromCaller(thread, args, ID(tuple));
 }
 
+RawObject FUNC(_builtins, _tuple_index)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Tuple self(&scope, tupleUnderlying(args.get(0)));
+  Object value(&scope, args.get(1));
+  word start = SmallInt::cast(args.get(2)).value();
+  word stop = SmallInt::cast(args.get(3)).value();
+  return tupleIndex(thread, self, value, start, stop);
+}
+
 RawObject FUNC(_builtins, _tuple_len)(Thread*, Arguments args) {
   return SmallInt::fromWord(tupleUnderlying(args.get(0)).length());
 }
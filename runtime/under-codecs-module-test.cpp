@@ -1,4 +1,6 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cstring>
+
 #include "gtest/gtest.h"
 
 #include "builtins.h"
@@ -206,6 +208,30 @@ TEST_F(CodecsModuleTest, DecodeUTF8WithInvalidStartByteReturnsIndices) {
   EXPECT_TRUE(isStrEqualsCStr(result.at(2), "invalid start byte"));
 }
 
+TEST_F(CodecsModuleTest,
+       DecodeUTF8WithReplaceErrorHandlerAfterLongRunsReturnsStr) {
+  HandleScope scope(thread_);
+  const char* encoded =
+      "0123456789abcdef\xC3\xA9ghijklmnop\xFFqrstuvwxyz0123456789\xE2\x82\xAC";
+  Object bytes(&scope, runtime_->newBytesWithAll(View<byte>(
+                           reinterpret_cast<const byte*>(encoded),
+                           std::strlen(encoded))));
+  Object errors(&scope, runtime_->newStrFromCStr("replace"));
+  Object index(&scope, runtime_->newInt(0));
+  Object strarray(&scope, runtime_->newStrArray());
+  Object is_final(&scope, Bool::trueObj());
+  Object result_obj(&scope, runBuiltin(FUNC(_codecs, _utf_8_decode), bytes,
+                                       errors, index, strarray, is_final));
+  ASSERT_TRUE(result_obj.isTuple());
+
+  Tuple result(&scope, *result_obj);
+  EXPECT_TRUE(isStrEqualsCStr(result.at(0),
+                              "0123456789abcdef\xC3\xA9ghijklmnop\xEF\xBF\xBD"
+                              "qrstuvwxyz0123456789\xE2\x82\xAC"));
+  EXPECT_TRUE(isIntEqualsWord(result.at(1), std::strlen(encoded)));
+  EXPECT_TRUE(isStrEqualsCStr(result.at(2), ""));
+}
+
 TEST_F(CodecsModuleTest, DecodeUTF8StatefulWithInvalidStartByteReturnsIndices) {
   HandleScope scope(thread_);
   byte encoded[] = {'h', 'e', 'l', 'l', 0x80, 'o'};
@@ -390,6 +416,20 @@ encoded = Foo(b"hello")
   EXPECT_TRUE(isStrEqualsCStr(result.at(2), ""));
 }
 
+TEST_F(CodecsModuleTest, DecodeLatin1WithNonASCIIBytesReturnsStr) {
+  HandleScope scope(thread_);
+  byte encoded[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i',
+                    0xe9, 'j', 0x80, 0xff, 'k'};
+  Object bytes(&scope, runtime_->newBytesWithAll(encoded));
+  Object result_obj(&scope, runBuiltin(FUNC(_codecs, _latin_1_decode), bytes));
+  ASSERT_TRUE(result_obj.isTuple());
+
+  Tuple result(&scope, *result_obj);
+  EXPECT_TRUE(isStrEqualsCStr(result.at(0),
+                              "abcdefghi\xC3\xA9j\xC2\x80\xC3\xBFk"));
+  EXPECT_TRUE(isIntEqualsWord(result.at(1), 14));
+}
+
 TEST_F(CodecsModuleTest, DecodeEscapeWithWellFormedLatin1ReturnsString) {
   HandleScope scope(thread_);
   byte encoded[] = {'h', 'e', 'l', 'l', 0xE9, 'o'};
@@ -1257,6 +1297,25 @@ TEST_F(CodecsModuleTest,
   EXPECT_TRUE(isBytesEqualsBytes(bytes, expected));
 }
 
+TEST_F(CodecsModuleTest,
+       EncodeUTF16LeWithCodePointsAboveSurrogatesReturnsSingleCodeUnits) {
+  HandleScope scope(thread_);
+  Object str(&scope, runtime_->newStrFromCStr("\ue000\uffff"));
+  Object errors(&scope, runtime_->newStrFromCStr("strict"));
+  Object index(&scope, runtime_->newInt(0));
+  Object bytearray(&scope, runtime_->newBytearray());
+  Object byteorder(&scope, runtime_->newInt(-1));
+  Object result_obj(&scope, runBuiltin(FUNC(_codecs, _utf_16_encode), str,
+                                       errors, index, bytearray, byteorder));
+  ASSERT_TRUE(result_obj.isTuple());
+
+  Tuple result(&scope, *result_obj);
+  Bytes bytes(&scope, result.at(0));
+  EXPECT_TRUE(isIntEqualsWord(result.at(1), 2));
+  byte expected[] = {0x00, 0xe0, 0xff, 0xff};
+  EXPECT_TRUE(isBytesEqualsBytes(bytes, expected));
+}
+
 TEST_F(CodecsModuleTest, EncodeUTF32WithWellFormedASCIIReturnsBytes) {
   HandleScope scope(thread_);
   Object str(&scope, runtime_->newStrFromCStr("hi"));
@@ -1,4 +1,6 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cstring>
+
 #include "builtins.h"
 #include "bytearray-builtins.h"
 #include "bytes-builtins.h"
@@ -36,18 +38,40 @@ static SymbolId lookupSymbolForErrorHandler(const Str& error) {
   return SymbolId::kInvalid;
 }
 
-static int asciiDecode(Thread* thread, const StrArray& dst,
-                       const Byteslike& src, word start, word end) {
-  // TODO(T41032331): Implement a fastpass to read longs instead of chars
-  Runtime* runtime = thread->runtime();
-  for (word i = start; i < end; i++) {
-    byte ch = src.byteAt(i);
-    if (ch > kMaxASCII) {
-      return i;
-    }
-    runtime->strArrayAddASCII(thread, dst, ch);
+// Returns the index of the first non-ASCII byte in `bytes[start:end]`, or
+// `end` if there is none. Scans a word at a time.
+static word asciiEnd(const Byteslike& bytes, word start, word end) {
+  const byte* data = reinterpret_cast<const byte*>(bytes.address());
+  const uword non_ascii_mask = (~uword{0} / 0xFF) << (kBitsPerByte - 1);
+  word i = start;
+  for (; i + kWordSize <= end; i += kWordSize) {
+    uword block;
+    std::memcpy(&block, data + i, kWordSize);
+    if ((block & non_ascii_mask) != 0) break;
+  }
+  while (i < end && data[i] <= kMaxASCII) {
+    i++;
   }
-  return end;
+  return i;
+}
+
+// Appends `src[start:end]`, which must be valid UTF-8, to `dst`.
+static void strArrayAddByteslike(Thread* thread, const StrArray& dst,
+                                 const Byteslike& src, word start, word end) {
+  word length = end - start;
+  if (length == 0) return;
+  word num_items = dst.numItems();
+  thread->runtime()->strArrayEnsureCapacity(thread, dst, num_items + length);
+  MutableBytes::cast(dst.items())
+      .replaceFromWithByteslikeStartAt(num_items, src, length, start);
+  dst.setNumItems(num_items + length);
+}
+
+static word asciiDecode(Thread* thread, const StrArray& dst,
+                        const Byteslike& src, word start, word end) {
+  word ascii_end = asciiEnd(src, start, end);
+  strArrayAddByteslike(thread, dst, src, start, ascii_end);
+  return ascii_end;
 }
 
 RawObject FUNC(_codecs, _ascii_decode)(Thread* thread, Arguments args) {
@@ -333,15 +357,24 @@ RawObject FUNC(_codecs, _latin_1_decode)(Thread* thread, Arguments args) {
   word num_bytes = asciiDecode(thread, array, bytes, 0, length);
   if (num_bytes != length) {
     // A non-ASCII character was found; switch to a Latin-1 decoding for the
-    // remainder of the input sequence
+    // remainder of the input sequence. Each byte becomes at most two bytes of
+    // UTF-8.
+    word num_items = array.numItems();
+    runtime->strArrayEnsureCapacity(thread, array,
+                                    num_items + (length - num_bytes) * 2);
+    byte* dst =
+        reinterpret_cast<byte*>(MutableBytes::cast(array.items()).address());
+    const byte* src = reinterpret_cast<const byte*>(bytes.address());
     for (word i = num_bytes; i < length; ++i) {
-      byte code_point = bytes.byteAt(i);
+      byte code_point = src[i];
       if (code_point <= kMaxASCII) {
-        runtime->strArrayAddASCII(thread, array, code_point);
+        dst[num_items++] = code_point;
       } else {
-        runtime->strArrayAddCodePoint(thread, array, code_point);
+        dst[num_items++] = 0xC0 | (code_point >> 6);
+        dst[num_items++] = 0x80 | (code_point & 0x3F);
       }
     }
+    array.setNumItems(num_items);
   }
   Object array_str(&scope, runtime->strFromStrArray(array));
   Object length_obj(&scope, runtime->newInt(length));
@@ -782,19 +815,20 @@ RawObject FUNC(_codecs, _utf_8_decode)(Thread* thread, Arguments args) {
   SymbolId error_id = lookupSymbolForErrorHandler(errors);
   bool is_final = Bool::cast(*final_obj).value();
   while (i < length) {
-    // TODO(T41032331): Scan for non-ASCII characters by words instead of chars
-    Utf8DecoderResult validator_result = isValidUtf8Codepoint(bytes, i);
-    if (validator_result >= k1Byte) {
-      byte codepoint[4] = {0};
-      for (int codeunit = 0; codeunit + 1 <= validator_result; codeunit++) {
-        codepoint[codeunit] = bytes.byteAt(i + codeunit);
-      }
-      i += validator_result;
-      Str temp(&scope,
-               runtime->newStrWithAll(View<byte>{codepoint, validator_result}));
-      runtime->strArrayAddStr(thread, dst, temp);
-      continue;
+    // Validate the longest well-formed run, skipping ASCII a word at a time,
+    // and copy it in one go.
+    word run_end = i;
+    Utf8DecoderResult validator_result = k1Byte;
+    while (run_end < length) {
+      run_end = asciiEnd(bytes, run_end, length);
+      if (run_end == length) break;
+      validator_result = isValidUtf8Codepoint(bytes, run_end);
+      if (validator_result < k1Byte) break;
+      run_end += validator_result;
     }
+    strArrayAddByteslike(thread, dst, bytes, i, run_end);
+    i = run_end;
+    if (i == length) break;
     if (validator_result != kInvalidStart && !is_final) {
       break;
     }
@@ -851,6 +885,71 @@ RawObject FUNC(_codecs, _utf_8_decode)(Thread* thread, Arguments args) {
   return runtime->newTupleWith3(dst_obj, outpos_obj, message_obj);
 }
 
+// Returns the end of the run of non-surrogate code points starting at byte
+// offset `start` in `str`, and sets `num_code_points` to the run's length.
+static word strSurrogateFreeEnd(const Str& str, word start,
+                                word* num_code_points) {
+  word length = str.length();
+  if (str.isLargeStr() && LargeStr::cast(*str).isASCII()) {
+    *num_code_points = length - start;
+    return length;
+  }
+  word count = 0;
+  word i = start;
+  for (; i < length; i++) {
+    byte b = str.byteAt(i);
+    if (b == UTF8::kSurrogateLeadByte && str.byteAt(i + 1) >= 0xA0) break;
+    if (!UTF8::isTrailByte(b)) count++;
+  }
+  *num_code_points = count;
+  return i;
+}
+
+// Appends the bytes `str[start:end]` to `array`.
+static void bytearrayAddStrBytes(Thread* thread, Runtime* runtime,
+                                 const Bytearray& array, const Str& str,
+                                 word start, word end) {
+  word num_items = array.numItems();
+  word new_length = num_items + (end - start);
+  runtime->bytearrayEnsureCapacity(thread, array, new_length);
+  MutableBytes::cast(array.items())
+      .replaceFromWithStrStartAt(num_items, *str, end - start, start);
+  array.setNumItems(new_length);
+}
+
+// Appends the UTF-16 or UTF-32 encoding, with `unit_size` bytes per code unit,
+// of the `num_code_points` non-surrogate code points in `str[start:end]` to
+// `array`.
+static void bytearrayAddEncodedRun(Thread* thread, Runtime* runtime,
+                                   const Bytearray& array, const Str& str,
+                                   word start, word end, word num_code_points,
+                                   word unit_size, endian endianness) {
+  word num_items = array.numItems();
+  // A code point takes at most four bytes in either encoding.
+  runtime->bytearrayEnsureCapacity(thread, array,
+                                   num_items + num_code_points * 4);
+  byte* dst =
+      reinterpret_cast<byte*>(MutableBytes::cast(array.items()).address());
+  auto write_unit = [&](uint32_t unit) {
+    for (word j = 0; j < unit_size; j++) {
+      word shift = endianness == endian::little ? j : unit_size - 1 - j;
+      dst[num_items++] = static_cast<byte>(unit >> (shift * kBitsPerByte));
+    }
+  };
+  for (word i = start; i < end;) {
+    word num_bytes;
+    int32_t codepoint = str.codePointAt(i, &num_bytes);
+    i += num_bytes;
+    if (unit_size == 2 && codepoint > kMaxUint16) {
+      write_unit(Unicode::highSurrogateFor(codepoint));
+      write_unit(Unicode::lowSurrogateFor(codepoint));
+    } else {
+      write_unit(codepoint);
+    }
+  }
+  array.setNumItems(num_items);
+}
+
 RawObject FUNC(_codecs, _utf_8_encode)(Thread* thread, Arguments args) {
   Runtime* runtime = thread->runtime();
   HandleScope scope(thread);
@@ -865,47 +964,51 @@ RawObject FUNC(_codecs, _utf_8_encode)(Thread* thread, Arguments args) {
   SymbolId error_symbol = lookupSymbolForErrorHandler(errors);
   for (word byte_offset = thread->strOffset(data, index);
        byte_offset < data.length(); index++) {
+    word num_code_points;
+    word run_end = strSurrogateFreeEnd(data, byte_offset, &num_code_points);
+    if (num_code_points > 0) {
+      bytearrayAddStrBytes(thread, runtime, output, data, byte_offset,
+                           run_end);
+      byte_offset = run_end;
+      // The loop increment accounts for the last code point of the run.
+      index += num_code_points - 1;
+      continue;
+    }
     word num_bytes;
     int32_t codepoint = data.codePointAt(byte_offset, &num_bytes);
     byte_offset += num_bytes;
-    if (!Unicode::isSurrogate(codepoint)) {
-      for (word j = byte_offset - num_bytes; j < byte_offset; j++) {
-        bytearrayAdd(thread, runtime, output, data.byteAt(j));
-      }
-    } else {
-      switch (error_symbol) {
-        case ID(ignore):
+    switch (error_symbol) {
+      case ID(ignore):
+        continue;
+      case ID(replace):
+        bytearrayAdd(thread, runtime, output, kASCIIReplacement);
+        continue;
+      case ID(surrogateescape):
+        if (isEscapedLatin1Surrogate(codepoint)) {
+          bytearrayAdd(thread, runtime, output,
+                       codepoint - Unicode::kLowSurrogateStart);
           continue;
-        case ID(replace):
-          bytearrayAdd(thread, runtime, output, kASCIIReplacement);
+        }
+        break;
+      case ID(surrogatepass):
+        if (Unicode::isSurrogate(codepoint)) {
+          bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 3));
+          bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 2));
+          bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 1));
           continue;
-        case ID(surrogateescape):
-          if (isEscapedLatin1Surrogate(codepoint)) {
-            bytearrayAdd(thread, runtime, output,
-                         codepoint - Unicode::kLowSurrogateStart);
-            continue;
-          }
-          break;
-        case ID(surrogatepass):
-          if (Unicode::isSurrogate(codepoint)) {
-            bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 3));
-            bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 2));
-            bytearrayAdd(thread, runtime, output, data.byteAt(byte_offset - 1));
-            continue;
-          }
-          break;
-        default:
-          break;
-      }
-      Object outpos1(&scope, runtime->newInt(index));
-      while (byte_offset < data.length() &&
-             Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
-        byte_offset += num_bytes;
-        index++;
-      }
-      Object outpos2(&scope, runtime->newInt(index + 1));
-      return runtime->newTupleWith2(outpos1, outpos2);
+        }
+        break;
+      default:
+        break;
+    }
+    Object outpos1(&scope, runtime->newInt(index));
+    while (byte_offset < data.length() &&
+           Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
+      byte_offset += num_bytes;
+      index++;
     }
+    Object outpos2(&scope, runtime->newInt(index + 1));
+    return runtime->newTupleWith2(outpos1, outpos2);
   }
   Object output_bytes(&scope, bytearrayAsBytes(thread, output));
   Object index_obj(&scope, runtime->newInt(index));
@@ -944,47 +1047,46 @@ RawObject FUNC(_codecs, _utf_16_encode)(Thread* thread, Arguments args) {
   for (word byte_offset = thread->strOffset(data, index);
        byte_offset < data.length(); index++) {
     endian endianness = byteorder.value <= 0 ? endian::little : endian::big;
+    word num_code_points;
+    word run_end = strSurrogateFreeEnd(data, byte_offset, &num_code_points);
+    if (num_code_points > 0) {
+      bytearrayAddEncodedRun(thread, runtime, output, data, byte_offset,
+                             run_end, num_code_points, /*unit_size=*/2,
+                             endianness);
+      byte_offset = run_end;
+      // The loop increment accounts for the last code point of the run.
+      index += num_code_points - 1;
+      continue;
+    }
     word num_bytes;
     int32_t codepoint = data.codePointAt(byte_offset, &num_bytes);
     byte_offset += num_bytes;
-    if (!Unicode::isSurrogate(codepoint)) {
-      if (codepoint < Unicode::kHighSurrogateStart) {
-        appendUtf16ToBytearray(thread, runtime, output, codepoint, endianness);
-      } else {
-        appendUtf16ToBytearray(thread, runtime, output,
-                               Unicode::highSurrogateFor(codepoint),
+    switch (error_id) {
+      case ID(ignore):
+        continue;
+      case ID(replace):
+        appendUtf16ToBytearray(thread, runtime, output, kASCIIReplacement,
                                endianness);
-        appendUtf16ToBytearray(thread, runtime, output,
-                               Unicode::lowSurrogateFor(codepoint), endianness);
-      }
-    } else {
-      switch (error_id) {
-        case ID(ignore):
-          continue;
-        case ID(replace):
-          appendUtf16ToBytearray(thread, runtime, output, kASCIIReplacement,
+        continue;
+      case ID(surrogateescape):
+        if (isEscapedLatin1Surrogate(codepoint)) {
+          appendUtf16ToBytearray(thread, runtime, output,
+                                 codepoint - Unicode::kLowSurrogateStart,
                                  endianness);
           continue;
-        case ID(surrogateescape):
-          if (isEscapedLatin1Surrogate(codepoint)) {
-            appendUtf16ToBytearray(thread, runtime, output,
-                                   codepoint - Unicode::kLowSurrogateStart,
-                                   endianness);
-            continue;
-          }
-          break;
-        default:
-          break;
-      }
-      Object outpos1(&scope, runtime->newInt(index));
-      while (byte_offset < data.length() &&
-             Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
-        byte_offset += num_bytes;
-        index++;
-      }
-      Object outpos2(&scope, runtime->newInt(index + 1));
-      return runtime->newTupleWith2(outpos1, outpos2);
+        }
+        break;
+      default:
+        break;
+    }
+    Object outpos1(&scope, runtime->newInt(index));
+    while (byte_offset < data.length() &&
+           Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
+      byte_offset += num_bytes;
+      index++;
     }
+    Object outpos2(&scope, runtime->newInt(index + 1));
+    return runtime->newTupleWith2(outpos1, outpos2);
   }
   Object output_bytes(&scope, bytearrayAsBytes(thread, output));
   Object index_obj(&scope, runtime->newInt(index));
@@ -1027,39 +1129,46 @@ RawObject FUNC(_codecs, _utf_32_encode)(Thread* thread, Arguments args) {
   for (word byte_offset = thread->strOffset(data, index);
        byte_offset < data.length(); index++) {
     endian endianness = byteorder.value <= 0 ? endian::little : endian::big;
+    word num_code_points;
+    word run_end = strSurrogateFreeEnd(data, byte_offset, &num_code_points);
+    if (num_code_points > 0) {
+      bytearrayAddEncodedRun(thread, runtime, output, data, byte_offset,
+                             run_end, num_code_points, /*unit_size=*/4,
+                             endianness);
+      byte_offset = run_end;
+      // The loop increment accounts for the last code point of the run.
+      index += num_code_points - 1;
+      continue;
+    }
     word num_bytes;
     int32_t codepoint = data.codePointAt(byte_offset, &num_bytes);
     byte_offset += num_bytes;
-    if (!Unicode::isSurrogate(codepoint)) {
-      appendUtf32ToBytearray(thread, runtime, output, codepoint, endianness);
-    } else {
-      switch (error_id) {
-        case ID(ignore):
-          continue;
-        case ID(replace):
-          appendUtf32ToBytearray(thread, runtime, output, kASCIIReplacement,
+    switch (error_id) {
+      case ID(ignore):
+        continue;
+      case ID(replace):
+        appendUtf32ToBytearray(thread, runtime, output, kASCIIReplacement,
+                               endianness);
+        continue;
+      case ID(surrogateescape):
+        if (isEscapedLatin1Surrogate(codepoint)) {
+          appendUtf32ToBytearray(thread, runtime, output,
+                                 codepoint - Unicode::kLowSurrogateStart,
                                  endianness);
           continue;
-        case ID(surrogateescape):
-          if (isEscapedLatin1Surrogate(codepoint)) {
-            appendUtf32ToBytearray(thread, runtime, output,
-                                   codepoint - Unicode::kLowSurrogateStart,
-                                   endianness);
-            continue;
-          }
-          break;
-        default:
-          break;
-      }
-      Object outpos1(&scope, runtime->newInt(index));
-      while (byte_offset < data.length() &&
-             Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
-        byte_offset += num_bytes;
-        index++;
-      }
-      Object outpos2(&scope, runtime->newInt(index + 1));
-      return runtime->newTupleWith2(outpos1, outpos2);
+        }
+        break;
+      default:
+        break;
+    }
+    Object outpos1(&scope, runtime->newInt(index));
+    while (byte_offset < data.length() &&
+           Unicode::isSurrogate(data.codePointAt(byte_offset, &num_bytes))) {
+      byte_offset += num_bytes;
+      index++;
     }
+    Object outpos2(&scope, runtime->newInt(index + 1));
+    return runtime->newTupleWith2(outpos1, outpos2);
   }
   Object output_bytes(&scope, bytearrayAsBytes(thread, output));
   Object index_obj(&scope, runtime->newInt(index));
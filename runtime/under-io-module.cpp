@@ -1,6 +1,9 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
 #include "under-io-module.h"
 
+#include <cerrno>
+#include <cstring>
+
 #include "builtins.h"
 #include "bytes-builtins.h"
 #include "byteslike.h"
@@ -305,6 +308,81 @@ static RawObject fillBuffer(Thread* thread, const Object& raw_file,
   return Unbound::object();
 }
 
+static const word kDefaultBufferSize = 1 * kKiB;  // bytes
+
+// Returns true if `raw_file` is a `FileIO` whose reads can be done directly on
+// its file descriptor.
+static bool isReadableFileIO(const Object& raw_file) {
+  if (!raw_file.isFileIO()) return false;
+  RawFileIO file_io = raw_file.rawCast<RawFileIO>();
+  return !file_io.closed() && file_io.isReadable() == Bool::trueObj() &&
+         file_io.fd().isSmallInt();
+}
+
+// Reads from `fd` until `num_bytes` bytes are read (`kMaxWord` reads up to
+// the end of the file). The result starts with `prefix_length` bytes of
+// `prefix` at `prefix_start`. It is allocated up front for the rest of the
+// file when its size is known and the data is read straight into it; it is
+// only copied again when the file is shorter or longer than expected.
+// Returns `None` if a non-blocking file has no data.
+static RawObject readFileDescriptor(Thread* thread, int fd, word num_bytes,
+                                   const Object& prefix, word prefix_start,
+                                   word prefix_length) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  // If there is an OSError from File::seek or File::size, it is not raised;
+  // the result then grows while reading like for a pipe.
+  word pos = File::seek(fd, 0, 1);
+  word end = File::size(fd);
+  word capacity = prefix_length;
+  if (pos >= 0 && end > pos) {
+    capacity += end - pos;
+  } else {
+    capacity += kDefaultBufferSize;
+  }
+  capacity = Utils::minimum(capacity, num_bytes);
+
+  MutableBytes result(&scope, runtime->newMutableBytesUninitialized(capacity));
+  if (prefix_length > 0) {
+    result.replaceFromWithStartAt(0, MutableBytes::cast(*prefix),
+                                  prefix_length, prefix_start);
+  }
+  word length = prefix_length;
+  for (;;) {
+    if (length == capacity) {
+      if (length == num_bytes) break;
+      // Look for the end of the file before growing the result, as files
+      // usually end at the size reported for them.
+      byte probe[kDefaultBufferSize];
+      word wanted = Utils::minimum(num_bytes - length, kDefaultBufferSize);
+      word probe_length = File::read(fd, probe, wanted);
+      if (probe_length == -EAGAIN || probe_length == 0) break;
+      if (probe_length < 0) return thread->raiseOSErrorFromErrno(-probe_length);
+      capacity = Utils::minimum(capacity * 2 + kDefaultBufferSize, num_bytes);
+      MutableBytes grown(&scope,
+                         runtime->newMutableBytesUninitialized(capacity));
+      grown.replaceFromWith(0, *result, length);
+      std::memcpy(reinterpret_cast<byte*>(grown.address()) + length, probe,
+                  probe_length);
+      length += probe_length;
+      result = *grown;
+      continue;
+    }
+    byte* dst = reinterpret_cast<byte*>(result.address());
+    word read_length = File::read(fd, dst + length, capacity - length);
+    if (read_length == -EAGAIN) {
+      if (length == 0) return NoneType::object();
+      break;
+    }
+    if (read_length < 0) return thread->raiseOSErrorFromErrno(-read_length);
+    if (read_length == 0) break;
+    length += read_length;
+  }
+  if (length == capacity) return result.becomeImmutable();
+  Bytes result_bytes(&scope, *result);
+  return bytesSubseq(thread, result_bytes, 0, length);
+}
+
 // Helper function for read requests that are bigger (or close to) than the size
 // of the buffer.
 static RawObject readBig(Thread* thread, const BufferedReader& buffered_reader,
@@ -315,14 +393,23 @@ static RawObject readBig(Thread* thread, const BufferedReader& buffered_reader,
   DCHECK(num_bytes == kMaxWord || num_bytes > available,
          "num_bytes should be big");
 
-  // TODO(T59000373): We could specialize this to avoid the intermediate
-  // allocations when the size of the result is known and `readinto` is
-  // available.
+  Object raw_file(&scope, buffered_reader.underlying());
+  if (isReadableFileIO(raw_file)) {
+    int fd = SmallInt::cast(raw_file.rawCast<RawFileIO>().fd()).value();
+    Object read_buf(&scope, buffered_reader.readBuf());
+    Object result(&scope,
+                  readFileDescriptor(thread, fd, num_bytes, read_buf,
+                                     buffered_reader.readPos(), available));
+    if (result.isErrorException()) return *result;
+    buffered_reader.setReadPos(0);
+    buffered_reader.setBufferNumBytes(0);
+    return *result;
+  }
 
+  // Other raw streams are read in chunks that are joined at the end.
   word length = available;
   Object chunks(&scope, NoneType::object());
   Object chunk(&scope, NoneType::object());
-  Object raw_file(&scope, buffered_reader.underlying());
   Bytes bytes(&scope, Bytes::empty());
   for (;;) {
     word wanted = (num_bytes == kMaxWord) ? 32 * kKiB : num_bytes - available;
@@ -558,7 +645,7 @@ RawObject FUNC(_io, _buffered_reader_read)(Thread* thread, Arguments args) {
   }
 
   Object raw_file(&scope, self.underlying());
-  if (num_bytes == kMaxWord) {
+  if (num_bytes == kMaxWord && !isReadableFileIO(raw_file)) {
     Object readall_result(&scope, thread->invokeMethod1(raw_file, ID(readall)));
     if (readall_result.isErrorException()) return *readall_result;
     if (!readall_result.isErrorNotFound()) {
@@ -769,6 +856,178 @@ RawObject FUNC(_io, _buffered_reader_readline)(Thread* thread, Arguments args) {
   return result.becomeImmutable();
 }
 
+// Returns the raw stream of `self` if the write helpers below can write to
+// its file descriptor directly or `Unbound` if managed code must be used
+// because the raw stream is not a `FileIO` or the writer is not initialized.
+static RawObject bufferedWriterFileIO(const BufferedWriter& self) {
+  RawObject raw = self.underlying();
+  if (!raw.isFileIO() || !self.writeBuf().isBytearray()) {
+    return Unbound::object();
+  }
+  RawFileIO file_io = raw.rawCast<RawFileIO>();
+  if (!file_io.closed() && (file_io.isWritable() != Bool::trueObj() ||
+                            !file_io.fd().isSmallInt())) {
+    return Unbound::object();
+  }
+  return file_io;
+}
+
+// Writes the contents of the write buffer of `self` followed by `data` (if
+// not null) to `fd`. Both are passed to each `writev` call, so large writes
+// go straight from `data` to the file without being copied into the buffer.
+// Bytes that could not be written stay in the write buffer. Returns the
+// number of bytes of `data` that were written or buffered.
+static RawObject bufferedWriterWriteThrough(Thread* thread,
+                                           const BufferedWriter& self, int fd,
+                                           const Byteslike* data) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Bytearray write_buf(&scope, self.writeBuf());
+  word buffered = write_buf.numItems();
+  word data_length = data == nullptr ? 0 : data->length();
+  word total = buffered + data_length;
+  word written = 0;
+  ssize_t result = 0;
+  while (written < total) {
+    struct iovec iov[2];
+    int iov_count = 0;
+    if (written < buffered) {
+      byte* buffer = reinterpret_cast<byte*>(
+          MutableBytes::cast(write_buf.items()).address());
+      iov[iov_count].iov_base = buffer + written;
+      iov[iov_count].iov_len = buffered - written;
+      iov_count++;
+    }
+    if (data_length > 0) {
+      word data_written = Utils::maximum(written - buffered, word{0});
+      iov[iov_count].iov_base =
+          reinterpret_cast<byte*>(data->address()) + data_written;
+      iov[iov_count].iov_len = data_length - data_written;
+      iov_count++;
+    }
+    result = File::writev(fd, iov, iov_count);
+    if (result < 0) break;
+    written += result;
+  }
+
+  word buffer_left = Utils::maximum(buffered - written, word{0});
+  word data_written = Utils::maximum(written - buffered, word{0});
+  if (buffer_left > 0 && written > 0) {
+    MutableBytes items(&scope, write_buf.items());
+    items.replaceFromWithStartAt(0, *items, buffer_left, written);
+  }
+  write_buf.setNumItems(buffer_left);
+  if (result >= 0) return SmallInt::fromWord(data_length);
+
+  // Keep the rest of `data` buffered like the managed implementation does.
+  // A non-blocking stream only accepts what fits into the buffer.
+  int errno_value = -result;
+  word keep = data_length - data_written;
+  if (errno_value == EAGAIN) {
+    word capacity = Utils::maximum(self.bufferSize() - buffer_left, word{0});
+    keep = Utils::minimum(keep, capacity);
+  }
+  if (keep > 0) {
+    runtime->bytearrayEnsureCapacity(thread, write_buf, buffer_left + keep);
+    byte* buffer = reinterpret_cast<byte*>(
+        MutableBytes::cast(write_buf.items()).address());
+    data->copyToStartAt(buffer + buffer_left, keep, data_written);
+    write_buf.setNumItems(buffer_left + keep);
+  }
+  if (errno_value != EAGAIN) {
+    return thread->raiseOSErrorFromErrno(errno_value);
+  }
+  Object type(&scope, runtime->typeAt(LayoutId::kBlockingIOError));
+  Object errno_obj(&scope, SmallInt::fromWord(errno_value));
+  Object message(&scope, runtime->newStrFromCStr(
+                             "write could not complete without blocking"));
+  Object written_obj(&scope, SmallInt::fromWord(data_written + keep));
+  Object exc_args(&scope,
+                  runtime->newTupleWith3(errno_obj, message, written_obj));
+  return thread->raiseWithType(*type, *exc_args);
+}
+
+// Writes out the write buffer of `self`. Returns `Unbound` if managed code
+// must be used instead.
+static RawObject bufferedWriterFlush(Thread* thread,
+                                     const BufferedWriter& self) {
+  HandleScope scope(thread);
+  Object raw(&scope, bufferedWriterFileIO(self));
+  if (raw.isUnbound()) return Unbound::object();
+  FileIO file_io(&scope, *raw);
+  if (file_io.closed()) {
+    return thread->raiseWithFmt(LayoutId::kValueError, "flush of closed file");
+  }
+  if (Bytearray::cast(self.writeBuf()).numItems() == 0) {
+    return NoneType::object();
+  }
+  int fd = SmallInt::cast(file_io.fd()).value();
+  Object result(&scope, bufferedWriterWriteThrough(thread, self, fd, nullptr));
+  if (result.isErrorException()) return *result;
+  return NoneType::object();
+}
+
+RawObject FUNC(_io, _buffered_writer_flush)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object self_obj(&scope, args.get(0));
+  if (!self_obj.isBufferedWriter()) return Unbound::object();
+  BufferedWriter self(&scope, *self_obj);
+  return bufferedWriterFlush(thread, self);
+}
+
+RawObject FUNC(_io, _buffered_writer_init)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object self_obj(&scope, args.get(0));
+  if (!runtime->isInstanceOfBufferedWriter(*self_obj)) {
+    return thread->raiseRequiresType(self_obj, ID(BufferedWriter));
+  }
+  BufferedWriter self(&scope, *self_obj);
+
+  Int buffer_size_obj(&scope, intUnderlying(args.get(1)));
+  if (!buffer_size_obj.isSmallInt() && !buffer_size_obj.isBool()) {
+    return thread->raiseWithFmt(LayoutId::kOverflowError,
+                                "cannot fit value into an index-sized integer");
+  }
+  word buffer_size = buffer_size_obj.asWord();
+  DCHECK(buffer_size > 0, "invalid buffer size");
+  self.setBufferSize(SmallInt::fromWord(buffer_size));
+  self.setWriteBuf(runtime->newBytearray());
+  return NoneType::object();
+}
+
+RawObject FUNC(_io, _buffered_writer_write)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object self_obj(&scope, args.get(0));
+  if (!self_obj.isBufferedWriter()) return Unbound::object();
+  BufferedWriter self(&scope, *self_obj);
+  Object raw(&scope, bufferedWriterFileIO(self));
+  if (raw.isUnbound()) return Unbound::object();
+  FileIO file_io(&scope, *raw);
+  if (file_io.closed()) {
+    return thread->raiseWithFmt(LayoutId::kValueError, "write to closed file");
+  }
+  Object data_obj(&scope, args.get(1));
+  if (!runtime->isByteslike(*data_obj)) return Unbound::object();
+  Byteslike data(&scope, thread, *data_obj);
+  if (!data.isValid()) return Unbound::object();
+
+  Bytearray write_buf(&scope, self.writeBuf());
+  word buffered = write_buf.numItems();
+  word length = data.length();
+  if (buffered + length <= self.bufferSize()) {
+    runtime->bytearrayEnsureCapacity(thread, write_buf, buffered + length);
+    byte* buffer = reinterpret_cast<byte*>(
+        MutableBytes::cast(write_buf.items()).address());
+    data.copyTo(buffer + buffered, length);
+    write_buf.setNumItems(buffered + length);
+    return SmallInt::fromWord(length);
+  }
+  int fd = SmallInt::cast(file_io.fd()).value();
+  return bufferedWriterWriteThrough(thread, self, fd, &data);
+}
+
 RawObject FUNC(_io, _TextIOWrapper_attached_guard)(Thread* thread,
                                                    Arguments args) {
   HandleScope scope(thread);
@@ -869,17 +1128,219 @@ RawObject FUNC(_io,
   return Unbound::object();
 }
 
+// Line endings recorded in `IncrementalNewlineDecoder._seennl`.
+static const word kSeenLF = 1;
+static const word kSeenCR = 2;
+static const word kSeenCRLF = 4;
+
+// Returns the length of the first line of `data` including its line ending
+// or -1 if `data` contains no complete line. With universal newlines a line
+// ends at "\n", "\r" or "\r\n", otherwise at `newline`. A "\r" at the end of
+// `data` only ends a line if `cr_is_final`; otherwise it may be the start of
+// a "\r\n". Stores the length and kind of the line ending in
+// `newline_length` and `seen`.
+static word findLineEnd(const byte* data, word length, bool universal,
+                        byte newline, bool cr_is_final, word* newline_length,
+                        word* seen) {
+  if (!universal) {
+    const void* found = std::memchr(data, newline, length);
+    if (found == nullptr) return -1;
+    *newline_length = 1;
+    *seen = 0;
+    return static_cast<const byte*>(found) - data + 1;
+  }
+  const void* lf = std::memchr(data, '\n', length);
+  word lf_index = lf == nullptr ? length : static_cast<const byte*>(lf) - data;
+  const void* cr = std::memchr(data, '\r', lf_index);
+  if (cr != nullptr) {
+    word cr_index = static_cast<const byte*>(cr) - data;
+    if (cr_index + 1 < length && data[cr_index + 1] == '\n') {
+      *newline_length = 2;
+      *seen = kSeenCRLF;
+      return cr_index + 2;
+    }
+    if (cr_index + 1 == length && !cr_is_final) return -1;
+    *newline_length = 1;
+    *seen = kSeenCR;
+    return cr_index + 1;
+  }
+  if (lf == nullptr) return -1;
+  *newline_length = 1;
+  *seen = kSeenLF;
+  return lf_index + 1;
+}
+
+// Returns true if the decoder of `text_io` holds no bytes or pending "\r" from
+// earlier reads, so lines can be decoded straight from the read buffer.
+static bool textIOWrapperDecoderIsClean(Thread* thread,
+                                        const TextIOWrapper& text_io) {
+  HandleScope scope(thread);
+  Object decoder(&scope, text_io.decoder());
+  if (text_io.readuniversal()) {
+    if (!decoder.isIncrementalNewlineDecoder()) return false;
+    IncrementalNewlineDecoder newline_decoder(&scope, *decoder);
+    if (newline_decoder.pendingcr() != Bool::falseObj() ||
+        !newline_decoder.seennl().isSmallInt()) {
+      return false;
+    }
+    decoder = newline_decoder.decoder();
+  }
+  if (decoder.isNoneType()) return false;
+  Object name(&scope, thread->runtime()->symbols()->at(ID(buffer)));
+  Object pending(&scope, objectGetAttribute(thread, decoder, name));
+  if (pending.isErrorException()) {
+    thread->clearPendingException();
+    return false;
+  }
+  return pending.isErrorNotFound() ||
+         (pending.isBytes() && Bytes::cast(*pending).length() == 0);
+}
+
+// Reads a line of a UTF-8 or ASCII `TextIOWrapper` by scanning the buffer of
+// its `BufferedReader` for the line ending and decoding only the bytes of the
+// line. Text left in `_decoded_chars` by the managed code is used first.
+// Returns `Unbound` to use the managed code for other encodings, buffers and
+// newline settings, when the decoder holds state, for lines longer than the
+// read buffer and for bytes that are not valid in the encoding.
+RawObject FUNC(_io, _TextIOWrapper_readline_UTF8)(Thread* thread,
+                                                  Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object self_obj(&scope, args.get(0));
+  if (!self_obj.isTextIOWrapper()) return Unbound::object();
+  TextIOWrapper text_io(&scope, *self_obj);
+  Object buffer_obj(&scope, text_io.buffer());
+  if (!buffer_obj.isBufferedReader()) return Unbound::object();
+  BufferedReader buffer(&scope, *buffer_obj);
+  if (buffer.closed()) return Unbound::object();
+
+  bool ascii_only;
+  RawObject encoding = text_io.encoding();
+  if (encoding == SmallStr::fromCStr("utf-8") ||
+      encoding == SmallStr::fromCStr("UTF-8")) {
+    ascii_only = false;
+  } else if (encoding == SmallStr::fromCStr("ascii") ||
+             encoding == SmallStr::fromCStr("ASCII")) {
+    ascii_only = true;
+  } else {
+    return Unbound::object();
+  }
+  bool universal = text_io.readuniversal();
+  bool translate = text_io.readtranslate();
+  byte newline = '\n';
+  if (!universal) {
+    RawObject readnl = text_io.readnl();
+    if (readnl == SmallStr::fromCStr("\r")) {
+      newline = '\r';
+    } else if (readnl != SmallStr::fromCStr("\n")) {
+      return Unbound::object();
+    }
+  }
+
+  Object decoded_obj(&scope, text_io.decodedChars());
+  Object used_obj(&scope, text_io.decodedCharsUsed());
+  if (!decoded_obj.isStr() || !used_obj.isSmallInt()) return Unbound::object();
+  Str decoded(&scope, *decoded_obj);
+  word used = SmallInt::cast(*used_obj).value();
+  word pending_start = decoded.offsetByCodePoints(0, used);
+  word pending_length = decoded.length() - pending_start;
+  Str prefix(&scope, Str::empty());
+  word newline_length = 0;
+  word seen = 0;
+  if (pending_length > 0) {
+    // The decoder already translated these characters and only leaves a
+    // "\r" at the end of its output at the end of the file.
+    byte small_str[SmallStr::kMaxLength];
+    const byte* data;
+    if (decoded.isSmallStr()) {
+      decoded.copyTo(small_str, decoded.length());
+      data = small_str;
+    } else {
+      data = reinterpret_cast<byte*>(LargeStr::cast(*decoded).address());
+    }
+    word line_length = findLineEnd(data + pending_start, pending_length,
+                                   universal && !translate, newline,
+                                   /*cr_is_final=*/true, &newline_length,
+                                   &seen);
+    if (line_length >= 0) {
+      Str line(&scope, strSubstr(thread, decoded, pending_start, line_length));
+      text_io.setDecodedCharsUsed(
+          SmallInt::fromWord(used + line.codePointLength()));
+      return *line;
+    }
+    prefix = strSubstr(thread, decoded, pending_start, pending_length);
+  }
+  if (!textIOWrapperDecoderIsClean(thread, text_io)) return Unbound::object();
+
+  Object raw(&scope, buffer.underlying());
+  word line_length;
+  for (bool at_eof = false;;) {
+    word read_pos = buffer.readPos();
+    word available = buffer.bufferNumBytes() - read_pos;
+    line_length = -1;
+    if (available > 0) {
+      byte* data = reinterpret_cast<byte*>(
+          MutableBytes::cast(buffer.readBuf()).address());
+      line_length = findLineEnd(data + read_pos, available, universal, newline,
+                                at_eof, &newline_length, &seen);
+    }
+    if (line_length >= 0) break;
+    if (at_eof) {
+      line_length = available;
+      newline_length = 0;
+      seen = 0;
+      break;
+    }
+    if (available >= buffer.bufferSize()) return Unbound::object();
+    MutableBytes read_buf(&scope, rewindOrInitReadBuf(thread, buffer));
+    word buffer_num_bytes = buffer.bufferNumBytes();
+    Object fill_result(&scope,
+                       fillBuffer(thread, raw, read_buf, &buffer_num_bytes));
+    if (fill_result.isErrorException()) return *fill_result;
+    buffer.setBufferNumBytes(buffer_num_bytes);
+    if (fill_result.isNoneType()) return Unbound::object();
+    at_eof = !fill_result.isUnbound();
+  }
+
+  Object line(&scope, Str::empty());
+  word read_pos = buffer.readPos();
+  if (line_length > 0) {
+    // Universal newlines mode with translation returns "\r" and "\r\n" line
+    // endings as "\n".
+    bool translate_newline = translate && newline_length > 0;
+    word copy_length =
+        translate_newline ? line_length - newline_length : line_length;
+    word result_length = translate_newline ? copy_length + 1 : copy_length;
+    MutableBytes read_buf(&scope, buffer.readBuf());
+    MutableBytes result(&scope,
+                        runtime->newMutableBytesUninitialized(result_length));
+    result.replaceFromWithStartAt(0, *read_buf, copy_length, read_pos);
+    if (translate_newline) result.byteAtPut(copy_length, '\n');
+    if (ascii_only ? !result.isASCII()
+                   : !bytesIsValidUTF8(Bytes::cast(*result))) {
+      return Unbound::object();
+    }
+    line = result.becomeStr();
+  }
+  buffer.setReadPos(read_pos + line_length);
+  if (seen != 0) {
+    IncrementalNewlineDecoder decoder(&scope, text_io.decoder());
+    word seennl = SmallInt::cast(decoder.seennl()).value();
+    decoder.setSeennl(SmallInt::fromWord(seennl | seen));
+  }
+  text_io.setDecodedChars(Str::empty());
+  text_io.setDecodedCharsUsed(SmallInt::fromWord(0));
+  text_io.setSnapshot(NoneType::object());
+  if (prefix.length() == 0) return *line;
+  Str line_str(&scope, *line);
+  return runtime->strConcat(thread, prefix, line_str);
+}
+
 // Copy the bytes of a UTF-8 encoded string with no surrogates to the write
 // buffer (a Bytearray) of underlying Bufferedwriter of TextIOWrapper
-// If the length of write buffer will be larger than
-// BufferedWriter.bufferSize(), return Unbound to escape to managed code and
-// call BufferedWriter.write()
 // If the newline is "\r\n", return Unbound to use managed code
-// If text_io.lineBuffering() or haslf or "\r" in text, return Unbound to
-// managed code to use flush()
-// TODO(T61927696): Implement native version of BufferedWriter._flush_unlocked()
-// with FileIO as BufferedWriter.raw. With that function, we can do flush in
-// here.
+// The buffer is flushed when it grows beyond BufferedWriter.bufferSize() or
+// when line buffering is enabled and the text contains a newline.
 RawObject FUNC(_io, _TextIOWrapper_write_UTF8)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
 
@@ -976,11 +1437,15 @@ RawObject FUNC(_io, _TextIOWrapper_write_UTF8)(Thread* thread, Arguments args) {
   }
 
   if (text_io.lineBuffering() && hasnl) {
-    // TODO(T61927696): Implement native support for
-    // BufferedWriter._flush_unlocked to do flush here
-    Object flush_result(&scope, thread->invokeMethod1(buffer, ID(flush)));
+    Object flush_result(&scope, bufferedWriterFlush(thread, buffer));
+    if (flush_result.isUnbound()) {
+      flush_result = thread->invokeMethod1(buffer, ID(flush));
+    }
     if (flush_result.isErrorException()) return *flush_result;
     text_io.setTelling(text_io.seekable());
+  } else if (new_len > buffer.bufferSize()) {
+    Object flush_result(&scope, bufferedWriterFlush(thread, buffer));
+    if (flush_result.isErrorException()) return *flush_result;
   }
 
   text_io.setDecodedChars(Str::empty());
@@ -1029,7 +1494,8 @@ static const BuiltinAttribute kBufferedReaderAttributes[] = {
 };
 
 static const BuiltinAttribute kBufferedWriterAttributes[] = {
-    {ID(buffer_size), RawBufferedWriter::kBufferSizeOffset},
+    {ID(buffer_size), RawBufferedWriter::kBufferSizeOffset,
+     AttributeFlags::kReadOnly},
     {ID(_write_buf), RawBufferedWriter::kWriteBufOffset},
     {ID(_write_lock), RawBufferedWriter::kWriteLockOffset},
 };
@@ -1200,8 +1666,6 @@ static const BuiltinAttribute kFileIOAttributes[] = {
     {ID(_closefd), RawFileIO::kCloseFdOffset},
 };
 
-static const word kDefaultBufferSize = 1 * kKiB;  // bytes
-
 RawObject METH(FileIO, readall)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Runtime* runtime = thread->runtime();
@@ -1217,55 +1681,8 @@ RawObject METH(FileIO, readall)(Thread* thread, Arguments args) {
   Object fd_obj(&scope, file_io.fd());
   DCHECK(fd_obj.isSmallInt(), "fd must be small int");
   int fd = SmallInt::cast(*fd_obj).value();
-  // If there is OSError from File::seek or File::size, error will not be
-  // thrown. This case is handled by the for loop below.
-  word pos = File::seek(fd, 0, 1);
-  word end = File::size(fd);
-  word buffer_size = kDefaultBufferSize;
-
-  if (end > 0 && pos >= 0 && end >= pos) {
-    buffer_size = end - pos + 1;
-  }
-  // OSError from getting File::seek or File::size, or end < pos
-  // read buffer by buffer
-  Bytearray result_array(&scope, runtime->newBytearray());
-  word read_size;
-  word total_len = 0;
-  for (;;) {
-    read_size = buffer_size;
-    runtime->bytearrayEnsureCapacity(thread, result_array,
-                                     total_len + buffer_size);
-    byte* dst = reinterpret_cast<byte*>(
-        MutableBytes::cast(result_array.items()).address());
-    word result_len = File::read(fd, dst + total_len, read_size);
-    if (result_len < 0) {
-      return thread->raiseOSErrorFromErrno(-result_len);
-    }
-    total_len += result_len;
-    // From the glibc manual: "If read returns at least one character, there
-    // is no way you can tell whether end-of-file was reached. But if you did
-    // reach the end, the next read will return zero."
-    // Therefore, we can't stop when the result_len is less than read_len, as
-    // we still don't know if there's more input that we're blocked on.
-    if (result_len == 0) {
-      if (total_len == 0) {
-        return Bytes::empty();
-      }
-      // TODO(T70612758): Find a way to shorten the MutableBytes object without
-      // extra allocation
-      Bytes result_bytes(
-          &scope, MutableBytes::cast(result_array.items()).becomeImmutable());
-      MutableBytes result(&scope,
-                          runtime->newMutableBytesUninitialized(total_len));
-      dst = reinterpret_cast<byte*>(result.address());
-      result_bytes.copyTo(dst, total_len);
-      return result.becomeImmutable();
-    }
-    result_array.setNumItems(total_len);
-    if (total_len == buffer_size) {
-      buffer_size *= 2;
-    }
-  }
+  Object none(&scope, NoneType::object());
+  return readFileDescriptor(thread, fd, kMaxWord, none, 0, 0);
 }
 
 static RawObject readintoBytesAddress(Thread* thread, const int fd, byte* dst,
@@ -1,8 +1,16 @@
 // Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
 #include "builtins.h"
 #include "dict-builtins.h"
 #include "float-builtins.h"
+#include "float-conversion.h"
+#include "formatter-utils.h"
+#include "formatter.h"
 #include "handles.h"
+#include "list-builtins.h"
 #include "objects.h"
 #include "runtime.h"
 #include "str-builtins.h"
@@ -14,6 +22,10 @@
 namespace py {
 
 static const word kDictKeySetInitLength = 8;
+// Objects with at most this many keys share their keys with the following
+// objects that start with the same key, which is the common case for arrays
+// of records.
+static const word kSharedKeysMaxItems = 64;
 static const int kNumUEscapeChars = 4;
 
 enum class LoadsArg {
@@ -28,11 +40,36 @@ enum class LoadsArg {
   kKw = 8,
 };
 
+// `_loads_values` keeps the hook arguments at the same positions as `loads` so
+// the parser can look them up with `LoadsArg`.
+enum class LoadsValuesArg {
+  kBuffer = 0,
+  kEnd = 1,
+  kStrict = 2,
+};
+
+enum class DumpsArg {
+  kObj = 0,
+  kSkipkeys = 1,
+  kEnsureAscii = 2,
+  kCheckCircular = 3,
+  kAllowNan = 4,
+  kCls = 5,
+  kIndent = 6,
+  kSeparators = 7,
+  kDefault = 8,
+  kSortKeys = 9,
+  kKw = 10,
+};
+
 struct JSONParser {
   // Index of next byte to read.
   word next;
   word length;
   Arguments args;
+  // When set, the input is a sequence of whitespace separated documents that
+  // are all appended to this list.
+  List* values;
   bool has_object_hook;
   bool has_object_pairs_hook;
   bool has_parse_constant;
@@ -126,6 +163,10 @@ static NEVER_INLINE RawObject raiseJSONDecodeError(Thread* thread,
   // Convert byte position to codepoint.
   Object msg_str(&scope, runtime->newStrFromCStr(msg));
   Object doc(&scope, env->args.get(static_cast<word>(LoadsArg::kString)));
+  if (!runtime->isInstanceOfStr(*doc)) {
+    // `JSONDecodeError` computes line and column numbers on a `str`.
+    doc = dataArraySubstr(thread, data, 0, env->length);
+  }
   Object pos_obj(&scope, runtime->newInt(pos));
   Object args(&scope, runtime->newTupleWith3(msg_str, doc, pos_obj));
   return thread->raiseWithType(*json_decode_error, *args);
@@ -675,8 +716,27 @@ static int scan(Thread* thread, JSONParser* env, const DataArray& data, byte b,
   }
 }
 
+// Returns true if the string starting at `data[next]` is `key` without any
+// escape sequences, so `key` can be used without scanning the string.
+static bool matchesKey(const DataArray& data, word next, word length,
+                       RawStr key) {
+  word key_length = key.length();
+  if (length - next <= key_length) return false;
+  for (word i = 0; i < key_length; i++) {
+    byte b = data.byteAt(next + i);
+    if (b != key.byteAt(i) || b == '"' || b == '\\' ||
+        ASCII::isControlCharacter(b)) {
+      return false;
+    }
+  }
+  return data.byteAt(next + key_length) == '"';
+}
+
+// Scans a dict key. `expected_key` is the key predicted by the shape of
+// previously decoded objects or `Unbound` if there is no prediction.
 static inline RawObject scanDictKey(Thread* thread, JSONParser* env,
                                     const DataArray& data, byte b,
+                                    const Object& expected_key,
                                     MutableTuple* dict_key_set,
                                     word* dict_key_set_remaining) {
   if (b != '"') {
@@ -686,10 +746,17 @@ static inline RawObject scanDictKey(Thread* thread, JSONParser* env,
   }
 
   HandleScope scope(thread);
-  Object dict_key(&scope, scanString(thread, env, data));
-  if (dict_key.isErrorException()) return *dict_key;
+  Object dict_key(&scope, NoneType::object());
+  if (expected_key.isStr() &&
+      matchesKey(data, env->next, env->length, Str::cast(*expected_key))) {
+    env->next += Str::cast(*expected_key).length() + 1;
+    dict_key = *expected_key;
+  } else {
+    dict_key = scanString(thread, env, data);
+    if (dict_key.isErrorException()) return *dict_key;
+  }
 
-  if (dict_key.isLargeStr()) {
+  if (dict_key.isLargeStr() && dict_key != expected_key) {
     RawObject str_key_interned = NoneType::object();
     bool added =
         internSetAdd(thread, **dict_key_set, dict_key, &str_key_interned);
@@ -715,6 +782,13 @@ static RawObject parse(Thread* thread, JSONParser* env, const DataArray& data) {
   Object container(&scope, NoneType::object());
   Object dict_key(&scope, NoneType::object());
   Object value(&scope, NoneType::object());
+  // Maps the first key of recently decoded objects to their shared keys.
+  Dict shared_keys(&scope, runtime->newDict());
+  Object keys(&scope, NoneType::object());
+  // The keys of the most recently decoded object sharing its keys, used to
+  // predict the keys of the next object.
+  Object last_keys(&scope, NoneType::object());
+  Object expected_key(&scope, Unbound::object());
   MutableTuple dict_key_set(&scope,
                             runtime->newMutableTuple(kDictKeySetInitLength));
   word dict_key_set_remaining =
@@ -751,9 +825,21 @@ static RawObject parse(Thread* thread, JSONParser* env, const DataArray& data) {
           }
           thread->stackPush(*container);
           container = *value;
-          dict_key = scanDictKey(thread, env, data, b, &dict_key_set,
-                                 &dict_key_set_remaining);
+          expected_key = last_keys.isNoneType()
+                             ? Unbound::object()
+                             : dictSharedKeysAt(last_keys, 0);
+          dict_key = scanDictKey(thread, env, data, b, expected_key,
+                                 &dict_key_set, &dict_key_set_remaining);
           if (dict_key.isErrorException()) return *dict_key;
+          if (dict_key == expected_key) {
+            keys = *last_keys;
+          } else {
+            keys = dictAtByStr(thread, shared_keys, dict_key);
+          }
+          if (!keys.isErrorNotFound()) {
+            Dict dict(&scope, *container);
+            dictUseSharedKeys(thread, dict, keys);
+          }
           b = nextNonWhitespace(thread, env, data);
           thread->stackPush(*dict_key);
           continue;
@@ -793,17 +879,39 @@ static RawObject parse(Thread* thread, JSONParser* env, const DataArray& data) {
       if (container.isDict()) {
         Dict dict(&scope, *container);
         dict_key = thread->stackPop();
-        dictAtPutByStr(thread, dict, dict_key, value);
+        expected_key = Unbound::object();
+        bool appended = false;
+        if (dictHasSharedKeys(dict)) {
+          keys = dict.indices();
+          if (dict_key == dictSharedKeysAt(keys, dict.numItems())) {
+            dictSharedKeysAppend(dict, value);
+            expected_key = dictSharedKeysAt(keys, dict.numItems());
+            appended = true;
+          }
+        }
+        if (!appended) {
+          dictAtPutByStr(thread, dict, dict_key, value);
+        }
         if (b == ',') {
           b = nextNonWhitespace(thread, env, data);
-          dict_key = scanDictKey(thread, env, data, b, &dict_key_set,
-                                 &dict_key_set_remaining);
+          dict_key = scanDictKey(thread, env, data, b, expected_key,
+                                 &dict_key_set, &dict_key_set_remaining);
           if (dict_key.isErrorException()) return *dict_key;
           b = nextNonWhitespace(thread, env, data);
           thread->stackPush(*dict_key);
           break;
         }
         if (b == '}') {
+          if (!dictHasSharedKeys(dict) &&
+              dict.numItems() <= kSharedKeysMaxItems) {
+            keys = dictShareKeys(thread, dict);
+            word i = 0;
+            dictNextKey(dict, &i, &dict_key);
+            dictAtPutByStr(thread, shared_keys, dict_key, keys);
+          }
+          if (dictHasSharedKeys(dict)) {
+            last_keys = dict.indices();
+          }
           value = *container;
           container = thread->stackPop();
           b = nextNonWhitespace(thread, env, data);
@@ -819,6 +927,12 @@ static RawObject parse(Thread* thread, JSONParser* env, const DataArray& data) {
       }
 
       DCHECK(container.isNoneType(), "expected no container");
+      if (env->values != nullptr) {
+        runtime->listAdd(thread, *env->values, value);
+        if (env->next > env->length) return **env->values;
+        // `b` starts the next document.
+        break;
+      }
       if (env->next <= env->length) {
         return raiseJSONDecodeError(thread, env, data, env->next - 1,
                                     "Extra data");
@@ -828,6 +942,26 @@ static RawObject parse(Thread* thread, JSONParser* env, const DataArray& data) {
   }
 }
 
+static void initParserHooks(JSONParser* env) {
+  Arguments args = env->args;
+  if (!args.get(static_cast<word>(LoadsArg::kObjectHook)).isNoneType()) {
+    env->has_object_hook = true;
+  }
+  if (!args.get(static_cast<word>(LoadsArg::kParseFloat)).isNoneType()) {
+    env->has_parse_float = true;
+  }
+  if (!args.get(static_cast<word>(LoadsArg::kParseInt)).isNoneType()) {
+    env->has_parse_int = true;
+  }
+  if (!args.get(static_cast<word>(LoadsArg::kParseConstant)).isNoneType()) {
+    env->has_parse_constant = true;
+  }
+  if (!args.get(static_cast<word>(LoadsArg::kObjectPairsHook)).isNoneType()) {
+    env->has_object_hook = true;
+    env->has_object_pairs_hook = true;
+  }
+}
+
 RawObject FUNC(_json, loads)(Thread* thread, Arguments args) {
   HandleScope scope(thread);
   Runtime* runtime = thread->runtime();
@@ -924,23 +1058,797 @@ RawObject FUNC(_json, loads)(Thread* thread, Arguments args) {
   env.args = args;
   env.strict = strict;
 
-  if (!args.get(static_cast<word>(LoadsArg::kObjectHook)).isNoneType()) {
-    env.has_object_hook = true;
+  initParserHooks(&env);
+  return parse(thread, &env, data);
+}
+
+enum class JSONScanMode {
+  kBetween,
+  kString,
+  kStringEscape,
+  kScalar,
+  kCount,
+};
+
+static bool isScalarDelimiter(byte b) {
+  return b == ' ' || b == '\t' || b == '\n' || b == '\r' || b == ',' ||
+         b == '"' || b == '[' || b == ']' || b == '{' || b == '}';
+}
+
+// Scans `data[*pos:length]` for the ends of top-level documents in a sequence
+// of whitespace separated documents. Only nesting and strings are tracked;
+// the documents are validated when they are parsed. The scan can be resumed
+// with more data using the updated `pos`, `depth` and `mode`. Returns the
+// index after the last completed document or 0 if none was completed.
+static word scanDocumentEnds(const byte* data, word length, word* pos,
+                             word* depth, JSONScanMode* mode) {
+  word end = 0;
+  word level = *depth;
+  JSONScanMode current = *mode;
+  for (word i = *pos; i < length; i++) {
+    byte b = data[i];
+    switch (current) {
+      case JSONScanMode::kString:
+        if (b == '\\') {
+          current = JSONScanMode::kStringEscape;
+        } else if (b == '"') {
+          current = JSONScanMode::kBetween;
+          if (level == 0) end = i + 1;
+        }
+        break;
+      case JSONScanMode::kStringEscape:
+        current = JSONScanMode::kString;
+        break;
+      case JSONScanMode::kScalar:
+        if (isScalarDelimiter(b)) {
+          current = JSONScanMode::kBetween;
+          end = i;
+          // Look at the delimiter again outside of the scalar.
+          i--;
+        }
+        break;
+      case JSONScanMode::kBetween:
+        switch (b) {
+          case '"':
+            current = JSONScanMode::kString;
+            break;
+          case '[':
+          case '{':
+            level++;
+            break;
+          case ']':
+          case '}':
+            // Unbalanced brackets end a document so the parser reports them.
+            if (level > 0) level--;
+            if (level == 0) end = i + 1;
+            break;
+          case ' ':
+          case '\t':
+          case '\n':
+          case '\r':
+            break;
+          default:
+            if (level == 0) current = JSONScanMode::kScalar;
+            break;
+        }
+        break;
+      case JSONScanMode::kCount:
+        UNREACHABLE("invalid scan mode");
+    }
   }
-  if (!args.get(static_cast<word>(LoadsArg::kParseFloat)).isNoneType()) {
-    env.has_parse_float = true;
+  *pos = length;
+  *depth = level;
+  *mode = current;
+  return end;
+}
+
+RawObject FUNC(_json, _scan_values)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object buffer_obj(&scope, args.get(0));
+  if (!runtime->isInstanceOfBytearray(*buffer_obj)) {
+    return thread->raiseRequiresType(buffer_obj, ID(bytearray));
   }
-  if (!args.get(static_cast<word>(LoadsArg::kParseInt)).isNoneType()) {
-    env.has_parse_int = true;
+  Object pos_obj(&scope, args.get(1));
+  if (!runtime->isInstanceOfInt(*pos_obj)) {
+    return thread->raiseRequiresType(pos_obj, ID(int));
   }
-  if (!args.get(static_cast<word>(LoadsArg::kParseConstant)).isNoneType()) {
-    env.has_parse_constant = true;
+  Object state_obj(&scope, args.get(2));
+  if (!runtime->isInstanceOfInt(*state_obj)) {
+    return thread->raiseRequiresType(state_obj, ID(int));
   }
-  if (!args.get(static_cast<word>(LoadsArg::kObjectPairsHook)).isNoneType()) {
-    env.has_object_hook = true;
-    env.has_object_pairs_hook = true;
+  Bytearray buffer(&scope, *buffer_obj);
+  word length = buffer.numItems();
+  word pos = intUnderlying(*pos_obj).asWordSaturated();
+  word state = intUnderlying(*state_obj).asWordSaturated();
+  word num_modes = static_cast<word>(JSONScanMode::kCount);
+  if (pos < 0 || pos > length || state < 0) {
+    return thread->raiseWithFmt(LayoutId::kValueError, "invalid scan state");
   }
+  word depth = state / num_modes;
+  JSONScanMode mode = static_cast<JSONScanMode>(state % num_modes);
+  MutableBytes items(&scope, buffer.items());
+  word end = scanDocumentEnds(reinterpret_cast<byte*>(items.address()), length,
+                              &pos, &depth, &mode);
+  Object end_obj(&scope, SmallInt::fromWord(end));
+  pos_obj = SmallInt::fromWord(pos);
+  state_obj = runtime->newInt(depth * num_modes + static_cast<word>(mode));
+  return runtime->newTupleWith3(end_obj, pos_obj, state_obj);
+}
+
+RawObject FUNC(_json, _loads_values)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object buffer_obj(&scope,
+                    args.get(static_cast<word>(LoadsValuesArg::kBuffer)));
+  if (!runtime->isInstanceOfBytearray(*buffer_obj)) {
+    return thread->raiseRequiresType(buffer_obj, ID(bytearray));
+  }
+  Object end_obj(&scope, args.get(static_cast<word>(LoadsValuesArg::kEnd)));
+  if (!runtime->isInstanceOfInt(*end_obj)) {
+    return thread->raiseRequiresType(end_obj, ID(int));
+  }
+  Bytearray buffer(&scope, *buffer_obj);
+  word end = intUnderlying(*end_obj).asWordSaturated();
+  if (end < 0 || end > buffer.numItems()) {
+    return thread->raiseWithFmt(LayoutId::kValueError, "end out of range");
+  }
+  Object strict_obj(&scope,
+                    args.get(static_cast<word>(LoadsValuesArg::kStrict)));
+  Object strict(&scope, Interpreter::isTrue(thread, *strict_obj));
+  if (strict.isErrorException()) return *strict;
+
+  List values(&scope, runtime->newList());
+  DataArray data(&scope, buffer.items());
+  JSONParser env;
+  memset(&env, 0, sizeof(env));
+  env.length = end;
+  env.args = args;
+  env.values = &values;
+  env.strict = strict == Bool::trueObj();
+  initParserHooks(&env);
+  nextNonWhitespace(thread, &env, data);
+  if (env.next > env.length) return *values;
+  env.next--;
   return parse(thread, &env, data);
 }
 
+// Growable buffer for an encoded document. It lives outside of the managed
+// heap so that it stays put while the encoder calls back into Python code.
+class JSONWriter {
+ public:
+  JSONWriter() = default;
+  ~JSONWriter() { std::free(data_); }
+
+  const byte* data() const { return data_; }
+  word length() const { return length_; }
+
+  // Makes room for `count` more bytes and returns where they go. The caller
+  // must `advance` by the number of bytes actually written.
+  byte* reserve(word count) {
+    if (length_ + count > capacity_) {
+      grow(length_ + count);
+    }
+    return data_ + length_;
+  }
+  void advance(word count) {
+    DCHECK(length_ + count <= capacity_, "advance past capacity");
+    length_ += count;
+  }
+
+  void write(byte b) {
+    *reserve(1) = b;
+    length_++;
+  }
+  void write(const byte* bytes, word count) {
+    std::memcpy(reserve(count), bytes, count);
+    length_ += count;
+  }
+  void write(const char* c_str) {
+    write(reinterpret_cast<const byte*>(c_str), std::strlen(c_str));
+  }
+  void write(RawStr str) {
+    word count = str.length();
+    str.copyTo(reserve(count), count);
+    length_ += count;
+  }
+
+ private:
+  void grow(word min_capacity) {
+    word new_capacity = Utils::maximum(min_capacity, capacity_ * 2);
+    new_capacity = Utils::maximum(new_capacity, word{64});
+    data_ = static_cast<byte*>(std::realloc(data_, new_capacity));
+    CHECK(data_ != nullptr, "out of memory");
+    capacity_ = new_capacity;
+  }
+
+  byte* data_ = nullptr;
+  word length_ = 0;
+  word capacity_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONWriter);
+};
+
+struct JSONEncoder {
+  JSONWriter out;
+  Arguments args;
+  // Objects currently being encoded when checking for circular references,
+  // nullptr otherwise.
+  const List* markers;
+  Vector<byte> indent;
+  Vector<byte> item_separator;
+  Vector<byte> key_separator;
+  bool allow_nan;
+  bool check_circular;
+  bool ensure_ascii;
+  bool has_default;
+  bool has_indent;
+  bool skipkeys;
+  bool sort_keys;
+};
+
+// Returns whether any byte of `chunk` must be escaped: a control character,
+// `"`, `\` or, if `ensure_ascii` is set, DEL or a non-ASCII byte. Tests all
+// bytes of the word at once.
+static bool chunkNeedsEscape(uword chunk, bool ensure_ascii) {
+  const uword ones = kMaxUword / 0xff;
+  const uword quotes = chunk ^ (ones * '"');
+  const uword backslashes = chunk ^ (ones * '\\');
+  uword result = ((chunk - ones * 0x20) & ~chunk) |
+                 ((quotes - ones) & ~quotes) |
+                 ((backslashes - ones) & ~backslashes);
+  if (ensure_ascii) {
+    result |= chunk | (chunk + ones);
+  }
+  return (result & (ones * 0x80)) != 0;
+}
+
+static bool byteNeedsEscape(byte b, bool ensure_ascii) {
+  return b < 0x20 || b == '"' || b == '\\' || (ensure_ascii && b >= 0x7f);
+}
+
+static void writeUEscape(JSONWriter* out, int32_t code_unit) {
+  byte* dst = out->reserve(6);
+  dst[0] = '\\';
+  dst[1] = 'u';
+  uwordToHexadecimal(dst + 2, 4, code_unit);
+  out->advance(6);
+}
+
+// Writes `str` as a quoted JSON string, escaped like `encode_basestring` or
+// `encode_basestring_ascii` in `json.encoder`.
+static void writeJSONString(JSONWriter* out, RawStr str, bool ensure_ascii) {
+  word length = str.length();
+  byte small_str[SmallStr::kMaxLength];
+  const byte* bytes;
+  if (str.isSmallStr()) {
+    str.copyTo(small_str, length);
+    bytes = small_str;
+  } else {
+    // No allocation happens below, so the string does not move.
+    bytes = reinterpret_cast<const byte*>(LargeStr::cast(str).address());
+  }
+  out->write('"');
+  word run_start = 0;
+  word i = 0;
+  while (i < length) {
+    if (i + kWordSize <= length) {
+      uword chunk;
+      std::memcpy(&chunk, bytes + i, kWordSize);
+      if (!chunkNeedsEscape(chunk, ensure_ascii)) {
+        i += kWordSize;
+        continue;
+      }
+    }
+    for (word chunk_end = Utils::minimum(i + kWordSize, length);
+         i < chunk_end;) {
+      byte b = bytes[i];
+      if (!byteNeedsEscape(b, ensure_ascii)) {
+        i++;
+        continue;
+      }
+      out->write(bytes + run_start, i - run_start);
+      i++;
+      switch (b) {
+        case '"':
+          out->write("\\\"");
+          break;
+        case '\\':
+          out->write("\\\\");
+          break;
+        case '\b':
+          out->write("\\b");
+          break;
+        case '\f':
+          out->write("\\f");
+          break;
+        case '\n':
+          out->write("\\n");
+          break;
+        case '\r':
+          out->write("\\r");
+          break;
+        case '\t':
+          out->write("\\t");
+          break;
+        default: {
+          if (b < 0x80) {
+            writeUEscape(out, b);
+            break;
+          }
+          // Decode the rest of the UTF-8 sequence.
+          int32_t code_point;
+          if (b < 0xe0) {
+            code_point = ((b & 0x1f) << 6) | (bytes[i] & 0x3f);
+            i += 1;
+          } else if (b < 0xf0) {
+            code_point = ((b & 0x0f) << 12) | ((bytes[i] & 0x3f) << 6) |
+                         (bytes[i + 1] & 0x3f);
+            i += 2;
+          } else {
+            code_point = ((b & 0x07) << 18) | ((bytes[i] & 0x3f) << 12) |
+                         ((bytes[i + 1] & 0x3f) << 6) | (bytes[i + 2] & 0x3f);
+            i += 3;
+          }
+          if (code_point > 0xffff) {
+            writeUEscape(out, Unicode::highSurrogateFor(code_point));
+            writeUEscape(out, Unicode::lowSurrogateFor(code_point));
+          } else {
+            writeUEscape(out, code_point);
+          }
+          break;
+        }
+      }
+      run_start = i;
+    }
+  }
+  out->write(bytes + run_start, length - run_start);
+  out->write('"');
+}
+
+static void writeSeparator(JSONWriter* out, const Vector<byte>& separator) {
+  out->write(separator.begin(), separator.size());
+}
+
+static void writeNewlineIndent(JSONEncoder* env, word level) {
+  env->out.write('\n');
+  for (word i = 0; i < level; i++) {
+    env->out.write(env->indent.begin(), env->indent.size());
+  }
+}
+
+static RawObject writeFloat(Thread* thread, JSONEncoder* env, double value) {
+  if (std::isfinite(value)) {
+    unique_c_ptr<char> buf(
+        doubleToString(value, 'r', 0, false, true, false, nullptr));
+    env->out.write(buf.get());
+    return NoneType::object();
+  }
+  if (!env->allow_nan) {
+    return thread->raiseWithFmt(
+        LayoutId::kValueError,
+        "Out of range float values are not JSON compliant");
+  }
+  if (std::isnan(value)) {
+    env->out.write("NaN");
+  } else if (value > 0) {
+    env->out.write("Infinity");
+  } else {
+    env->out.write("-Infinity");
+  }
+  return NoneType::object();
+}
+
+static void writeInt(Thread* thread, JSONEncoder* env, RawInt value) {
+  if (value.isSmallInt()) {
+    word num = SmallInt::cast(value).value();
+    byte buffer[kUwordDigits10 + 1];
+    byte* end = buffer + ARRAYSIZE(buffer);
+    byte* start = uwordToDecimal(num < 0 ? -static_cast<uword>(num) : num, end);
+    if (num < 0) *--start = '-';
+    env->out.write(start, end - start);
+    return;
+  }
+  HandleScope scope(thread);
+  Int value_int(&scope, value);
+  env->out.write(Str::cast(formatIntDecimalSimple(thread, value_int)));
+}
+
+static RawObject encodeValue(Thread* thread, JSONEncoder* env,
+                             const Object& obj, word level);
+
+// Registers `obj` as being encoded. Raises if it already is.
+static RawObject markersEnter(Thread* thread, JSONEncoder* env,
+                              const Object& obj) {
+  if (env->markers == nullptr) return NoneType::object();
+  const List& markers = *env->markers;
+  for (word i = 0, num_items = markers.numItems(); i < num_items; i++) {
+    if (markers.at(i) == *obj) {
+      return thread->raiseWithFmt(LayoutId::kValueError,
+                                  "Circular reference detected");
+    }
+  }
+  thread->runtime()->listAdd(thread, markers, obj);
+  return NoneType::object();
+}
+
+static void markersLeave(Thread* thread, JSONEncoder* env) {
+  if (env->markers == nullptr) return;
+  const List& markers = *env->markers;
+  listPop(thread, markers, markers.numItems() - 1);
+}
+
+static RawObject encodeSequence(Thread* thread, JSONEncoder* env,
+                                const Object& obj, word level) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  bool is_list = runtime->isInstanceOfList(*obj);
+  word num_items;
+  if (is_list) {
+    List list(&scope, *obj);
+    num_items = list.numItems();
+  } else {
+    num_items = tupleUnderlying(*obj).length();
+  }
+  if (num_items == 0) {
+    env->out.write("[]");
+    return NoneType::object();
+  }
+  Object result(&scope, markersEnter(thread, env, obj));
+  if (result.isErrorException()) return *result;
+  env->out.write('[');
+  if (env->has_indent) {
+    writeNewlineIndent(env, level + 1);
+  }
+  Object item(&scope, NoneType::object());
+  // Re-check the length on every iteration; `default` may mutate the list.
+  for (word i = 0;; i++) {
+    if (is_list) {
+      List list(&scope, *obj);
+      if (i >= list.numItems()) break;
+      item = list.at(i);
+    } else {
+      Tuple tuple(&scope, tupleUnderlying(*obj));
+      if (i >= tuple.length()) break;
+      item = tuple.at(i);
+    }
+    if (i > 0) {
+      writeSeparator(&env->out, env->item_separator);
+      if (env->has_indent) {
+        writeNewlineIndent(env, level + 1);
+      }
+    }
+    result = encodeValue(thread, env, item, level + 1);
+    if (result.isErrorException()) return *result;
+  }
+  if (env->has_indent) {
+    writeNewlineIndent(env, level);
+  }
+  env->out.write(']');
+  markersLeave(thread, env);
+  return NoneType::object();
+}
+
+// Writes a dict key converted to a JSON string. Returns `Unbound` if the key
+// is skipped.
+static RawObject encodeDictKey(Thread* thread, JSONEncoder* env,
+                               const Object& key) {
+  Runtime* runtime = thread->runtime();
+  if (runtime->isInstanceOfStr(*key)) {
+    writeJSONString(&env->out, strUnderlying(*key), env->ensure_ascii);
+    return NoneType::object();
+  }
+  if (runtime->isInstanceOfFloat(*key)) {
+    env->out.write('"');
+    RawObject result =
+        writeFloat(thread, env, floatUnderlying(*key).value());
+    if (result.isErrorException()) return result;
+    env->out.write('"');
+    return NoneType::object();
+  }
+  if (key == Bool::trueObj()) {
+    env->out.write("\"true\"");
+    return NoneType::object();
+  }
+  if (key == Bool::falseObj()) {
+    env->out.write("\"false\"");
+    return NoneType::object();
+  }
+  if (key.isNoneType()) {
+    env->out.write("\"null\"");
+    return NoneType::object();
+  }
+  if (runtime->isInstanceOfInt(*key)) {
+    env->out.write('"');
+    writeInt(thread, env, intUnderlying(*key));
+    env->out.write('"');
+    return NoneType::object();
+  }
+  if (env->skipkeys) {
+    return Unbound::object();
+  }
+  return thread->raiseWithFmt(
+      LayoutId::kTypeError,
+      "keys must be str, int, float, bool or None, not %T", &key);
+}
+
+// Returns `list(dict.items())`. Like CPython, dict subclasses are encoded
+// through `items()` so that overrides of it are honored.
+static RawObject dictItemsList(Thread* thread, const Object& dict) {
+  HandleScope scope(thread);
+  Object items(&scope, thread->invokeMethod1(dict, ID(items)));
+  if (items.isErrorException()) return *items;
+  Object list_type(&scope, thread->runtime()->typeAt(LayoutId::kList));
+  return Interpreter::call1(thread, list_type, items);
+}
+
+static RawObject encodeDict(Thread* thread, JSONEncoder* env,
+                            const Object& obj, word level) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Dict dict(&scope, *obj);
+  if (dict.numItems() == 0) {
+    env->out.write("{}");
+    return NoneType::object();
+  }
+  Object result(&scope, markersEnter(thread, env, obj));
+  if (result.isErrorException()) return *result;
+  env->out.write('{');
+  if (env->has_indent) {
+    writeNewlineIndent(env, level + 1);
+  }
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  Object items(&scope, NoneType::object());
+  // Exact dicts are read straight from their storage unless the items need
+  // sorting.
+  bool use_items = !obj.isDict() || env->sort_keys;
+  if (!obj.isDict()) {
+    items = dictItemsList(thread, obj);
+    if (items.isErrorException()) return *items;
+  } else if (env->sort_keys) {
+    List list(&scope, runtime->newList());
+    for (word i = 0; dictNextItem(dict, &i, &key, &value);) {
+      Object item(&scope, runtime->newTupleWith2(key, value));
+      runtime->listAdd(thread, list, item);
+    }
+    items = *list;
+  }
+  if (env->sort_keys) {
+    // Same as `sorted(dict.items())`.
+    List list(&scope, *items);
+    result = listSort(thread, list);
+    if (result.isErrorException()) return *result;
+  }
+  bool first = true;
+  for (word i = 0;;) {
+    if (use_items) {
+      List list(&scope, *items);
+      if (i >= list.numItems()) break;
+      Object item(&scope, list.at(i++));
+      if (!runtime->isInstanceOfTuple(*item) ||
+          tupleUnderlying(*item).length() != 2) {
+        return thread->raiseWithFmt(LayoutId::kValueError,
+                                    "items must return 2-tuples");
+      }
+      Tuple pair(&scope, tupleUnderlying(*item));
+      key = pair.at(0);
+      value = pair.at(1);
+    } else if (!dictNextItem(dict, &i, &key, &value)) {
+      break;
+    }
+    if (!first) {
+      writeSeparator(&env->out, env->item_separator);
+      if (env->has_indent) {
+        writeNewlineIndent(env, level + 1);
+      }
+    }
+    result = encodeDictKey(thread, env, key);
+    if (result.isErrorException()) return *result;
+    if (result.isUnbound()) continue;
+    first = false;
+    writeSeparator(&env->out, env->key_separator);
+    result = encodeValue(thread, env, value, level + 1);
+    if (result.isErrorException()) return *result;
+  }
+  if (env->has_indent) {
+    writeNewlineIndent(env, level);
+  }
+  env->out.write('}');
+  markersLeave(thread, env);
+  return NoneType::object();
+}
+
+static RawObject encodeValue(Thread* thread, JSONEncoder* env,
+                             const Object& obj, word level) {
+  Runtime* runtime = thread->runtime();
+  if (runtime->isInstanceOfStr(*obj)) {
+    writeJSONString(&env->out, strUnderlying(*obj), env->ensure_ascii);
+    return NoneType::object();
+  }
+  if (obj.isNoneType()) {
+    env->out.write("null");
+    return NoneType::object();
+  }
+  if (obj == Bool::trueObj()) {
+    env->out.write("true");
+    return NoneType::object();
+  }
+  if (obj == Bool::falseObj()) {
+    env->out.write("false");
+    return NoneType::object();
+  }
+  if (runtime->isInstanceOfInt(*obj)) {
+    writeInt(thread, env, intUnderlying(*obj));
+    return NoneType::object();
+  }
+  if (runtime->isInstanceOfFloat(*obj)) {
+    return writeFloat(thread, env, floatUnderlying(*obj).value());
+  }
+  if (level >= thread->recursionLimit()) {
+    return thread->raiseWithFmt(
+        LayoutId::kRecursionError,
+        "maximum recursion depth exceeded while encoding a JSON object");
+  }
+  if (runtime->isInstanceOfList(*obj) || runtime->isInstanceOfTuple(*obj)) {
+    return encodeSequence(thread, env, obj, level);
+  }
+  if (runtime->isInstanceOfDict(*obj)) {
+    return encodeDict(thread, env, obj, level);
+  }
+  if (!env->has_default) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "Object of type %T is not JSON serializable",
+                                &obj);
+  }
+  HandleScope scope(thread);
+  Object result(&scope, markersEnter(thread, env, obj));
+  if (result.isErrorException()) return *result;
+  Object default_func(&scope,
+                      env->args.get(static_cast<word>(DumpsArg::kDefault)));
+  Object converted(&scope, Interpreter::call1(thread, default_func, obj));
+  if (converted.isErrorException()) return *converted;
+  result = encodeValue(thread, env, converted, level);
+  if (result.isErrorException()) return *result;
+  markersLeave(thread, env);
+  return NoneType::object();
+}
+
+static void copyStrToVector(RawStr str, Vector<byte>* dst) {
+  for (word i = 0, length = str.length(); i < length; i++) {
+    dst->push_back(str.byteAt(i));
+  }
+}
+
+static void copyCStrToVector(const char* c_str, Vector<byte>* dst) {
+  for (const char* p = c_str; *p != '\0'; p++) {
+    dst->push_back(*p);
+  }
+}
+
+static RawObject encodeBasestring(Thread* thread, const Object& obj,
+                                  bool ensure_ascii) {
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfStr(*obj)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "first argument must be a string, not %T",
+                                &obj);
+  }
+  JSONWriter out;
+  writeJSONString(&out, strUnderlying(*obj), ensure_ascii);
+  return runtime->newStrWithAll(View<byte>(out.data(), out.length()));
+}
+
+RawObject FUNC(_json, encode_basestring)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Object obj(&scope, args.get(0));
+  return encodeBasestring(thread, obj, /*ensure_ascii=*/false);
+}
+
+RawObject FUNC(_json, encode_basestring_ascii)(Thread* thread,
+                                               Arguments args) {
+  HandleScope scope(thread);
+  Object obj(&scope, args.get(0));
+  return encodeBasestring(thread, obj, /*ensure_ascii=*/true);
+}
+
+// Fills in `env` from the arguments of `dumps`. Returns `False` if they need
+// the `JSONEncoder` from `json.encoder`.
+static RawObject dumpsOptions(Thread* thread, Arguments args,
+                              JSONEncoder* env) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object indent(&scope, args.get(static_cast<word>(DumpsArg::kIndent)));
+  if (indent.isNoneType()) {
+    env->has_indent = false;
+  } else if (runtime->isInstanceOfStr(*indent)) {
+    env->has_indent = true;
+    copyStrToVector(strUnderlying(*indent), &env->indent);
+  } else if (indent.isSmallInt()) {
+    env->has_indent = true;
+    for (word i = 0, n = SmallInt::cast(*indent).value(); i < n; i++) {
+      env->indent.push_back(' ');
+    }
+  } else {
+    return Bool::falseObj();
+  }
+
+  Object separators(&scope,
+                    args.get(static_cast<word>(DumpsArg::kSeparators)));
+  if (separators.isNoneType()) {
+    copyCStrToVector(env->has_indent ? "," : ", ", &env->item_separator);
+    copyCStrToVector(": ", &env->key_separator);
+  } else {
+    Object item_separator(&scope, NoneType::object());
+    Object key_separator(&scope, NoneType::object());
+    if (separators.isTuple() && Tuple::cast(*separators).length() == 2) {
+      item_separator = Tuple::cast(*separators).at(0);
+      key_separator = Tuple::cast(*separators).at(1);
+    } else if (separators.isList() && List::cast(*separators).numItems() == 2) {
+      item_separator = List::cast(*separators).at(0);
+      key_separator = List::cast(*separators).at(1);
+    } else {
+      return Bool::falseObj();
+    }
+    if (!runtime->isInstanceOfStr(*item_separator) ||
+        !runtime->isInstanceOfStr(*key_separator)) {
+      return Bool::falseObj();
+    }
+    copyStrToVector(strUnderlying(*item_separator), &env->item_separator);
+    copyStrToVector(strUnderlying(*key_separator), &env->key_separator);
+  }
+
+  bool* flags[] = {&env->skipkeys, &env->ensure_ascii, &env->check_circular,
+                   &env->allow_nan, &env->sort_keys};
+  DumpsArg flag_args[] = {DumpsArg::kSkipkeys, DumpsArg::kEnsureAscii,
+                          DumpsArg::kCheckCircular, DumpsArg::kAllowNan,
+                          DumpsArg::kSortKeys};
+  for (word i = 0; i < static_cast<word>(ARRAYSIZE(flags)); i++) {
+    RawObject value =
+        Interpreter::isTrue(thread, args.get(static_cast<word>(flag_args[i])));
+    if (value.isErrorException()) return value;
+    *flags[i] = value == Bool::trueObj();
+  }
+  env->has_default =
+      !args.get(static_cast<word>(DumpsArg::kDefault)).isNoneType();
+  return Bool::trueObj();
+}
+
+RawObject FUNC(_json, dumps)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  JSONEncoder env;
+  env.args = args;
+  env.markers = nullptr;
+  Object cls(&scope, args.get(static_cast<word>(DumpsArg::kCls)));
+  Dict kw(&scope, args.get(static_cast<word>(DumpsArg::kKw)));
+  Object supported(&scope, Bool::falseObj());
+  if (cls.isNoneType() && kw.numItems() == 0) {
+    supported = dumpsOptions(thread, args, &env);
+    if (supported.isErrorException()) return *supported;
+  }
+  if (supported == Bool::falseObj()) {
+    Object function(&scope, runtime->lookupNameInModule(thread, ID(_json),
+                                                        ID(_encode_with_cls)));
+    CHECK(!function.isErrorNotFound(), "missing function in internal module");
+    thread->stackPush(*function);
+    MutableTuple call_args(&scope, runtime->newMutableTuple(10));
+    for (word i = 0; i < 10; i++) {
+      call_args.atPut(i, args.get(i));
+    }
+    thread->stackPush(call_args.becomeImmutable());
+    thread->stackPush(*kw);
+    return Interpreter::callEx(thread, CallFunctionExFlag::VAR_KEYWORDS);
+  }
+
+  List markers(&scope, runtime->newList());
+  if (env.check_circular) {
+    env.markers = &markers;
+  }
+  Object obj(&scope, args.get(static_cast<word>(DumpsArg::kObj)));
+  Object result(&scope, encodeValue(thread, &env, obj, 0));
+  if (result.isErrorException()) return *result;
+  return runtime->newStrWithAll(View<byte>(env.out.data(), env.out.length()));
+}
+
 }  // namespace py
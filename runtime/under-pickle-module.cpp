@@ -0,0 +1,1669 @@
+// Copyright (c) Facebook, Inc. and its affiliates. (http://www.facebook.com)
+#include <cstdarg>
+#include <cstring>
+
+#include "builtins-module.h"
+#include "builtins.h"
+#include "bytes-builtins.h"
+#include "dict-builtins.h"
+#include "handles.h"
+#include "interpreter.h"
+#include "list-builtins.h"
+#include "modules.h"
+#include "objects.h"
+#include "runtime.h"
+#include "set-builtins.h"
+#include "str-builtins.h"
+#include "thread.h"
+#include "utils.h"
+#include "vector.h"
+
+namespace py {
+
+// Opcodes of the pickle protocol; see `Lib/pickletools.py` for documentation.
+enum PickleOpcode : byte {
+  kMark = '(',
+  kStop = '.',
+  kPop = '0',
+  kPopMark = '1',
+  kDup = '2',
+  kBinBytes = 'B',
+  kShortBinBytes = 'C',
+  kBinFloat = 'G',
+  kBinInt = 'J',
+  kBinInt1 = 'K',
+  kBinInt2 = 'M',
+  kBinString = 'T',
+  kShortBinString = 'U',
+  kNoneObject = 'N',
+  kPersId = 'P',
+  kBinPersId = 'Q',
+  kReduce = 'R',
+  kBinUnicode = 'X',
+  kEmptyList = ']',
+  kAppend = 'a',
+  kBuild = 'b',
+  kGlobal = 'c',
+  kDict = 'd',
+  kAppends = 'e',
+  kBinGet = 'h',
+  kLongBinGet = 'j',
+  kList = 'l',
+  kBinPut = 'q',
+  kLongBinPut = 'r',
+  kSetItem = 's',
+  kTuple = 't',
+  kSetItems = 'u',
+  kEmptyDict = '}',
+  kEmptyTuple = ')',
+  kProto = 0x80,
+  kNewObj = 0x81,
+  kExt1 = 0x82,
+  kExt2 = 0x83,
+  kExt4 = 0x84,
+  kTuple1 = 0x85,
+  kTuple2 = 0x86,
+  kTuple3 = 0x87,
+  kNewTrue = 0x88,
+  kNewFalse = 0x89,
+  kLong1 = 0x8a,
+  kLong4 = 0x8b,
+  kShortBinUnicode = 0x8c,
+  kBinUnicode8 = 0x8d,
+  kBinBytes8 = 0x8e,
+  kEmptySet = 0x8f,
+  kAddItems = 0x90,
+  kFrozenSet = 0x91,
+  kNewObjEx = 0x92,
+  kStackGlobal = 0x93,
+  kMemoize = 0x94,
+  kFrame = 0x95,
+  kByteArray8 = 0x96,
+  kNextBuffer = 0x97,
+  kReadOnlyBuffer = 0x98,
+};
+
+static const word kPickleHighestProtocol = 5;
+static const word kPickleFrameSizeTarget = 64 * kKiB;
+static const word kPickleFrameSizeMin = 4;
+static const word kPickleBatchSize = 1000;
+
+static NEVER_INLINE RawObject raisePickleError(Thread* thread,
+                                               SymbolId exception,
+                                               const char* fmt, ...) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object type(&scope, runtime->lookupNameInModule(thread, ID(_pickle),
+                                                  exception));
+  CHECK(type.isType(), "_pickle exception type not found");
+  va_list args;
+  va_start(args, fmt);
+  Object message(&scope, runtime->newStrFromFmtV(thread, fmt, args));
+  va_end(args);
+  return thread->raiseWithType(*type, *message);
+}
+
+// Pickler
+
+enum class DumpsArg {
+  kObj = 0,
+  kProtocol = 1,
+  kMemo = 2,
+  kPersistentId = 3,
+  kReducerOverride = 4,
+  kDispatchTable = 5,
+  kBufferCallback = 6,
+  kFixImports = 7,
+};
+
+struct PickleWriter {
+  Arguments args;
+  word protocol;
+  word depth;
+  word memo_size;
+  // Bytes of all completed frames.
+  Vector<byte> output;
+  // Bytes of the frame under construction for protocol 4 and up; all bytes
+  // for older protocols.
+  Vector<byte> frame;
+
+  RawObject arg(DumpsArg index) const {
+    return args.get(static_cast<word>(index));
+  }
+};
+
+static void writeByte(PickleWriter* writer, byte value) {
+  writer->frame.push_back(value);
+}
+
+static void writeUInt(PickleWriter* writer, uint64_t value, word num_bytes) {
+  for (word i = 0; i < num_bytes; i++) {
+    writer->frame.push_back(static_cast<byte>(value >> (i * kBitsPerByte)));
+  }
+}
+
+static void writeOpcodeWithLength(PickleWriter* writer, byte op,
+                                  uint64_t length, word num_bytes) {
+  writeByte(writer, op);
+  writeUInt(writer, length, num_bytes);
+}
+
+static void writeDataArray(PickleWriter* writer, RawObject data, word length) {
+  Vector<byte>* frame = &writer->frame;
+  frame->reserve(frame->size() + length);
+  if (data.isSmallStr()) {
+    RawSmallStr str = SmallStr::cast(data);
+    for (word i = 0; i < length; i++) frame->push_back(str.byteAt(i));
+  } else if (data.isSmallBytes()) {
+    RawSmallBytes bytes = SmallBytes::cast(data);
+    for (word i = 0; i < length; i++) frame->push_back(bytes.byteAt(i));
+  } else {
+    RawDataArray array = DataArray::cast(data);
+    for (word i = 0; i < length; i++) frame->push_back(array.byteAt(i));
+  }
+}
+
+// Moves the current frame into the output, prefixed with a FRAME opcode if it
+// is big enough to be worth it. Only used for protocol 4 and up.
+static void commitFrame(PickleWriter* writer, bool force) {
+  word size = writer->frame.size();
+  if (size == 0 || (!force && size < kPickleFrameSizeTarget)) return;
+  Vector<byte>* output = &writer->output;
+  output->reserve(output->size() + size + 9);
+  if (size >= kPickleFrameSizeMin) {
+    output->push_back(kFrame);
+    for (word i = 0; i < 8; i++) {
+      output->push_back(static_cast<byte>(static_cast<uint64_t>(size) >>
+                                          (i * kBitsPerByte)));
+    }
+  }
+  for (byte b : writer->frame) output->push_back(b);
+  writer->frame.clear();
+}
+
+static RawObject save(Thread* thread, PickleWriter* writer, const Object& obj,
+                      bool save_persistent_id);
+
+// The memo maps the hash of each memoized object to a list of alternating
+// objects and memo indices. Objects are compared by identity, like the
+// `id()`-keyed memo of the pure Python pickler.
+static RawObject memoGet(Thread* thread, PickleWriter* writer,
+                         const Object& obj) {
+  HandleScope scope(thread);
+  Dict memo(&scope, writer->arg(DumpsArg::kMemo));
+  Object key(&scope,
+             SmallInt::fromWordTruncated(thread->runtime()->hash(*obj)));
+  RawObject bucket =
+      dictAt(thread, memo, key, SmallInt::cast(*key).hash());
+  if (bucket.isErrorNotFound()) return bucket;
+  RawList entries = List::cast(bucket);
+  for (word i = 0; i < entries.numItems(); i += 2) {
+    if (entries.at(i) == *obj) return entries.at(i + 1);
+  }
+  return Error::notFound();
+}
+
+static void writeGet(PickleWriter* writer, word index) {
+  if (index < 256) {
+    writeByte(writer, kBinGet);
+    writeByte(writer, static_cast<byte>(index));
+  } else {
+    writeOpcodeWithLength(writer, kLongBinGet, index, 4);
+  }
+}
+
+static void memoize(Thread* thread, PickleWriter* writer, const Object& obj) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  word index = writer->memo_size++;
+  if (writer->protocol >= 4) {
+    writeByte(writer, kMemoize);
+  } else if (index < 256) {
+    writeByte(writer, kBinPut);
+    writeByte(writer, static_cast<byte>(index));
+  } else {
+    writeOpcodeWithLength(writer, kLongBinPut, index, 4);
+  }
+  Dict memo(&scope, writer->arg(DumpsArg::kMemo));
+  Object key(&scope, SmallInt::fromWordTruncated(runtime->hash(*obj)));
+  word key_hash = SmallInt::cast(*key).hash();
+  Object bucket(&scope, dictAt(thread, memo, key, key_hash));
+  if (bucket.isErrorNotFound()) {
+    bucket = runtime->newList();
+    dictAtPut(thread, memo, key, key_hash, bucket);
+  }
+  List entries(&scope, *bucket);
+  runtime->listAdd(thread, entries, obj);
+  Object index_obj(&scope, SmallInt::fromWord(index));
+  runtime->listAdd(thread, entries, index_obj);
+}
+
+// Returns the number of objects in a memo that was filled by earlier calls
+// of `dump()` on the same pickler.
+static word memoSize(Thread* thread, const Dict& memo) {
+  HandleScope scope(thread);
+  Object key(&scope, NoneType::object());
+  Object entries(&scope, NoneType::object());
+  word result = 0;
+  for (word i = 0; dictNextItem(memo, &i, &key, &entries);) {
+    result += List::cast(*entries).numItems() / 2;
+  }
+  return result;
+}
+
+static void saveInt(PickleWriter* writer, RawInt value) {
+  if (value.isSmallInt()) {
+    word num = SmallInt::cast(value).value();
+    if (0 <= num && num < 256) {
+      writeByte(writer, kBinInt1);
+      writeByte(writer, static_cast<byte>(num));
+      return;
+    }
+    if (0 <= num && num < 65536) {
+      writeOpcodeWithLength(writer, kBinInt2, num, 2);
+      return;
+    }
+    if (-(word{1} << 31) <= num && num < (word{1} << 31)) {
+      writeOpcodeWithLength(writer, kBinInt, static_cast<uint32_t>(num), 4);
+      return;
+    }
+  }
+  // Encode as little-endian two's complement with the minimal number of
+  // bytes, the same as `pickle.encode_long()`.
+  word num_bytes = (value.bitLength() >> 3) + 1;
+  Vector<byte> digits;
+  digits.reserve(num_bytes);
+  for (word i = 0; i < num_bytes; i++) digits.push_back(0);
+  word copied = value.copyTo(digits.begin(), num_bytes);
+  byte sign_extension = value.isNegative() ? kMaxByte : 0;
+  for (word i = copied; i < num_bytes; i++) digits[i] = sign_extension;
+  if (value.isNegative() && num_bytes > 1 && digits[num_bytes - 1] == kMaxByte &&
+      (digits[num_bytes - 2] & 0x80) != 0) {
+    num_bytes--;
+  }
+  if (num_bytes < 256) {
+    writeByte(writer, kLong1);
+    writeByte(writer, static_cast<byte>(num_bytes));
+  } else {
+    writeOpcodeWithLength(writer, kLong4, num_bytes, 4);
+  }
+  for (word i = 0; i < num_bytes; i++) writeByte(writer, digits[i]);
+}
+
+static void saveFloat(PickleWriter* writer, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeByte(writer, kBinFloat);
+  for (word i = 7; i >= 0; i--) {
+    writeByte(writer, static_cast<byte>(bits >> (i * kBitsPerByte)));
+  }
+}
+
+static void saveStr(Thread* thread, PickleWriter* writer, const Str& str) {
+  // Strings are stored as UTF-8 with surrogates encoded like
+  // "surrogatepass", which is exactly what BINUNICODE expects.
+  word length = str.length();
+  if (length < 256 && writer->protocol >= 4) {
+    writeByte(writer, kShortBinUnicode);
+    writeByte(writer, static_cast<byte>(length));
+  } else if (length > kMaxUint32 && writer->protocol >= 4) {
+    writeOpcodeWithLength(writer, kBinUnicode8, length, 8);
+  } else {
+    writeOpcodeWithLength(writer, kBinUnicode, length, 4);
+  }
+  writeDataArray(writer, *str, length);
+  memoize(thread, writer, str);
+}
+
+static void saveBytesData(PickleWriter* writer, RawObject data, word length) {
+  if (length < 256) {
+    writeByte(writer, kShortBinBytes);
+    writeByte(writer, static_cast<byte>(length));
+  } else if (length > kMaxUint32 && writer->protocol >= 4) {
+    writeOpcodeWithLength(writer, kBinBytes8, length, 8);
+  } else {
+    writeOpcodeWithLength(writer, kBinBytes, length, 4);
+  }
+  writeDataArray(writer, data, length);
+}
+
+static RawObject saveReduce(Thread* thread, PickleWriter* writer,
+                            const Object& reduce_value, const Object& obj);
+
+static RawObject callPickleHelper(Thread* thread, SymbolId helper,
+                                  const Object& arg) {
+  return thread->invokeFunction1(ID(_pickle), helper, arg);
+}
+
+static RawObject saveTuple(Thread* thread, PickleWriter* writer,
+                           const Tuple& tuple) {
+  word length = tuple.length();
+  if (length == 0) {
+    writeByte(writer, kEmptyTuple);
+    return NoneType::object();
+  }
+  HandleScope scope(thread);
+  Object item(&scope, NoneType::object());
+  Object tuple_obj(&scope, *tuple);
+  bool small = length <= 3;
+  if (!small) writeByte(writer, kMark);
+  for (word i = 0; i < length; i++) {
+    item = tuple.at(i);
+    Object result(&scope, save(thread, writer, item, true));
+    if (result.isErrorException()) return *result;
+  }
+  // A recursive tuple was memoized while saving its items; discard the items
+  // and fetch it from the memo instead.
+  Object memo_index(&scope, memoGet(thread, writer, tuple_obj));
+  if (!memo_index.isErrorNotFound()) {
+    if (small) {
+      for (word i = 0; i < length; i++) writeByte(writer, kPop);
+    } else {
+      writeByte(writer, kPopMark);
+    }
+    writeGet(writer, SmallInt::cast(*memo_index).value());
+    return NoneType::object();
+  }
+  if (small) {
+    writeByte(writer, static_cast<byte>(kTuple1 + length - 1));
+  } else {
+    writeByte(writer, kTuple);
+  }
+  memoize(thread, writer, tuple_obj);
+  return NoneType::object();
+}
+
+static RawObject saveListItems(Thread* thread, PickleWriter* writer,
+                               const List& list) {
+  HandleScope scope(thread);
+  Object item(&scope, NoneType::object());
+  for (word start = 0; start < list.numItems(); start += kPickleBatchSize) {
+    word end = Utils::minimum(start + kPickleBatchSize, list.numItems());
+    bool single = end - start == 1;
+    if (!single) writeByte(writer, kMark);
+    for (word i = start; i < end && i < list.numItems(); i++) {
+      item = list.at(i);
+      Object result(&scope, save(thread, writer, item, true));
+      if (result.isErrorException()) return *result;
+    }
+    writeByte(writer, single ? kAppend : kAppends);
+  }
+  return NoneType::object();
+}
+
+static RawObject saveDictItems(Thread* thread, PickleWriter* writer,
+                               const Dict& dict) {
+  HandleScope scope(thread);
+  Object key(&scope, NoneType::object());
+  Object value(&scope, NoneType::object());
+  word num_items = dict.numItems();
+  word remaining = num_items;
+  word i = 0;
+  while (remaining > 0) {
+    word batch = Utils::minimum(remaining, kPickleBatchSize);
+    if (batch > 1) writeByte(writer, kMark);
+    for (word j = 0; j < batch; j++) {
+      bool has_item = dictNextItem(dict, &i, &key, &value);
+      if (!has_item || dict.numItems() != num_items) {
+        return thread->raiseWithFmt(LayoutId::kRuntimeError,
+                                    "dictionary changed size during iteration");
+      }
+      Object result(&scope, save(thread, writer, key, true));
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, value, true);
+      if (result.isErrorException()) return *result;
+    }
+    writeByte(writer, batch > 1 ? kSetItems : kSetItem);
+    remaining -= batch;
+  }
+  return NoneType::object();
+}
+
+static RawObject saveSetItems(Thread* thread, PickleWriter* writer,
+                              const SetBase& set, bool is_frozen) {
+  HandleScope scope(thread);
+  Object item(&scope, NoneType::object());
+  word num_items = set.numItems();
+  word i = 0;
+  RawObject raw_item = NoneType::object();
+  if (is_frozen) {
+    writeByte(writer, kMark);
+    while (setNextItem(set, &i, &raw_item)) {
+      item = raw_item;
+      Object result(&scope, save(thread, writer, item, true));
+      if (result.isErrorException()) return *result;
+    }
+    return NoneType::object();
+  }
+  word remaining = num_items;
+  while (remaining > 0) {
+    word batch = Utils::minimum(remaining, kPickleBatchSize);
+    writeByte(writer, kMark);
+    for (word j = 0; j < batch; j++) {
+      bool has_item = setNextItem(set, &i, &raw_item);
+      if (!has_item || set.numItems() != num_items) {
+        return thread->raiseWithFmt(LayoutId::kRuntimeError,
+                                    "set changed size during iteration");
+      }
+      item = raw_item;
+      Object result(&scope, save(thread, writer, item, true));
+      if (result.isErrorException()) return *result;
+    }
+    writeByte(writer, kAddItems);
+    remaining -= batch;
+  }
+  return NoneType::object();
+}
+
+static void writeGlobalLine(PickleWriter* writer, RawStr str) {
+  writeDataArray(writer, str, str.length());
+  writeByte(writer, '\n');
+}
+
+// Kinds of results of `_pickle._global_info()`.
+enum class GlobalKind {
+  // `(kind, code)`: registered with `copyreg.add_extension()`.
+  kExtension = 0,
+  // `(kind, module_name, qualname)`: saved with GLOBAL or STACK_GLOBAL.
+  kName = 1,
+  // `(kind, reduce_value)`: nested name that older protocols can only express
+  // as `getattr(parent, name)`.
+  kGetattr = 2,
+  // `(kind, reduce_value)`: types of singletons such as `type(None)`.
+  kReduce = 3,
+};
+
+// Saves `obj` by reference to its module and qualified name. `name` is the
+// name returned by `__reduce__` or `None`.
+static RawObject saveGlobal(Thread* thread, PickleWriter* writer,
+                            const Object& obj, const Object& name) {
+  HandleScope scope(thread);
+  Object proto(&scope, SmallInt::fromWord(writer->protocol));
+  Object fix_imports(&scope, writer->arg(DumpsArg::kFixImports));
+  Object info_obj(&scope,
+                  thread->invokeFunction4(ID(_pickle), ID(_global_info), obj,
+                                          name, proto, fix_imports));
+  if (info_obj.isErrorException()) return *info_obj;
+  Tuple info(&scope, *info_obj);
+  auto kind = static_cast<GlobalKind>(SmallInt::cast(info.at(0)).value());
+  if (kind == GlobalKind::kExtension) {
+    word code = SmallInt::cast(info.at(1)).value();
+    if (code <= 0xff) {
+      writeByte(writer, kExt1);
+      writeByte(writer, static_cast<byte>(code));
+    } else if (code <= 0xffff) {
+      writeOpcodeWithLength(writer, kExt2, code, 2);
+    } else {
+      writeOpcodeWithLength(writer, kExt4, code, 4);
+    }
+    return NoneType::object();
+  }
+  if (kind == GlobalKind::kReduce) {
+    Object reduce_value(&scope, info.at(1));
+    return saveReduce(thread, writer, reduce_value, obj);
+  }
+  if (kind == GlobalKind::kGetattr) {
+    Object reduce_value(&scope, info.at(1));
+    Object none(&scope, NoneType::object());
+    Object result(&scope, saveReduce(thread, writer, reduce_value, none));
+    if (result.isErrorException()) return *result;
+  } else if (writer->protocol >= 4) {
+    Object module_name(&scope, info.at(1));
+    Object qualname(&scope, info.at(2));
+    Object result(&scope, save(thread, writer, module_name, true));
+    if (result.isErrorException()) return *result;
+    result = save(thread, writer, qualname, true);
+    if (result.isErrorException()) return *result;
+    writeByte(writer, kStackGlobal);
+  } else {
+    writeByte(writer, kGlobal);
+    writeGlobalLine(writer, Str::cast(info.at(1)));
+    writeGlobalLine(writer, Str::cast(info.at(2)));
+  }
+  memoize(thread, writer, obj);
+  return NoneType::object();
+}
+
+static bool isFunctionNamed(Thread* thread, const Object& func,
+                            const char* name) {
+  HandleScope scope(thread);
+  Object func_name(&scope, thread->runtime()->attributeAtById(
+                               thread, func, ID(__name__)));
+  if (func_name.isErrorException()) {
+    thread->clearPendingException();
+    return false;
+  }
+  return thread->runtime()->isInstanceOfStr(*func_name) &&
+         strUnderlying(*func_name).equalsCStr(name);
+}
+
+static RawObject saveReduce(Thread* thread, PickleWriter* writer,
+                            const Object& reduce_value, const Object& obj) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  if (!reduce_value.isTuple()) {
+    return raisePickleError(thread, ID(PicklingError),
+                            "__reduce__ must return a string or tuple");
+  }
+  Tuple reduce_tuple(&scope, *reduce_value);
+  word length = reduce_tuple.length();
+  if (length < 2 || length > 6) {
+    return raisePickleError(
+        thread, ID(PicklingError),
+        "tuple returned by __reduce__ must contain 2 through 6 elements");
+  }
+  Object func(&scope, reduce_tuple.at(0));
+  Object args_obj(&scope, reduce_tuple.at(1));
+  Object state(&scope, length > 2 ? reduce_tuple.at(2) : NoneType::object());
+  Object list_items(&scope,
+                    length > 3 ? reduce_tuple.at(3) : NoneType::object());
+  Object dict_items(&scope,
+                    length > 4 ? reduce_tuple.at(4) : NoneType::object());
+  Object state_setter(&scope,
+                      length > 5 ? reduce_tuple.at(5) : NoneType::object());
+  if (!runtime->isCallable(thread, func)) {
+    return raisePickleError(thread, ID(PicklingError),
+                            "first item of the tuple returned by __reduce__ "
+                            "must be callable");
+  }
+  if (!args_obj.isTuple()) {
+    return raisePickleError(thread, ID(PicklingError),
+                            "second item of the tuple returned by __reduce__ "
+                            "must be a tuple");
+  }
+  Tuple args(&scope, *args_obj);
+  Object result(&scope, NoneType::object());
+  if (isFunctionNamed(thread, func, "__newobj_ex__")) {
+    if (args.length() != 3) {
+      return raisePickleError(thread, ID(PicklingError),
+                              "length of the NEWOBJ_EX argument tuple must "
+                              "be exactly 3, not %w",
+                              args.length());
+    }
+    Object cls(&scope, args.at(0));
+    Object cls_args(&scope, args.at(1));
+    Object cls_kwargs(&scope, args.at(2));
+    if (writer->protocol >= 4) {
+      result = save(thread, writer, cls, true);
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, cls_args, true);
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, cls_kwargs, true);
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kNewObjEx);
+    } else {
+      Object partial(&scope, callPickleHelper(thread, ID(_newobj_ex_partial),
+                                              args_obj));
+      if (partial.isErrorException()) return *partial;
+      result = save(thread, writer, partial, true);
+      if (result.isErrorException()) return *result;
+      Object empty(&scope, runtime->emptyTuple());
+      result = save(thread, writer, empty, true);
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kReduce);
+    }
+  } else if (isFunctionNamed(thread, func, "__newobj__")) {
+    if (args.length() == 0) {
+      return raisePickleError(thread, ID(PicklingError),
+                              "__newobj__ arglist is empty");
+    }
+    Object cls(&scope, args.at(0));
+    if (!runtime->isInstanceOfType(*cls)) {
+      return raisePickleError(thread, ID(PicklingError),
+                              "args[0] from __newobj__ args is not a type");
+    }
+    if (!obj.isNoneType() && runtime->typeOf(*obj) != *cls) {
+      return raisePickleError(
+          thread, ID(PicklingError),
+          "args[0] from __newobj__ args has the wrong class");
+    }
+    result = save(thread, writer, cls, true);
+    if (result.isErrorException()) return *result;
+    Object cls_args_obj(
+        &scope, runtime->tupleSubseq(thread, args, 1, args.length() - 1));
+    result = save(thread, writer, cls_args_obj, true);
+    if (result.isErrorException()) return *result;
+    writeByte(writer, kNewObj);
+  } else {
+    result = save(thread, writer, func, true);
+    if (result.isErrorException()) return *result;
+    result = save(thread, writer, args, true);
+    if (result.isErrorException()) return *result;
+    writeByte(writer, kReduce);
+  }
+
+  if (!obj.isNoneType()) {
+    // A reference cycle may have memoized `obj` while saving its arguments.
+    Object memo_index(&scope, memoGet(thread, writer, obj));
+    if (!memo_index.isErrorNotFound()) {
+      writeByte(writer, kPop);
+      writeGet(writer, SmallInt::cast(*memo_index).value());
+    } else {
+      memoize(thread, writer, obj);
+    }
+  }
+
+  if (!list_items.isNoneType()) {
+    Object items(&scope, thread->invokeFunction1(ID(builtins), ID(list),
+                                                 list_items));
+    if (items.isErrorException()) return *items;
+    List list(&scope, *items);
+    result = saveListItems(thread, writer, list);
+    if (result.isErrorException()) return *result;
+  }
+  if (!dict_items.isNoneType()) {
+    Object items_obj(&scope, callPickleHelper(thread, ID(_dict_items_list),
+                                              dict_items));
+    if (items_obj.isErrorException()) return *items_obj;
+    List items(&scope, *items_obj);
+    Object key(&scope, NoneType::object());
+    Object value(&scope, NoneType::object());
+    for (word i = 0; i < items.numItems(); i++) {
+      Tuple pair(&scope, items.at(i));
+      key = pair.at(0);
+      value = pair.at(1);
+      result = save(thread, writer, key, true);
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, value, true);
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kSetItem);
+    }
+  }
+  if (!state.isNoneType()) {
+    if (state_setter.isNoneType()) {
+      result = save(thread, writer, state, true);
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kBuild);
+    } else {
+      // Call `state_setter(obj, state)` and discard the result.
+      result = save(thread, writer, state_setter, true);
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, obj, true);
+      if (result.isErrorException()) return *result;
+      result = save(thread, writer, state, true);
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kTuple2);
+      writeByte(writer, kReduce);
+      writeByte(writer, kPop);
+    }
+  }
+  return NoneType::object();
+}
+
+static RawObject savePickleBuffer(Thread* thread, PickleWriter* writer,
+                                  const Object& obj) {
+  HandleScope scope(thread);
+  if (writer->protocol < 5) {
+    return raisePickleError(thread, ID(PicklingError),
+                            "PickleBuffer can only pickled with protocol >= 5");
+  }
+  Object info_obj(&scope,
+                  callPickleHelper(thread, ID(_picklebuffer_info), obj));
+  if (info_obj.isErrorException()) return *info_obj;
+  Tuple info(&scope, *info_obj);
+  Bytes data(&scope, info.at(0));
+  bool readonly = info.at(1) == Bool::trueObj();
+  bool in_band = true;
+  Object buffer_callback(&scope, writer->arg(DumpsArg::kBufferCallback));
+  if (!buffer_callback.isNoneType()) {
+    Object in_band_obj(&scope,
+                       Interpreter::call1(thread, buffer_callback, obj));
+    if (in_band_obj.isErrorException()) return *in_band_obj;
+    Object truthy(&scope, Interpreter::isTrue(thread, *in_band_obj));
+    if (truthy.isErrorException()) return *truthy;
+    in_band = truthy == Bool::trueObj();
+  }
+  if (in_band) {
+    word length = data.length();
+    if (readonly) {
+      saveBytesData(writer, *data, length);
+    } else {
+      writeOpcodeWithLength(writer, kByteArray8, length, 8);
+      writeDataArray(writer, *data, length);
+    }
+    return NoneType::object();
+  }
+  writeByte(writer, kNextBuffer);
+  if (readonly) writeByte(writer, kReadOnlyBuffer);
+  return NoneType::object();
+}
+
+static RawObject saveObject(Thread* thread, PickleWriter* writer,
+                            const Object& obj) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object result(&scope, NoneType::object());
+  if (obj.isStr()) {
+    Str str(&scope, *obj);
+    saveStr(thread, writer, str);
+    return NoneType::object();
+  }
+  if (obj.isBytes() && writer->protocol >= 3) {
+    Bytes bytes(&scope, *obj);
+    saveBytesData(writer, *bytes, bytes.length());
+    memoize(thread, writer, obj);
+    return NoneType::object();
+  }
+  if (obj.isBytearray() && writer->protocol >= 5) {
+    Bytearray array(&scope, *obj);
+    word length = array.numItems();
+    writeOpcodeWithLength(writer, kByteArray8, length, 8);
+    writeDataArray(writer, array.items(), length);
+    memoize(thread, writer, obj);
+    return NoneType::object();
+  }
+  if (obj.isTuple()) {
+    Tuple tuple(&scope, *obj);
+    return saveTuple(thread, writer, tuple);
+  }
+  if (obj.isList()) {
+    List list(&scope, *obj);
+    writeByte(writer, kEmptyList);
+    memoize(thread, writer, obj);
+    return saveListItems(thread, writer, list);
+  }
+  if (obj.isDict()) {
+    Dict dict(&scope, *obj);
+    writeByte(writer, kEmptyDict);
+    memoize(thread, writer, obj);
+    return saveDictItems(thread, writer, dict);
+  }
+  if (obj.isSet() && writer->protocol >= 4) {
+    Set set(&scope, *obj);
+    writeByte(writer, kEmptySet);
+    memoize(thread, writer, obj);
+    return saveSetItems(thread, writer, set, /*is_frozen=*/false);
+  }
+  if (obj.isFrozenSet() && writer->protocol >= 4) {
+    FrozenSet set(&scope, *obj);
+    result = saveSetItems(thread, writer, set, /*is_frozen=*/true);
+    if (result.isErrorException()) return *result;
+    Object memo_index(&scope, memoGet(thread, writer, obj));
+    if (!memo_index.isErrorNotFound()) {
+      writeByte(writer, kPopMark);
+      writeGet(writer, SmallInt::cast(*memo_index).value());
+      return NoneType::object();
+    }
+    writeByte(writer, kFrozenSet);
+    memoize(thread, writer, obj);
+    return NoneType::object();
+  }
+
+  Object reducer_override(&scope, writer->arg(DumpsArg::kReducerOverride));
+  if (!reducer_override.isNoneType()) {
+    Object reduce_value(&scope,
+                        Interpreter::call1(thread, reducer_override, obj));
+    if (reduce_value.isErrorException()) return *reduce_value;
+    if (reduce_value != NotImplementedType::object()) {
+      if (runtime->isInstanceOfStr(*reduce_value)) {
+        return saveGlobal(thread, writer, obj, reduce_value);
+      }
+      return saveReduce(thread, writer, reduce_value, obj);
+    }
+  }
+
+  Object none(&scope, NoneType::object());
+  if (runtime->isInstanceOfType(*obj) || obj.isFunction()) {
+    return saveGlobal(thread, writer, obj, none);
+  }
+  Object type(&scope, runtime->typeOf(*obj));
+  Object picklebuffer_type(&scope, runtime->lookupNameInModule(
+                                       thread, ID(_pickle), ID(PickleBuffer)));
+  if (*type == *picklebuffer_type) {
+    return savePickleBuffer(thread, writer, obj);
+  }
+
+  Object reduce_value(&scope, NoneType::object());
+  Object dispatch_table(&scope, writer->arg(DumpsArg::kDispatchTable));
+  Object reduce_func(&scope, NoneType::object());
+  if (!dispatch_table.isNoneType()) {
+    reduce_func = thread->invokeMethod3(dispatch_table, ID(get), type, none);
+    if (reduce_func.isErrorException()) return *reduce_func;
+    if (reduce_func.isErrorNotFound()) reduce_func = NoneType::object();
+  }
+  if (!reduce_func.isNoneType()) {
+    reduce_value = Interpreter::call1(thread, reduce_func, obj);
+  } else if (obj.isBytes() || obj.isBytearray()) {
+    reduce_value = callPickleHelper(thread, ID(_reduce_bytes), obj);
+  } else if (obj.isSet() || obj.isFrozenSet()) {
+    reduce_value = callPickleHelper(thread, ID(_reduce_set), obj);
+  } else {
+    Object proto(&scope, SmallInt::fromWord(writer->protocol));
+    reduce_value = thread->invokeMethod2(obj, ID(__reduce_ex__), proto);
+    if (reduce_value.isErrorNotFound()) {
+      reduce_value = thread->invokeMethod1(obj, ID(__reduce__));
+      if (reduce_value.isErrorNotFound()) {
+        return raisePickleError(thread, ID(PicklingError),
+                                "Can't pickle %T object", &obj);
+      }
+    }
+  }
+  if (reduce_value.isErrorException()) return *reduce_value;
+  if (runtime->isInstanceOfStr(*reduce_value)) {
+    return saveGlobal(thread, writer, obj, reduce_value);
+  }
+  if (!reduce_value.isTuple()) {
+    return raisePickleError(thread, ID(PicklingError),
+                            "%T.__reduce__ must return a string or tuple",
+                            &obj);
+  }
+  return saveReduce(thread, writer, reduce_value, obj);
+}
+
+static RawObject save(Thread* thread, PickleWriter* writer, const Object& obj,
+                      bool save_persistent_id) {
+  HandleScope scope(thread);
+  Object persistent_id(&scope, writer->arg(DumpsArg::kPersistentId));
+  if (save_persistent_id && !persistent_id.isNoneType()) {
+    Object pid(&scope, Interpreter::call1(thread, persistent_id, obj));
+    if (pid.isErrorException()) return *pid;
+    if (!pid.isNoneType()) {
+      Object result(&scope, save(thread, writer, pid, false));
+      if (result.isErrorException()) return *result;
+      writeByte(writer, kBinPersId);
+      return NoneType::object();
+    }
+  }
+
+  if (obj.isNoneType()) {
+    writeByte(writer, kNoneObject);
+    return NoneType::object();
+  }
+  if (obj.isBool()) {
+    writeByte(writer, obj == Bool::trueObj() ? kNewTrue : kNewFalse);
+    return NoneType::object();
+  }
+  if (obj.isInt()) {
+    saveInt(writer, Int::cast(*obj));
+    return NoneType::object();
+  }
+  if (obj.isFloat()) {
+    saveFloat(writer, Float::cast(*obj).value());
+    return NoneType::object();
+  }
+
+  Object memo_index(&scope, memoGet(thread, writer, obj));
+  if (!memo_index.isErrorNotFound()) {
+    writeGet(writer, SmallInt::cast(*memo_index).value());
+    return NoneType::object();
+  }
+
+  if (++writer->depth > thread->recursionLimit()) {
+    writer->depth--;
+    return thread->raiseWithFmt(LayoutId::kRecursionError,
+                                "maximum recursion depth exceeded while "
+                                "pickling an object");
+  }
+  Object result(&scope, saveObject(thread, writer, obj));
+  writer->depth--;
+  if (result.isErrorException()) return *result;
+  if (writer->protocol >= 4) commitFrame(writer, /*force=*/false);
+  return NoneType::object();
+}
+
+RawObject FUNC(_pickle, _dumps)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  PickleWriter writer;
+  writer.args = args;
+  writer.protocol =
+      SmallInt::cast(args.get(static_cast<word>(DumpsArg::kProtocol))).value();
+  writer.depth = 0;
+  Dict memo(&scope, args.get(static_cast<word>(DumpsArg::kMemo)));
+  writer.memo_size = memoSize(thread, memo);
+  DCHECK(2 <= writer.protocol && writer.protocol <= kPickleHighestProtocol,
+         "unexpected protocol");
+  writeByte(&writer, kProto);
+  writeByte(&writer, static_cast<byte>(writer.protocol));
+  if (writer.protocol >= 4) commitFrame(&writer, /*force=*/true);
+  Object obj(&scope, args.get(static_cast<word>(DumpsArg::kObj)));
+  Object result(&scope, save(thread, &writer, obj, true));
+  if (result.isErrorException()) return *result;
+  writeByte(&writer, kStop);
+  if (writer.protocol >= 4) {
+    commitFrame(&writer, /*force=*/true);
+    return thread->runtime()->newBytesWithAll(
+        View<byte>(writer.output.begin(), writer.output.size()));
+  }
+  return thread->runtime()->newBytesWithAll(
+      View<byte>(writer.frame.begin(), writer.frame.size()));
+}
+
+// Unpickler
+
+struct PickleReader {
+  Thread* thread;
+  word protocol;
+  // In-memory input: either the whole pickle passed to `loads()` or the
+  // current frame read from a file.
+  word next;
+  word length;
+  bool in_frame;
+  bool from_file;
+};
+
+enum class LoadsArg {
+  kUnpickler = 0,
+  kData = 1,
+  kRead = 2,
+  kReadline = 3,
+};
+
+static RawObject raiseTruncated(Thread* thread) {
+  return raisePickleError(thread, ID(UnpicklingError),
+                          "pickle data was truncated");
+}
+
+// Makes `count` bytes available at `data[reader->next]`. Returns `None` on
+// success.
+static RawObject ensureAvailable(PickleReader* reader, Arguments args,
+                                 Object* data, word count) {
+  if (reader->next + count <= reader->length) return NoneType::object();
+  Thread* thread = reader->thread;
+  if (!reader->from_file || reader->in_frame) {
+    if (reader->in_frame && reader->next == reader->length) {
+      reader->in_frame = false;
+    } else {
+      return raiseTruncated(thread);
+    }
+  }
+  if (reader->next < reader->length) return raiseTruncated(thread);
+  HandleScope scope(thread);
+  Object read(&scope, args.get(static_cast<word>(LoadsArg::kRead)));
+  Object count_obj(&scope, SmallInt::fromWord(count));
+  Object chunk(&scope, Interpreter::call1(thread, read, count_obj));
+  if (chunk.isErrorException()) return *chunk;
+  if (!thread->runtime()->isInstanceOfBytes(*chunk)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "read() must return bytes, not %T", &chunk);
+  }
+  Bytes bytes(&scope, bytesUnderlying(*chunk));
+  if (bytes.length() < count) {
+    if (bytes.length() == 0 && count == 1) {
+      return thread->raiseWithFmt(LayoutId::kEOFError, "Ran out of input");
+    }
+    return raiseTruncated(thread);
+  }
+  MutableBytes copy(&scope,
+                    thread->runtime()->newMutableBytesUninitialized(count));
+  copy.replaceFromWithBytes(0, *bytes, count);
+  *data = *copy;
+  reader->next = 0;
+  reader->length = count;
+  return NoneType::object();
+}
+
+static RawObject readLine(PickleReader* reader, Arguments args, Object* data) {
+  Thread* thread = reader->thread;
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  if (reader->next < reader->length || !reader->from_file) {
+    MutableBytes bytes(&scope, **data);
+    word end = bytes.findByte('\n', reader->next, reader->length - reader->next);
+    if (end < 0) return raiseTruncated(thread);
+    word start = reader->next;
+    reader->next = end + 1;
+    return dataArraySubstr(thread, bytes, start, end - start);
+  }
+  reader->in_frame = false;
+  Object readline(&scope, args.get(static_cast<word>(LoadsArg::kReadline)));
+  Object line_obj(&scope, Interpreter::call0(thread, readline));
+  if (line_obj.isErrorException()) return *line_obj;
+  if (!runtime->isInstanceOfBytes(*line_obj)) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "readline() must return bytes, not %T",
+                                &line_obj);
+  }
+  Bytes line(&scope, bytesUnderlying(*line_obj));
+  word length = line.length();
+  if (length == 0 || line.byteAt(length - 1) != '\n') {
+    return raiseTruncated(thread);
+  }
+  MutableBytes copy(&scope, runtime->newMutableBytesUninitialized(length - 1));
+  copy.replaceFromWithBytes(0, *line, length - 1);
+  return dataArraySubstr(thread, copy, 0, length - 1);
+}
+
+static uint64_t readUInt(const MutableBytes& data, word index, word num_bytes) {
+  uint64_t result = 0;
+  for (word i = num_bytes - 1; i >= 0; i--) {
+    result = (result << kBitsPerByte) | data.byteAt(index + i);
+  }
+  return result;
+}
+
+static RawObject loadStr(Thread* thread, const MutableBytes& data, word start,
+                         word length) {
+  bool is_ascii = true;
+  for (word i = 0; i < length; i++) {
+    if (data.byteAt(start + i) > kMaxASCII) {
+      is_ascii = false;
+      break;
+    }
+  }
+  if (is_ascii) return dataArraySubstr(thread, data, start, length);
+  HandleScope scope(thread);
+  MutableBytes copy(&scope,
+                    thread->runtime()->newMutableBytesUninitialized(length));
+  copy.replaceFromWithStartAt(0, *data, length, start);
+  Bytes bytes(&scope, copy.becomeImmutable());
+  if (!bytesIsValidStr(*bytes)) {
+    return thread->raiseWithFmt(LayoutId::kUnicodeDecodeError,
+                                "'utf-8' codec can't decode pickled string");
+  }
+  return bytes.becomeStr();
+}
+
+static RawObject loadBytes(Thread* thread, const MutableBytes& data,
+                           word start, word length) {
+  HandleScope scope(thread);
+  MutableBytes copy(&scope,
+                    thread->runtime()->newMutableBytesUninitialized(length));
+  copy.replaceFromWithStartAt(0, *data, length, start);
+  return copy.becomeImmutable();
+}
+
+static RawObject loadLong(Thread* thread, const MutableBytes& data, word start,
+                          word length) {
+  if (length == 0) return SmallInt::fromWord(0);
+  HandleScope scope(thread);
+  Bytes bytes(&scope, loadBytes(thread, data, start, length));
+  return thread->runtime()->bytesToInt(thread, bytes, endian::little,
+                                       /*is_signed=*/true);
+}
+
+static RawObject popMark(Thread* thread, List* stack, const List& metastack) {
+  HandleScope scope(thread);
+  if (metastack.numItems() == 0) {
+    return raisePickleError(thread, ID(UnpicklingError),
+                            "could not find MARK");
+  }
+  Object items(&scope, **stack);
+  *stack = metastack.at(metastack.numItems() - 1);
+  metastack.atPut(metastack.numItems() - 1, NoneType::object());
+  metastack.setNumItems(metastack.numItems() - 1);
+  return *items;
+}
+
+static RawObject listToTuple(Thread* thread, const List& list) {
+  HandleScope scope(thread);
+  word length = list.numItems();
+  if (length == 0) return thread->runtime()->emptyTuple();
+  MutableTuple result(&scope, thread->runtime()->newMutableTuple(length));
+  result.replaceFromWith(0, Tuple::cast(list.items()), length);
+  return result.becomeImmutable();
+}
+
+static RawObject stackPop(Thread* thread, const List& stack) {
+  word length = stack.numItems();
+  if (length == 0) {
+    return raisePickleError(thread, ID(UnpicklingError), "stack underflow");
+  }
+  RawObject result = stack.at(length - 1);
+  stack.atPut(length - 1, NoneType::object());
+  stack.setNumItems(length - 1);
+  return result;
+}
+
+static RawObject stackTop(Thread* thread, const List& stack) {
+  word length = stack.numItems();
+  if (length == 0) {
+    return raisePickleError(thread, ID(UnpicklingError), "stack underflow");
+  }
+  return stack.at(length - 1);
+}
+
+static RawObject memoPut(Thread* thread, const Dict& memo, word index,
+                         const Object& value) {
+  HandleScope scope(thread);
+  Object key(&scope, SmallInt::fromWord(index));
+  dictAtPut(thread, memo, key, SmallInt::cast(*key).hash(), value);
+  return NoneType::object();
+}
+
+static RawObject memoLoad(Thread* thread, const Dict& memo, word index) {
+  HandleScope scope(thread);
+  Object key(&scope, SmallInt::fromWord(index));
+  Object result(&scope,
+                dictAt(thread, memo, key, SmallInt::cast(*key).hash()));
+  if (result.isErrorNotFound()) {
+    return raisePickleError(thread, ID(UnpicklingError), "Memo value not found at index %w", index);
+  }
+  return *result;
+}
+
+static RawObject callWithArgs(Thread* thread, const Object& callable,
+                              const Object& args) {
+  thread->stackPush(*callable);
+  thread->stackPush(*args);
+  return Interpreter::callEx(thread, 0);
+}
+
+static RawObject loadGlobal(Thread* thread, const Object& unpickler,
+                            const Object& module_name, const Object& name) {
+  Runtime* runtime = thread->runtime();
+  if (!runtime->isInstanceOfStr(*module_name) ||
+      !runtime->isInstanceOfStr(*name)) {
+    return raisePickleError(thread, ID(UnpicklingError),
+                            "STACK_GLOBAL requires str");
+  }
+  return thread->invokeMethod3(unpickler, ID(find_class), module_name, name);
+}
+
+// Sets `unpickler.proto` so that `find_class()` can apply the compatibility
+// mappings for older protocols.
+static RawObject setUnpicklerProto(Thread* thread, const Object& unpickler,
+                                   word protocol) {
+  HandleScope scope(thread);
+  Object name(&scope, thread->runtime()->symbols()->at(ID(proto)));
+  Object value(&scope, SmallInt::fromWord(protocol));
+  return setAttribute(thread, unpickler, name, value);
+}
+
+static RawObject load(Thread* thread, Arguments args, PickleReader* reader,
+                      Object* data_obj) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  Object unpickler(&scope, args.get(static_cast<word>(LoadsArg::kUnpickler)));
+  Object memo_obj(&scope, runtime->attributeAtById(thread, unpickler, ID(memo)));
+  if (memo_obj.isErrorException()) return *memo_obj;
+  if (!memo_obj.isDict()) {
+    return thread->raiseWithFmt(LayoutId::kTypeError,
+                                "memo must be a dict, not %T", &memo_obj);
+  }
+  Dict memo(&scope, *memo_obj);
+  List stack(&scope, runtime->newList());
+  List metastack(&scope, runtime->newList());
+  Object value(&scope, NoneType::object());
+  Object tmp(&scope, NoneType::object());
+  Object tmp2(&scope, NoneType::object());
+  Object result(&scope, NoneType::object());
+  MutableBytes data(&scope, **data_obj);
+
+#define READ(count)                                                            \
+  do {                                                                         \
+    result = ensureAvailable(reader, args, data_obj, count);                   \
+    if (result.isErrorException()) return *result;                             \
+    data = **data_obj;                                                         \
+  } while (0)
+#define PUSH(obj)                                                              \
+  do {                                                                         \
+    value = (obj);                                                             \
+    if (value.isErrorException()) return *value;                               \
+    runtime->listAdd(thread, stack, value);                                    \
+  } while (0)
+#define POP_INTO(handle)                                                       \
+  do {                                                                         \
+    handle = stackPop(thread, stack);                                          \
+    if (handle.isErrorException()) return *handle;                             \
+  } while (0)
+#define POP_MARK_INTO(handle)                                                  \
+  do {                                                                         \
+    handle = popMark(thread, &stack, metastack);                               \
+    if (handle.isErrorException()) return *handle;                             \
+  } while (0)
+
+  // The PROTO opcode byte was consumed by the caller.
+  READ(1);
+  reader->protocol = data.byteAt(reader->next++);
+  if (reader->protocol > kPickleHighestProtocol) {
+    return thread->raiseWithFmt(LayoutId::kValueError,
+                                "unsupported pickle protocol: %w",
+                                reader->protocol);
+  }
+  result = setUnpicklerProto(thread, unpickler, reader->protocol);
+  if (result.isErrorException()) return *result;
+
+  for (;;) {
+    READ(1);
+    byte op = data.byteAt(reader->next++);
+    switch (op) {
+      case kProto: {
+        READ(1);
+        reader->protocol = data.byteAt(reader->next++);
+        if (reader->protocol > kPickleHighestProtocol) {
+          return thread->raiseWithFmt(LayoutId::kValueError,
+                                      "unsupported pickle protocol: %w",
+                                      reader->protocol);
+        }
+        result = setUnpicklerProto(thread, unpickler, reader->protocol);
+        if (result.isErrorException()) return *result;
+        break;
+      }
+      case kFrame: {
+        READ(8);
+        uint64_t frame_size = readUInt(data, reader->next, 8);
+        reader->next += 8;
+        if (frame_size > static_cast<uint64_t>(kMaxWord)) {
+          return thread->raiseWithFmt(LayoutId::kOverflowError,
+                                      "FRAME length exceeds system's maximum");
+        }
+        if (reader->from_file) {
+          if (reader->next != reader->length) {
+            return raisePickleError(thread, ID(UnpicklingError),
+                                    "beginning of a new frame before end of "
+                                    "current frame");
+          }
+          reader->in_frame = false;
+          READ(static_cast<word>(frame_size));
+          reader->in_frame = true;
+        } else if (reader->next + static_cast<word>(frame_size) >
+                   reader->length) {
+          return raiseTruncated(thread);
+        }
+        break;
+      }
+      case kStop:
+        return stackPop(thread, stack);
+      case kNoneObject:
+        PUSH(NoneType::object());
+        break;
+      case kNewTrue:
+        PUSH(Bool::trueObj());
+        break;
+      case kNewFalse:
+        PUSH(Bool::falseObj());
+        break;
+      case kBinInt1:
+        READ(1);
+        PUSH(SmallInt::fromWord(data.byteAt(reader->next++)));
+        break;
+      case kBinInt2:
+        READ(2);
+        PUSH(SmallInt::fromWord(readUInt(data, reader->next, 2)));
+        reader->next += 2;
+        break;
+      case kBinInt:
+        READ(4);
+        PUSH(SmallInt::fromWord(
+            static_cast<int32_t>(readUInt(data, reader->next, 4))));
+        reader->next += 4;
+        break;
+      case kLong1: {
+        READ(1);
+        word length = data.byteAt(reader->next++);
+        READ(length);
+        PUSH(loadLong(thread, data, reader->next, length));
+        reader->next += length;
+        break;
+      }
+      case kLong4: {
+        READ(4);
+        word length = static_cast<int32_t>(readUInt(data, reader->next, 4));
+        reader->next += 4;
+        if (length < 0) {
+          return raisePickleError(thread, ID(UnpicklingError),
+                                  "LONG pickle has negative byte count");
+        }
+        READ(length);
+        PUSH(loadLong(thread, data, reader->next, length));
+        reader->next += length;
+        break;
+      }
+      case kBinFloat: {
+        READ(8);
+        uint64_t bits = 0;
+        for (word i = 0; i < 8; i++) {
+          bits = (bits << kBitsPerByte) | data.byteAt(reader->next + i);
+        }
+        reader->next += 8;
+        double number;
+        std::memcpy(&number, &bits, sizeof(number));
+        PUSH(runtime->newFloat(number));
+        break;
+      }
+      case kShortBinUnicode:
+      case kBinUnicode:
+      case kBinUnicode8: {
+        word size_bytes = op == kShortBinUnicode ? 1 : op == kBinUnicode ? 4 : 8;
+        READ(size_bytes);
+        word length = readUInt(data, reader->next, size_bytes);
+        reader->next += size_bytes;
+        READ(length);
+        PUSH(loadStr(thread, data, reader->next, length));
+        reader->next += length;
+        break;
+      }
+      case kShortBinBytes:
+      case kBinBytes:
+      case kBinBytes8:
+      case kByteArray8: {
+        word size_bytes = op == kShortBinBytes ? 1 : op == kBinBytes ? 4 : 8;
+        READ(size_bytes);
+        word length = readUInt(data, reader->next, size_bytes);
+        reader->next += size_bytes;
+        READ(length);
+        if (op == kByteArray8) {
+          Bytearray array(&scope, runtime->newBytearray());
+          if (length > 0) {
+            MutableBytes items(&scope,
+                               runtime->newMutableBytesUninitialized(length));
+            items.replaceFromWithStartAt(0, *data, length, reader->next);
+            array.setItems(*items);
+            array.setNumItems(length);
+          }
+          tmp = *array;
+        } else {
+          tmp = loadBytes(thread, data, reader->next, length);
+        }
+        reader->next += length;
+        PUSH(*tmp);
+        break;
+      }
+      case kShortBinString:
+      case kBinString: {
+        // Only written by Python 2.
+        word size_bytes = op == kShortBinString ? 1 : 4;
+        READ(size_bytes);
+        word length = op == kShortBinString
+                          ? data.byteAt(reader->next)
+                          : static_cast<int32_t>(readUInt(data, reader->next, 4));
+        reader->next += size_bytes;
+        if (length < 0) {
+          return raisePickleError(thread, ID(UnpicklingError),
+                                  "BINSTRING pickle has negative byte count");
+        }
+        READ(length);
+        tmp = loadBytes(thread, data, reader->next, length);
+        reader->next += length;
+        PUSH(thread->invokeFunction2(ID(_pickle), ID(_decode_string), unpickler,
+                                     tmp));
+        break;
+      }
+      case kNextBuffer:
+        PUSH(callPickleHelper(thread, ID(_next_buffer), unpickler));
+        break;
+      case kReadOnlyBuffer:
+        POP_INTO(tmp);
+        PUSH(callPickleHelper(thread, ID(_readonly_buffer), tmp));
+        break;
+      case kEmptyTuple:
+        PUSH(runtime->emptyTuple());
+        break;
+      case kTuple1:
+      case kTuple2:
+      case kTuple3: {
+        word length = op - kTuple1 + 1;
+        if (stack.numItems() < length) {
+          return raisePickleError(thread, ID(UnpicklingError),
+                                  "stack underflow");
+        }
+        MutableTuple tuple(&scope, runtime->newMutableTuple(length));
+        word start = stack.numItems() - length;
+        for (word i = 0; i < length; i++) {
+          tuple.atPut(i, stack.at(start + i));
+          stack.atPut(start + i, NoneType::object());
+        }
+        stack.setNumItems(start);
+        PUSH(tuple.becomeImmutable());
+        break;
+      }
+      case kTuple: {
+        POP_MARK_INTO(tmp);
+        List items(&scope, *tmp);
+        PUSH(listToTuple(thread, items));
+        break;
+      }
+      case kEmptyList:
+        PUSH(runtime->newList());
+        break;
+      case kList:
+        POP_MARK_INTO(tmp);
+        PUSH(*tmp);
+        break;
+      case kEmptyDict:
+        PUSH(runtime->newDict());
+        break;
+      case kDict: {
+        POP_MARK_INTO(tmp);
+        List items(&scope, *tmp);
+        Dict dict(&scope, runtime->newDict());
+        for (word i = 0; i + 1 < items.numItems(); i += 2) {
+          tmp = items.at(i);
+          tmp2 = items.at(i + 1);
+          Object hash(&scope, Interpreter::hash(thread, tmp));
+          if (hash.isErrorException()) return *hash;
+          result = dictAtPut(thread, dict, tmp, SmallInt::cast(*hash).value(),
+                             tmp2);
+          if (result.isErrorException()) return *result;
+        }
+        PUSH(*dict);
+        break;
+      }
+      case kEmptySet:
+        PUSH(runtime->newSet());
+        break;
+      case kMark:
+        runtime->listAdd(thread, metastack, stack);
+        stack = runtime->newList();
+        break;
+      case kPop:
+        if (stack.numItems() > 0) {
+          POP_INTO(tmp);
+        } else {
+          POP_MARK_INTO(tmp);
+        }
+        break;
+      case kPopMark:
+        POP_MARK_INTO(tmp);
+        break;
+      case kDup:
+        tmp = stackTop(thread, stack);
+        if (tmp.isErrorException()) return *tmp;
+        PUSH(*tmp);
+        break;
+      case kAppend:
+      case kAppends:
+      case kSetItem:
+      case kSetItems:
+      case kAddItems: {
+        // `items` are the values pushed since the last MARK (or the last one
+        // or two values for the single-item opcodes).
+        List items(&scope, runtime->newList());
+        if (op == kAppend || op == kSetItem) {
+          word count = op == kAppend ? 1 : 2;
+          if (stack.numItems() < count + 1) {
+            return raisePickleError(thread, ID(UnpicklingError),
+                                    "stack underflow");
+          }
+          for (word i = stack.numItems() - count; i < stack.numItems(); i++) {
+            tmp = stack.at(i);
+            runtime->listAdd(thread, items, tmp);
+          }
+          for (word i = 0; i < count; i++) {
+            POP_INTO(tmp);
+          }
+        } else {
+          POP_MARK_INTO(tmp);
+          items = *tmp;
+        }
+        tmp = stackTop(thread, stack);
+        if (tmp.isErrorException()) return *tmp;
+        if (op == kAppend || op == kAppends) {
+          if (tmp.isList()) {
+            List list(&scope, *tmp);
+            for (word i = 0; i < items.numItems(); i++) {
+              tmp2 = items.at(i);
+              runtime->listAdd(thread, list, tmp2);
+            }
+            break;
+          }
+          result =
+              thread->invokeFunction2(ID(_pickle), ID(_extend), tmp, items);
+        } else if (op == kSetItem || op == kSetItems) {
+          if (tmp.isDict()) {
+            Dict dict(&scope, *tmp);
+            Object key(&scope, NoneType::object());
+            for (word i = 0; i + 1 < items.numItems(); i += 2) {
+              key = items.at(i);
+              tmp2 = items.at(i + 1);
+              Object hash(&scope, Interpreter::hash(thread, key));
+              if (hash.isErrorException()) return *hash;
+              result = dictAtPut(thread, dict, key,
+                                 SmallInt::cast(*hash).value(), tmp2);
+              if (result.isErrorException()) return *result;
+            }
+            break;
+          }
+          result =
+              thread->invokeFunction2(ID(_pickle), ID(_setitems), tmp, items);
+        } else {
+          if (tmp.isSet()) {
+            Set set(&scope, *tmp);
+            for (word i = 0; i < items.numItems(); i++) {
+              tmp2 = items.at(i);
+              Object hash(&scope, Interpreter::hash(thread, tmp2));
+              if (hash.isErrorException()) return *hash;
+              result =
+                  setAdd(thread, set, tmp2, SmallInt::cast(*hash).value());
+              if (result.isErrorException()) return *result;
+            }
+            break;
+          }
+          result =
+              thread->invokeFunction2(ID(_pickle), ID(_additems), tmp, items);
+        }
+        if (result.isErrorException()) return *result;
+        break;
+      }
+      case kFrozenSet: {
+        POP_MARK_INTO(tmp);
+        PUSH(thread->invokeFunction1(ID(builtins), ID(frozenset), tmp));
+        break;
+      }
+      case kBinGet:
+        READ(1);
+        PUSH(memoLoad(thread, memo, data.byteAt(reader->next++)));
+        break;
+      case kLongBinGet:
+        READ(4);
+        PUSH(memoLoad(thread, memo, readUInt(data, reader->next, 4)));
+        reader->next += 4;
+        break;
+      case kBinPut:
+      case kLongBinPut: {
+        word size_bytes = op == kBinPut ? 1 : 4;
+        READ(size_bytes);
+        word index = readUInt(data, reader->next, size_bytes);
+        reader->next += size_bytes;
+        if (op == kLongBinPut && index > kMaxInt32) {
+          return thread->raiseWithFmt(LayoutId::kValueError,
+                                      "negative LONG_BINPUT argument");
+        }
+        tmp = stackTop(thread, stack);
+        if (tmp.isErrorException()) return *tmp;
+        memoPut(thread, memo, index, tmp);
+        break;
+      }
+      case kMemoize:
+        tmp = stackTop(thread, stack);
+        if (tmp.isErrorException()) return *tmp;
+        memoPut(thread, memo, memo.numItems(), tmp);
+        break;
+      case kGlobal: {
+        tmp = readLine(reader, args, data_obj);
+        if (tmp.isErrorException()) return *tmp;
+        tmp2 = readLine(reader, args, data_obj);
+        if (tmp2.isErrorException()) return *tmp2;
+        data = **data_obj;
+        PUSH(loadGlobal(thread, unpickler, tmp, tmp2));
+        break;
+      }
+      case kStackGlobal:
+        POP_INTO(tmp2);
+        POP_INTO(tmp);
+        PUSH(loadGlobal(thread, unpickler, tmp, tmp2));
+        break;
+      case kExt1:
+      case kExt2:
+      case kExt4: {
+        word size_bytes = op == kExt1 ? 1 : op == kExt2 ? 2 : 4;
+        READ(size_bytes);
+        tmp = SmallInt::fromWord(readUInt(data, reader->next, size_bytes));
+        reader->next += size_bytes;
+        PUSH(thread->invokeFunction2(ID(_pickle), ID(_get_extension),
+                                     unpickler, tmp));
+        break;
+      }
+      case kReduce:
+        POP_INTO(tmp2);
+        POP_INTO(tmp);
+        PUSH(callWithArgs(thread, tmp, tmp2));
+        break;
+      case kNewObj:
+        POP_INTO(tmp2);
+        POP_INTO(tmp);
+        PUSH(thread->invokeFunction2(ID(_pickle), ID(_newobj), tmp, tmp2));
+        break;
+      case kNewObjEx: {
+        Object kwargs(&scope, NoneType::object());
+        POP_INTO(kwargs);
+        POP_INTO(tmp2);
+        POP_INTO(tmp);
+        PUSH(thread->invokeFunction3(ID(_pickle), ID(_newobj_ex), tmp, tmp2,
+                                     kwargs));
+        break;
+      }
+      case kBuild:
+        POP_INTO(tmp2);
+        tmp = stackTop(thread, stack);
+        if (tmp.isErrorException()) return *tmp;
+        result = thread->invokeFunction2(ID(_pickle), ID(_build), tmp, tmp2);
+        if (result.isErrorException()) return *result;
+        break;
+      case kBinPersId:
+        POP_INTO(tmp);
+        PUSH(thread->invokeMethod2(unpickler, ID(persistent_load), tmp));
+        break;
+      case kPersId: {
+        tmp = readLine(reader, args, data_obj);
+        if (tmp.isErrorException()) return *tmp;
+        data = **data_obj;
+        PUSH(thread->invokeMethod2(unpickler, ID(persistent_load), tmp));
+        break;
+      }
+      default: {
+        if (op >= ' ' && op < kMaxASCII) {
+          return raisePickleError(thread, ID(UnpicklingError),
+                                  "invalid load key, '%c'.", op);
+        }
+        return raisePickleError(thread, ID(UnpicklingError),
+                                op < 0x10 ? "invalid load key, '\\x0%x'."
+                                          : "invalid load key, '\\x%x'.",
+                                op);
+      }
+    }
+  }
+#undef READ
+#undef PUSH
+#undef POP_INTO
+#undef POP_MARK_INTO
+}
+
+RawObject FUNC(_pickle, _load)(Thread* thread, Arguments args) {
+  HandleScope scope(thread);
+  Runtime* runtime = thread->runtime();
+  PickleReader reader;
+  reader.thread = thread;
+  reader.protocol = 0;
+  reader.in_frame = false;
+  Object data_arg(&scope, args.get(static_cast<word>(LoadsArg::kData)));
+  Object data(&scope, runtime->emptyMutableBytes());
+  if (data_arg.isNoneType()) {
+    reader.from_file = true;
+    reader.next = 0;
+    reader.length = 0;
+  } else {
+    // The caller already checked that the pickle starts with PROTO.
+    Bytes bytes(&scope, bytesUnderlying(*data_arg));
+    word length = bytes.length();
+    MutableBytes copy(&scope, runtime->newMutableBytesUninitialized(length));
+    copy.replaceFromWithBytes(0, *bytes, length);
+    data = *copy;
+    reader.from_file = false;
+    reader.next = 1;
+    reader.length = length;
+  }
+  return load(thread, args, &reader, &data);
+}
+
+}  // namespace py
@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <sstream>
 
 #include "gtest/gtest.h"
@@ -163,6 +164,34 @@ TEST(UtilsTestNoFixture,
   EXPECT_EQ(Utils::memoryFindReverse(haystack, 5, needle, 2), -1);
 }
 
+TEST(UtilsTestNoFixture,
+     MemoryFindReverseWithPeriodicNeedleReturnsFirstLocationFromRight) {
+  byte haystack[] = "abaabaabaabab";
+  byte needle[] = "abaaba";
+  EXPECT_EQ(Utils::memoryFindReverse(haystack, 13, needle, 6), 6);
+}
+
+TEST(UtilsTestNoFixture,
+     MemoryFindReverseWithNonPeriodicNeedleReturnsFirstLocationFromRight) {
+  byte haystack[] = "xyzzy abcde xyzzy abcdf";
+  byte needle[] = "xyzzy ab";
+  EXPECT_EQ(Utils::memoryFindReverse(haystack, 23, needle, 8), 12);
+}
+
+TEST(UtilsTestNoFixture,
+     MemoryFindReverseWithLongRepetitiveHaystackFindsNeedleAtStart) {
+  const word haystack_len = 100000;
+  std::unique_ptr<byte[]> haystack(new byte[haystack_len]);
+  std::memset(haystack.get(), 'a', haystack_len);
+  haystack[0] = 'b';
+  byte needle[] = "baaaaaaaaaaaaaaaaaaa";
+  EXPECT_EQ(Utils::memoryFindReverse(haystack.get(), haystack_len, needle, 20),
+            0);
+  needle[0] = 'c';
+  EXPECT_EQ(Utils::memoryFindReverse(haystack.get(), haystack_len, needle, 20),
+            -1);
+}
+
 TEST(UtilsTestNoFixture, RotateLeft) {
   EXPECT_EQ(Utils::rotateLeft(1ULL, 0), 0x0000000000000001ULL);
   EXPECT_EQ(Utils::rotateLeft(1ULL, 1), 0x0000000000000002ULL);
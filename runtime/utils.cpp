@@ -18,6 +18,133 @@
 
 namespace py {
 
+// Byte accessors for `twoWayFind`. `ReverseBytes` presents the bytes ending
+// at `end` in reverse order so that the same search finds last occurrences.
+struct ForwardBytes {
+  const byte* start;
+  byte operator[](word index) const { return start[index]; }
+};
+
+struct ReverseBytes {
+  const byte* end;
+  byte operator[](word index) const { return end[-1 - index]; }
+};
+
+// Split `needle` at a critical factorization as described by Crochemore and
+// Perrin in "Two-way string-matching" (J. ACM 38(3), 1991). Returns the start
+// of the right half and stores its period in `period`.
+template <typename T>
+static word criticalFactorization(T needle, word needle_len, word* period) {
+  // Maximal suffix for the usual ordering of bytes.
+  word max_suffix = -1;
+  word j = 0;
+  word k = 1;
+  word p = 1;
+  while (j + k < needle_len) {
+    byte a = needle[j + k];
+    byte b = needle[max_suffix + k];
+    if (a < b) {
+      j += k;
+      k = 1;
+      p = j - max_suffix;
+    } else if (a == b) {
+      if (k != p) {
+        k++;
+      } else {
+        j += p;
+        k = 1;
+      }
+    } else {
+      max_suffix = j++;
+      k = p = 1;
+    }
+  }
+  *period = p;
+
+  // Maximal suffix for the reversed ordering of bytes.
+  word max_suffix_rev = -1;
+  j = 0;
+  k = p = 1;
+  while (j + k < needle_len) {
+    byte a = needle[j + k];
+    byte b = needle[max_suffix_rev + k];
+    if (b < a) {
+      j += k;
+      k = 1;
+      p = j - max_suffix_rev;
+    } else if (a == b) {
+      if (k != p) {
+        k++;
+      } else {
+        j += p;
+        k = 1;
+      }
+    } else {
+      max_suffix_rev = j++;
+      k = p = 1;
+    }
+  }
+
+  // The larger of the two maximal suffixes gives a critical factorization.
+  if (max_suffix_rev < max_suffix) {
+    return max_suffix + 1;
+  }
+  *period = p;
+  return max_suffix_rev + 1;
+}
+
+// Two-way string matching: linear time and constant space regardless of the
+// contents of `haystack` and `needle`. Returns the index of the first
+// occurrence of `needle` or -1.
+template <typename T>
+static word twoWayFind(T haystack, word haystack_len, T needle,
+                       word needle_len) {
+  word period;
+  word suffix = criticalFactorization(needle, needle_len, &period);
+  bool is_periodic = true;
+  for (word i = 0; i < suffix; i++) {
+    if (needle[i] != needle[i + period]) {
+      is_periodic = false;
+      break;
+    }
+  }
+  word last = haystack_len - needle_len;
+  if (is_periodic) {
+    // The left half repeats within the right half; remember how much of the
+    // needle is known to match after a shift by `period`.
+    word memory = 0;
+    for (word j = 0; j <= last;) {
+      word i = Utils::maximum(suffix, memory);
+      while (i < needle_len && needle[i] == haystack[i + j]) i++;
+      if (i < needle_len) {
+        j += i - suffix + 1;
+        memory = 0;
+        continue;
+      }
+      i = suffix - 1;
+      while (memory <= i && needle[i] == haystack[i + j]) i--;
+      if (i < memory) return j;
+      j += period;
+      memory = needle_len - period;
+    }
+    return -1;
+  }
+  period = Utils::maximum(suffix, needle_len - suffix) + 1;
+  for (word j = 0; j <= last;) {
+    word i = suffix;
+    while (i < needle_len && needle[i] == haystack[i + j]) i++;
+    if (i < needle_len) {
+      j += i - suffix + 1;
+      continue;
+    }
+    i = suffix - 1;
+    while (i >= 0 && needle[i] == haystack[i + j]) i--;
+    if (i < 0) return j;
+    j += period;
+  }
+  return -1;
+}
+
 word Utils::memoryFind(const byte* haystack, word haystack_len,
                        const byte* needle, word needle_len) {
   DCHECK(haystack != nullptr, "haystack cannot be null");
@@ -33,7 +160,13 @@ word Utils::memoryFind(const byte* haystack, word haystack_len,
     // Fast path: one character
     result = std::memchr(haystack, *needle, haystack_len);
   } else {
+#if defined(__GLIBC__)
+    // glibc implements memmem with the two-way algorithm.
     result = ::memmem(haystack, haystack_len, needle, needle_len);
+#else
+    return twoWayFind(ForwardBytes{haystack}, haystack_len,
+                      ForwardBytes{needle}, needle_len);
+#endif
   }
   if (result == nullptr) return -1;
   return static_cast<const byte*>(result) - haystack;
@@ -68,20 +201,15 @@ word Utils::memoryFindReverse(const byte* haystack, word haystack_len,
   if (haystack_len == 0 || needle_len == 0) return -1;
   // The needle is too big to be contained in haystack
   if (haystack_len < needle_len) return -1;
-  byte needle_start = *needle;
   if (needle_len == 1) {
     // Fast path: one character
-    return memoryFindCharReverse(haystack, haystack_len, needle_start);
+    return memoryFindCharReverse(haystack, haystack_len, *needle);
   }
-  // The last position where its possible to find needle in haystack
-  word last_offset = haystack_len - needle_len;
-  for (word i = last_offset; i >= 0; i--) {
-    if (haystack[i] == needle_start &&
-        std::memcmp(haystack + i, needle, needle_len) == 0) {
-      return i;
-    }
-  }
-  return -1;
+  // Search for the reversed needle in the reversed haystack.
+  word result = twoWayFind(ReverseBytes{haystack + haystack_len}, haystack_len,
+                           ReverseBytes{needle + needle_len}, needle_len);
+  if (result == -1) return -1;
+  return haystack_len - needle_len - result;
 }
 
 void Utils::printDebugInfoAndAbort() {
@@ -34,6 +34,7 @@ library/_io.py
 library/_json.py
 library/_os.py
 library/_path.py
+library/_pickle.py
 library/_signal.py
 library/_str_mod.py
 library/_thread.py